@@ -0,0 +1,2751 @@
+# Automatically generated by configure - do not modify!
+ifndef FFMPEG_CONFIG_MAK
+FFMPEG_CONFIG_MAK=1
+FFMPEG_CONFIGURATION=--x86asmexe=/tmp/nasmpy/nasm --disable-doc --enable-gpl --disable-avformat --disable-avdevice --disable-postproc --disable-programs --disable-avcodec --disable-filter='sr,derain,dnn_processing'
+prefix=/usr/local
+LIBDIR=$(DESTDIR)${prefix}/lib
+SHLIBDIR=$(DESTDIR)${prefix}/lib
+INCDIR=$(DESTDIR)${prefix}/include
+BINDIR=$(DESTDIR)${prefix}/bin
+DATADIR=$(DESTDIR)${prefix}/share/ffmpeg
+DOCDIR=$(DESTDIR)${prefix}/share/doc/ffmpeg
+MANDIR=$(DESTDIR)${prefix}/share/man
+PKGCONFIGDIR=$(DESTDIR)${prefix}/lib/pkgconfig
+INSTALL_NAME_DIR=
+SRC_PATH=src
+SRC_LINK=src
+ifndef MAIN_MAKEFILE
+SRC_PATH:=$(SRC_PATH:.%=..%)
+endif
+CC_IDENT=gcc 12 (Debian 12.2.0-14+deb12u1)
+ARCH=x86
+INTRINSICS=none
+EXTERN_PREFIX=
+CC=gcc
+CXX=g++
+AS=gcc
+OBJCC=gcc
+LD=gcc
+DEPCC=gcc
+DEPCCFLAGS= $(CPPFLAGS)
+DEPAS=gcc
+DEPASFLAGS= $(CPPFLAGS)
+X86ASM=/tmp/nasmpy/nasm
+DEPX86ASM=/tmp/nasmpy/nasm
+DEPX86ASMFLAGS=$(X86ASMFLAGS)
+AR=ar
+ARFLAGS=rcD
+AR_O=$@
+AR_CMD=ar
+NM_CMD=nm -g
+RANLIB=ranlib -D
+STRIP=strip
+STRIPTYPE=direct
+NVCC=clang
+CP=cp -p
+LN_S=ln -s -f
+CPPFLAGS= -D_ISOC99_SOURCE -D_FILE_OFFSET_BITS=64 -D_LARGEFILE_SOURCE -D_POSIX_C_SOURCE=200112 -D_XOPEN_SOURCE=600 -DPIC -DZLIB_CONST
+CFLAGS=   -std=c11 -fomit-frame-pointer -fPIC -pthread   -g -Wdeclaration-after-statement -Wall -Wdisabled-optimization -Wpointer-arith -Wredundant-decls -Wwrite-strings -Wtype-limits -Wundef -Wmissing-prototypes -Wno-pointer-to-int-cast -Wstrict-prototypes -Wempty-body -Wno-parentheses -Wno-switch -Wno-format-zero-length -Wno-pointer-sign -Wno-unused-const-variable -Wno-bool-operation -Wno-char-subscripts -O3 -fno-math-errno -fno-signed-zeros -fno-tree-vectorize -Werror=format-security -Werror=implicit-function-declaration -Werror=missing-prototypes -Werror=return-type -Werror=vla -Wformat -fdiagnostics-color=auto -Wno-maybe-uninitialized
+CXXFLAGS=  -D__STDC_CONSTANT_MACROS -std=c++11
+OBJCFLAGS=  
+ASFLAGS=   -fPIC -g
+NVCCFLAGS=--cuda-gpu-arch=sm_30 -O2 -m64 -S -nocudalib -nocudainc --cuda-device-only -include src/compat/cuda/cuda_runtime.h
+AS_C=-c
+AS_O=-o $@
+OBJCC_C=-c
+OBJCC_E=-E -o $@
+OBJCC_O=-o $@
+CC_C=-c
+CC_E=-E -o $@
+CC_O=-o $@
+CXX_C=-c
+CXX_O=-o $@
+NVCC_C=
+NVCC_O=-o $@
+LD_O=-o $@
+X86ASM_O=-o $@
+LD_LIB=-l%
+LD_PATH=-L
+DLLTOOL=
+WINDRES=windres
+DEPWINDRES=gcc
+DOXYGEN=doxygen
+LDFLAGS=  -Wl,--as-needed -Wl,-z,noexecstack -Wl,--warn-common -Wl,-rpath-link=:libpostproc:libswresample:libswscale:libavfilter:libavdevice:libavformat:libavcodec:libavutil:libavresample
+LDEXEFLAGS=
+LDSOFLAGS=
+SHFLAGS=-shared -Wl,-soname,$$(@F) -Wl,-Bsymbolic -Wl,--version-script,$(SUBDIR)lib$(NAME).ver
+ASMSTRIPFLAGS= -x
+X86ASMFLAGS=-f elf64 -DPIC -g -F dwarf
+BUILDSUF=
+PROGSSUF=
+FULLNAME=$(NAME)$(BUILDSUF)
+LIBPREF=lib
+LIBSUF=.a
+LIBNAME=$(LIBPREF)$(FULLNAME)$(LIBSUF)
+SLIBPREF=lib
+SLIBSUF=.so
+EXESUF=
+EXTRA_VERSION=
+CCDEP=
+CXXDEP=
+CCDEP_FLAGS=
+ASDEP=
+ASDEP_FLAGS=
+X86ASMDEP=
+X86ASMDEP_FLAGS=
+CC_DEPFLAGS=-MMD -MF $(@:.o=.d) -MT $@
+AS_DEPFLAGS=-MMD -MF $(@:.o=.d) -MT $@
+X86ASM_DEPFLAGS=-MD $(@:.o=.d)
+HOSTCC=gcc
+HOSTLD=gcc
+HOSTCFLAGS=  -std=c99 -Wall -O3
+HOSTCPPFLAGS= -D_ISOC99_SOURCE -D_POSIX_C_SOURCE=200112 -D_XOPEN_SOURCE=600 -D_POSIX_C_SOURCE=200112 -D_XOPEN_SOURCE=600
+HOSTEXESUF=
+HOSTLDFLAGS= 
+HOSTEXTRALIBS=-lm
+DEPHOSTCC=gcc
+DEPHOSTCCFLAGS= $(HOSTCCFLAGS)
+HOSTCCDEP=
+HOSTCCDEP_FLAGS=
+HOSTCC_DEPFLAGS=-MMD -MF $(@:.o=.d) -MT $@
+HOSTCC_C=-c
+HOSTCC_O=-o $@
+HOSTLD_O=-o $@
+TARGET_EXEC= 
+TARGET_PATH=$(CURDIR)
+TARGET_SAMPLES=$(SAMPLES)
+CFLAGS-ffplay=
+CFLAGS_HEADERS= -Wno-deprecated-declarations -Wno-unused-variable
+LIB_INSTALL_EXTRA_CMD=$$(RANLIB) "$(LIBDIR)/$(LIBNAME)"
+EXTRALIBS=
+COMPAT_OBJS=
+INSTALL=install
+LIBTARGET=
+SLIBNAME=$(SLIBPREF)$(FULLNAME)$(SLIBSUF)
+SLIBNAME_WITH_VERSION=$(SLIBNAME).$(LIBVERSION)
+SLIBNAME_WITH_MAJOR=$(SLIBNAME).$(LIBMAJOR)
+SLIB_CREATE_DEF_CMD=
+SLIB_EXTRA_CMD=
+SLIB_INSTALL_NAME=$(SLIBNAME_WITH_VERSION)
+SLIB_INSTALL_LINKS=$(SLIBNAME_WITH_MAJOR) $(SLIBNAME)
+SLIB_INSTALL_EXTRA_LIB=
+SLIB_INSTALL_EXTRA_SHLIB=
+VERSION_SCRIPT_POSTPROCESS_CMD=cat
+SAMPLES:=$(FATE_SAMPLES)
+NOREDZONE_FLAGS=-mno-red-zone
+LIBFUZZER_PATH=
+IGNORE_TESTS=
+avdevice_FFLIBS=avformat avcodec avutil
+avfilter_FFLIBS=swscale swresample avutil
+swscale_FFLIBS=avutil
+postproc_FFLIBS=avutil
+avformat_FFLIBS=avcodec avutil
+avcodec_FFLIBS=avutil
+swresample_FFLIBS=avutil
+avresample_FFLIBS=avutil
+avutil_FFLIBS=
+EXTRALIBS-avdevice=-lm
+EXTRALIBS-avfilter=-pthread -lm
+EXTRALIBS-swscale=-lm
+EXTRALIBS-postproc=-lm
+EXTRALIBS-avformat=-lm -lz
+EXTRALIBS-avcodec=-pthread -lm
+EXTRALIBS-swresample=-lm
+EXTRALIBS-avresample=-lm
+EXTRALIBS-avutil=-pthread -lm
+EXTRALIBS-ffplay=
+EXTRALIBS-ffprobe=
+EXTRALIBS-ffmpeg=
+EXTRALIBS-cpu_init=-pthread
+EXTRALIBS-cws2fws=-lz
+!ARCH_AARCH64=yes
+!ARCH_ALPHA=yes
+!ARCH_ARM=yes
+!ARCH_AVR32=yes
+!ARCH_AVR32_AP=yes
+!ARCH_AVR32_UC=yes
+!ARCH_BFIN=yes
+!ARCH_IA64=yes
+!ARCH_M68K=yes
+!ARCH_MIPS=yes
+!ARCH_MIPS64=yes
+!ARCH_PARISC=yes
+!ARCH_PPC=yes
+!ARCH_PPC64=yes
+!ARCH_S390=yes
+!ARCH_SH4=yes
+!ARCH_SPARC=yes
+!ARCH_SPARC64=yes
+!ARCH_TILEGX=yes
+!ARCH_TILEPRO=yes
+!ARCH_TOMI=yes
+ARCH_X86=yes
+!ARCH_X86_32=yes
+ARCH_X86_64=yes
+!HAVE_ARMV5TE=yes
+!HAVE_ARMV6=yes
+!HAVE_ARMV6T2=yes
+!HAVE_ARMV8=yes
+!HAVE_NEON=yes
+!HAVE_VFP=yes
+!HAVE_VFPV3=yes
+!HAVE_SETEND=yes
+!HAVE_ALTIVEC=yes
+!HAVE_DCBZL=yes
+!HAVE_LDBRX=yes
+!HAVE_POWER8=yes
+!HAVE_PPC4XX=yes
+!HAVE_VSX=yes
+HAVE_AESNI=yes
+HAVE_AMD3DNOW=yes
+HAVE_AMD3DNOWEXT=yes
+HAVE_AVX=yes
+HAVE_AVX2=yes
+HAVE_AVX512=yes
+HAVE_FMA3=yes
+HAVE_FMA4=yes
+HAVE_MMX=yes
+HAVE_MMXEXT=yes
+HAVE_SSE=yes
+HAVE_SSE2=yes
+HAVE_SSE3=yes
+HAVE_SSE4=yes
+HAVE_SSE42=yes
+HAVE_SSSE3=yes
+HAVE_XOP=yes
+HAVE_CPUNOP=yes
+HAVE_I686=yes
+!HAVE_MIPSFPU=yes
+!HAVE_MIPS32R2=yes
+!HAVE_MIPS32R5=yes
+!HAVE_MIPS64R2=yes
+!HAVE_MIPS32R6=yes
+!HAVE_MIPS64R6=yes
+!HAVE_MIPSDSP=yes
+!HAVE_MIPSDSPR2=yes
+!HAVE_MSA=yes
+!HAVE_MSA2=yes
+!HAVE_LOONGSON2=yes
+!HAVE_LOONGSON3=yes
+!HAVE_MMI=yes
+!HAVE_ARMV5TE_EXTERNAL=yes
+!HAVE_ARMV6_EXTERNAL=yes
+!HAVE_ARMV6T2_EXTERNAL=yes
+!HAVE_ARMV8_EXTERNAL=yes
+!HAVE_NEON_EXTERNAL=yes
+!HAVE_VFP_EXTERNAL=yes
+!HAVE_VFPV3_EXTERNAL=yes
+!HAVE_SETEND_EXTERNAL=yes
+!HAVE_ALTIVEC_EXTERNAL=yes
+!HAVE_DCBZL_EXTERNAL=yes
+!HAVE_LDBRX_EXTERNAL=yes
+!HAVE_POWER8_EXTERNAL=yes
+!HAVE_PPC4XX_EXTERNAL=yes
+!HAVE_VSX_EXTERNAL=yes
+HAVE_AESNI_EXTERNAL=yes
+HAVE_AMD3DNOW_EXTERNAL=yes
+HAVE_AMD3DNOWEXT_EXTERNAL=yes
+HAVE_AVX_EXTERNAL=yes
+HAVE_AVX2_EXTERNAL=yes
+HAVE_AVX512_EXTERNAL=yes
+HAVE_FMA3_EXTERNAL=yes
+HAVE_FMA4_EXTERNAL=yes
+HAVE_MMX_EXTERNAL=yes
+HAVE_MMXEXT_EXTERNAL=yes
+HAVE_SSE_EXTERNAL=yes
+HAVE_SSE2_EXTERNAL=yes
+HAVE_SSE3_EXTERNAL=yes
+HAVE_SSE4_EXTERNAL=yes
+HAVE_SSE42_EXTERNAL=yes
+HAVE_SSSE3_EXTERNAL=yes
+HAVE_XOP_EXTERNAL=yes
+!HAVE_CPUNOP_EXTERNAL=yes
+!HAVE_I686_EXTERNAL=yes
+!HAVE_MIPSFPU_EXTERNAL=yes
+!HAVE_MIPS32R2_EXTERNAL=yes
+!HAVE_MIPS32R5_EXTERNAL=yes
+!HAVE_MIPS64R2_EXTERNAL=yes
+!HAVE_MIPS32R6_EXTERNAL=yes
+!HAVE_MIPS64R6_EXTERNAL=yes
+!HAVE_MIPSDSP_EXTERNAL=yes
+!HAVE_MIPSDSPR2_EXTERNAL=yes
+!HAVE_MSA_EXTERNAL=yes
+!HAVE_MSA2_EXTERNAL=yes
+!HAVE_LOONGSON2_EXTERNAL=yes
+!HAVE_LOONGSON3_EXTERNAL=yes
+!HAVE_MMI_EXTERNAL=yes
+!HAVE_ARMV5TE_INLINE=yes
+!HAVE_ARMV6_INLINE=yes
+!HAVE_ARMV6T2_INLINE=yes
+!HAVE_ARMV8_INLINE=yes
+!HAVE_NEON_INLINE=yes
+!HAVE_VFP_INLINE=yes
+!HAVE_VFPV3_INLINE=yes
+!HAVE_SETEND_INLINE=yes
+!HAVE_ALTIVEC_INLINE=yes
+!HAVE_DCBZL_INLINE=yes
+!HAVE_LDBRX_INLINE=yes
+!HAVE_POWER8_INLINE=yes
+!HAVE_PPC4XX_INLINE=yes
+!HAVE_VSX_INLINE=yes
+HAVE_AESNI_INLINE=yes
+HAVE_AMD3DNOW_INLINE=yes
+HAVE_AMD3DNOWEXT_INLINE=yes
+HAVE_AVX_INLINE=yes
+HAVE_AVX2_INLINE=yes
+HAVE_AVX512_INLINE=yes
+HAVE_FMA3_INLINE=yes
+HAVE_FMA4_INLINE=yes
+HAVE_MMX_INLINE=yes
+HAVE_MMXEXT_INLINE=yes
+HAVE_SSE_INLINE=yes
+HAVE_SSE2_INLINE=yes
+HAVE_SSE3_INLINE=yes
+HAVE_SSE4_INLINE=yes
+HAVE_SSE42_INLINE=yes
+HAVE_SSSE3_INLINE=yes
+HAVE_XOP_INLINE=yes
+!HAVE_CPUNOP_INLINE=yes
+!HAVE_I686_INLINE=yes
+!HAVE_MIPSFPU_INLINE=yes
+!HAVE_MIPS32R2_INLINE=yes
+!HAVE_MIPS32R5_INLINE=yes
+!HAVE_MIPS64R2_INLINE=yes
+!HAVE_MIPS32R6_INLINE=yes
+!HAVE_MIPS64R6_INLINE=yes
+!HAVE_MIPSDSP_INLINE=yes
+!HAVE_MIPSDSPR2_INLINE=yes
+!HAVE_MSA_INLINE=yes
+!HAVE_MSA2_INLINE=yes
+!HAVE_LOONGSON2_INLINE=yes
+!HAVE_LOONGSON3_INLINE=yes
+!HAVE_MMI_INLINE=yes
+HAVE_ALIGNED_STACK=yes
+HAVE_FAST_64BIT=yes
+HAVE_FAST_CLZ=yes
+HAVE_FAST_CMOV=yes
+HAVE_LOCAL_ALIGNED=yes
+HAVE_SIMD_ALIGN_16=yes
+HAVE_SIMD_ALIGN_32=yes
+HAVE_SIMD_ALIGN_64=yes
+!HAVE_ATOMIC_CAS_PTR=yes
+!HAVE_MACHINE_RW_BARRIER=yes
+!HAVE_MEMORYBARRIER=yes
+HAVE_MM_EMPTY=yes
+!HAVE_RDTSC=yes
+HAVE_SEM_TIMEDWAIT=yes
+HAVE_SYNC_VAL_COMPARE_AND_SWAP=yes
+!HAVE_CABS=yes
+!HAVE_CEXP=yes
+HAVE_INLINE_ASM=yes
+HAVE_SYMVER=yes
+HAVE_X86ASM=yes
+!HAVE_BIGENDIAN=yes
+HAVE_FAST_UNALIGNED=yes
+HAVE_ARPA_INET_H=yes
+HAVE_ASM_TYPES_H=yes
+!HAVE_CDIO_PARANOIA_H=yes
+!HAVE_CDIO_PARANOIA_PARANOIA_H=yes
+!HAVE_CUDA_H=yes
+!HAVE_DISPATCH_DISPATCH_H=yes
+!HAVE_DEV_BKTR_IOCTL_BT848_H=yes
+!HAVE_DEV_BKTR_IOCTL_METEOR_H=yes
+!HAVE_DEV_IC_BT8XX_H=yes
+!HAVE_DEV_VIDEO_BKTR_IOCTL_BT848_H=yes
+!HAVE_DEV_VIDEO_METEOR_IOCTL_METEOR_H=yes
+!HAVE_DIRECT_H=yes
+HAVE_DIRENT_H=yes
+!HAVE_DXGIDEBUG_H=yes
+!HAVE_DXVA_H=yes
+!HAVE_ES2_GL_H=yes
+!HAVE_GSM_H=yes
+!HAVE_IO_H=yes
+HAVE_LINUX_PERF_EVENT_H=yes
+!HAVE_MACHINE_IOCTL_BT848_H=yes
+!HAVE_MACHINE_IOCTL_METEOR_H=yes
+HAVE_MALLOC_H=yes
+!HAVE_OPENCV2_CORE_CORE_C_H=yes
+!HAVE_OPENGL_GL3_H=yes
+HAVE_POLL_H=yes
+HAVE_SYS_PARAM_H=yes
+HAVE_SYS_RESOURCE_H=yes
+HAVE_SYS_SELECT_H=yes
+HAVE_SYS_SOUNDCARD_H=yes
+HAVE_SYS_TIME_H=yes
+HAVE_SYS_UN_H=yes
+!HAVE_SYS_VIDEOIO_H=yes
+HAVE_TERMIOS_H=yes
+!HAVE_UDPLITE_H=yes
+HAVE_UNISTD_H=yes
+!HAVE_VALGRIND_VALGRIND_H=yes
+!HAVE_WINDOWS_H=yes
+!HAVE_WINSOCK2_H=yes
+!HAVE_INTRINSICS_NEON=yes
+HAVE_ATANF=yes
+HAVE_ATAN2F=yes
+HAVE_CBRT=yes
+HAVE_CBRTF=yes
+HAVE_COPYSIGN=yes
+HAVE_COSF=yes
+HAVE_ERF=yes
+HAVE_EXP2=yes
+HAVE_EXP2F=yes
+HAVE_EXPF=yes
+HAVE_HYPOT=yes
+HAVE_ISFINITE=yes
+HAVE_ISINF=yes
+HAVE_ISNAN=yes
+HAVE_LDEXPF=yes
+HAVE_LLRINT=yes
+HAVE_LLRINTF=yes
+HAVE_LOG2=yes
+HAVE_LOG2F=yes
+HAVE_LOG10F=yes
+HAVE_LRINT=yes
+HAVE_LRINTF=yes
+HAVE_POWF=yes
+HAVE_RINT=yes
+HAVE_ROUND=yes
+HAVE_ROUNDF=yes
+HAVE_SINF=yes
+HAVE_TRUNC=yes
+HAVE_TRUNCF=yes
+!HAVE_DOS_PATHS=yes
+!HAVE_LIBC_MSVCRT=yes
+!HAVE_MMAL_PARAMETER_VIDEO_MAX_NUM_CALLBACKS=yes
+HAVE_SECTION_DATA_REL_RO=yes
+HAVE_THREADS=yes
+!HAVE_UWP=yes
+!HAVE_WINRT=yes
+HAVE_ACCESS=yes
+!HAVE_ALIGNED_MALLOC=yes
+!HAVE_ARC4RANDOM=yes
+HAVE_CLOCK_GETTIME=yes
+!HAVE_CLOSESOCKET=yes
+!HAVE_COMMANDLINETOARGVW=yes
+HAVE_FCNTL=yes
+HAVE_GETADDRINFO=yes
+!HAVE_GETHRTIME=yes
+HAVE_GETOPT=yes
+!HAVE_GETMODULEHANDLE=yes
+!HAVE_GETPROCESSAFFINITYMASK=yes
+!HAVE_GETPROCESSMEMORYINFO=yes
+!HAVE_GETPROCESSTIMES=yes
+HAVE_GETRUSAGE=yes
+!HAVE_GETSTDHANDLE=yes
+!HAVE_GETSYSTEMTIMEASFILETIME=yes
+HAVE_GETTIMEOFDAY=yes
+HAVE_GLOB=yes
+!HAVE_GLXGETPROCADDRESS=yes
+HAVE_GMTIME_R=yes
+HAVE_INET_ATON=yes
+HAVE_ISATTY=yes
+!HAVE_KBHIT=yes
+HAVE_LOCALTIME_R=yes
+HAVE_LSTAT=yes
+!HAVE_LZO1X_999_COMPRESS=yes
+!HAVE_MACH_ABSOLUTE_TIME=yes
+!HAVE_MAPVIEWOFFILE=yes
+HAVE_MEMALIGN=yes
+HAVE_MKSTEMP=yes
+HAVE_MMAP=yes
+HAVE_MPROTECT=yes
+HAVE_NANOSLEEP=yes
+!HAVE_PEEKNAMEDPIPE=yes
+HAVE_POSIX_MEMALIGN=yes
+HAVE_PTHREAD_CANCEL=yes
+HAVE_SCHED_GETAFFINITY=yes
+!HAVE_SECITEMIMPORT=yes
+!HAVE_SETCONSOLETEXTATTRIBUTE=yes
+!HAVE_SETCONSOLECTRLHANDLER=yes
+!HAVE_SETDLLDIRECTORY=yes
+!HAVE_SETMODE=yes
+HAVE_SETRLIMIT=yes
+!HAVE_SLEEP=yes
+HAVE_STRERROR_R=yes
+HAVE_SYSCONF=yes
+!HAVE_SYSCTL=yes
+HAVE_USLEEP=yes
+!HAVE_UTGETOSTYPEFROMSTRING=yes
+!HAVE_VIRTUALALLOC=yes
+!HAVE_WGLGETPROCADDRESS=yes
+!HAVE_BCRYPT=yes
+!HAVE_VAAPI_DRM=yes
+!HAVE_VAAPI_X11=yes
+!HAVE_VDPAU_X11=yes
+HAVE_PTHREADS=yes
+!HAVE_OS2THREADS=yes
+!HAVE_W32THREADS=yes
+!HAVE_AS_ARCH_DIRECTIVE=yes
+!HAVE_AS_DN_DIRECTIVE=yes
+!HAVE_AS_FPU_DIRECTIVE=yes
+!HAVE_AS_FUNC=yes
+!HAVE_AS_OBJECT_ARCH=yes
+!HAVE_ASM_MOD_Q=yes
+!HAVE_BLOCKS_EXTENSION=yes
+HAVE_EBP_AVAILABLE=yes
+HAVE_EBX_AVAILABLE=yes
+!HAVE_GNU_AS=yes
+!HAVE_GNU_WINDRES=yes
+!HAVE_IBM_ASM=yes
+HAVE_INLINE_ASM_DIRECT_SYMBOL_REFS=yes
+HAVE_INLINE_ASM_LABELS=yes
+HAVE_INLINE_ASM_NONLOCAL_LABELS=yes
+HAVE_PRAGMA_DEPRECATED=yes
+!HAVE_RSYNC_CONTIMEOUT=yes
+!HAVE_SYMVER_ASM_LABEL=yes
+HAVE_SYMVER_GNU_ASM=yes
+!HAVE_VFP_ARGS=yes
+!HAVE_XFORM_ASM=yes
+HAVE_XMM_CLOBBERS=yes
+!HAVE_KCMVIDEOCODECTYPE_HEVC=yes
+!HAVE_KCVPIXELFORMATTYPE_420YPCBCR10BIPLANARVIDEORANGE=yes
+!HAVE_KCVIMAGEBUFFERTRANSFERFUNCTION_SMPTE_ST_2084_PQ=yes
+!HAVE_KCVIMAGEBUFFERTRANSFERFUNCTION_ITU_R_2100_HLG=yes
+!HAVE_KCVIMAGEBUFFERTRANSFERFUNCTION_LINEAR=yes
+HAVE_SOCKLEN_T=yes
+HAVE_STRUCT_ADDRINFO=yes
+HAVE_STRUCT_GROUP_SOURCE_REQ=yes
+HAVE_STRUCT_IP_MREQ_SOURCE=yes
+HAVE_STRUCT_IPV6_MREQ=yes
+HAVE_STRUCT_MSGHDR_MSG_FLAGS=yes
+HAVE_STRUCT_POLLFD=yes
+HAVE_STRUCT_RUSAGE_RU_MAXRSS=yes
+!HAVE_STRUCT_SCTP_EVENT_SUBSCRIBE=yes
+HAVE_STRUCT_SOCKADDR_IN6=yes
+!HAVE_STRUCT_SOCKADDR_SA_LEN=yes
+HAVE_STRUCT_SOCKADDR_STORAGE=yes
+HAVE_STRUCT_STAT_ST_MTIM_TV_NSEC=yes
+HAVE_STRUCT_V4L2_FRMIVALENUM_DISCRETE=yes
+!HAVE_MAKEINFO=yes
+!HAVE_MAKEINFO_HTML=yes
+!HAVE_OPENCL_D3D11=yes
+!HAVE_OPENCL_DRM_ARM=yes
+!HAVE_OPENCL_DRM_BEIGNET=yes
+!HAVE_OPENCL_DXVA2=yes
+!HAVE_OPENCL_VAAPI_BEIGNET=yes
+!HAVE_OPENCL_VAAPI_INTEL_MEDIA=yes
+HAVE_PERL=yes
+HAVE_POD2MAN=yes
+!HAVE_TEXI2HTML=yes
+!CONFIG_DOC=yes
+!CONFIG_HTMLPAGES=yes
+CONFIG_MANPAGES=yes
+CONFIG_PODPAGES=yes
+!CONFIG_TXTPAGES=yes
+CONFIG_AVIO_LIST_DIR_EXAMPLE=yes
+CONFIG_AVIO_READING_EXAMPLE=yes
+!CONFIG_DECODE_AUDIO_EXAMPLE=yes
+!CONFIG_DECODE_VIDEO_EXAMPLE=yes
+!CONFIG_DEMUXING_DECODING_EXAMPLE=yes
+!CONFIG_ENCODE_AUDIO_EXAMPLE=yes
+!CONFIG_ENCODE_VIDEO_EXAMPLE=yes
+!CONFIG_EXTRACT_MVS_EXAMPLE=yes
+CONFIG_FILTER_AUDIO_EXAMPLE=yes
+!CONFIG_FILTERING_AUDIO_EXAMPLE=yes
+!CONFIG_FILTERING_VIDEO_EXAMPLE=yes
+!CONFIG_HTTP_MULTICLIENT_EXAMPLE=yes
+!CONFIG_HW_DECODE_EXAMPLE=yes
+!CONFIG_METADATA_EXAMPLE=yes
+!CONFIG_MUXING_EXAMPLE=yes
+!CONFIG_QSVDEC_EXAMPLE=yes
+!CONFIG_REMUXING_EXAMPLE=yes
+CONFIG_RESAMPLING_AUDIO_EXAMPLE=yes
+CONFIG_SCALING_VIDEO_EXAMPLE=yes
+!CONFIG_TRANSCODE_AAC_EXAMPLE=yes
+!CONFIG_TRANSCODING_EXAMPLE=yes
+!CONFIG_VAAPI_ENCODE_EXAMPLE=yes
+!CONFIG_VAAPI_TRANSCODE_EXAMPLE=yes
+!CONFIG_AVISYNTH=yes
+!CONFIG_FREI0R=yes
+!CONFIG_LIBCDIO=yes
+!CONFIG_LIBDAVS2=yes
+!CONFIG_LIBRUBBERBAND=yes
+!CONFIG_LIBVIDSTAB=yes
+!CONFIG_LIBX264=yes
+!CONFIG_LIBX265=yes
+!CONFIG_LIBXAVS=yes
+!CONFIG_LIBXAVS2=yes
+!CONFIG_LIBXVID=yes
+!CONFIG_DECKLINK=yes
+!CONFIG_LIBFDK_AAC=yes
+!CONFIG_OPENSSL=yes
+!CONFIG_LIBTLS=yes
+!CONFIG_GMP=yes
+!CONFIG_LIBARIBB24=yes
+!CONFIG_LIBLENSFUN=yes
+!CONFIG_LIBOPENCORE_AMRNB=yes
+!CONFIG_LIBOPENCORE_AMRWB=yes
+!CONFIG_LIBVMAF=yes
+!CONFIG_LIBVO_AMRWBENC=yes
+!CONFIG_MBEDTLS=yes
+!CONFIG_RKMPP=yes
+!CONFIG_LIBSMBCLIENT=yes
+!CONFIG_CHROMAPRINT=yes
+!CONFIG_GCRYPT=yes
+!CONFIG_GNUTLS=yes
+!CONFIG_JNI=yes
+!CONFIG_LADSPA=yes
+!CONFIG_LIBAOM=yes
+!CONFIG_LIBASS=yes
+!CONFIG_LIBBLURAY=yes
+!CONFIG_LIBBS2B=yes
+!CONFIG_LIBCACA=yes
+!CONFIG_LIBCELT=yes
+!CONFIG_LIBCODEC2=yes
+!CONFIG_LIBDAV1D=yes
+!CONFIG_LIBDC1394=yes
+!CONFIG_LIBDRM=yes
+!CONFIG_LIBFLITE=yes
+!CONFIG_LIBFONTCONFIG=yes
+!CONFIG_LIBFREETYPE=yes
+!CONFIG_LIBFRIBIDI=yes
+!CONFIG_LIBGLSLANG=yes
+!CONFIG_LIBGME=yes
+!CONFIG_LIBGSM=yes
+!CONFIG_LIBIEC61883=yes
+!CONFIG_LIBILBC=yes
+!CONFIG_LIBJACK=yes
+!CONFIG_LIBKLVANC=yes
+!CONFIG_LIBKVAZAAR=yes
+!CONFIG_LIBMODPLUG=yes
+!CONFIG_LIBMP3LAME=yes
+!CONFIG_LIBMYSOFA=yes
+!CONFIG_LIBOPENCV=yes
+!CONFIG_LIBOPENH264=yes
+!CONFIG_LIBOPENJPEG=yes
+!CONFIG_LIBOPENMPT=yes
+!CONFIG_LIBOPUS=yes
+!CONFIG_LIBPULSE=yes
+!CONFIG_LIBRABBITMQ=yes
+!CONFIG_LIBRAV1E=yes
+!CONFIG_LIBRSVG=yes
+!CONFIG_LIBRTMP=yes
+!CONFIG_LIBSHINE=yes
+!CONFIG_LIBSMBCLIENT=yes
+!CONFIG_LIBSNAPPY=yes
+!CONFIG_LIBSOXR=yes
+!CONFIG_LIBSPEEX=yes
+!CONFIG_LIBSRT=yes
+!CONFIG_LIBSSH=yes
+!CONFIG_LIBTENSORFLOW=yes
+!CONFIG_LIBTESSERACT=yes
+!CONFIG_LIBTHEORA=yes
+!CONFIG_LIBTWOLAME=yes
+!CONFIG_LIBV4L2=yes
+!CONFIG_LIBVORBIS=yes
+!CONFIG_LIBVPX=yes
+!CONFIG_LIBWAVPACK=yes
+!CONFIG_LIBWEBP=yes
+!CONFIG_LIBXML2=yes
+!CONFIG_LIBZIMG=yes
+!CONFIG_LIBZMQ=yes
+!CONFIG_LIBZVBI=yes
+!CONFIG_LV2=yes
+!CONFIG_MEDIACODEC=yes
+!CONFIG_OPENAL=yes
+!CONFIG_OPENGL=yes
+!CONFIG_POCKETSPHINX=yes
+!CONFIG_VAPOURSYNTH=yes
+!CONFIG_ALSA=yes
+!CONFIG_APPKIT=yes
+!CONFIG_AVFOUNDATION=yes
+CONFIG_BZLIB=yes
+!CONFIG_COREIMAGE=yes
+CONFIG_ICONV=yes
+CONFIG_LIBXCB=yes
+!CONFIG_LIBXCB_SHM=yes
+!CONFIG_LIBXCB_SHAPE=yes
+!CONFIG_LIBXCB_XFIXES=yes
+CONFIG_LZMA=yes
+!CONFIG_MEDIAFOUNDATION=yes
+!CONFIG_SCHANNEL=yes
+!CONFIG_SDL2=yes
+!CONFIG_SECURETRANSPORT=yes
+!CONFIG_SNDIO=yes
+!CONFIG_XLIB=yes
+CONFIG_ZLIB=yes
+!CONFIG_CUDA_NVCC=yes
+!CONFIG_CUDA_SDK=yes
+!CONFIG_LIBNPP=yes
+!CONFIG_LIBMFX=yes
+!CONFIG_MMAL=yes
+!CONFIG_OMX=yes
+!CONFIG_OPENCL=yes
+!CONFIG_VULKAN=yes
+!CONFIG_AMF=yes
+!CONFIG_AUDIOTOOLBOX=yes
+!CONFIG_CRYSTALHD=yes
+!CONFIG_CUDA=yes
+!CONFIG_CUDA_LLVM=yes
+!CONFIG_CUVID=yes
+!CONFIG_D3D11VA=yes
+!CONFIG_DXVA2=yes
+!CONFIG_FFNVCODEC=yes
+!CONFIG_NVDEC=yes
+!CONFIG_NVENC=yes
+!CONFIG_VAAPI=yes
+!CONFIG_VDPAU=yes
+!CONFIG_VIDEOTOOLBOX=yes
+CONFIG_V4L2_M2M=yes
+!CONFIG_XVMC=yes
+!CONFIG_FTRAPV=yes
+!CONFIG_GRAY=yes
+!CONFIG_HARDCODED_TABLES=yes
+!CONFIG_OMX_RPI=yes
+CONFIG_RUNTIME_CPUDETECT=yes
+CONFIG_SAFE_BITSTREAM_READER=yes
+!CONFIG_SHARED=yes
+!CONFIG_SMALL=yes
+CONFIG_STATIC=yes
+CONFIG_SWSCALE_ALPHA=yes
+CONFIG_GPL=yes
+!CONFIG_NONFREE=yes
+!CONFIG_VERSION3=yes
+!CONFIG_AVDEVICE=yes
+CONFIG_AVFILTER=yes
+CONFIG_SWSCALE=yes
+!CONFIG_POSTPROC=yes
+!CONFIG_AVFORMAT=yes
+!CONFIG_AVCODEC=yes
+CONFIG_SWRESAMPLE=yes
+!CONFIG_AVRESAMPLE=yes
+CONFIG_AVUTIL=yes
+!CONFIG_FFPLAY=yes
+!CONFIG_FFPROBE=yes
+!CONFIG_FFMPEG=yes
+!CONFIG_DCT=yes
+!CONFIG_DWT=yes
+!CONFIG_ERROR_RESILIENCE=yes
+CONFIG_FAAN=yes
+CONFIG_FAST_UNALIGNED=yes
+CONFIG_FFT=yes
+!CONFIG_LSP=yes
+!CONFIG_LZO=yes
+!CONFIG_MDCT=yes
+CONFIG_PIXELUTILS=yes
+!CONFIG_NETWORK=yes
+CONFIG_RDFT=yes
+!CONFIG_AUTODETECT=yes
+!CONFIG_FONTCONFIG=yes
+CONFIG_LARGE_TESTS=yes
+!CONFIG_LINUX_PERF=yes
+!CONFIG_MEMORY_POISONING=yes
+!CONFIG_NEON_CLOBBER_TEST=yes
+!CONFIG_OSSFUZZ=yes
+CONFIG_PIC=yes
+!CONFIG_THUMB=yes
+!CONFIG_VALGRIND_BACKTRACE=yes
+!CONFIG_XMM_CLOBBER_TEST=yes
+!CONFIG_BSFS=yes
+!CONFIG_DECODERS=yes
+!CONFIG_ENCODERS=yes
+!CONFIG_HWACCELS=yes
+!CONFIG_PARSERS=yes
+!CONFIG_INDEVS=yes
+!CONFIG_OUTDEVS=yes
+CONFIG_FILTERS=yes
+!CONFIG_DEMUXERS=yes
+!CONFIG_MUXERS=yes
+!CONFIG_PROTOCOLS=yes
+!CONFIG_AANDCTTABLES=yes
+!CONFIG_AC3DSP=yes
+!CONFIG_ADTS_HEADER=yes
+!CONFIG_AUDIO_FRAME_QUEUE=yes
+!CONFIG_AUDIODSP=yes
+!CONFIG_BLOCKDSP=yes
+!CONFIG_BSWAPDSP=yes
+!CONFIG_CABAC=yes
+!CONFIG_CBS=yes
+!CONFIG_CBS_AV1=yes
+!CONFIG_CBS_H264=yes
+!CONFIG_CBS_H265=yes
+!CONFIG_CBS_JPEG=yes
+!CONFIG_CBS_MPEG2=yes
+!CONFIG_CBS_VP9=yes
+!CONFIG_DIRAC_PARSE=yes
+!CONFIG_DNN=yes
+!CONFIG_DVPROFILE=yes
+!CONFIG_EXIF=yes
+CONFIG_FAANDCT=yes
+CONFIG_FAANIDCT=yes
+CONFIG_FDCTDSP=yes
+!CONFIG_FLACDSP=yes
+!CONFIG_FMTCONVERT=yes
+!CONFIG_FRAME_THREAD_ENCODER=yes
+!CONFIG_G722DSP=yes
+!CONFIG_GOLOMB=yes
+!CONFIG_GPLV3=yes
+!CONFIG_H263DSP=yes
+!CONFIG_H264CHROMA=yes
+!CONFIG_H264DSP=yes
+!CONFIG_H264PARSE=yes
+!CONFIG_H264PRED=yes
+!CONFIG_H264QPEL=yes
+!CONFIG_HEVCPARSE=yes
+!CONFIG_HPELDSP=yes
+!CONFIG_HUFFMAN=yes
+!CONFIG_HUFFYUVDSP=yes
+!CONFIG_HUFFYUVENCDSP=yes
+CONFIG_IDCTDSP=yes
+!CONFIG_IIRFILTER=yes
+!CONFIG_MDCT15=yes
+!CONFIG_INTRAX8=yes
+!CONFIG_ISO_MEDIA=yes
+!CONFIG_IVIDSP=yes
+!CONFIG_JPEGTABLES=yes
+!CONFIG_LGPLV3=yes
+!CONFIG_LIBX262=yes
+!CONFIG_LLAUDDSP=yes
+!CONFIG_LLVIDDSP=yes
+!CONFIG_LLVIDENCDSP=yes
+!CONFIG_LPC=yes
+!CONFIG_LZF=yes
+!CONFIG_ME_CMP=yes
+!CONFIG_MPEG_ER=yes
+!CONFIG_MPEGAUDIO=yes
+!CONFIG_MPEGAUDIODSP=yes
+!CONFIG_MPEGAUDIOHEADER=yes
+!CONFIG_MPEGVIDEO=yes
+!CONFIG_MPEGVIDEOENC=yes
+!CONFIG_MSS34DSP=yes
+!CONFIG_PIXBLOCKDSP=yes
+!CONFIG_QPELDSP=yes
+!CONFIG_QSV=yes
+!CONFIG_QSVDEC=yes
+!CONFIG_QSVENC=yes
+!CONFIG_QSVVPP=yes
+!CONFIG_RANGECODER=yes
+!CONFIG_RIFFDEC=yes
+!CONFIG_RIFFENC=yes
+!CONFIG_RTPDEC=yes
+!CONFIG_RTPENC_CHAIN=yes
+!CONFIG_RV34DSP=yes
+CONFIG_SCENE_SAD=yes
+!CONFIG_SINEWIN=yes
+!CONFIG_SNAPPY=yes
+!CONFIG_SRTP=yes
+!CONFIG_STARTCODE=yes
+!CONFIG_TEXTUREDSP=yes
+!CONFIG_TEXTUREDSPENC=yes
+!CONFIG_TPELDSP=yes
+!CONFIG_VAAPI_1=yes
+!CONFIG_VAAPI_ENCODE=yes
+!CONFIG_VC1DSP=yes
+!CONFIG_VIDEODSP=yes
+!CONFIG_VP3DSP=yes
+!CONFIG_VP56DSP=yes
+!CONFIG_VP8DSP=yes
+!CONFIG_WMA_FREQS=yes
+!CONFIG_WMV2DSP=yes
+!CONFIG_AAC_ADTSTOASC_BSF=yes
+!CONFIG_AV1_FRAME_MERGE_BSF=yes
+!CONFIG_AV1_FRAME_SPLIT_BSF=yes
+!CONFIG_AV1_METADATA_BSF=yes
+!CONFIG_CHOMP_BSF=yes
+!CONFIG_DUMP_EXTRADATA_BSF=yes
+!CONFIG_DCA_CORE_BSF=yes
+!CONFIG_EAC3_CORE_BSF=yes
+!CONFIG_EXTRACT_EXTRADATA_BSF=yes
+!CONFIG_FILTER_UNITS_BSF=yes
+!CONFIG_H264_METADATA_BSF=yes
+!CONFIG_H264_MP4TOANNEXB_BSF=yes
+!CONFIG_H264_REDUNDANT_PPS_BSF=yes
+!CONFIG_HAPQA_EXTRACT_BSF=yes
+!CONFIG_HEVC_METADATA_BSF=yes
+!CONFIG_HEVC_MP4TOANNEXB_BSF=yes
+!CONFIG_IMX_DUMP_HEADER_BSF=yes
+!CONFIG_MJPEG2JPEG_BSF=yes
+!CONFIG_MJPEGA_DUMP_HEADER_BSF=yes
+!CONFIG_MP3_HEADER_DECOMPRESS_BSF=yes
+!CONFIG_MPEG2_METADATA_BSF=yes
+!CONFIG_MPEG4_UNPACK_BFRAMES_BSF=yes
+!CONFIG_MOV2TEXTSUB_BSF=yes
+!CONFIG_NOISE_BSF=yes
+!CONFIG_NULL_BSF=yes
+!CONFIG_OPUS_METADATA_BSF=yes
+!CONFIG_PCM_RECHUNK_BSF=yes
+!CONFIG_PRORES_METADATA_BSF=yes
+!CONFIG_REMOVE_EXTRADATA_BSF=yes
+!CONFIG_TEXT2MOVSUB_BSF=yes
+!CONFIG_TRACE_HEADERS_BSF=yes
+!CONFIG_TRUEHD_CORE_BSF=yes
+!CONFIG_VP9_METADATA_BSF=yes
+!CONFIG_VP9_RAW_REORDER_BSF=yes
+!CONFIG_VP9_SUPERFRAME_BSF=yes
+!CONFIG_VP9_SUPERFRAME_SPLIT_BSF=yes
+!CONFIG_AASC_DECODER=yes
+!CONFIG_AIC_DECODER=yes
+!CONFIG_ALIAS_PIX_DECODER=yes
+!CONFIG_AGM_DECODER=yes
+!CONFIG_AMV_DECODER=yes
+!CONFIG_ANM_DECODER=yes
+!CONFIG_ANSI_DECODER=yes
+!CONFIG_APNG_DECODER=yes
+!CONFIG_ARBC_DECODER=yes
+!CONFIG_ASV1_DECODER=yes
+!CONFIG_ASV2_DECODER=yes
+!CONFIG_AURA_DECODER=yes
+!CONFIG_AURA2_DECODER=yes
+!CONFIG_AVRP_DECODER=yes
+!CONFIG_AVRN_DECODER=yes
+!CONFIG_AVS_DECODER=yes
+!CONFIG_AVUI_DECODER=yes
+!CONFIG_AYUV_DECODER=yes
+!CONFIG_BETHSOFTVID_DECODER=yes
+!CONFIG_BFI_DECODER=yes
+!CONFIG_BINK_DECODER=yes
+!CONFIG_BITPACKED_DECODER=yes
+!CONFIG_BMP_DECODER=yes
+!CONFIG_BMV_VIDEO_DECODER=yes
+!CONFIG_BRENDER_PIX_DECODER=yes
+!CONFIG_C93_DECODER=yes
+!CONFIG_CAVS_DECODER=yes
+!CONFIG_CDGRAPHICS_DECODER=yes
+!CONFIG_CDTOONS_DECODER=yes
+!CONFIG_CDXL_DECODER=yes
+!CONFIG_CFHD_DECODER=yes
+!CONFIG_CINEPAK_DECODER=yes
+!CONFIG_CLEARVIDEO_DECODER=yes
+!CONFIG_CLJR_DECODER=yes
+!CONFIG_CLLC_DECODER=yes
+!CONFIG_COMFORTNOISE_DECODER=yes
+!CONFIG_CPIA_DECODER=yes
+!CONFIG_CSCD_DECODER=yes
+!CONFIG_CYUV_DECODER=yes
+!CONFIG_DDS_DECODER=yes
+!CONFIG_DFA_DECODER=yes
+!CONFIG_DIRAC_DECODER=yes
+!CONFIG_DNXHD_DECODER=yes
+!CONFIG_DPX_DECODER=yes
+!CONFIG_DSICINVIDEO_DECODER=yes
+!CONFIG_DVAUDIO_DECODER=yes
+!CONFIG_DVVIDEO_DECODER=yes
+!CONFIG_DXA_DECODER=yes
+!CONFIG_DXTORY_DECODER=yes
+!CONFIG_DXV_DECODER=yes
+!CONFIG_EACMV_DECODER=yes
+!CONFIG_EAMAD_DECODER=yes
+!CONFIG_EATGQ_DECODER=yes
+!CONFIG_EATGV_DECODER=yes
+!CONFIG_EATQI_DECODER=yes
+!CONFIG_EIGHTBPS_DECODER=yes
+!CONFIG_EIGHTSVX_EXP_DECODER=yes
+!CONFIG_EIGHTSVX_FIB_DECODER=yes
+!CONFIG_ESCAPE124_DECODER=yes
+!CONFIG_ESCAPE130_DECODER=yes
+!CONFIG_EXR_DECODER=yes
+!CONFIG_FFV1_DECODER=yes
+!CONFIG_FFVHUFF_DECODER=yes
+!CONFIG_FIC_DECODER=yes
+!CONFIG_FITS_DECODER=yes
+!CONFIG_FLASHSV_DECODER=yes
+!CONFIG_FLASHSV2_DECODER=yes
+!CONFIG_FLIC_DECODER=yes
+!CONFIG_FLV_DECODER=yes
+!CONFIG_FMVC_DECODER=yes
+!CONFIG_FOURXM_DECODER=yes
+!CONFIG_FRAPS_DECODER=yes
+!CONFIG_FRWU_DECODER=yes
+!CONFIG_G2M_DECODER=yes
+!CONFIG_GDV_DECODER=yes
+!CONFIG_GIF_DECODER=yes
+!CONFIG_H261_DECODER=yes
+!CONFIG_H263_DECODER=yes
+!CONFIG_H263I_DECODER=yes
+!CONFIG_H263P_DECODER=yes
+!CONFIG_H263_V4L2M2M_DECODER=yes
+!CONFIG_H264_DECODER=yes
+!CONFIG_H264_CRYSTALHD_DECODER=yes
+!CONFIG_H264_V4L2M2M_DECODER=yes
+!CONFIG_H264_MEDIACODEC_DECODER=yes
+!CONFIG_H264_MMAL_DECODER=yes
+!CONFIG_H264_QSV_DECODER=yes
+!CONFIG_H264_RKMPP_DECODER=yes
+!CONFIG_HAP_DECODER=yes
+!CONFIG_HEVC_DECODER=yes
+!CONFIG_HEVC_QSV_DECODER=yes
+!CONFIG_HEVC_RKMPP_DECODER=yes
+!CONFIG_HEVC_V4L2M2M_DECODER=yes
+!CONFIG_HNM4_VIDEO_DECODER=yes
+!CONFIG_HQ_HQA_DECODER=yes
+!CONFIG_HQX_DECODER=yes
+!CONFIG_HUFFYUV_DECODER=yes
+!CONFIG_HYMT_DECODER=yes
+!CONFIG_IDCIN_DECODER=yes
+!CONFIG_IFF_ILBM_DECODER=yes
+!CONFIG_IMM4_DECODER=yes
+!CONFIG_IMM5_DECODER=yes
+!CONFIG_INDEO2_DECODER=yes
+!CONFIG_INDEO3_DECODER=yes
+!CONFIG_INDEO4_DECODER=yes
+!CONFIG_INDEO5_DECODER=yes
+!CONFIG_INTERPLAY_VIDEO_DECODER=yes
+!CONFIG_JPEG2000_DECODER=yes
+!CONFIG_JPEGLS_DECODER=yes
+!CONFIG_JV_DECODER=yes
+!CONFIG_KGV1_DECODER=yes
+!CONFIG_KMVC_DECODER=yes
+!CONFIG_LAGARITH_DECODER=yes
+!CONFIG_LOCO_DECODER=yes
+!CONFIG_LSCR_DECODER=yes
+!CONFIG_M101_DECODER=yes
+!CONFIG_MAGICYUV_DECODER=yes
+!CONFIG_MDEC_DECODER=yes
+!CONFIG_MIMIC_DECODER=yes
+!CONFIG_MJPEG_DECODER=yes
+!CONFIG_MJPEGB_DECODER=yes
+!CONFIG_MMVIDEO_DECODER=yes
+!CONFIG_MOTIONPIXELS_DECODER=yes
+!CONFIG_MPEG1VIDEO_DECODER=yes
+!CONFIG_MPEG2VIDEO_DECODER=yes
+!CONFIG_MPEG4_DECODER=yes
+!CONFIG_MPEG4_CRYSTALHD_DECODER=yes
+!CONFIG_MPEG4_V4L2M2M_DECODER=yes
+!CONFIG_MPEG4_MMAL_DECODER=yes
+!CONFIG_MPEGVIDEO_DECODER=yes
+!CONFIG_MPEG1_V4L2M2M_DECODER=yes
+!CONFIG_MPEG2_MMAL_DECODER=yes
+!CONFIG_MPEG2_CRYSTALHD_DECODER=yes
+!CONFIG_MPEG2_V4L2M2M_DECODER=yes
+!CONFIG_MPEG2_QSV_DECODER=yes
+!CONFIG_MPEG2_MEDIACODEC_DECODER=yes
+!CONFIG_MSA1_DECODER=yes
+!CONFIG_MSCC_DECODER=yes
+!CONFIG_MSMPEG4V1_DECODER=yes
+!CONFIG_MSMPEG4V2_DECODER=yes
+!CONFIG_MSMPEG4V3_DECODER=yes
+!CONFIG_MSMPEG4_CRYSTALHD_DECODER=yes
+!CONFIG_MSRLE_DECODER=yes
+!CONFIG_MSS1_DECODER=yes
+!CONFIG_MSS2_DECODER=yes
+!CONFIG_MSVIDEO1_DECODER=yes
+!CONFIG_MSZH_DECODER=yes
+!CONFIG_MTS2_DECODER=yes
+!CONFIG_MV30_DECODER=yes
+!CONFIG_MVC1_DECODER=yes
+!CONFIG_MVC2_DECODER=yes
+!CONFIG_MVDV_DECODER=yes
+!CONFIG_MVHA_DECODER=yes
+!CONFIG_MWSC_DECODER=yes
+!CONFIG_MXPEG_DECODER=yes
+!CONFIG_NOTCHLC_DECODER=yes
+!CONFIG_NUV_DECODER=yes
+!CONFIG_PAF_VIDEO_DECODER=yes
+!CONFIG_PAM_DECODER=yes
+!CONFIG_PBM_DECODER=yes
+!CONFIG_PCX_DECODER=yes
+!CONFIG_PFM_DECODER=yes
+!CONFIG_PGM_DECODER=yes
+!CONFIG_PGMYUV_DECODER=yes
+!CONFIG_PICTOR_DECODER=yes
+!CONFIG_PIXLET_DECODER=yes
+!CONFIG_PNG_DECODER=yes
+!CONFIG_PPM_DECODER=yes
+!CONFIG_PRORES_DECODER=yes
+!CONFIG_PROSUMER_DECODER=yes
+!CONFIG_PSD_DECODER=yes
+!CONFIG_PTX_DECODER=yes
+!CONFIG_QDRAW_DECODER=yes
+!CONFIG_QPEG_DECODER=yes
+!CONFIG_QTRLE_DECODER=yes
+!CONFIG_R10K_DECODER=yes
+!CONFIG_R210_DECODER=yes
+!CONFIG_RASC_DECODER=yes
+!CONFIG_RAWVIDEO_DECODER=yes
+!CONFIG_RL2_DECODER=yes
+!CONFIG_ROQ_DECODER=yes
+!CONFIG_RPZA_DECODER=yes
+!CONFIG_RSCC_DECODER=yes
+!CONFIG_RV10_DECODER=yes
+!CONFIG_RV20_DECODER=yes
+!CONFIG_RV30_DECODER=yes
+!CONFIG_RV40_DECODER=yes
+!CONFIG_S302M_DECODER=yes
+!CONFIG_SANM_DECODER=yes
+!CONFIG_SCPR_DECODER=yes
+!CONFIG_SCREENPRESSO_DECODER=yes
+!CONFIG_SGI_DECODER=yes
+!CONFIG_SGIRLE_DECODER=yes
+!CONFIG_SHEERVIDEO_DECODER=yes
+!CONFIG_SMACKER_DECODER=yes
+!CONFIG_SMC_DECODER=yes
+!CONFIG_SMVJPEG_DECODER=yes
+!CONFIG_SNOW_DECODER=yes
+!CONFIG_SP5X_DECODER=yes
+!CONFIG_SPEEDHQ_DECODER=yes
+!CONFIG_SRGC_DECODER=yes
+!CONFIG_SUNRAST_DECODER=yes
+!CONFIG_SVQ1_DECODER=yes
+!CONFIG_SVQ3_DECODER=yes
+!CONFIG_TARGA_DECODER=yes
+!CONFIG_TARGA_Y216_DECODER=yes
+!CONFIG_TDSC_DECODER=yes
+!CONFIG_THEORA_DECODER=yes
+!CONFIG_THP_DECODER=yes
+!CONFIG_TIERTEXSEQVIDEO_DECODER=yes
+!CONFIG_TIFF_DECODER=yes
+!CONFIG_TMV_DECODER=yes
+!CONFIG_TRUEMOTION1_DECODER=yes
+!CONFIG_TRUEMOTION2_DECODER=yes
+!CONFIG_TRUEMOTION2RT_DECODER=yes
+!CONFIG_TSCC_DECODER=yes
+!CONFIG_TSCC2_DECODER=yes
+!CONFIG_TXD_DECODER=yes
+!CONFIG_ULTI_DECODER=yes
+!CONFIG_UTVIDEO_DECODER=yes
+!CONFIG_V210_DECODER=yes
+!CONFIG_V210X_DECODER=yes
+!CONFIG_V308_DECODER=yes
+!CONFIG_V408_DECODER=yes
+!CONFIG_V410_DECODER=yes
+!CONFIG_VB_DECODER=yes
+!CONFIG_VBLE_DECODER=yes
+!CONFIG_VC1_DECODER=yes
+!CONFIG_VC1_CRYSTALHD_DECODER=yes
+!CONFIG_VC1IMAGE_DECODER=yes
+!CONFIG_VC1_MMAL_DECODER=yes
+!CONFIG_VC1_QSV_DECODER=yes
+!CONFIG_VC1_V4L2M2M_DECODER=yes
+!CONFIG_VCR1_DECODER=yes
+!CONFIG_VMDVIDEO_DECODER=yes
+!CONFIG_VMNC_DECODER=yes
+!CONFIG_VP3_DECODER=yes
+!CONFIG_VP4_DECODER=yes
+!CONFIG_VP5_DECODER=yes
+!CONFIG_VP6_DECODER=yes
+!CONFIG_VP6A_DECODER=yes
+!CONFIG_VP6F_DECODER=yes
+!CONFIG_VP7_DECODER=yes
+!CONFIG_VP8_DECODER=yes
+!CONFIG_VP8_RKMPP_DECODER=yes
+!CONFIG_VP8_V4L2M2M_DECODER=yes
+!CONFIG_VP9_DECODER=yes
+!CONFIG_VP9_RKMPP_DECODER=yes
+!CONFIG_VP9_V4L2M2M_DECODER=yes
+!CONFIG_VQA_DECODER=yes
+!CONFIG_WEBP_DECODER=yes
+!CONFIG_WCMV_DECODER=yes
+!CONFIG_WRAPPED_AVFRAME_DECODER=yes
+!CONFIG_WMV1_DECODER=yes
+!CONFIG_WMV2_DECODER=yes
+!CONFIG_WMV3_DECODER=yes
+!CONFIG_WMV3_CRYSTALHD_DECODER=yes
+!CONFIG_WMV3IMAGE_DECODER=yes
+!CONFIG_WNV1_DECODER=yes
+!CONFIG_XAN_WC3_DECODER=yes
+!CONFIG_XAN_WC4_DECODER=yes
+!CONFIG_XBM_DECODER=yes
+!CONFIG_XFACE_DECODER=yes
+!CONFIG_XL_DECODER=yes
+!CONFIG_XPM_DECODER=yes
+!CONFIG_XWD_DECODER=yes
+!CONFIG_Y41P_DECODER=yes
+!CONFIG_YLC_DECODER=yes
+!CONFIG_YOP_DECODER=yes
+!CONFIG_YUV4_DECODER=yes
+!CONFIG_ZERO12V_DECODER=yes
+!CONFIG_ZEROCODEC_DECODER=yes
+!CONFIG_ZLIB_DECODER=yes
+!CONFIG_ZMBV_DECODER=yes
+!CONFIG_AAC_DECODER=yes
+!CONFIG_AAC_FIXED_DECODER=yes
+!CONFIG_AAC_LATM_DECODER=yes
+!CONFIG_AC3_DECODER=yes
+!CONFIG_AC3_FIXED_DECODER=yes
+!CONFIG_ACELP_KELVIN_DECODER=yes
+!CONFIG_ALAC_DECODER=yes
+!CONFIG_ALS_DECODER=yes
+!CONFIG_AMRNB_DECODER=yes
+!CONFIG_AMRWB_DECODER=yes
+!CONFIG_APE_DECODER=yes
+!CONFIG_APTX_DECODER=yes
+!CONFIG_APTX_HD_DECODER=yes
+!CONFIG_ATRAC1_DECODER=yes
+!CONFIG_ATRAC3_DECODER=yes
+!CONFIG_ATRAC3AL_DECODER=yes
+!CONFIG_ATRAC3P_DECODER=yes
+!CONFIG_ATRAC3PAL_DECODER=yes
+!CONFIG_ATRAC9_DECODER=yes
+!CONFIG_BINKAUDIO_DCT_DECODER=yes
+!CONFIG_BINKAUDIO_RDFT_DECODER=yes
+!CONFIG_BMV_AUDIO_DECODER=yes
+!CONFIG_COOK_DECODER=yes
+!CONFIG_DCA_DECODER=yes
+!CONFIG_DOLBY_E_DECODER=yes
+!CONFIG_DSD_LSBF_DECODER=yes
+!CONFIG_DSD_MSBF_DECODER=yes
+!CONFIG_DSD_LSBF_PLANAR_DECODER=yes
+!CONFIG_DSD_MSBF_PLANAR_DECODER=yes
+!CONFIG_DSICINAUDIO_DECODER=yes
+!CONFIG_DSS_SP_DECODER=yes
+!CONFIG_DST_DECODER=yes
+!CONFIG_EAC3_DECODER=yes
+!CONFIG_EVRC_DECODER=yes
+!CONFIG_FFWAVESYNTH_DECODER=yes
+!CONFIG_FLAC_DECODER=yes
+!CONFIG_G723_1_DECODER=yes
+!CONFIG_G729_DECODER=yes
+!CONFIG_GSM_DECODER=yes
+!CONFIG_GSM_MS_DECODER=yes
+!CONFIG_HCA_DECODER=yes
+!CONFIG_HCOM_DECODER=yes
+!CONFIG_IAC_DECODER=yes
+!CONFIG_ILBC_DECODER=yes
+!CONFIG_IMC_DECODER=yes
+!CONFIG_INTERPLAY_ACM_DECODER=yes
+!CONFIG_MACE3_DECODER=yes
+!CONFIG_MACE6_DECODER=yes
+!CONFIG_METASOUND_DECODER=yes
+!CONFIG_MLP_DECODER=yes
+!CONFIG_MP1_DECODER=yes
+!CONFIG_MP1FLOAT_DECODER=yes
+!CONFIG_MP2_DECODER=yes
+!CONFIG_MP2FLOAT_DECODER=yes
+!CONFIG_MP3FLOAT_DECODER=yes
+!CONFIG_MP3_DECODER=yes
+!CONFIG_MP3ADUFLOAT_DECODER=yes
+!CONFIG_MP3ADU_DECODER=yes
+!CONFIG_MP3ON4FLOAT_DECODER=yes
+!CONFIG_MP3ON4_DECODER=yes
+!CONFIG_MPC7_DECODER=yes
+!CONFIG_MPC8_DECODER=yes
+!CONFIG_NELLYMOSER_DECODER=yes
+!CONFIG_ON2AVC_DECODER=yes
+!CONFIG_OPUS_DECODER=yes
+!CONFIG_PAF_AUDIO_DECODER=yes
+!CONFIG_QCELP_DECODER=yes
+!CONFIG_QDM2_DECODER=yes
+!CONFIG_QDMC_DECODER=yes
+!CONFIG_RA_144_DECODER=yes
+!CONFIG_RA_288_DECODER=yes
+!CONFIG_RALF_DECODER=yes
+!CONFIG_SBC_DECODER=yes
+!CONFIG_SHORTEN_DECODER=yes
+!CONFIG_SIPR_DECODER=yes
+!CONFIG_SIREN_DECODER=yes
+!CONFIG_SMACKAUD_DECODER=yes
+!CONFIG_SONIC_DECODER=yes
+!CONFIG_TAK_DECODER=yes
+!CONFIG_TRUEHD_DECODER=yes
+!CONFIG_TRUESPEECH_DECODER=yes
+!CONFIG_TTA_DECODER=yes
+!CONFIG_TWINVQ_DECODER=yes
+!CONFIG_VMDAUDIO_DECODER=yes
+!CONFIG_VORBIS_DECODER=yes
+!CONFIG_WAVPACK_DECODER=yes
+!CONFIG_WMALOSSLESS_DECODER=yes
+!CONFIG_WMAPRO_DECODER=yes
+!CONFIG_WMAV1_DECODER=yes
+!CONFIG_WMAV2_DECODER=yes
+!CONFIG_WMAVOICE_DECODER=yes
+!CONFIG_WS_SND1_DECODER=yes
+!CONFIG_XMA1_DECODER=yes
+!CONFIG_XMA2_DECODER=yes
+!CONFIG_PCM_ALAW_DECODER=yes
+!CONFIG_PCM_BLURAY_DECODER=yes
+!CONFIG_PCM_DVD_DECODER=yes
+!CONFIG_PCM_F16LE_DECODER=yes
+!CONFIG_PCM_F24LE_DECODER=yes
+!CONFIG_PCM_F32BE_DECODER=yes
+!CONFIG_PCM_F32LE_DECODER=yes
+!CONFIG_PCM_F64BE_DECODER=yes
+!CONFIG_PCM_F64LE_DECODER=yes
+!CONFIG_PCM_LXF_DECODER=yes
+!CONFIG_PCM_MULAW_DECODER=yes
+!CONFIG_PCM_S8_DECODER=yes
+!CONFIG_PCM_S8_PLANAR_DECODER=yes
+!CONFIG_PCM_S16BE_DECODER=yes
+!CONFIG_PCM_S16BE_PLANAR_DECODER=yes
+!CONFIG_PCM_S16LE_DECODER=yes
+!CONFIG_PCM_S16LE_PLANAR_DECODER=yes
+!CONFIG_PCM_S24BE_DECODER=yes
+!CONFIG_PCM_S24DAUD_DECODER=yes
+!CONFIG_PCM_S24LE_DECODER=yes
+!CONFIG_PCM_S24LE_PLANAR_DECODER=yes
+!CONFIG_PCM_S32BE_DECODER=yes
+!CONFIG_PCM_S32LE_DECODER=yes
+!CONFIG_PCM_S32LE_PLANAR_DECODER=yes
+!CONFIG_PCM_S64BE_DECODER=yes
+!CONFIG_PCM_S64LE_DECODER=yes
+!CONFIG_PCM_U8_DECODER=yes
+!CONFIG_PCM_U16BE_DECODER=yes
+!CONFIG_PCM_U16LE_DECODER=yes
+!CONFIG_PCM_U24BE_DECODER=yes
+!CONFIG_PCM_U24LE_DECODER=yes
+!CONFIG_PCM_U32BE_DECODER=yes
+!CONFIG_PCM_U32LE_DECODER=yes
+!CONFIG_PCM_VIDC_DECODER=yes
+!CONFIG_DERF_DPCM_DECODER=yes
+!CONFIG_GREMLIN_DPCM_DECODER=yes
+!CONFIG_INTERPLAY_DPCM_DECODER=yes
+!CONFIG_ROQ_DPCM_DECODER=yes
+!CONFIG_SDX2_DPCM_DECODER=yes
+!CONFIG_SOL_DPCM_DECODER=yes
+!CONFIG_XAN_DPCM_DECODER=yes
+!CONFIG_ADPCM_4XM_DECODER=yes
+!CONFIG_ADPCM_ADX_DECODER=yes
+!CONFIG_ADPCM_AFC_DECODER=yes
+!CONFIG_ADPCM_AGM_DECODER=yes
+!CONFIG_ADPCM_AICA_DECODER=yes
+!CONFIG_ADPCM_ARGO_DECODER=yes
+!CONFIG_ADPCM_CT_DECODER=yes
+!CONFIG_ADPCM_DTK_DECODER=yes
+!CONFIG_ADPCM_EA_DECODER=yes
+!CONFIG_ADPCM_EA_MAXIS_XA_DECODER=yes
+!CONFIG_ADPCM_EA_R1_DECODER=yes
+!CONFIG_ADPCM_EA_R2_DECODER=yes
+!CONFIG_ADPCM_EA_R3_DECODER=yes
+!CONFIG_ADPCM_EA_XAS_DECODER=yes
+!CONFIG_ADPCM_G722_DECODER=yes
+!CONFIG_ADPCM_G726_DECODER=yes
+!CONFIG_ADPCM_G726LE_DECODER=yes
+!CONFIG_ADPCM_IMA_AMV_DECODER=yes
+!CONFIG_ADPCM_IMA_ALP_DECODER=yes
+!CONFIG_ADPCM_IMA_APC_DECODER=yes
+!CONFIG_ADPCM_IMA_APM_DECODER=yes
+!CONFIG_ADPCM_IMA_CUNNING_DECODER=yes
+!CONFIG_ADPCM_IMA_DAT4_DECODER=yes
+!CONFIG_ADPCM_IMA_DK3_DECODER=yes
+!CONFIG_ADPCM_IMA_DK4_DECODER=yes
+!CONFIG_ADPCM_IMA_EA_EACS_DECODER=yes
+!CONFIG_ADPCM_IMA_EA_SEAD_DECODER=yes
+!CONFIG_ADPCM_IMA_ISS_DECODER=yes
+!CONFIG_ADPCM_IMA_MTF_DECODER=yes
+!CONFIG_ADPCM_IMA_OKI_DECODER=yes
+!CONFIG_ADPCM_IMA_QT_DECODER=yes
+!CONFIG_ADPCM_IMA_RAD_DECODER=yes
+!CONFIG_ADPCM_IMA_SSI_DECODER=yes
+!CONFIG_ADPCM_IMA_SMJPEG_DECODER=yes
+!CONFIG_ADPCM_IMA_WAV_DECODER=yes
+!CONFIG_ADPCM_IMA_WS_DECODER=yes
+!CONFIG_ADPCM_MS_DECODER=yes
+!CONFIG_ADPCM_MTAF_DECODER=yes
+!CONFIG_ADPCM_PSX_DECODER=yes
+!CONFIG_ADPCM_SBPRO_2_DECODER=yes
+!CONFIG_ADPCM_SBPRO_3_DECODER=yes
+!CONFIG_ADPCM_SBPRO_4_DECODER=yes
+!CONFIG_ADPCM_SWF_DECODER=yes
+!CONFIG_ADPCM_THP_DECODER=yes
+!CONFIG_ADPCM_THP_LE_DECODER=yes
+!CONFIG_ADPCM_VIMA_DECODER=yes
+!CONFIG_ADPCM_XA_DECODER=yes
+!CONFIG_ADPCM_YAMAHA_DECODER=yes
+!CONFIG_ADPCM_ZORK_DECODER=yes
+!CONFIG_SSA_DECODER=yes
+!CONFIG_ASS_DECODER=yes
+!CONFIG_CCAPTION_DECODER=yes
+!CONFIG_DVBSUB_DECODER=yes
+!CONFIG_DVDSUB_DECODER=yes
+!CONFIG_JACOSUB_DECODER=yes
+!CONFIG_MICRODVD_DECODER=yes
+!CONFIG_MOVTEXT_DECODER=yes
+!CONFIG_MPL2_DECODER=yes
+!CONFIG_PGSSUB_DECODER=yes
+!CONFIG_PJS_DECODER=yes
+!CONFIG_REALTEXT_DECODER=yes
+!CONFIG_SAMI_DECODER=yes
+!CONFIG_SRT_DECODER=yes
+!CONFIG_STL_DECODER=yes
+!CONFIG_SUBRIP_DECODER=yes
+!CONFIG_SUBVIEWER_DECODER=yes
+!CONFIG_SUBVIEWER1_DECODER=yes
+!CONFIG_TEXT_DECODER=yes
+!CONFIG_VPLAYER_DECODER=yes
+!CONFIG_WEBVTT_DECODER=yes
+!CONFIG_XSUB_DECODER=yes
+!CONFIG_AAC_AT_DECODER=yes
+!CONFIG_AC3_AT_DECODER=yes
+!CONFIG_ADPCM_IMA_QT_AT_DECODER=yes
+!CONFIG_ALAC_AT_DECODER=yes
+!CONFIG_AMR_NB_AT_DECODER=yes
+!CONFIG_EAC3_AT_DECODER=yes
+!CONFIG_GSM_MS_AT_DECODER=yes
+!CONFIG_ILBC_AT_DECODER=yes
+!CONFIG_MP1_AT_DECODER=yes
+!CONFIG_MP2_AT_DECODER=yes
+!CONFIG_MP3_AT_DECODER=yes
+!CONFIG_PCM_ALAW_AT_DECODER=yes
+!CONFIG_PCM_MULAW_AT_DECODER=yes
+!CONFIG_QDMC_AT_DECODER=yes
+!CONFIG_QDM2_AT_DECODER=yes
+!CONFIG_LIBARIBB24_DECODER=yes
+!CONFIG_LIBCELT_DECODER=yes
+!CONFIG_LIBCODEC2_DECODER=yes
+!CONFIG_LIBDAV1D_DECODER=yes
+!CONFIG_LIBDAVS2_DECODER=yes
+!CONFIG_LIBFDK_AAC_DECODER=yes
+!CONFIG_LIBGSM_DECODER=yes
+!CONFIG_LIBGSM_MS_DECODER=yes
+!CONFIG_LIBILBC_DECODER=yes
+!CONFIG_LIBOPENCORE_AMRNB_DECODER=yes
+!CONFIG_LIBOPENCORE_AMRWB_DECODER=yes
+!CONFIG_LIBOPENJPEG_DECODER=yes
+!CONFIG_LIBOPUS_DECODER=yes
+!CONFIG_LIBRSVG_DECODER=yes
+!CONFIG_LIBSPEEX_DECODER=yes
+!CONFIG_LIBVORBIS_DECODER=yes
+!CONFIG_LIBVPX_VP8_DECODER=yes
+!CONFIG_LIBVPX_VP9_DECODER=yes
+!CONFIG_LIBZVBI_TELETEXT_DECODER=yes
+!CONFIG_BINTEXT_DECODER=yes
+!CONFIG_XBIN_DECODER=yes
+!CONFIG_IDF_DECODER=yes
+!CONFIG_LIBAOM_AV1_DECODER=yes
+!CONFIG_LIBOPENH264_DECODER=yes
+!CONFIG_H264_CUVID_DECODER=yes
+!CONFIG_HEVC_CUVID_DECODER=yes
+!CONFIG_HEVC_MEDIACODEC_DECODER=yes
+!CONFIG_MJPEG_CUVID_DECODER=yes
+!CONFIG_MJPEG_QSV_DECODER=yes
+!CONFIG_MPEG1_CUVID_DECODER=yes
+!CONFIG_MPEG2_CUVID_DECODER=yes
+!CONFIG_MPEG4_CUVID_DECODER=yes
+!CONFIG_MPEG4_MEDIACODEC_DECODER=yes
+!CONFIG_VC1_CUVID_DECODER=yes
+!CONFIG_VP8_CUVID_DECODER=yes
+!CONFIG_VP8_MEDIACODEC_DECODER=yes
+!CONFIG_VP8_QSV_DECODER=yes
+!CONFIG_VP9_CUVID_DECODER=yes
+!CONFIG_VP9_MEDIACODEC_DECODER=yes
+!CONFIG_VP9_QSV_DECODER=yes
+!CONFIG_A64MULTI_ENCODER=yes
+!CONFIG_A64MULTI5_ENCODER=yes
+!CONFIG_ALIAS_PIX_ENCODER=yes
+!CONFIG_AMV_ENCODER=yes
+!CONFIG_APNG_ENCODER=yes
+!CONFIG_ASV1_ENCODER=yes
+!CONFIG_ASV2_ENCODER=yes
+!CONFIG_AVRP_ENCODER=yes
+!CONFIG_AVUI_ENCODER=yes
+!CONFIG_AYUV_ENCODER=yes
+!CONFIG_BMP_ENCODER=yes
+!CONFIG_CINEPAK_ENCODER=yes
+!CONFIG_CLJR_ENCODER=yes
+!CONFIG_COMFORTNOISE_ENCODER=yes
+!CONFIG_DNXHD_ENCODER=yes
+!CONFIG_DPX_ENCODER=yes
+!CONFIG_DVVIDEO_ENCODER=yes
+!CONFIG_FFV1_ENCODER=yes
+!CONFIG_FFVHUFF_ENCODER=yes
+!CONFIG_FITS_ENCODER=yes
+!CONFIG_FLASHSV_ENCODER=yes
+!CONFIG_FLASHSV2_ENCODER=yes
+!CONFIG_FLV_ENCODER=yes
+!CONFIG_GIF_ENCODER=yes
+!CONFIG_H261_ENCODER=yes
+!CONFIG_H263_ENCODER=yes
+!CONFIG_H263P_ENCODER=yes
+!CONFIG_HAP_ENCODER=yes
+!CONFIG_HUFFYUV_ENCODER=yes
+!CONFIG_JPEG2000_ENCODER=yes
+!CONFIG_JPEGLS_ENCODER=yes
+!CONFIG_LJPEG_ENCODER=yes
+!CONFIG_MAGICYUV_ENCODER=yes
+!CONFIG_MJPEG_ENCODER=yes
+!CONFIG_MPEG1VIDEO_ENCODER=yes
+!CONFIG_MPEG2VIDEO_ENCODER=yes
+!CONFIG_MPEG4_ENCODER=yes
+!CONFIG_MSMPEG4V2_ENCODER=yes
+!CONFIG_MSMPEG4V3_ENCODER=yes
+!CONFIG_MSVIDEO1_ENCODER=yes
+!CONFIG_PAM_ENCODER=yes
+!CONFIG_PBM_ENCODER=yes
+!CONFIG_PCX_ENCODER=yes
+!CONFIG_PGM_ENCODER=yes
+!CONFIG_PGMYUV_ENCODER=yes
+!CONFIG_PNG_ENCODER=yes
+!CONFIG_PPM_ENCODER=yes
+!CONFIG_PRORES_ENCODER=yes
+!CONFIG_PRORES_AW_ENCODER=yes
+!CONFIG_PRORES_KS_ENCODER=yes
+!CONFIG_QTRLE_ENCODER=yes
+!CONFIG_R10K_ENCODER=yes
+!CONFIG_R210_ENCODER=yes
+!CONFIG_RAWVIDEO_ENCODER=yes
+!CONFIG_ROQ_ENCODER=yes
+!CONFIG_RV10_ENCODER=yes
+!CONFIG_RV20_ENCODER=yes
+!CONFIG_S302M_ENCODER=yes
+!CONFIG_SGI_ENCODER=yes
+!CONFIG_SNOW_ENCODER=yes
+!CONFIG_SUNRAST_ENCODER=yes
+!CONFIG_SVQ1_ENCODER=yes
+!CONFIG_TARGA_ENCODER=yes
+!CONFIG_TIFF_ENCODER=yes
+!CONFIG_UTVIDEO_ENCODER=yes
+!CONFIG_V210_ENCODER=yes
+!CONFIG_V308_ENCODER=yes
+!CONFIG_V408_ENCODER=yes
+!CONFIG_V410_ENCODER=yes
+!CONFIG_VC2_ENCODER=yes
+!CONFIG_WRAPPED_AVFRAME_ENCODER=yes
+!CONFIG_WMV1_ENCODER=yes
+!CONFIG_WMV2_ENCODER=yes
+!CONFIG_XBM_ENCODER=yes
+!CONFIG_XFACE_ENCODER=yes
+!CONFIG_XWD_ENCODER=yes
+!CONFIG_Y41P_ENCODER=yes
+!CONFIG_YUV4_ENCODER=yes
+!CONFIG_ZLIB_ENCODER=yes
+!CONFIG_ZMBV_ENCODER=yes
+!CONFIG_AAC_ENCODER=yes
+!CONFIG_AC3_ENCODER=yes
+!CONFIG_AC3_FIXED_ENCODER=yes
+!CONFIG_ALAC_ENCODER=yes
+!CONFIG_APTX_ENCODER=yes
+!CONFIG_APTX_HD_ENCODER=yes
+!CONFIG_DCA_ENCODER=yes
+!CONFIG_EAC3_ENCODER=yes
+!CONFIG_FLAC_ENCODER=yes
+!CONFIG_G723_1_ENCODER=yes
+!CONFIG_MLP_ENCODER=yes
+!CONFIG_MP2_ENCODER=yes
+!CONFIG_MP2FIXED_ENCODER=yes
+!CONFIG_NELLYMOSER_ENCODER=yes
+!CONFIG_OPUS_ENCODER=yes
+!CONFIG_RA_144_ENCODER=yes
+!CONFIG_SBC_ENCODER=yes
+!CONFIG_SONIC_ENCODER=yes
+!CONFIG_SONIC_LS_ENCODER=yes
+!CONFIG_TRUEHD_ENCODER=yes
+!CONFIG_TTA_ENCODER=yes
+!CONFIG_VORBIS_ENCODER=yes
+!CONFIG_WAVPACK_ENCODER=yes
+!CONFIG_WMAV1_ENCODER=yes
+!CONFIG_WMAV2_ENCODER=yes
+!CONFIG_PCM_ALAW_ENCODER=yes
+!CONFIG_PCM_DVD_ENCODER=yes
+!CONFIG_PCM_F32BE_ENCODER=yes
+!CONFIG_PCM_F32LE_ENCODER=yes
+!CONFIG_PCM_F64BE_ENCODER=yes
+!CONFIG_PCM_F64LE_ENCODER=yes
+!CONFIG_PCM_MULAW_ENCODER=yes
+!CONFIG_PCM_S8_ENCODER=yes
+!CONFIG_PCM_S8_PLANAR_ENCODER=yes
+!CONFIG_PCM_S16BE_ENCODER=yes
+!CONFIG_PCM_S16BE_PLANAR_ENCODER=yes
+!CONFIG_PCM_S16LE_ENCODER=yes
+!CONFIG_PCM_S16LE_PLANAR_ENCODER=yes
+!CONFIG_PCM_S24BE_ENCODER=yes
+!CONFIG_PCM_S24DAUD_ENCODER=yes
+!CONFIG_PCM_S24LE_ENCODER=yes
+!CONFIG_PCM_S24LE_PLANAR_ENCODER=yes
+!CONFIG_PCM_S32BE_ENCODER=yes
+!CONFIG_PCM_S32LE_ENCODER=yes
+!CONFIG_PCM_S32LE_PLANAR_ENCODER=yes
+!CONFIG_PCM_S64BE_ENCODER=yes
+!CONFIG_PCM_S64LE_ENCODER=yes
+!CONFIG_PCM_U8_ENCODER=yes
+!CONFIG_PCM_U16BE_ENCODER=yes
+!CONFIG_PCM_U16LE_ENCODER=yes
+!CONFIG_PCM_U24BE_ENCODER=yes
+!CONFIG_PCM_U24LE_ENCODER=yes
+!CONFIG_PCM_U32BE_ENCODER=yes
+!CONFIG_PCM_U32LE_ENCODER=yes
+!CONFIG_PCM_VIDC_ENCODER=yes
+!CONFIG_ROQ_DPCM_ENCODER=yes
+!CONFIG_ADPCM_ADX_ENCODER=yes
+!CONFIG_ADPCM_G722_ENCODER=yes
+!CONFIG_ADPCM_G726_ENCODER=yes
+!CONFIG_ADPCM_G726LE_ENCODER=yes
+!CONFIG_ADPCM_IMA_QT_ENCODER=yes
+!CONFIG_ADPCM_IMA_SSI_ENCODER=yes
+!CONFIG_ADPCM_IMA_WAV_ENCODER=yes
+!CONFIG_ADPCM_MS_ENCODER=yes
+!CONFIG_ADPCM_SWF_ENCODER=yes
+!CONFIG_ADPCM_YAMAHA_ENCODER=yes
+!CONFIG_SSA_ENCODER=yes
+!CONFIG_ASS_ENCODER=yes
+!CONFIG_DVBSUB_ENCODER=yes
+!CONFIG_DVDSUB_ENCODER=yes
+!CONFIG_MOVTEXT_ENCODER=yes
+!CONFIG_SRT_ENCODER=yes
+!CONFIG_SUBRIP_ENCODER=yes
+!CONFIG_TEXT_ENCODER=yes
+!CONFIG_WEBVTT_ENCODER=yes
+!CONFIG_XSUB_ENCODER=yes
+!CONFIG_AAC_AT_ENCODER=yes
+!CONFIG_AAC_MF_ENCODER=yes
+!CONFIG_AC3_MF_ENCODER=yes
+!CONFIG_ALAC_AT_ENCODER=yes
+!CONFIG_ILBC_AT_ENCODER=yes
+!CONFIG_MP3_MF_ENCODER=yes
+!CONFIG_PCM_ALAW_AT_ENCODER=yes
+!CONFIG_PCM_MULAW_AT_ENCODER=yes
+!CONFIG_LIBAOM_AV1_ENCODER=yes
+!CONFIG_LIBCODEC2_ENCODER=yes
+!CONFIG_LIBFDK_AAC_ENCODER=yes
+!CONFIG_LIBGSM_ENCODER=yes
+!CONFIG_LIBGSM_MS_ENCODER=yes
+!CONFIG_LIBILBC_ENCODER=yes
+!CONFIG_LIBMP3LAME_ENCODER=yes
+!CONFIG_LIBOPENCORE_AMRNB_ENCODER=yes
+!CONFIG_LIBOPENJPEG_ENCODER=yes
+!CONFIG_LIBOPUS_ENCODER=yes
+!CONFIG_LIBRAV1E_ENCODER=yes
+!CONFIG_LIBSHINE_ENCODER=yes
+!CONFIG_LIBSPEEX_ENCODER=yes
+!CONFIG_LIBTHEORA_ENCODER=yes
+!CONFIG_LIBTWOLAME_ENCODER=yes
+!CONFIG_LIBVO_AMRWBENC_ENCODER=yes
+!CONFIG_LIBVORBIS_ENCODER=yes
+!CONFIG_LIBVPX_VP8_ENCODER=yes
+!CONFIG_LIBVPX_VP9_ENCODER=yes
+!CONFIG_LIBWAVPACK_ENCODER=yes
+!CONFIG_LIBWEBP_ANIM_ENCODER=yes
+!CONFIG_LIBWEBP_ENCODER=yes
+!CONFIG_LIBX262_ENCODER=yes
+!CONFIG_LIBX264_ENCODER=yes
+!CONFIG_LIBX264RGB_ENCODER=yes
+!CONFIG_LIBX265_ENCODER=yes
+!CONFIG_LIBXAVS_ENCODER=yes
+!CONFIG_LIBXAVS2_ENCODER=yes
+!CONFIG_LIBXVID_ENCODER=yes
+!CONFIG_H263_V4L2M2M_ENCODER=yes
+!CONFIG_LIBOPENH264_ENCODER=yes
+!CONFIG_H264_AMF_ENCODER=yes
+!CONFIG_H264_MF_ENCODER=yes
+!CONFIG_H264_NVENC_ENCODER=yes
+!CONFIG_H264_OMX_ENCODER=yes
+!CONFIG_H264_QSV_ENCODER=yes
+!CONFIG_H264_V4L2M2M_ENCODER=yes
+!CONFIG_H264_VAAPI_ENCODER=yes
+!CONFIG_H264_VIDEOTOOLBOX_ENCODER=yes
+!CONFIG_NVENC_ENCODER=yes
+!CONFIG_NVENC_H264_ENCODER=yes
+!CONFIG_NVENC_HEVC_ENCODER=yes
+!CONFIG_HEVC_AMF_ENCODER=yes
+!CONFIG_HEVC_MF_ENCODER=yes
+!CONFIG_HEVC_NVENC_ENCODER=yes
+!CONFIG_HEVC_QSV_ENCODER=yes
+!CONFIG_HEVC_V4L2M2M_ENCODER=yes
+!CONFIG_HEVC_VAAPI_ENCODER=yes
+!CONFIG_HEVC_VIDEOTOOLBOX_ENCODER=yes
+!CONFIG_LIBKVAZAAR_ENCODER=yes
+!CONFIG_MJPEG_QSV_ENCODER=yes
+!CONFIG_MJPEG_VAAPI_ENCODER=yes
+!CONFIG_MPEG2_QSV_ENCODER=yes
+!CONFIG_MPEG2_VAAPI_ENCODER=yes
+!CONFIG_MPEG4_OMX_ENCODER=yes
+!CONFIG_MPEG4_V4L2M2M_ENCODER=yes
+!CONFIG_VP8_V4L2M2M_ENCODER=yes
+!CONFIG_VP8_VAAPI_ENCODER=yes
+!CONFIG_VP9_VAAPI_ENCODER=yes
+!CONFIG_VP9_QSV_ENCODER=yes
+!CONFIG_H263_VAAPI_HWACCEL=yes
+!CONFIG_H263_VIDEOTOOLBOX_HWACCEL=yes
+!CONFIG_H264_D3D11VA_HWACCEL=yes
+!CONFIG_H264_D3D11VA2_HWACCEL=yes
+!CONFIG_H264_DXVA2_HWACCEL=yes
+!CONFIG_H264_NVDEC_HWACCEL=yes
+!CONFIG_H264_VAAPI_HWACCEL=yes
+!CONFIG_H264_VDPAU_HWACCEL=yes
+!CONFIG_H264_VIDEOTOOLBOX_HWACCEL=yes
+!CONFIG_HEVC_D3D11VA_HWACCEL=yes
+!CONFIG_HEVC_D3D11VA2_HWACCEL=yes
+!CONFIG_HEVC_DXVA2_HWACCEL=yes
+!CONFIG_HEVC_NVDEC_HWACCEL=yes
+!CONFIG_HEVC_VAAPI_HWACCEL=yes
+!CONFIG_HEVC_VDPAU_HWACCEL=yes
+!CONFIG_HEVC_VIDEOTOOLBOX_HWACCEL=yes
+!CONFIG_MJPEG_NVDEC_HWACCEL=yes
+!CONFIG_MJPEG_VAAPI_HWACCEL=yes
+!CONFIG_MPEG1_NVDEC_HWACCEL=yes
+!CONFIG_MPEG1_VDPAU_HWACCEL=yes
+!CONFIG_MPEG1_VIDEOTOOLBOX_HWACCEL=yes
+!CONFIG_MPEG1_XVMC_HWACCEL=yes
+!CONFIG_MPEG2_D3D11VA_HWACCEL=yes
+!CONFIG_MPEG2_D3D11VA2_HWACCEL=yes
+!CONFIG_MPEG2_NVDEC_HWACCEL=yes
+!CONFIG_MPEG2_DXVA2_HWACCEL=yes
+!CONFIG_MPEG2_VAAPI_HWACCEL=yes
+!CONFIG_MPEG2_VDPAU_HWACCEL=yes
+!CONFIG_MPEG2_VIDEOTOOLBOX_HWACCEL=yes
+!CONFIG_MPEG2_XVMC_HWACCEL=yes
+!CONFIG_MPEG4_NVDEC_HWACCEL=yes
+!CONFIG_MPEG4_VAAPI_HWACCEL=yes
+!CONFIG_MPEG4_VDPAU_HWACCEL=yes
+!CONFIG_MPEG4_VIDEOTOOLBOX_HWACCEL=yes
+!CONFIG_VC1_D3D11VA_HWACCEL=yes
+!CONFIG_VC1_D3D11VA2_HWACCEL=yes
+!CONFIG_VC1_DXVA2_HWACCEL=yes
+!CONFIG_VC1_NVDEC_HWACCEL=yes
+!CONFIG_VC1_VAAPI_HWACCEL=yes
+!CONFIG_VC1_VDPAU_HWACCEL=yes
+!CONFIG_VP8_NVDEC_HWACCEL=yes
+!CONFIG_VP8_VAAPI_HWACCEL=yes
+!CONFIG_VP9_D3D11VA_HWACCEL=yes
+!CONFIG_VP9_D3D11VA2_HWACCEL=yes
+!CONFIG_VP9_DXVA2_HWACCEL=yes
+!CONFIG_VP9_NVDEC_HWACCEL=yes
+!CONFIG_VP9_VAAPI_HWACCEL=yes
+!CONFIG_VP9_VDPAU_HWACCEL=yes
+!CONFIG_WMV3_D3D11VA_HWACCEL=yes
+!CONFIG_WMV3_D3D11VA2_HWACCEL=yes
+!CONFIG_WMV3_DXVA2_HWACCEL=yes
+!CONFIG_WMV3_NVDEC_HWACCEL=yes
+!CONFIG_WMV3_VAAPI_HWACCEL=yes
+!CONFIG_WMV3_VDPAU_HWACCEL=yes
+!CONFIG_AAC_PARSER=yes
+!CONFIG_AAC_LATM_PARSER=yes
+!CONFIG_AC3_PARSER=yes
+!CONFIG_ADX_PARSER=yes
+!CONFIG_AV1_PARSER=yes
+!CONFIG_AVS2_PARSER=yes
+!CONFIG_BMP_PARSER=yes
+!CONFIG_CAVSVIDEO_PARSER=yes
+!CONFIG_COOK_PARSER=yes
+!CONFIG_DCA_PARSER=yes
+!CONFIG_DIRAC_PARSER=yes
+!CONFIG_DNXHD_PARSER=yes
+!CONFIG_DPX_PARSER=yes
+!CONFIG_DVAUDIO_PARSER=yes
+!CONFIG_DVBSUB_PARSER=yes
+!CONFIG_DVDSUB_PARSER=yes
+!CONFIG_DVD_NAV_PARSER=yes
+!CONFIG_FLAC_PARSER=yes
+!CONFIG_G723_1_PARSER=yes
+!CONFIG_G729_PARSER=yes
+!CONFIG_GIF_PARSER=yes
+!CONFIG_GSM_PARSER=yes
+!CONFIG_H261_PARSER=yes
+!CONFIG_H263_PARSER=yes
+!CONFIG_H264_PARSER=yes
+!CONFIG_HEVC_PARSER=yes
+!CONFIG_MJPEG_PARSER=yes
+!CONFIG_MLP_PARSER=yes
+!CONFIG_MPEG4VIDEO_PARSER=yes
+!CONFIG_MPEGAUDIO_PARSER=yes
+!CONFIG_MPEGVIDEO_PARSER=yes
+!CONFIG_OPUS_PARSER=yes
+!CONFIG_PNG_PARSER=yes
+!CONFIG_PNM_PARSER=yes
+!CONFIG_RV30_PARSER=yes
+!CONFIG_RV40_PARSER=yes
+!CONFIG_SBC_PARSER=yes
+!CONFIG_SIPR_PARSER=yes
+!CONFIG_TAK_PARSER=yes
+!CONFIG_VC1_PARSER=yes
+!CONFIG_VORBIS_PARSER=yes
+!CONFIG_VP3_PARSER=yes
+!CONFIG_VP8_PARSER=yes
+!CONFIG_VP9_PARSER=yes
+!CONFIG_WEBP_PARSER=yes
+!CONFIG_XMA_PARSER=yes
+!CONFIG_ALSA_INDEV=yes
+!CONFIG_ANDROID_CAMERA_INDEV=yes
+!CONFIG_AVFOUNDATION_INDEV=yes
+!CONFIG_BKTR_INDEV=yes
+!CONFIG_DECKLINK_INDEV=yes
+!CONFIG_DSHOW_INDEV=yes
+!CONFIG_FBDEV_INDEV=yes
+!CONFIG_GDIGRAB_INDEV=yes
+!CONFIG_IEC61883_INDEV=yes
+!CONFIG_JACK_INDEV=yes
+!CONFIG_KMSGRAB_INDEV=yes
+!CONFIG_LAVFI_INDEV=yes
+!CONFIG_OPENAL_INDEV=yes
+!CONFIG_OSS_INDEV=yes
+!CONFIG_PULSE_INDEV=yes
+!CONFIG_SNDIO_INDEV=yes
+!CONFIG_V4L2_INDEV=yes
+!CONFIG_VFWCAP_INDEV=yes
+!CONFIG_XCBGRAB_INDEV=yes
+!CONFIG_LIBCDIO_INDEV=yes
+!CONFIG_LIBDC1394_INDEV=yes
+!CONFIG_ALSA_OUTDEV=yes
+!CONFIG_CACA_OUTDEV=yes
+!CONFIG_DECKLINK_OUTDEV=yes
+!CONFIG_FBDEV_OUTDEV=yes
+!CONFIG_OPENGL_OUTDEV=yes
+!CONFIG_OSS_OUTDEV=yes
+!CONFIG_PULSE_OUTDEV=yes
+!CONFIG_SDL2_OUTDEV=yes
+!CONFIG_SNDIO_OUTDEV=yes
+!CONFIG_V4L2_OUTDEV=yes
+!CONFIG_XV_OUTDEV=yes
+CONFIG_ABENCH_FILTER=yes
+CONFIG_ACOMPRESSOR_FILTER=yes
+CONFIG_ACONTRAST_FILTER=yes
+CONFIG_ACOPY_FILTER=yes
+CONFIG_ACUE_FILTER=yes
+CONFIG_ACROSSFADE_FILTER=yes
+CONFIG_ACROSSOVER_FILTER=yes
+CONFIG_ACRUSHER_FILTER=yes
+CONFIG_ADECLICK_FILTER=yes
+CONFIG_ADECLIP_FILTER=yes
+CONFIG_ADELAY_FILTER=yes
+CONFIG_ADERIVATIVE_FILTER=yes
+CONFIG_AECHO_FILTER=yes
+CONFIG_AEMPHASIS_FILTER=yes
+CONFIG_AEVAL_FILTER=yes
+CONFIG_AFADE_FILTER=yes
+!CONFIG_AFFTDN_FILTER=yes
+!CONFIG_AFFTFILT_FILTER=yes
+!CONFIG_AFIR_FILTER=yes
+CONFIG_AFORMAT_FILTER=yes
+CONFIG_AGATE_FILTER=yes
+CONFIG_AIIR_FILTER=yes
+CONFIG_AINTEGRAL_FILTER=yes
+CONFIG_AINTERLEAVE_FILTER=yes
+CONFIG_ALIMITER_FILTER=yes
+CONFIG_ALLPASS_FILTER=yes
+CONFIG_ALOOP_FILTER=yes
+CONFIG_AMERGE_FILTER=yes
+!CONFIG_AMETADATA_FILTER=yes
+CONFIG_AMIX_FILTER=yes
+CONFIG_AMULTIPLY_FILTER=yes
+CONFIG_ANEQUALIZER_FILTER=yes
+CONFIG_ANLMDN_FILTER=yes
+CONFIG_ANLMS_FILTER=yes
+CONFIG_ANULL_FILTER=yes
+CONFIG_APAD_FILTER=yes
+CONFIG_APERMS_FILTER=yes
+CONFIG_APHASER_FILTER=yes
+CONFIG_APULSATOR_FILTER=yes
+CONFIG_AREALTIME_FILTER=yes
+CONFIG_ARESAMPLE_FILTER=yes
+CONFIG_AREVERSE_FILTER=yes
+CONFIG_ARNNDN_FILTER=yes
+CONFIG_ASELECT_FILTER=yes
+CONFIG_ASENDCMD_FILTER=yes
+CONFIG_ASETNSAMPLES_FILTER=yes
+CONFIG_ASETPTS_FILTER=yes
+CONFIG_ASETRATE_FILTER=yes
+CONFIG_ASETTB_FILTER=yes
+CONFIG_ASHOWINFO_FILTER=yes
+CONFIG_ASIDEDATA_FILTER=yes
+CONFIG_ASOFTCLIP_FILTER=yes
+CONFIG_ASPLIT_FILTER=yes
+!CONFIG_ASR_FILTER=yes
+CONFIG_ASTATS_FILTER=yes
+CONFIG_ASTREAMSELECT_FILTER=yes
+CONFIG_ASUBBOOST_FILTER=yes
+!CONFIG_ATEMPO_FILTER=yes
+CONFIG_ATRIM_FILTER=yes
+CONFIG_AXCORRELATE_FILTER=yes
+!CONFIG_AZMQ_FILTER=yes
+CONFIG_BANDPASS_FILTER=yes
+CONFIG_BANDREJECT_FILTER=yes
+CONFIG_BASS_FILTER=yes
+CONFIG_BIQUAD_FILTER=yes
+!CONFIG_BS2B_FILTER=yes
+!CONFIG_CHROMABER_VULKAN_FILTER=yes
+CONFIG_CHANNELMAP_FILTER=yes
+CONFIG_CHANNELSPLIT_FILTER=yes
+CONFIG_CHORUS_FILTER=yes
+CONFIG_COMPAND_FILTER=yes
+CONFIG_COMPENSATIONDELAY_FILTER=yes
+CONFIG_CROSSFEED_FILTER=yes
+CONFIG_CRYSTALIZER_FILTER=yes
+CONFIG_DCSHIFT_FILTER=yes
+CONFIG_DEESSER_FILTER=yes
+CONFIG_DRMETER_FILTER=yes
+CONFIG_DYNAUDNORM_FILTER=yes
+CONFIG_EARWAX_FILTER=yes
+CONFIG_EBUR128_FILTER=yes
+CONFIG_EQUALIZER_FILTER=yes
+CONFIG_EXTRASTEREO_FILTER=yes
+!CONFIG_FIREQUALIZER_FILTER=yes
+CONFIG_FLANGER_FILTER=yes
+CONFIG_HAAS_FILTER=yes
+CONFIG_HDCD_FILTER=yes
+!CONFIG_HEADPHONE_FILTER=yes
+CONFIG_HIGHPASS_FILTER=yes
+CONFIG_HIGHSHELF_FILTER=yes
+CONFIG_JOIN_FILTER=yes
+!CONFIG_LADSPA_FILTER=yes
+CONFIG_LOUDNORM_FILTER=yes
+CONFIG_LOWPASS_FILTER=yes
+CONFIG_LOWSHELF_FILTER=yes
+!CONFIG_LV2_FILTER=yes
+CONFIG_MCOMPAND_FILTER=yes
+CONFIG_PAN_FILTER=yes
+CONFIG_REPLAYGAIN_FILTER=yes
+!CONFIG_RESAMPLE_FILTER=yes
+!CONFIG_RUBBERBAND_FILTER=yes
+CONFIG_SIDECHAINCOMPRESS_FILTER=yes
+CONFIG_SIDECHAINGATE_FILTER=yes
+CONFIG_SILENCEDETECT_FILTER=yes
+CONFIG_SILENCEREMOVE_FILTER=yes
+!CONFIG_SOFALIZER_FILTER=yes
+CONFIG_STEREOTOOLS_FILTER=yes
+CONFIG_STEREOWIDEN_FILTER=yes
+!CONFIG_SUPEREQUALIZER_FILTER=yes
+!CONFIG_SURROUND_FILTER=yes
+CONFIG_TREBLE_FILTER=yes
+CONFIG_TREMOLO_FILTER=yes
+CONFIG_VIBRATO_FILTER=yes
+CONFIG_VOLUME_FILTER=yes
+CONFIG_VOLUMEDETECT_FILTER=yes
+CONFIG_AEVALSRC_FILTER=yes
+CONFIG_AFIRSRC_FILTER=yes
+CONFIG_ANOISESRC_FILTER=yes
+CONFIG_ANULLSRC_FILTER=yes
+!CONFIG_FLITE_FILTER=yes
+CONFIG_HILBERT_FILTER=yes
+!CONFIG_SINC_FILTER=yes
+CONFIG_SINE_FILTER=yes
+CONFIG_ANULLSINK_FILTER=yes
+CONFIG_ADDROI_FILTER=yes
+CONFIG_ALPHAEXTRACT_FILTER=yes
+CONFIG_ALPHAMERGE_FILTER=yes
+CONFIG_AMPLIFY_FILTER=yes
+!CONFIG_ASS_FILTER=yes
+CONFIG_ATADENOISE_FILTER=yes
+CONFIG_AVGBLUR_FILTER=yes
+!CONFIG_AVGBLUR_OPENCL_FILTER=yes
+!CONFIG_AVGBLUR_VULKAN_FILTER=yes
+CONFIG_BBOX_FILTER=yes
+CONFIG_BENCH_FILTER=yes
+CONFIG_BILATERAL_FILTER=yes
+CONFIG_BITPLANENOISE_FILTER=yes
+CONFIG_BLACKDETECT_FILTER=yes
+CONFIG_BLACKFRAME_FILTER=yes
+CONFIG_BLEND_FILTER=yes
+!CONFIG_BM3D_FILTER=yes
+CONFIG_BOXBLUR_FILTER=yes
+!CONFIG_BOXBLUR_OPENCL_FILTER=yes
+CONFIG_BWDIF_FILTER=yes
+CONFIG_CAS_FILTER=yes
+CONFIG_CHROMAHOLD_FILTER=yes
+CONFIG_CHROMAKEY_FILTER=yes
+CONFIG_CHROMASHIFT_FILTER=yes
+CONFIG_CIESCOPE_FILTER=yes
+CONFIG_CODECVIEW_FILTER=yes
+CONFIG_COLORBALANCE_FILTER=yes
+CONFIG_COLORCHANNELMIXER_FILTER=yes
+CONFIG_COLORKEY_FILTER=yes
+!CONFIG_COLORKEY_OPENCL_FILTER=yes
+CONFIG_COLORHOLD_FILTER=yes
+CONFIG_COLORLEVELS_FILTER=yes
+CONFIG_COLORMATRIX_FILTER=yes
+CONFIG_COLORSPACE_FILTER=yes
+CONFIG_CONVOLUTION_FILTER=yes
+!CONFIG_CONVOLUTION_OPENCL_FILTER=yes
+!CONFIG_CONVOLVE_FILTER=yes
+CONFIG_COPY_FILTER=yes
+!CONFIG_COREIMAGE_FILTER=yes
+!CONFIG_COVER_RECT_FILTER=yes
+CONFIG_CROP_FILTER=yes
+CONFIG_CROPDETECT_FILTER=yes
+CONFIG_CUE_FILTER=yes
+CONFIG_CURVES_FILTER=yes
+CONFIG_DATASCOPE_FILTER=yes
+CONFIG_DBLUR_FILTER=yes
+CONFIG_DCTDNOIZ_FILTER=yes
+CONFIG_DEBAND_FILTER=yes
+CONFIG_DEBLOCK_FILTER=yes
+CONFIG_DECIMATE_FILTER=yes
+!CONFIG_DECONVOLVE_FILTER=yes
+CONFIG_DEDOT_FILTER=yes
+CONFIG_DEFLATE_FILTER=yes
+CONFIG_DEFLICKER_FILTER=yes
+!CONFIG_DEINTERLACE_QSV_FILTER=yes
+!CONFIG_DEINTERLACE_VAAPI_FILTER=yes
+CONFIG_DEJUDDER_FILTER=yes
+CONFIG_DELOGO_FILTER=yes
+!CONFIG_DENOISE_VAAPI_FILTER=yes
+!CONFIG_DERAIN_FILTER=yes
+CONFIG_DESHAKE_FILTER=yes
+!CONFIG_DESHAKE_OPENCL_FILTER=yes
+CONFIG_DESPILL_FILTER=yes
+CONFIG_DETELECINE_FILTER=yes
+CONFIG_DILATION_FILTER=yes
+!CONFIG_DILATION_OPENCL_FILTER=yes
+CONFIG_DISPLACE_FILTER=yes
+!CONFIG_DNN_PROCESSING_FILTER=yes
+CONFIG_DOUBLEWEAVE_FILTER=yes
+CONFIG_DRAWBOX_FILTER=yes
+CONFIG_DRAWGRAPH_FILTER=yes
+CONFIG_DRAWGRID_FILTER=yes
+!CONFIG_DRAWTEXT_FILTER=yes
+CONFIG_EDGEDETECT_FILTER=yes
+!CONFIG_ELBG_FILTER=yes
+CONFIG_ENTROPY_FILTER=yes
+CONFIG_EQ_FILTER=yes
+CONFIG_EROSION_FILTER=yes
+!CONFIG_EROSION_OPENCL_FILTER=yes
+CONFIG_EXTRACTPLANES_FILTER=yes
+CONFIG_FADE_FILTER=yes
+!CONFIG_FFTDNOIZ_FILTER=yes
+!CONFIG_FFTFILT_FILTER=yes
+CONFIG_FIELD_FILTER=yes
+CONFIG_FIELDHINT_FILTER=yes
+CONFIG_FIELDMATCH_FILTER=yes
+CONFIG_FIELDORDER_FILTER=yes
+CONFIG_FILLBORDERS_FILTER=yes
+!CONFIG_FIND_RECT_FILTER=yes
+CONFIG_FLOODFILL_FILTER=yes
+CONFIG_FORMAT_FILTER=yes
+CONFIG_FPS_FILTER=yes
+CONFIG_FRAMEPACK_FILTER=yes
+CONFIG_FRAMERATE_FILTER=yes
+CONFIG_FRAMESTEP_FILTER=yes
+CONFIG_FREEZEDETECT_FILTER=yes
+CONFIG_FREEZEFRAMES_FILTER=yes
+!CONFIG_FREI0R_FILTER=yes
+CONFIG_FSPP_FILTER=yes
+CONFIG_GBLUR_FILTER=yes
+CONFIG_GEQ_FILTER=yes
+CONFIG_GRADFUN_FILTER=yes
+CONFIG_GRAPHMONITOR_FILTER=yes
+CONFIG_GREYEDGE_FILTER=yes
+CONFIG_HALDCLUT_FILTER=yes
+CONFIG_HFLIP_FILTER=yes
+CONFIG_HISTEQ_FILTER=yes
+CONFIG_HISTOGRAM_FILTER=yes
+CONFIG_HQDN3D_FILTER=yes
+CONFIG_HQX_FILTER=yes
+CONFIG_HSTACK_FILTER=yes
+CONFIG_HUE_FILTER=yes
+CONFIG_HWDOWNLOAD_FILTER=yes
+CONFIG_HWMAP_FILTER=yes
+CONFIG_HWUPLOAD_FILTER=yes
+!CONFIG_HWUPLOAD_CUDA_FILTER=yes
+CONFIG_HYSTERESIS_FILTER=yes
+CONFIG_IDET_FILTER=yes
+CONFIG_IL_FILTER=yes
+CONFIG_INFLATE_FILTER=yes
+CONFIG_INTERLACE_FILTER=yes
+CONFIG_INTERLEAVE_FILTER=yes
+CONFIG_KERNDEINT_FILTER=yes
+CONFIG_LAGFUN_FILTER=yes
+CONFIG_LENSCORRECTION_FILTER=yes
+!CONFIG_LENSFUN_FILTER=yes
+!CONFIG_LIBVMAF_FILTER=yes
+CONFIG_LIMITER_FILTER=yes
+CONFIG_LOOP_FILTER=yes
+CONFIG_LUMAKEY_FILTER=yes
+CONFIG_LUT_FILTER=yes
+CONFIG_LUT1D_FILTER=yes
+CONFIG_LUT2_FILTER=yes
+CONFIG_LUT3D_FILTER=yes
+CONFIG_LUTRGB_FILTER=yes
+CONFIG_LUTYUV_FILTER=yes
+CONFIG_MASKEDCLAMP_FILTER=yes
+CONFIG_MASKEDMAX_FILTER=yes
+CONFIG_MASKEDMERGE_FILTER=yes
+CONFIG_MASKEDMIN_FILTER=yes
+CONFIG_MASKEDTHRESHOLD_FILTER=yes
+CONFIG_MASKFUN_FILTER=yes
+!CONFIG_MCDEINT_FILTER=yes
+CONFIG_MEDIAN_FILTER=yes
+CONFIG_MERGEPLANES_FILTER=yes
+CONFIG_MESTIMATE_FILTER=yes
+!CONFIG_METADATA_FILTER=yes
+CONFIG_MIDEQUALIZER_FILTER=yes
+CONFIG_MINTERPOLATE_FILTER=yes
+CONFIG_MIX_FILTER=yes
+CONFIG_MPDECIMATE_FILTER=yes
+CONFIG_NEGATE_FILTER=yes
+CONFIG_NLMEANS_FILTER=yes
+!CONFIG_NLMEANS_OPENCL_FILTER=yes
+CONFIG_NNEDI_FILTER=yes
+CONFIG_NOFORMAT_FILTER=yes
+CONFIG_NOISE_FILTER=yes
+CONFIG_NORMALIZE_FILTER=yes
+CONFIG_NULL_FILTER=yes
+!CONFIG_OCR_FILTER=yes
+!CONFIG_OCV_FILTER=yes
+CONFIG_OSCILLOSCOPE_FILTER=yes
+CONFIG_OVERLAY_FILTER=yes
+!CONFIG_OVERLAY_OPENCL_FILTER=yes
+!CONFIG_OVERLAY_QSV_FILTER=yes
+!CONFIG_OVERLAY_VULKAN_FILTER=yes
+!CONFIG_OVERLAY_CUDA_FILTER=yes
+CONFIG_OWDENOISE_FILTER=yes
+CONFIG_PAD_FILTER=yes
+!CONFIG_PAD_OPENCL_FILTER=yes
+CONFIG_PALETTEGEN_FILTER=yes
+CONFIG_PALETTEUSE_FILTER=yes
+CONFIG_PERMS_FILTER=yes
+CONFIG_PERSPECTIVE_FILTER=yes
+CONFIG_PHASE_FILTER=yes
+CONFIG_PHOTOSENSITIVITY_FILTER=yes
+CONFIG_PIXDESCTEST_FILTER=yes
+CONFIG_PIXSCOPE_FILTER=yes
+!CONFIG_PP_FILTER=yes
+CONFIG_PP7_FILTER=yes
+CONFIG_PREMULTIPLY_FILTER=yes
+CONFIG_PREWITT_FILTER=yes
+!CONFIG_PREWITT_OPENCL_FILTER=yes
+!CONFIG_PROCAMP_VAAPI_FILTER=yes
+!CONFIG_PROGRAM_OPENCL_FILTER=yes
+CONFIG_PSEUDOCOLOR_FILTER=yes
+CONFIG_PSNR_FILTER=yes
+CONFIG_PULLUP_FILTER=yes
+CONFIG_QP_FILTER=yes
+CONFIG_RANDOM_FILTER=yes
+CONFIG_READEIA608_FILTER=yes
+CONFIG_READVITC_FILTER=yes
+CONFIG_REALTIME_FILTER=yes
+CONFIG_REMAP_FILTER=yes
+CONFIG_REMOVEGRAIN_FILTER=yes
+!CONFIG_REMOVELOGO_FILTER=yes
+CONFIG_REPEATFIELDS_FILTER=yes
+CONFIG_REVERSE_FILTER=yes
+CONFIG_RGBASHIFT_FILTER=yes
+CONFIG_ROBERTS_FILTER=yes
+!CONFIG_ROBERTS_OPENCL_FILTER=yes
+CONFIG_ROTATE_FILTER=yes
+CONFIG_SAB_FILTER=yes
+CONFIG_SCALE_FILTER=yes
+!CONFIG_SCALE_CUDA_FILTER=yes
+!CONFIG_SCALE_NPP_FILTER=yes
+!CONFIG_SCALE_QSV_FILTER=yes
+!CONFIG_SCALE_VAAPI_FILTER=yes
+!CONFIG_SCALE_VULKAN_FILTER=yes
+CONFIG_SCALE2REF_FILTER=yes
+CONFIG_SCDET_FILTER=yes
+CONFIG_SCROLL_FILTER=yes
+CONFIG_SELECT_FILTER=yes
+CONFIG_SELECTIVECOLOR_FILTER=yes
+CONFIG_SENDCMD_FILTER=yes
+CONFIG_SEPARATEFIELDS_FILTER=yes
+CONFIG_SETDAR_FILTER=yes
+CONFIG_SETFIELD_FILTER=yes
+CONFIG_SETPARAMS_FILTER=yes
+CONFIG_SETPTS_FILTER=yes
+CONFIG_SETRANGE_FILTER=yes
+CONFIG_SETSAR_FILTER=yes
+CONFIG_SETTB_FILTER=yes
+!CONFIG_SHARPNESS_VAAPI_FILTER=yes
+CONFIG_SHOWINFO_FILTER=yes
+CONFIG_SHOWPALETTE_FILTER=yes
+CONFIG_SHUFFLEFRAMES_FILTER=yes
+CONFIG_SHUFFLEPLANES_FILTER=yes
+CONFIG_SIDEDATA_FILTER=yes
+CONFIG_SIGNALSTATS_FILTER=yes
+!CONFIG_SIGNATURE_FILTER=yes
+CONFIG_SMARTBLUR_FILTER=yes
+CONFIG_SOBEL_FILTER=yes
+!CONFIG_SOBEL_OPENCL_FILTER=yes
+CONFIG_SPLIT_FILTER=yes
+!CONFIG_SPP_FILTER=yes
+!CONFIG_SR_FILTER=yes
+CONFIG_SSIM_FILTER=yes
+CONFIG_STEREO3D_FILTER=yes
+CONFIG_STREAMSELECT_FILTER=yes
+!CONFIG_SUBTITLES_FILTER=yes
+CONFIG_SUPER2XSAI_FILTER=yes
+CONFIG_SWAPRECT_FILTER=yes
+CONFIG_SWAPUV_FILTER=yes
+CONFIG_TBLEND_FILTER=yes
+CONFIG_TELECINE_FILTER=yes
+CONFIG_THISTOGRAM_FILTER=yes
+CONFIG_THRESHOLD_FILTER=yes
+CONFIG_THUMBNAIL_FILTER=yes
+!CONFIG_THUMBNAIL_CUDA_FILTER=yes
+CONFIG_TILE_FILTER=yes
+CONFIG_TINTERLACE_FILTER=yes
+CONFIG_TLUT2_FILTER=yes
+CONFIG_TMEDIAN_FILTER=yes
+CONFIG_TMIX_FILTER=yes
+CONFIG_TONEMAP_FILTER=yes
+!CONFIG_TONEMAP_OPENCL_FILTER=yes
+!CONFIG_TONEMAP_VAAPI_FILTER=yes
+CONFIG_TPAD_FILTER=yes
+CONFIG_TRANSPOSE_FILTER=yes
+!CONFIG_TRANSPOSE_NPP_FILTER=yes
+!CONFIG_TRANSPOSE_OPENCL_FILTER=yes
+!CONFIG_TRANSPOSE_VAAPI_FILTER=yes
+CONFIG_TRIM_FILTER=yes
+CONFIG_UNPREMULTIPLY_FILTER=yes
+CONFIG_UNSHARP_FILTER=yes
+!CONFIG_UNSHARP_OPENCL_FILTER=yes
+CONFIG_UNTILE_FILTER=yes
+!CONFIG_USPP_FILTER=yes
+CONFIG_V360_FILTER=yes
+CONFIG_VAGUEDENOISER_FILTER=yes
+CONFIG_VECTORSCOPE_FILTER=yes
+CONFIG_VFLIP_FILTER=yes
+CONFIG_VFRDET_FILTER=yes
+CONFIG_VIBRANCE_FILTER=yes
+!CONFIG_VIDSTABDETECT_FILTER=yes
+!CONFIG_VIDSTABTRANSFORM_FILTER=yes
+CONFIG_VIGNETTE_FILTER=yes
+CONFIG_VMAFMOTION_FILTER=yes
+!CONFIG_VPP_QSV_FILTER=yes
+CONFIG_VSTACK_FILTER=yes
+CONFIG_W3FDIF_FILTER=yes
+CONFIG_WAVEFORM_FILTER=yes
+CONFIG_WEAVE_FILTER=yes
+CONFIG_XBR_FILTER=yes
+CONFIG_XFADE_FILTER=yes
+!CONFIG_XFADE_OPENCL_FILTER=yes
+CONFIG_XMEDIAN_FILTER=yes
+CONFIG_XSTACK_FILTER=yes
+CONFIG_YADIF_FILTER=yes
+!CONFIG_YADIF_CUDA_FILTER=yes
+CONFIG_YAEPBLUR_FILTER=yes
+!CONFIG_ZMQ_FILTER=yes
+CONFIG_ZOOMPAN_FILTER=yes
+!CONFIG_ZSCALE_FILTER=yes
+CONFIG_ALLRGB_FILTER=yes
+CONFIG_ALLYUV_FILTER=yes
+CONFIG_CELLAUTO_FILTER=yes
+CONFIG_COLOR_FILTER=yes
+!CONFIG_COREIMAGESRC_FILTER=yes
+!CONFIG_FREI0R_SRC_FILTER=yes
+CONFIG_GRADIENTS_FILTER=yes
+CONFIG_HALDCLUTSRC_FILTER=yes
+CONFIG_LIFE_FILTER=yes
+CONFIG_MANDELBROT_FILTER=yes
+CONFIG_MPTESTSRC_FILTER=yes
+CONFIG_NULLSRC_FILTER=yes
+!CONFIG_OPENCLSRC_FILTER=yes
+CONFIG_PAL75BARS_FILTER=yes
+CONFIG_PAL100BARS_FILTER=yes
+CONFIG_RGBTESTSRC_FILTER=yes
+CONFIG_SIERPINSKI_FILTER=yes
+CONFIG_SMPTEBARS_FILTER=yes
+CONFIG_SMPTEHDBARS_FILTER=yes
+CONFIG_TESTSRC_FILTER=yes
+CONFIG_TESTSRC2_FILTER=yes
+CONFIG_YUVTESTSRC_FILTER=yes
+CONFIG_NULLSINK_FILTER=yes
+CONFIG_ABITSCOPE_FILTER=yes
+CONFIG_ADRAWGRAPH_FILTER=yes
+CONFIG_AGRAPHMONITOR_FILTER=yes
+CONFIG_AHISTOGRAM_FILTER=yes
+CONFIG_APHASEMETER_FILTER=yes
+CONFIG_AVECTORSCOPE_FILTER=yes
+CONFIG_CONCAT_FILTER=yes
+!CONFIG_SHOWCQT_FILTER=yes
+!CONFIG_SHOWFREQS_FILTER=yes
+!CONFIG_SHOWSPATIAL_FILTER=yes
+!CONFIG_SHOWSPECTRUM_FILTER=yes
+!CONFIG_SHOWSPECTRUMPIC_FILTER=yes
+CONFIG_SHOWVOLUME_FILTER=yes
+CONFIG_SHOWWAVES_FILTER=yes
+CONFIG_SHOWWAVESPIC_FILTER=yes
+!CONFIG_SPECTRUMSYNTH_FILTER=yes
+!CONFIG_AMOVIE_FILTER=yes
+!CONFIG_MOVIE_FILTER=yes
+CONFIG_AFIFO_FILTER=yes
+CONFIG_FIFO_FILTER=yes
+!CONFIG_AA_DEMUXER=yes
+!CONFIG_AAC_DEMUXER=yes
+!CONFIG_AC3_DEMUXER=yes
+!CONFIG_ACM_DEMUXER=yes
+!CONFIG_ACT_DEMUXER=yes
+!CONFIG_ADF_DEMUXER=yes
+!CONFIG_ADP_DEMUXER=yes
+!CONFIG_ADS_DEMUXER=yes
+!CONFIG_ADX_DEMUXER=yes
+!CONFIG_AEA_DEMUXER=yes
+!CONFIG_AFC_DEMUXER=yes
+!CONFIG_AIFF_DEMUXER=yes
+!CONFIG_AIX_DEMUXER=yes
+!CONFIG_ALP_DEMUXER=yes
+!CONFIG_AMR_DEMUXER=yes
+!CONFIG_AMRNB_DEMUXER=yes
+!CONFIG_AMRWB_DEMUXER=yes
+!CONFIG_ANM_DEMUXER=yes
+!CONFIG_APC_DEMUXER=yes
+!CONFIG_APE_DEMUXER=yes
+!CONFIG_APM_DEMUXER=yes
+!CONFIG_APNG_DEMUXER=yes
+!CONFIG_APTX_DEMUXER=yes
+!CONFIG_APTX_HD_DEMUXER=yes
+!CONFIG_AQTITLE_DEMUXER=yes
+!CONFIG_ARGO_ASF_DEMUXER=yes
+!CONFIG_ASF_DEMUXER=yes
+!CONFIG_ASF_O_DEMUXER=yes
+!CONFIG_ASS_DEMUXER=yes
+!CONFIG_AST_DEMUXER=yes
+!CONFIG_AU_DEMUXER=yes
+!CONFIG_AV1_DEMUXER=yes
+!CONFIG_AVI_DEMUXER=yes
+!CONFIG_AVISYNTH_DEMUXER=yes
+!CONFIG_AVR_DEMUXER=yes
+!CONFIG_AVS_DEMUXER=yes
+!CONFIG_AVS2_DEMUXER=yes
+!CONFIG_BETHSOFTVID_DEMUXER=yes
+!CONFIG_BFI_DEMUXER=yes
+!CONFIG_BINTEXT_DEMUXER=yes
+!CONFIG_BINK_DEMUXER=yes
+!CONFIG_BIT_DEMUXER=yes
+!CONFIG_BMV_DEMUXER=yes
+!CONFIG_BFSTM_DEMUXER=yes
+!CONFIG_BRSTM_DEMUXER=yes
+!CONFIG_BOA_DEMUXER=yes
+!CONFIG_C93_DEMUXER=yes
+!CONFIG_CAF_DEMUXER=yes
+!CONFIG_CAVSVIDEO_DEMUXER=yes
+!CONFIG_CDG_DEMUXER=yes
+!CONFIG_CDXL_DEMUXER=yes
+!CONFIG_CINE_DEMUXER=yes
+!CONFIG_CODEC2_DEMUXER=yes
+!CONFIG_CODEC2RAW_DEMUXER=yes
+!CONFIG_CONCAT_DEMUXER=yes
+!CONFIG_DASH_DEMUXER=yes
+!CONFIG_DATA_DEMUXER=yes
+!CONFIG_DAUD_DEMUXER=yes
+!CONFIG_DCSTR_DEMUXER=yes
+!CONFIG_DERF_DEMUXER=yes
+!CONFIG_DFA_DEMUXER=yes
+!CONFIG_DHAV_DEMUXER=yes
+!CONFIG_DIRAC_DEMUXER=yes
+!CONFIG_DNXHD_DEMUXER=yes
+!CONFIG_DSF_DEMUXER=yes
+!CONFIG_DSICIN_DEMUXER=yes
+!CONFIG_DSS_DEMUXER=yes
+!CONFIG_DTS_DEMUXER=yes
+!CONFIG_DTSHD_DEMUXER=yes
+!CONFIG_DV_DEMUXER=yes
+!CONFIG_DVBSUB_DEMUXER=yes
+!CONFIG_DVBTXT_DEMUXER=yes
+!CONFIG_DXA_DEMUXER=yes
+!CONFIG_EA_DEMUXER=yes
+!CONFIG_EA_CDATA_DEMUXER=yes
+!CONFIG_EAC3_DEMUXER=yes
+!CONFIG_EPAF_DEMUXER=yes
+!CONFIG_FFMETADATA_DEMUXER=yes
+!CONFIG_FILMSTRIP_DEMUXER=yes
+!CONFIG_FITS_DEMUXER=yes
+!CONFIG_FLAC_DEMUXER=yes
+!CONFIG_FLIC_DEMUXER=yes
+!CONFIG_FLV_DEMUXER=yes
+!CONFIG_LIVE_FLV_DEMUXER=yes
+!CONFIG_FOURXM_DEMUXER=yes
+!CONFIG_FRM_DEMUXER=yes
+!CONFIG_FSB_DEMUXER=yes
+!CONFIG_FWSE_DEMUXER=yes
+!CONFIG_G722_DEMUXER=yes
+!CONFIG_G723_1_DEMUXER=yes
+!CONFIG_G726_DEMUXER=yes
+!CONFIG_G726LE_DEMUXER=yes
+!CONFIG_G729_DEMUXER=yes
+!CONFIG_GDV_DEMUXER=yes
+!CONFIG_GENH_DEMUXER=yes
+!CONFIG_GIF_DEMUXER=yes
+!CONFIG_GSM_DEMUXER=yes
+!CONFIG_GXF_DEMUXER=yes
+!CONFIG_H261_DEMUXER=yes
+!CONFIG_H263_DEMUXER=yes
+!CONFIG_H264_DEMUXER=yes
+!CONFIG_HCA_DEMUXER=yes
+!CONFIG_HCOM_DEMUXER=yes
+!CONFIG_HEVC_DEMUXER=yes
+!CONFIG_HLS_DEMUXER=yes
+!CONFIG_HNM_DEMUXER=yes
+!CONFIG_ICO_DEMUXER=yes
+!CONFIG_IDCIN_DEMUXER=yes
+!CONFIG_IDF_DEMUXER=yes
+!CONFIG_IFF_DEMUXER=yes
+!CONFIG_IFV_DEMUXER=yes
+!CONFIG_ILBC_DEMUXER=yes
+!CONFIG_IMAGE2_DEMUXER=yes
+!CONFIG_IMAGE2PIPE_DEMUXER=yes
+!CONFIG_IMAGE2_ALIAS_PIX_DEMUXER=yes
+!CONFIG_IMAGE2_BRENDER_PIX_DEMUXER=yes
+!CONFIG_INGENIENT_DEMUXER=yes
+!CONFIG_IPMOVIE_DEMUXER=yes
+!CONFIG_IRCAM_DEMUXER=yes
+!CONFIG_ISS_DEMUXER=yes
+!CONFIG_IV8_DEMUXER=yes
+!CONFIG_IVF_DEMUXER=yes
+!CONFIG_IVR_DEMUXER=yes
+!CONFIG_JACOSUB_DEMUXER=yes
+!CONFIG_JV_DEMUXER=yes
+!CONFIG_KUX_DEMUXER=yes
+!CONFIG_KVAG_DEMUXER=yes
+!CONFIG_LMLM4_DEMUXER=yes
+!CONFIG_LOAS_DEMUXER=yes
+!CONFIG_LRC_DEMUXER=yes
+!CONFIG_LVF_DEMUXER=yes
+!CONFIG_LXF_DEMUXER=yes
+!CONFIG_M4V_DEMUXER=yes
+!CONFIG_MATROSKA_DEMUXER=yes
+!CONFIG_MGSTS_DEMUXER=yes
+!CONFIG_MICRODVD_DEMUXER=yes
+!CONFIG_MJPEG_DEMUXER=yes
+!CONFIG_MJPEG_2000_DEMUXER=yes
+!CONFIG_MLP_DEMUXER=yes
+!CONFIG_MLV_DEMUXER=yes
+!CONFIG_MM_DEMUXER=yes
+!CONFIG_MMF_DEMUXER=yes
+!CONFIG_MOV_DEMUXER=yes
+!CONFIG_MP3_DEMUXER=yes
+!CONFIG_MPC_DEMUXER=yes
+!CONFIG_MPC8_DEMUXER=yes
+!CONFIG_MPEGPS_DEMUXER=yes
+!CONFIG_MPEGTS_DEMUXER=yes
+!CONFIG_MPEGTSRAW_DEMUXER=yes
+!CONFIG_MPEGVIDEO_DEMUXER=yes
+!CONFIG_MPJPEG_DEMUXER=yes
+!CONFIG_MPL2_DEMUXER=yes
+!CONFIG_MPSUB_DEMUXER=yes
+!CONFIG_MSF_DEMUXER=yes
+!CONFIG_MSNWC_TCP_DEMUXER=yes
+!CONFIG_MTAF_DEMUXER=yes
+!CONFIG_MTV_DEMUXER=yes
+!CONFIG_MUSX_DEMUXER=yes
+!CONFIG_MV_DEMUXER=yes
+!CONFIG_MVI_DEMUXER=yes
+!CONFIG_MXF_DEMUXER=yes
+!CONFIG_MXG_DEMUXER=yes
+!CONFIG_NC_DEMUXER=yes
+!CONFIG_NISTSPHERE_DEMUXER=yes
+!CONFIG_NSP_DEMUXER=yes
+!CONFIG_NSV_DEMUXER=yes
+!CONFIG_NUT_DEMUXER=yes
+!CONFIG_NUV_DEMUXER=yes
+!CONFIG_OGG_DEMUXER=yes
+!CONFIG_OMA_DEMUXER=yes
+!CONFIG_PAF_DEMUXER=yes
+!CONFIG_PCM_ALAW_DEMUXER=yes
+!CONFIG_PCM_MULAW_DEMUXER=yes
+!CONFIG_PCM_VIDC_DEMUXER=yes
+!CONFIG_PCM_F64BE_DEMUXER=yes
+!CONFIG_PCM_F64LE_DEMUXER=yes
+!CONFIG_PCM_F32BE_DEMUXER=yes
+!CONFIG_PCM_F32LE_DEMUXER=yes
+!CONFIG_PCM_S32BE_DEMUXER=yes
+!CONFIG_PCM_S32LE_DEMUXER=yes
+!CONFIG_PCM_S24BE_DEMUXER=yes
+!CONFIG_PCM_S24LE_DEMUXER=yes
+!CONFIG_PCM_S16BE_DEMUXER=yes
+!CONFIG_PCM_S16LE_DEMUXER=yes
+!CONFIG_PCM_S8_DEMUXER=yes
+!CONFIG_PCM_U32BE_DEMUXER=yes
+!CONFIG_PCM_U32LE_DEMUXER=yes
+!CONFIG_PCM_U24BE_DEMUXER=yes
+!CONFIG_PCM_U24LE_DEMUXER=yes
+!CONFIG_PCM_U16BE_DEMUXER=yes
+!CONFIG_PCM_U16LE_DEMUXER=yes
+!CONFIG_PCM_U8_DEMUXER=yes
+!CONFIG_PJS_DEMUXER=yes
+!CONFIG_PMP_DEMUXER=yes
+!CONFIG_PP_BNK_DEMUXER=yes
+!CONFIG_PVA_DEMUXER=yes
+!CONFIG_PVF_DEMUXER=yes
+!CONFIG_QCP_DEMUXER=yes
+!CONFIG_R3D_DEMUXER=yes
+!CONFIG_RAWVIDEO_DEMUXER=yes
+!CONFIG_REALTEXT_DEMUXER=yes
+!CONFIG_REDSPARK_DEMUXER=yes
+!CONFIG_RL2_DEMUXER=yes
+!CONFIG_RM_DEMUXER=yes
+!CONFIG_ROQ_DEMUXER=yes
+!CONFIG_RPL_DEMUXER=yes
+!CONFIG_RSD_DEMUXER=yes
+!CONFIG_RSO_DEMUXER=yes
+!CONFIG_RTP_DEMUXER=yes
+!CONFIG_RTSP_DEMUXER=yes
+!CONFIG_S337M_DEMUXER=yes
+!CONFIG_SAMI_DEMUXER=yes
+!CONFIG_SAP_DEMUXER=yes
+!CONFIG_SBC_DEMUXER=yes
+!CONFIG_SBG_DEMUXER=yes
+!CONFIG_SCC_DEMUXER=yes
+!CONFIG_SDP_DEMUXER=yes
+!CONFIG_SDR2_DEMUXER=yes
+!CONFIG_SDS_DEMUXER=yes
+!CONFIG_SDX_DEMUXER=yes
+!CONFIG_SEGAFILM_DEMUXER=yes
+!CONFIG_SER_DEMUXER=yes
+!CONFIG_SHORTEN_DEMUXER=yes
+!CONFIG_SIFF_DEMUXER=yes
+!CONFIG_SLN_DEMUXER=yes
+!CONFIG_SMACKER_DEMUXER=yes
+!CONFIG_SMJPEG_DEMUXER=yes
+!CONFIG_SMUSH_DEMUXER=yes
+!CONFIG_SOL_DEMUXER=yes
+!CONFIG_SOX_DEMUXER=yes
+!CONFIG_SPDIF_DEMUXER=yes
+!CONFIG_SRT_DEMUXER=yes
+!CONFIG_STR_DEMUXER=yes
+!CONFIG_STL_DEMUXER=yes
+!CONFIG_SUBVIEWER1_DEMUXER=yes
+!CONFIG_SUBVIEWER_DEMUXER=yes
+!CONFIG_SUP_DEMUXER=yes
+!CONFIG_SVAG_DEMUXER=yes
+!CONFIG_SWF_DEMUXER=yes
+!CONFIG_TAK_DEMUXER=yes
+!CONFIG_TEDCAPTIONS_DEMUXER=yes
+!CONFIG_THP_DEMUXER=yes
+!CONFIG_THREEDOSTR_DEMUXER=yes
+!CONFIG_TIERTEXSEQ_DEMUXER=yes
+!CONFIG_TMV_DEMUXER=yes
+!CONFIG_TRUEHD_DEMUXER=yes
+!CONFIG_TTA_DEMUXER=yes
+!CONFIG_TXD_DEMUXER=yes
+!CONFIG_TTY_DEMUXER=yes
+!CONFIG_TY_DEMUXER=yes
+!CONFIG_V210_DEMUXER=yes
+!CONFIG_V210X_DEMUXER=yes
+!CONFIG_VAG_DEMUXER=yes
+!CONFIG_VC1_DEMUXER=yes
+!CONFIG_VC1T_DEMUXER=yes
+!CONFIG_VIVIDAS_DEMUXER=yes
+!CONFIG_VIVO_DEMUXER=yes
+!CONFIG_VMD_DEMUXER=yes
+!CONFIG_VOBSUB_DEMUXER=yes
+!CONFIG_VOC_DEMUXER=yes
+!CONFIG_VPK_DEMUXER=yes
+!CONFIG_VPLAYER_DEMUXER=yes
+!CONFIG_VQF_DEMUXER=yes
+!CONFIG_W64_DEMUXER=yes
+!CONFIG_WAV_DEMUXER=yes
+!CONFIG_WC3_DEMUXER=yes
+!CONFIG_WEBM_DASH_MANIFEST_DEMUXER=yes
+!CONFIG_WEBVTT_DEMUXER=yes
+!CONFIG_WSAUD_DEMUXER=yes
+!CONFIG_WSD_DEMUXER=yes
+!CONFIG_WSVQA_DEMUXER=yes
+!CONFIG_WTV_DEMUXER=yes
+!CONFIG_WVE_DEMUXER=yes
+!CONFIG_WV_DEMUXER=yes
+!CONFIG_XA_DEMUXER=yes
+!CONFIG_XBIN_DEMUXER=yes
+!CONFIG_XMV_DEMUXER=yes
+!CONFIG_XVAG_DEMUXER=yes
+!CONFIG_XWMA_DEMUXER=yes
+!CONFIG_YOP_DEMUXER=yes
+!CONFIG_YUV4MPEGPIPE_DEMUXER=yes
+!CONFIG_IMAGE_BMP_PIPE_DEMUXER=yes
+!CONFIG_IMAGE_DDS_PIPE_DEMUXER=yes
+!CONFIG_IMAGE_DPX_PIPE_DEMUXER=yes
+!CONFIG_IMAGE_EXR_PIPE_DEMUXER=yes
+!CONFIG_IMAGE_GIF_PIPE_DEMUXER=yes
+!CONFIG_IMAGE_J2K_PIPE_DEMUXER=yes
+!CONFIG_IMAGE_JPEG_PIPE_DEMUXER=yes
+!CONFIG_IMAGE_JPEGLS_PIPE_DEMUXER=yes
+!CONFIG_IMAGE_PAM_PIPE_DEMUXER=yes
+!CONFIG_IMAGE_PBM_PIPE_DEMUXER=yes
+!CONFIG_IMAGE_PCX_PIPE_DEMUXER=yes
+!CONFIG_IMAGE_PGMYUV_PIPE_DEMUXER=yes
+!CONFIG_IMAGE_PGM_PIPE_DEMUXER=yes
+!CONFIG_IMAGE_PICTOR_PIPE_DEMUXER=yes
+!CONFIG_IMAGE_PNG_PIPE_DEMUXER=yes
+!CONFIG_IMAGE_PPM_PIPE_DEMUXER=yes
+!CONFIG_IMAGE_PSD_PIPE_DEMUXER=yes
+!CONFIG_IMAGE_QDRAW_PIPE_DEMUXER=yes
+!CONFIG_IMAGE_SGI_PIPE_DEMUXER=yes
+!CONFIG_IMAGE_SVG_PIPE_DEMUXER=yes
+!CONFIG_IMAGE_SUNRAST_PIPE_DEMUXER=yes
+!CONFIG_IMAGE_TIFF_PIPE_DEMUXER=yes
+!CONFIG_IMAGE_WEBP_PIPE_DEMUXER=yes
+!CONFIG_IMAGE_XPM_PIPE_DEMUXER=yes
+!CONFIG_IMAGE_XWD_PIPE_DEMUXER=yes
+!CONFIG_LIBGME_DEMUXER=yes
+!CONFIG_LIBMODPLUG_DEMUXER=yes
+!CONFIG_LIBOPENMPT_DEMUXER=yes
+!CONFIG_VAPOURSYNTH_DEMUXER=yes
+!CONFIG_A64_MUXER=yes
+!CONFIG_AC3_MUXER=yes
+!CONFIG_ADTS_MUXER=yes
+!CONFIG_ADX_MUXER=yes
+!CONFIG_AIFF_MUXER=yes
+!CONFIG_AMR_MUXER=yes
+!CONFIG_APNG_MUXER=yes
+!CONFIG_APTX_MUXER=yes
+!CONFIG_APTX_HD_MUXER=yes
+!CONFIG_ASF_MUXER=yes
+!CONFIG_ASS_MUXER=yes
+!CONFIG_AST_MUXER=yes
+!CONFIG_ASF_STREAM_MUXER=yes
+!CONFIG_AU_MUXER=yes
+!CONFIG_AVI_MUXER=yes
+!CONFIG_AVM2_MUXER=yes
+!CONFIG_AVS2_MUXER=yes
+!CONFIG_BIT_MUXER=yes
+!CONFIG_CAF_MUXER=yes
+!CONFIG_CAVSVIDEO_MUXER=yes
+!CONFIG_CODEC2_MUXER=yes
+!CONFIG_CODEC2RAW_MUXER=yes
+!CONFIG_CRC_MUXER=yes
+!CONFIG_DASH_MUXER=yes
+!CONFIG_DATA_MUXER=yes
+!CONFIG_DAUD_MUXER=yes
+!CONFIG_DIRAC_MUXER=yes
+!CONFIG_DNXHD_MUXER=yes
+!CONFIG_DTS_MUXER=yes
+!CONFIG_DV_MUXER=yes
+!CONFIG_EAC3_MUXER=yes
+!CONFIG_F4V_MUXER=yes
+!CONFIG_FFMETADATA_MUXER=yes
+!CONFIG_FIFO_MUXER=yes
+!CONFIG_FIFO_TEST_MUXER=yes
+!CONFIG_FILMSTRIP_MUXER=yes
+!CONFIG_FITS_MUXER=yes
+!CONFIG_FLAC_MUXER=yes
+!CONFIG_FLV_MUXER=yes
+!CONFIG_FRAMECRC_MUXER=yes
+!CONFIG_FRAMEHASH_MUXER=yes
+!CONFIG_FRAMEMD5_MUXER=yes
+!CONFIG_G722_MUXER=yes
+!CONFIG_G723_1_MUXER=yes
+!CONFIG_G726_MUXER=yes
+!CONFIG_G726LE_MUXER=yes
+!CONFIG_GIF_MUXER=yes
+!CONFIG_GSM_MUXER=yes
+!CONFIG_GXF_MUXER=yes
+!CONFIG_H261_MUXER=yes
+!CONFIG_H263_MUXER=yes
+!CONFIG_H264_MUXER=yes
+!CONFIG_HASH_MUXER=yes
+!CONFIG_HDS_MUXER=yes
+!CONFIG_HEVC_MUXER=yes
+!CONFIG_HLS_MUXER=yes
+!CONFIG_ICO_MUXER=yes
+!CONFIG_ILBC_MUXER=yes
+!CONFIG_IMAGE2_MUXER=yes
+!CONFIG_IMAGE2PIPE_MUXER=yes
+!CONFIG_IPOD_MUXER=yes
+!CONFIG_IRCAM_MUXER=yes
+!CONFIG_ISMV_MUXER=yes
+!CONFIG_IVF_MUXER=yes
+!CONFIG_JACOSUB_MUXER=yes
+!CONFIG_KVAG_MUXER=yes
+!CONFIG_LATM_MUXER=yes
+!CONFIG_LRC_MUXER=yes
+!CONFIG_M4V_MUXER=yes
+!CONFIG_MD5_MUXER=yes
+!CONFIG_MATROSKA_MUXER=yes
+!CONFIG_MATROSKA_AUDIO_MUXER=yes
+!CONFIG_MICRODVD_MUXER=yes
+!CONFIG_MJPEG_MUXER=yes
+!CONFIG_MLP_MUXER=yes
+!CONFIG_MMF_MUXER=yes
+!CONFIG_MOV_MUXER=yes
+!CONFIG_MP2_MUXER=yes
+!CONFIG_MP3_MUXER=yes
+!CONFIG_MP4_MUXER=yes
+!CONFIG_MPEG1SYSTEM_MUXER=yes
+!CONFIG_MPEG1VCD_MUXER=yes
+!CONFIG_MPEG1VIDEO_MUXER=yes
+!CONFIG_MPEG2DVD_MUXER=yes
+!CONFIG_MPEG2SVCD_MUXER=yes
+!CONFIG_MPEG2VIDEO_MUXER=yes
+!CONFIG_MPEG2VOB_MUXER=yes
+!CONFIG_MPEGTS_MUXER=yes
+!CONFIG_MPJPEG_MUXER=yes
+!CONFIG_MXF_MUXER=yes
+!CONFIG_MXF_D10_MUXER=yes
+!CONFIG_MXF_OPATOM_MUXER=yes
+!CONFIG_NULL_MUXER=yes
+!CONFIG_NUT_MUXER=yes
+!CONFIG_OGA_MUXER=yes
+!CONFIG_OGG_MUXER=yes
+!CONFIG_OGV_MUXER=yes
+!CONFIG_OMA_MUXER=yes
+!CONFIG_OPUS_MUXER=yes
+!CONFIG_PCM_ALAW_MUXER=yes
+!CONFIG_PCM_MULAW_MUXER=yes
+!CONFIG_PCM_VIDC_MUXER=yes
+!CONFIG_PCM_F64BE_MUXER=yes
+!CONFIG_PCM_F64LE_MUXER=yes
+!CONFIG_PCM_F32BE_MUXER=yes
+!CONFIG_PCM_F32LE_MUXER=yes
+!CONFIG_PCM_S32BE_MUXER=yes
+!CONFIG_PCM_S32LE_MUXER=yes
+!CONFIG_PCM_S24BE_MUXER=yes
+!CONFIG_PCM_S24LE_MUXER=yes
+!CONFIG_PCM_S16BE_MUXER=yes
+!CONFIG_PCM_S16LE_MUXER=yes
+!CONFIG_PCM_S8_MUXER=yes
+!CONFIG_PCM_U32BE_MUXER=yes
+!CONFIG_PCM_U32LE_MUXER=yes
+!CONFIG_PCM_U24BE_MUXER=yes
+!CONFIG_PCM_U24LE_MUXER=yes
+!CONFIG_PCM_U16BE_MUXER=yes
+!CONFIG_PCM_U16LE_MUXER=yes
+!CONFIG_PCM_U8_MUXER=yes
+!CONFIG_PSP_MUXER=yes
+!CONFIG_RAWVIDEO_MUXER=yes
+!CONFIG_RM_MUXER=yes
+!CONFIG_ROQ_MUXER=yes
+!CONFIG_RSO_MUXER=yes
+!CONFIG_RTP_MUXER=yes
+!CONFIG_RTP_MPEGTS_MUXER=yes
+!CONFIG_RTSP_MUXER=yes
+!CONFIG_SAP_MUXER=yes
+!CONFIG_SBC_MUXER=yes
+!CONFIG_SCC_MUXER=yes
+!CONFIG_SEGAFILM_MUXER=yes
+!CONFIG_SEGMENT_MUXER=yes
+!CONFIG_STREAM_SEGMENT_MUXER=yes
+!CONFIG_SINGLEJPEG_MUXER=yes
+!CONFIG_SMJPEG_MUXER=yes
+!CONFIG_SMOOTHSTREAMING_MUXER=yes
+!CONFIG_SOX_MUXER=yes
+!CONFIG_SPX_MUXER=yes
+!CONFIG_SPDIF_MUXER=yes
+!CONFIG_SRT_MUXER=yes
+!CONFIG_STREAMHASH_MUXER=yes
+!CONFIG_SUP_MUXER=yes
+!CONFIG_SWF_MUXER=yes
+!CONFIG_TEE_MUXER=yes
+!CONFIG_TG2_MUXER=yes
+!CONFIG_TGP_MUXER=yes
+!CONFIG_MKVTIMESTAMP_V2_MUXER=yes
+!CONFIG_TRUEHD_MUXER=yes
+!CONFIG_TTA_MUXER=yes
+!CONFIG_UNCODEDFRAMECRC_MUXER=yes
+!CONFIG_VC1_MUXER=yes
+!CONFIG_VC1T_MUXER=yes
+!CONFIG_VOC_MUXER=yes
+!CONFIG_W64_MUXER=yes
+!CONFIG_WAV_MUXER=yes
+!CONFIG_WEBM_MUXER=yes
+!CONFIG_WEBM_DASH_MANIFEST_MUXER=yes
+!CONFIG_WEBM_CHUNK_MUXER=yes
+!CONFIG_WEBP_MUXER=yes
+!CONFIG_WEBVTT_MUXER=yes
+!CONFIG_WTV_MUXER=yes
+!CONFIG_WV_MUXER=yes
+!CONFIG_YUV4MPEGPIPE_MUXER=yes
+!CONFIG_CHROMAPRINT_MUXER=yes
+!CONFIG_ASYNC_PROTOCOL=yes
+!CONFIG_BLURAY_PROTOCOL=yes
+!CONFIG_CACHE_PROTOCOL=yes
+!CONFIG_CONCAT_PROTOCOL=yes
+!CONFIG_CRYPTO_PROTOCOL=yes
+!CONFIG_DATA_PROTOCOL=yes
+!CONFIG_FFRTMPCRYPT_PROTOCOL=yes
+!CONFIG_FFRTMPHTTP_PROTOCOL=yes
+!CONFIG_FILE_PROTOCOL=yes
+!CONFIG_FTP_PROTOCOL=yes
+!CONFIG_GOPHER_PROTOCOL=yes
+!CONFIG_HLS_PROTOCOL=yes
+!CONFIG_HTTP_PROTOCOL=yes
+!CONFIG_HTTPPROXY_PROTOCOL=yes
+!CONFIG_HTTPS_PROTOCOL=yes
+!CONFIG_ICECAST_PROTOCOL=yes
+!CONFIG_MMSH_PROTOCOL=yes
+!CONFIG_MMST_PROTOCOL=yes
+!CONFIG_MD5_PROTOCOL=yes
+!CONFIG_PIPE_PROTOCOL=yes
+!CONFIG_PROMPEG_PROTOCOL=yes
+!CONFIG_RTMP_PROTOCOL=yes
+!CONFIG_RTMPE_PROTOCOL=yes
+!CONFIG_RTMPS_PROTOCOL=yes
+!CONFIG_RTMPT_PROTOCOL=yes
+!CONFIG_RTMPTE_PROTOCOL=yes
+!CONFIG_RTMPTS_PROTOCOL=yes
+!CONFIG_RTP_PROTOCOL=yes
+!CONFIG_SCTP_PROTOCOL=yes
+!CONFIG_SRTP_PROTOCOL=yes
+!CONFIG_SUBFILE_PROTOCOL=yes
+!CONFIG_TEE_PROTOCOL=yes
+!CONFIG_TCP_PROTOCOL=yes
+!CONFIG_TLS_PROTOCOL=yes
+!CONFIG_UDP_PROTOCOL=yes
+!CONFIG_UDPLITE_PROTOCOL=yes
+!CONFIG_UNIX_PROTOCOL=yes
+!CONFIG_LIBAMQP_PROTOCOL=yes
+!CONFIG_LIBRTMP_PROTOCOL=yes
+!CONFIG_LIBRTMPE_PROTOCOL=yes
+!CONFIG_LIBRTMPS_PROTOCOL=yes
+!CONFIG_LIBRTMPT_PROTOCOL=yes
+!CONFIG_LIBRTMPTE_PROTOCOL=yes
+!CONFIG_LIBSRT_PROTOCOL=yes
+!CONFIG_LIBSSH_PROTOCOL=yes
+!CONFIG_LIBSMBCLIENT_PROTOCOL=yes
+!CONFIG_LIBZMQ_PROTOCOL=yes
+endif # FFMPEG_CONFIG_MAK
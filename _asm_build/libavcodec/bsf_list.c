@@ -0,0 +1,2 @@
+static const AVBitStreamFilter * const bitstream_filters[] = {
+    NULL };
@@ -0,0 +1,2 @@
+static const AVCodec * const codec_list[] = {
+    NULL };
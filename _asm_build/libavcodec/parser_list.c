@@ -0,0 +1,2 @@
+static const AVCodecParser * const parser_list[] = {
+    NULL };
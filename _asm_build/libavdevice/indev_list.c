@@ -0,0 +1,2 @@
+static const AVInputFormat * const indev_list[] = {
+    NULL };
@@ -0,0 +1,2 @@
+static const AVInputFormat * const demuxer_list[] = {
+    NULL };
@@ -53,6 +53,12 @@
 #define DURATION_SHORTEST 1
 #define DURATION_FIRST    2
 
+/**
+ * Number of samples mixed at once from every input; the output block stays
+ * in cache while all inputs are accumulated into it. Must be a multiple of 16.
+ */
+#define MIX_BLOCK_SIZE    256
+
 
 typedef struct FrameInfo {
     int nb_samples;
@@ -164,6 +170,7 @@ typedef struct MixContext {
     int duration_mode;          /**< mode for determining duration */
     float dropout_transition;   /**< transition time when an input drops out */
     char *weights_str;          /**< string for custom weights for every input */
+    int eager;                  /**< output as soon as all active inputs have samples */
 
     int nb_channels;            /**< number of channels */
     int sample_rate;            /**< sample rate */
@@ -195,6 +202,8 @@ static const AVOption amix_options[] = {
             OFFSET(dropout_transition), AV_OPT_TYPE_FLOAT, { .dbl = 2.0 }, 0, INT_MAX, A|F },
     { "weights", "Set weight for each input.",
             OFFSET(weights_str), AV_OPT_TYPE_STRING, {.str="1 1"}, 0, 0, A|F|T },
+    { "eager", "Output as soon as all active inputs have samples.",
+            OFFSET(eager), AV_OPT_TYPE_BOOL, { .i64 = 0 }, 0, 1, A|F },
     { NULL }
 };
 
@@ -292,7 +301,7 @@ static int output_frame(AVFilterLink *outlink)
     AVFilterContext *ctx = outlink->src;
     MixContext      *s = ctx->priv;
     AVFrame *out_buf, *in_buf;
-    int nb_samples, ns, i;
+    int nb_samples, ns, i, start, planes;
 
     if (s->input_state[0] & INPUT_ON) {
         /* first input live: use the corresponding frame size */
@@ -301,10 +310,10 @@ static int output_frame(AVFilterLink *outlink)
             if (s->input_state[i] & INPUT_ON) {
                 ns = av_audio_fifo_size(s->fifos[i]);
                 if (ns < nb_samples) {
-                    if (!(s->input_state[i] & INPUT_EOF))
+                    if (!(s->input_state[i] & INPUT_EOF) && !(s->eager && ns > 0))
                         /* unclosed input with not enough samples */
                         return 0;
-                    /* closed input to drain */
+                    /* closed input to drain, or partial output */
                     nb_samples = ns;
                 }
             }
@@ -336,35 +345,43 @@ static int output_frame(AVFilterLink *outlink)
     if (!out_buf)
         return AVERROR(ENOMEM);
 
-    in_buf = ff_get_audio_buffer(outlink, nb_samples);
+    in_buf = ff_get_audio_buffer(outlink, FFMIN(nb_samples, MIX_BLOCK_SIZE));
     if (!in_buf) {
         av_frame_free(&out_buf);
         return AVERROR(ENOMEM);
     }
 
-    for (i = 0; i < s->nb_inputs; i++) {
-        if (s->input_state[i] & INPUT_ON) {
-            int planes, plane_size, p;
+    planes = s->planar ? s->nb_channels : 1;
+
+    /* Mix block by block, accumulating every input into the same output
+     * block before moving on, so the output is not streamed from memory
+     * once per input. */
+    for (start = 0; start < nb_samples; start += MIX_BLOCK_SIZE) {
+        const int block_samples = FFMIN(nb_samples - start, MIX_BLOCK_SIZE);
+        const int stride        = s->planar ? 1 : s->nb_channels;
+        const int offset        = start * stride;
+        const int plane_size    = FFALIGN(block_samples * stride, 16);
 
-            av_audio_fifo_read(s->fifos[i], (void **)in_buf->extended_data,
-                               nb_samples);
+        for (i = 0; i < s->nb_inputs; i++) {
+            if (s->input_state[i] & INPUT_ON) {
+                int p;
 
-            planes     = s->planar ? s->nb_channels : 1;
-            plane_size = nb_samples * (s->planar ? 1 : s->nb_channels);
-            plane_size = FFALIGN(plane_size, 16);
+                av_audio_fifo_read(s->fifos[i], (void **)in_buf->extended_data,
+                                   block_samples);
 
-            if (out_buf->format == AV_SAMPLE_FMT_FLT ||
-                out_buf->format == AV_SAMPLE_FMT_FLTP) {
-                for (p = 0; p < planes; p++) {
-                    s->fdsp->vector_fmac_scalar((float *)out_buf->extended_data[p],
-                                                (float *) in_buf->extended_data[p],
-                                                s->input_scale[i], plane_size);
-                }
-            } else {
-                for (p = 0; p < planes; p++) {
-                    s->fdsp->vector_dmac_scalar((double *)out_buf->extended_data[p],
-                                                (double *) in_buf->extended_data[p],
-                                                s->input_scale[i], plane_size);
+                if (out_buf->format == AV_SAMPLE_FMT_FLT ||
+                    out_buf->format == AV_SAMPLE_FMT_FLTP) {
+                    for (p = 0; p < planes; p++) {
+                        s->fdsp->vector_fmac_scalar((float *)out_buf->extended_data[p] + offset,
+                                                    (float *) in_buf->extended_data[p],
+                                                    s->input_scale[i], plane_size);
+                    }
+                } else {
+                    for (p = 0; p < planes; p++) {
+                        s->fdsp->vector_dmac_scalar((double *)out_buf->extended_data[p] + offset,
+                                                    (double *) in_buf->extended_data[p],
+                                                    s->input_scale[i], plane_size);
+                    }
                 }
             }
         }
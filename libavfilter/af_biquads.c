@@ -65,6 +65,7 @@
 #include "libavutil/avassert.h"
 #include "libavutil/ffmath.h"
 #include "libavutil/opt.h"
+#include "af_biquads.h"
 #include "audio.h"
 #include "avfilter.h"
 #include "internal.h"
@@ -121,6 +122,11 @@ typedef struct BiquadsContext {
     ChanCache *cache;
     int block_align;
 
+    BiquadsDSPContext dsp;
+    double lane_coeffs[7][BIQUADS_NB_LANES];
+    void (*filter_lanes)(uint8_t *const *dst, uint8_t *const *src, int len,
+                         double *state, const double *coeffs);
+
     void (*filter)(struct BiquadsContext *s, const void *ibuf, void *obuf, int len,
                    double *i1, double *i2, double *o1, double *o2,
                    double b0, double b1, double b2, double a1, double a2, int *clippings,
@@ -139,6 +145,8 @@ static av_cold int init(AVFilterContext *ctx)
         }
     }
 
+    ff_biquads_dsp_init(&s->dsp);
+
     return 0;
 }
 
@@ -258,6 +266,57 @@ BIQUAD_FILTER(s32, int32_t, INT32_MIN, INT32_MAX, 1)
 BIQUAD_FILTER(flt, float,   -1., 1., 0)
 BIQUAD_FILTER(dbl, double,  -1., 1., 0)
 
+#define BIQUAD_FILTER_LANES(name, type)                                       \
+static void biquad_lanes_## name (uint8_t *const *dst, uint8_t *const *src,   \
+                                  int len, double *state,                     \
+                                  const double *coeffs)                       \
+{                                                                             \
+    int i, l;                                                                 \
+                                                                              \
+    for (l = 0; l < BIQUADS_NB_LANES; l++) {                                  \
+        const type *ibuf = (const type *)src[l];                              \
+        type *obuf = (type *)dst[l];                                          \
+        const double b0  = coeffs[0 * BIQUADS_NB_LANES + l];                  \
+        const double b1  = coeffs[1 * BIQUADS_NB_LANES + l];                  \
+        const double b2  = coeffs[2 * BIQUADS_NB_LANES + l];                  \
+        const double a1  = coeffs[3 * BIQUADS_NB_LANES + l];                  \
+        const double a2  = coeffs[4 * BIQUADS_NB_LANES + l];                  \
+        const double wet = coeffs[5 * BIQUADS_NB_LANES + l];                  \
+        const double dry = coeffs[6 * BIQUADS_NB_LANES + l];                  \
+        double i1 = state[0 * BIQUADS_NB_LANES + l];                          \
+        double i2 = state[1 * BIQUADS_NB_LANES + l];                          \
+        double o1 = state[2 * BIQUADS_NB_LANES + l];                          \
+        double o2 = state[3 * BIQUADS_NB_LANES + l];                          \
+                                                                              \
+        for (i = 0; i < len; i++) {                                           \
+            double x  = ibuf[i];                                              \
+            double o0 = i2 * b2 + i1 * b1 + x * b0 + o2 * a2 + o1 * a1;       \
+            i2 = i1;                                                          \
+            i1 = x;                                                           \
+            o2 = o1;                                                          \
+            o1 = o0;                                                          \
+            obuf[i] = o0 * wet + x * dry;                                     \
+        }                                                                     \
+                                                                              \
+        state[0 * BIQUADS_NB_LANES + l] = i1;                                 \
+        state[1 * BIQUADS_NB_LANES + l] = i2;                                 \
+        state[2 * BIQUADS_NB_LANES + l] = o1;                                 \
+        state[3 * BIQUADS_NB_LANES + l] = o2;                                 \
+    }                                                                         \
+}
+
+BIQUAD_FILTER_LANES(flt, float)
+BIQUAD_FILTER_LANES(dbl, double)
+
+av_cold void ff_biquads_dsp_init(BiquadsDSPContext *s)
+{
+    s->filter_lanes_flt = biquad_lanes_flt;
+    s->filter_lanes_dbl = biquad_lanes_dbl;
+
+    if (ARCH_X86)
+        ff_biquads_dsp_init_x86(s);
+}
+
 static int config_filter(AVFilterLink *outlink, int reset)
 {
     AVFilterContext *ctx    = outlink->src;
@@ -267,6 +326,7 @@ static int config_filter(AVFilterLink *outlink, int reset)
     double w0 = 2 * M_PI * s->frequency / inlink->sample_rate;
     double K = tan(w0 / 2.);
     double alpha, beta;
+    int i;
 
     if (w0 > M_PI) {
         av_log(ctx, AV_LOG_ERROR,
@@ -437,14 +497,27 @@ static int config_filter(AVFilterLink *outlink, int reset)
     if (reset)
         memset(s->cache, 0, sizeof(ChanCache) * inlink->channels);
 
+    s->filter_lanes = NULL;
     switch (inlink->format) {
     case AV_SAMPLE_FMT_S16P: s->filter = biquad_s16; break;
     case AV_SAMPLE_FMT_S32P: s->filter = biquad_s32; break;
-    case AV_SAMPLE_FMT_FLTP: s->filter = biquad_flt; break;
-    case AV_SAMPLE_FMT_DBLP: s->filter = biquad_dbl; break;
+    case AV_SAMPLE_FMT_FLTP: s->filter = biquad_flt;
+                             s->filter_lanes = s->dsp.filter_lanes_flt; break;
+    case AV_SAMPLE_FMT_DBLP: s->filter = biquad_dbl;
+                             s->filter_lanes = s->dsp.filter_lanes_dbl; break;
     default: av_assert0(0);
     }
 
+    for (i = 0; i < BIQUADS_NB_LANES; i++) {
+        s->lane_coeffs[0][i] =  s->b0;
+        s->lane_coeffs[1][i] =  s->b1;
+        s->lane_coeffs[2][i] =  s->b2;
+        s->lane_coeffs[3][i] = -s->a1;
+        s->lane_coeffs[4][i] = -s->a2;
+        s->lane_coeffs[5][i] =  s->mix;
+        s->lane_coeffs[6][i] =  1. - s->mix;
+    }
+
     s->block_align = av_get_bytes_per_sample(inlink->format);
 
     return 0;
@@ -459,6 +532,36 @@ typedef struct ThreadData {
     AVFrame *in, *out;
 } ThreadData;
 
+static void filter_channel_lanes(BiquadsContext *s, AVFrame *buf, AVFrame *out_buf,
+                                 const int *chs)
+{
+    uint8_t *src[BIQUADS_NB_LANES], *dst[BIQUADS_NB_LANES];
+    double state[4][BIQUADS_NB_LANES];
+    int l;
+
+    for (l = 0; l < BIQUADS_NB_LANES; l++) {
+        ChanCache *cache = &s->cache[chs[l]];
+
+        src[l] = buf->extended_data[chs[l]];
+        dst[l] = out_buf->extended_data[chs[l]];
+        state[0][l] = cache->i1;
+        state[1][l] = cache->i2;
+        state[2][l] = cache->o1;
+        state[3][l] = cache->o2;
+    }
+
+    s->filter_lanes(dst, src, buf->nb_samples, &state[0][0], &s->lane_coeffs[0][0]);
+
+    for (l = 0; l < BIQUADS_NB_LANES; l++) {
+        ChanCache *cache = &s->cache[chs[l]];
+
+        cache->i1 = state[0][l];
+        cache->i2 = state[1][l];
+        cache->o1 = state[2][l];
+        cache->o2 = state[3][l];
+    }
+}
+
 static int filter_channel(AVFilterContext *ctx, void *arg, int jobnr, int nb_jobs)
 {
     AVFilterLink *inlink = ctx->inputs[0];
@@ -468,7 +571,9 @@ static int filter_channel(AVFilterContext *ctx, void *arg, int jobnr, int nb_job
     BiquadsContext *s = ctx->priv;
     const int start = (buf->channels * jobnr) / nb_jobs;
     const int end = (buf->channels * (jobnr+1)) / nb_jobs;
-    int ch;
+    const int use_lanes = s->filter_lanes && !ctx->is_disabled;
+    int chs[BIQUADS_NB_LANES];
+    int ch, nb_chs = 0;
 
     for (ch = start; ch < end; ch++) {
         if (!((av_channel_layout_extract_channel(inlink->channel_layout, ch) & s->channels))) {
@@ -478,11 +583,29 @@ static int filter_channel(AVFilterContext *ctx, void *arg, int jobnr, int nb_job
             continue;
         }
 
+        if (use_lanes) {
+            chs[nb_chs++] = ch;
+            if (nb_chs == BIQUADS_NB_LANES) {
+                filter_channel_lanes(s, buf, out_buf, chs);
+                nb_chs = 0;
+            }
+            continue;
+        }
+
         s->filter(s, buf->extended_data[ch], out_buf->extended_data[ch], buf->nb_samples,
                   &s->cache[ch].i1, &s->cache[ch].i2, &s->cache[ch].o1, &s->cache[ch].o2,
                   s->b0, s->b1, s->b2, s->a1, s->a2, &s->cache[ch].clippings, ctx->is_disabled);
     }
 
+    /* channels left over from the last group of lanes */
+    for (ch = 0; ch < nb_chs; ch++) {
+        ChanCache *cache = &s->cache[chs[ch]];
+
+        s->filter(s, buf->extended_data[chs[ch]], out_buf->extended_data[chs[ch]],
+                  buf->nb_samples, &cache->i1, &cache->i2, &cache->o1, &cache->o2,
+                  s->b0, s->b1, s->b2, s->a1, s->a2, &cache->clippings, 0);
+    }
+
     return 0;
 }
 
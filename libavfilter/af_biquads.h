@@ -0,0 +1,46 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef AVFILTER_BIQUADS_H
+#define AVFILTER_BIQUADS_H
+
+#include <stdint.h>
+
+/* number of channels filtered together by the lanes functions */
+#define BIQUADS_NB_LANES 4
+
+typedef struct BiquadsDSPContext {
+    /**
+     * Run the same biquad over BIQUADS_NB_LANES planar channels at once.
+     *
+     * @param dst    output planes, may be the same as src
+     * @param src    input planes
+     * @param len    number of samples per plane
+     * @param state  i1, i2, o1 and o2, each for all lanes, updated on return
+     * @param coeffs b0, b1, b2, -a1, -a2, wet and dry, each repeated for all lanes
+     */
+    void (*filter_lanes_flt)(uint8_t *const *dst, uint8_t *const *src, int len,
+                             double *state, const double *coeffs);
+    void (*filter_lanes_dbl)(uint8_t *const *dst, uint8_t *const *src, int len,
+                             double *state, const double *coeffs);
+} BiquadsDSPContext;
+
+void ff_biquads_dsp_init(BiquadsDSPContext *s);
+void ff_biquads_dsp_init_x86(BiquadsDSPContext *s);
+
+#endif /* AVFILTER_BIQUADS_H */
@@ -21,6 +21,7 @@
 #include "libavutil/opt.h"
 #include "libavutil/eval.h"
 #include "libavutil/avassert.h"
+#include "libavutil/thread.h"
 #include "libavcodec/avfft.h"
 #include "avfilter.h"
 #include "internal.h"
@@ -28,6 +29,7 @@
 
 #define RDFT_BITS_MIN 4
 #define RDFT_BITS_MAX 16
+#define MAX_NB_THREADS 32
 
 enum WindowFunc {
     WFUNC_RECTANGULAR,
@@ -67,9 +69,11 @@ typedef struct FIREqualizerContext {
 
     RDFTContext   *analysis_rdft;
     RDFTContext   *analysis_irdft;
-    RDFTContext   *rdft;
-    RDFTContext   *irdft;
-    FFTContext    *fft_ctx;
+    RDFTContext   *rdft[MAX_NB_THREADS];
+    RDFTContext   *irdft[MAX_NB_THREADS];
+    FFTContext    *fft_ctx[MAX_NB_THREADS];
+    int           nb_threads;
+    RDFTContext   *kernel_rdft;
     RDFTContext   *cepstrum_rdft;
     RDFTContext   *cepstrum_irdft;
     int           analysis_rdft_len;
@@ -80,9 +84,15 @@ typedef struct FIREqualizerContext {
     float         *dump_buf;
     float         *kernel_tmp_buf;
     float         *kernel_buf;
+    float         *kernel_old_buf;
     float         *cepstrum_buf;
     float         *conv_buf;
     OverlapIndex  *conv_idx;
+    float         *xfade_conv_buf;
+    OverlapIndex  *xfade_idx;
+    float         *xfade_buf;
+    unsigned      xfade_buf_size;
+    int           xfade;
     int           fir_len;
     int           nsamples_max;
     int64_t       next_pts;
@@ -105,9 +115,25 @@ typedef struct FIREqualizerContext {
     int           fft2;
     int           min_phase;
 
+    int           async;
+
     int           nb_gain_entry;
     int           gain_entry_err;
     GainEntry     gain_entry_tbl[NB_GAIN_ENTRY_MAX];
+
+#if HAVE_THREADS
+    /* with async, kernels requested by commands are built by this thread
+     * into kernel_tmp_buf, which it owns until kernel_ready is cleared */
+    pthread_t       builder;
+    pthread_mutex_t builder_lock;
+    pthread_cond_t  builder_cond;
+    int             builder_started;
+    int             builder_exit;
+    char            *pending_gain;
+    char            *pending_gain_entry;
+    int             build_pending;
+    int             kernel_ready;
+#endif
 } FIREqualizerContext;
 
 #define OFFSET(x) offsetof(FIREqualizerContext, x)
@@ -142,22 +168,55 @@ static const AVOption firequalizer_options[] = {
     { "dumpscale", "set dump scale", OFFSET(dumpscale), AV_OPT_TYPE_INT, { .i64 = SCALE_LINLOG }, 0, NB_SCALE-1, FLAGS, "scale" },
     { "fft2", "set 2-channels fft", OFFSET(fft2), AV_OPT_TYPE_BOOL, { .i64 = 0 }, 0, 1, FLAGS },
     { "min_phase", "set minimum phase mode", OFFSET(min_phase), AV_OPT_TYPE_BOOL, { .i64 = 0 }, 0, 1, FLAGS },
+    { "async", "build the kernels requested by commands in the background", OFFSET(async), AV_OPT_TYPE_BOOL, { .i64 = 0 }, 0, 1, FLAGS },
     { NULL }
 };
 
 AVFILTER_DEFINE_CLASS(firequalizer);
 
+static void stop_builder(FIREqualizerContext *s)
+{
+#if HAVE_THREADS
+    if (!s->builder_started)
+        return;
+
+    pthread_mutex_lock(&s->builder_lock);
+    s->builder_exit = 1;
+    pthread_cond_signal(&s->builder_cond);
+    pthread_mutex_unlock(&s->builder_lock);
+    pthread_join(s->builder, NULL);
+    pthread_cond_destroy(&s->builder_cond);
+    pthread_mutex_destroy(&s->builder_lock);
+
+    av_freep(&s->pending_gain);
+    av_freep(&s->pending_gain_entry);
+    s->builder_started = 0;
+    s->builder_exit    = 0;
+    s->build_pending   = 0;
+    s->kernel_ready    = 0;
+#endif
+}
+
 static void common_uninit(FIREqualizerContext *s)
 {
+    int i;
+
+    stop_builder(s);
+
     av_rdft_end(s->analysis_rdft);
     av_rdft_end(s->analysis_irdft);
-    av_rdft_end(s->rdft);
-    av_rdft_end(s->irdft);
-    av_fft_end(s->fft_ctx);
+    for (i = 0; i < MAX_NB_THREADS; i++) {
+        av_rdft_end(s->rdft[i]);
+        av_rdft_end(s->irdft[i]);
+        av_fft_end(s->fft_ctx[i]);
+        s->rdft[i] = s->irdft[i] = NULL;
+        s->fft_ctx[i] = NULL;
+    }
+    av_rdft_end(s->kernel_rdft);
     av_rdft_end(s->cepstrum_rdft);
     av_rdft_end(s->cepstrum_irdft);
-    s->analysis_rdft = s->analysis_irdft = s->rdft = s->irdft = NULL;
-    s->fft_ctx = NULL;
+    s->analysis_rdft = s->analysis_irdft = NULL;
+    s->kernel_rdft = NULL;
     s->cepstrum_rdft = NULL;
     s->cepstrum_irdft = NULL;
 
@@ -165,9 +224,15 @@ static void common_uninit(FIREqualizerContext *s)
     av_freep(&s->dump_buf);
     av_freep(&s->kernel_tmp_buf);
     av_freep(&s->kernel_buf);
+    av_freep(&s->kernel_old_buf);
     av_freep(&s->cepstrum_buf);
     av_freep(&s->conv_buf);
     av_freep(&s->conv_idx);
+    av_freep(&s->xfade_conv_buf);
+    av_freep(&s->xfade_idx);
+    av_freep(&s->xfade_buf);
+    s->xfade_buf_size = 0;
+    s->xfade = 0;
 }
 
 static av_cold void uninit(AVFilterContext *ctx)
@@ -209,7 +274,8 @@ static int query_formats(AVFilterContext *ctx)
     return ff_set_common_samplerates(ctx, formats);
 }
 
-static void fast_convolute(FIREqualizerContext *av_restrict s, const float *av_restrict kernel_buf, float *av_restrict conv_buf,
+static void fast_convolute(FIREqualizerContext *av_restrict s, RDFTContext *rdft, RDFTContext *irdft,
+                           const float *av_restrict kernel_buf, float *av_restrict conv_buf,
                            OverlapIndex *av_restrict idx, float *av_restrict data, int nsamples)
 {
     if (nsamples <= s->nsamples_max) {
@@ -221,7 +287,7 @@ static void fast_convolute(FIREqualizerContext *av_restrict s, const float *av_r
         memset(buf, 0, center * sizeof(*data));
         memcpy(buf + center, data, nsamples * sizeof(*data));
         memset(buf + center + nsamples, 0, (s->rdft_len - nsamples - center) * sizeof(*data));
-        av_rdft_calc(s->rdft, buf);
+        av_rdft_calc(rdft, buf);
 
         buf[0] *= kernel_buf[0];
         buf[1] *= kernel_buf[s->rdft_len/2];
@@ -230,7 +296,7 @@ static void fast_convolute(FIREqualizerContext *av_restrict s, const float *av_r
             buf[2*k+1] *= kernel_buf[k];
         }
 
-        av_rdft_calc(s->irdft, buf);
+        av_rdft_calc(irdft, buf);
         for (k = 0; k < s->rdft_len - idx->overlap_idx; k++)
             buf[k] += obuf[k];
         memcpy(data, buf, nsamples * sizeof(*data));
@@ -238,16 +304,17 @@ static void fast_convolute(FIREqualizerContext *av_restrict s, const float *av_r
         idx->overlap_idx = nsamples;
     } else {
         while (nsamples > s->nsamples_max * 2) {
-            fast_convolute(s, kernel_buf, conv_buf, idx, data, s->nsamples_max);
+            fast_convolute(s, rdft, irdft, kernel_buf, conv_buf, idx, data, s->nsamples_max);
             data += s->nsamples_max;
             nsamples -= s->nsamples_max;
         }
-        fast_convolute(s, kernel_buf, conv_buf, idx, data, nsamples/2);
-        fast_convolute(s, kernel_buf, conv_buf, idx, data + nsamples/2, nsamples - nsamples/2);
+        fast_convolute(s, rdft, irdft, kernel_buf, conv_buf, idx, data, nsamples/2);
+        fast_convolute(s, rdft, irdft, kernel_buf, conv_buf, idx, data + nsamples/2, nsamples - nsamples/2);
     }
 }
 
-static void fast_convolute_nonlinear(FIREqualizerContext *av_restrict s, const float *av_restrict kernel_buf,
+static void fast_convolute_nonlinear(FIREqualizerContext *av_restrict s, RDFTContext *rdft, RDFTContext *irdft,
+                                     const float *av_restrict kernel_buf,
                                      float *av_restrict conv_buf, OverlapIndex *av_restrict idx,
                                      float *av_restrict data, int nsamples)
 {
@@ -258,7 +325,7 @@ static void fast_convolute_nonlinear(FIREqualizerContext *av_restrict s, const f
 
         memcpy(buf, data, nsamples * sizeof(*data));
         memset(buf + nsamples, 0, (s->rdft_len - nsamples) * sizeof(*data));
-        av_rdft_calc(s->rdft, buf);
+        av_rdft_calc(rdft, buf);
 
         buf[0] *= kernel_buf[0];
         buf[1] *= kernel_buf[1];
@@ -270,7 +337,7 @@ static void fast_convolute_nonlinear(FIREqualizerContext *av_restrict s, const f
             buf[k+1] = im;
         }
 
-        av_rdft_calc(s->irdft, buf);
+        av_rdft_calc(irdft, buf);
         for (k = 0; k < s->rdft_len - idx->overlap_idx; k++)
             buf[k] += obuf[k];
         memcpy(data, buf, nsamples * sizeof(*data));
@@ -278,16 +345,17 @@ static void fast_convolute_nonlinear(FIREqualizerContext *av_restrict s, const f
         idx->overlap_idx = nsamples;
     } else {
         while (nsamples > s->nsamples_max * 2) {
-            fast_convolute_nonlinear(s, kernel_buf, conv_buf, idx, data, s->nsamples_max);
+            fast_convolute_nonlinear(s, rdft, irdft, kernel_buf, conv_buf, idx, data, s->nsamples_max);
             data += s->nsamples_max;
             nsamples -= s->nsamples_max;
         }
-        fast_convolute_nonlinear(s, kernel_buf, conv_buf, idx, data, nsamples/2);
-        fast_convolute_nonlinear(s, kernel_buf, conv_buf, idx, data + nsamples/2, nsamples - nsamples/2);
+        fast_convolute_nonlinear(s, rdft, irdft, kernel_buf, conv_buf, idx, data, nsamples/2);
+        fast_convolute_nonlinear(s, rdft, irdft, kernel_buf, conv_buf, idx, data + nsamples/2, nsamples - nsamples/2);
     }
 }
 
-static void fast_convolute2(FIREqualizerContext *av_restrict s, const float *av_restrict kernel_buf, FFTComplex *av_restrict conv_buf,
+static void fast_convolute2(FIREqualizerContext *av_restrict s, FFTContext *fft_ctx,
+                            const float *av_restrict kernel_buf, FFTComplex *av_restrict conv_buf,
                             OverlapIndex *av_restrict idx, float *av_restrict data0, float *av_restrict data1, int nsamples)
 {
     if (nsamples <= s->nsamples_max) {
@@ -303,8 +371,8 @@ static void fast_convolute2(FIREqualizerContext *av_restrict s, const float *av_
             buf[center+k].im = data1[k];
         }
         memset(buf + center + nsamples, 0, (s->rdft_len - nsamples - center) * sizeof(*buf));
-        av_fft_permute(s->fft_ctx, buf);
-        av_fft_calc(s->fft_ctx, buf);
+        av_fft_permute(fft_ctx, buf);
+        av_fft_calc(fft_ctx, buf);
 
         /* swap re <-> im, do backward fft using forward fft_ctx */
         /* normalize with 0.5f */
@@ -324,8 +392,8 @@ static void fast_convolute2(FIREqualizerContext *av_restrict s, const float *av_
         buf[k].re = 0.5f * kernel_buf[k] * buf[k].im;
         buf[k].im = 0.5f * kernel_buf[k] * tmp;
 
-        av_fft_permute(s->fft_ctx, buf);
-        av_fft_calc(s->fft_ctx, buf);
+        av_fft_permute(fft_ctx, buf);
+        av_fft_calc(fft_ctx, buf);
 
         for (k = 0; k < s->rdft_len - idx->overlap_idx; k++) {
             buf[k].re += obuf[k].re;
@@ -341,14 +409,88 @@ static void fast_convolute2(FIREqualizerContext *av_restrict s, const float *av_
         idx->overlap_idx = nsamples;
     } else {
         while (nsamples > s->nsamples_max * 2) {
-            fast_convolute2(s, kernel_buf, conv_buf, idx, data0, data1, s->nsamples_max);
+            fast_convolute2(s, fft_ctx, kernel_buf, conv_buf, idx, data0, data1, s->nsamples_max);
             data0 += s->nsamples_max;
             data1 += s->nsamples_max;
             nsamples -= s->nsamples_max;
         }
-        fast_convolute2(s, kernel_buf, conv_buf, idx, data0, data1, nsamples/2);
-        fast_convolute2(s, kernel_buf, conv_buf, idx, data0 + nsamples/2, data1 + nsamples/2, nsamples - nsamples/2);
+        fast_convolute2(s, fft_ctx, kernel_buf, conv_buf, idx, data0, data1, nsamples/2);
+        fast_convolute2(s, fft_ctx, kernel_buf, conv_buf, idx, data0 + nsamples/2, data1 + nsamples/2, nsamples - nsamples/2);
+    }
+}
+
+static void convolute_channels(FIREqualizerContext *s, int jobnr, const float *kernel_buf,
+                               float *conv_buf, OverlapIndex *idx, int ch,
+                               float *data0, float *data1, int nsamples)
+{
+    if (data1) {
+        fast_convolute2(s, s->fft_ctx[jobnr], kernel_buf, (FFTComplex *)conv_buf,
+                        idx, data0, data1, nsamples);
+    } else if (s->min_phase) {
+        fast_convolute_nonlinear(s, s->rdft[jobnr], s->irdft[jobnr],
+                                 kernel_buf + (s->multi ? ch * s->rdft_len : 0),
+                                 conv_buf, idx, data0, nsamples);
+    } else {
+        fast_convolute(s, s->rdft[jobnr], s->irdft[jobnr],
+                       kernel_buf + (s->multi ? ch * s->rdft_len : 0),
+                       conv_buf, idx, data0, nsamples);
+    }
+}
+
+static void crossfade(float *av_restrict data, const float *av_restrict old, int nsamples)
+{
+    float rcp = 1.0f / nsamples;
+    int k;
+
+    for (k = 0; k < nsamples; k++)
+        data[k] = old[k] + (k + 1) * rcp * (data[k] - old[k]);
+}
+
+/* with fft2, the first nb_pairs units are channel pairs, the rest single channels */
+static int filter_channels(AVFilterContext *ctx, void *arg, int jobnr, int nb_jobs)
+{
+    FIREqualizerContext *s = ctx->priv;
+    AVFrame *frame = arg;
+    int nb_pairs = s->fft_ctx[0] && !s->min_phase ? frame->channels / 2 : 0;
+    int nb_units = frame->channels - nb_pairs;
+    int start = (nb_units *  jobnr)      / nb_jobs;
+    int end   = (nb_units * (jobnr + 1)) / nb_jobs;
+    int nsamples = frame->nb_samples;
+    int u;
+
+    for (u = start; u < end; u++) {
+        int ch = u < nb_pairs ? 2 * u : u + nb_pairs;
+        int nb_ch = u < nb_pairs ? 2 : 1;
+        float *conv_buf = s->conv_buf + 2 * ch * s->rdft_len;
+        float *data0 = (float *)frame->extended_data[ch];
+        float *data1 = nb_ch == 2 ? (float *)frame->extended_data[ch+1] : NULL;
+
+        if (s->xfade) {
+            /* run the previous kernel on a copy of the state and fade to the new one */
+            float *xfade_conv_buf = s->xfade_conv_buf + 2 * ch * s->rdft_len;
+            float *xdata0 = s->xfade_buf + ch * nsamples;
+            float *xdata1 = data1 ? xdata0 + nsamples : NULL;
+
+            memcpy(xfade_conv_buf, conv_buf, nb_ch * 2 * s->rdft_len * sizeof(*conv_buf));
+            memcpy(s->xfade_idx + ch, s->conv_idx + ch, nb_ch * sizeof(*s->conv_idx));
+            memcpy(xdata0, data0, nsamples * sizeof(*data0));
+            if (data1)
+                memcpy(xdata1, data1, nsamples * sizeof(*data1));
+
+            convolute_channels(s, jobnr, s->kernel_old_buf, xfade_conv_buf, s->xfade_idx + ch,
+                               ch, xdata0, xdata1, nsamples);
+            convolute_channels(s, jobnr, s->kernel_buf, conv_buf, s->conv_idx + ch,
+                               ch, data0, data1, nsamples);
+            crossfade(data0, xdata0, nsamples);
+            if (data1)
+                crossfade(data1, xdata1, nsamples);
+        } else {
+            convolute_channels(s, jobnr, s->kernel_buf, conv_buf, s->conv_idx + ch,
+                               ch, data0, data1, nsamples);
+        }
     }
+
+    return 0;
 }
 
 static void dump_fir(AVFilterContext *ctx, FILE *fp, int ch)
@@ -599,6 +741,7 @@ static void generate_min_phase_kernel(FIREqualizerContext *s, float *rdft_buf)
 
 }
 
+/* builds the kernel into kernel_tmp_buf */
 static int generate_kernel(AVFilterContext *ctx, const char *gain, const char *gain_entry)
 {
     FIREqualizerContext *s = ctx->priv;
@@ -718,7 +861,7 @@ static int generate_kernel(AVFilterContext *ctx, const char *gain, const char *g
         memcpy(rdft_buf + s->rdft_len/2, s->analysis_buf + s->analysis_rdft_len - s->rdft_len/2, s->rdft_len/2 * sizeof(*s->analysis_buf));
         if (s->min_phase)
             generate_min_phase_kernel(s, rdft_buf);
-        av_rdft_calc(s->rdft, rdft_buf);
+        av_rdft_calc(s->kernel_rdft, rdft_buf);
 
         for (k = 0; k < s->rdft_len; k++) {
             if (isnan(rdft_buf[k]) || isinf(rdft_buf[k])) {
@@ -744,13 +887,23 @@ static int generate_kernel(AVFilterContext *ctx, const char *gain, const char *g
             break;
     }
 
-    memcpy(s->kernel_buf, s->kernel_tmp_buf, (s->multi ? inlink->channels : 1) * s->rdft_len * sizeof(*s->kernel_buf));
     av_expr_free(gain_expr);
     if (dump_fp)
         fclose(dump_fp);
     return 0;
 }
 
+/* with xfade, the next frame is crossfaded from the kernel in use until now */
+static void install_kernel(FIREqualizerContext *s, int nb_channels, int xfade)
+{
+    int size = (s->multi ? nb_channels : 1) * s->rdft_len * sizeof(*s->kernel_buf);
+
+    if (xfade && !s->xfade)
+        memcpy(s->kernel_old_buf, s->kernel_buf, size);
+    memcpy(s->kernel_buf, s->kernel_tmp_buf, size);
+    s->xfade |= xfade;
+}
+
 #define SELECT_GAIN(s) (s->gain_cmd ? s->gain_cmd : s->gain)
 #define SELECT_GAIN_ENTRY(s) (s->gain_entry_cmd ? s->gain_entry_cmd : s->gain_entry)
 
@@ -758,7 +911,7 @@ static int config_input(AVFilterLink *inlink)
 {
     AVFilterContext *ctx = inlink->dst;
     FIREqualizerContext *s = ctx->priv;
-    int rdft_bits;
+    int rdft_bits, i, ret;
 
     common_uninit(s);
 
@@ -780,10 +933,16 @@ static int config_input(AVFilterLink *inlink)
         return AVERROR(EINVAL);
     }
 
-    if (!(s->rdft = av_rdft_init(rdft_bits, DFT_R2C)) || !(s->irdft = av_rdft_init(rdft_bits, IDFT_C2R)))
-        return AVERROR(ENOMEM);
+    /* the transform contexts keep scratch buffers, use one set per thread */
+    s->nb_threads = FFMIN3(ff_filter_get_nb_threads(ctx), inlink->channels, MAX_NB_THREADS);
+    for (i = 0; i < s->nb_threads; i++) {
+        if (!(s->rdft[i] = av_rdft_init(rdft_bits, DFT_R2C)) || !(s->irdft[i] = av_rdft_init(rdft_bits, IDFT_C2R)))
+            return AVERROR(ENOMEM);
 
-    if (s->fft2 && !s->multi && inlink->channels > 1 && !(s->fft_ctx = av_fft_init(rdft_bits, 0)))
+        if (s->fft2 && !s->multi && inlink->channels > 1 && !(s->fft_ctx[i] = av_fft_init(rdft_bits, 0)))
+            return AVERROR(ENOMEM);
+    }
+    if (!(s->kernel_rdft = av_rdft_init(rdft_bits, DFT_R2C)))
         return AVERROR(ENOMEM);
 
     if (s->min_phase) {
@@ -827,9 +986,13 @@ static int config_input(AVFilterLink *inlink)
     s->analysis_buf = av_malloc_array(s->analysis_rdft_len, sizeof(*s->analysis_buf));
     s->kernel_tmp_buf = av_malloc_array(s->rdft_len * (s->multi ? inlink->channels : 1), sizeof(*s->kernel_tmp_buf));
     s->kernel_buf = av_malloc_array(s->rdft_len * (s->multi ? inlink->channels : 1), sizeof(*s->kernel_buf));
+    s->kernel_old_buf = av_malloc_array(s->rdft_len * (s->multi ? inlink->channels : 1), sizeof(*s->kernel_old_buf));
     s->conv_buf   = av_calloc(2 * s->rdft_len * inlink->channels, sizeof(*s->conv_buf));
     s->conv_idx   = av_calloc(inlink->channels, sizeof(*s->conv_idx));
-    if (!s->analysis_buf || !s->kernel_tmp_buf || !s->kernel_buf || !s->conv_buf || !s->conv_idx)
+    s->xfade_conv_buf = av_malloc_array(2 * s->rdft_len * inlink->channels, sizeof(*s->xfade_conv_buf));
+    s->xfade_idx  = av_malloc_array(inlink->channels, sizeof(*s->xfade_idx));
+    if (!s->analysis_buf || !s->kernel_tmp_buf || !s->kernel_buf || !s->kernel_old_buf ||
+        !s->conv_buf || !s->conv_idx || !s->xfade_conv_buf || !s->xfade_idx)
         return AVERROR(ENOMEM);
 
     av_log(ctx, AV_LOG_DEBUG, "sample_rate = %d, channels = %d, analysis_rdft_len = %d, rdft_len = %d, fir_len = %d, nsamples_max = %d.\n",
@@ -838,35 +1001,47 @@ static int config_input(AVFilterLink *inlink)
     if (s->fixed)
         inlink->min_samples = inlink->max_samples = inlink->partial_buf_size = s->nsamples_max;
 
-    return generate_kernel(ctx, SELECT_GAIN(s), SELECT_GAIN_ENTRY(s));
+    ret = generate_kernel(ctx, SELECT_GAIN(s), SELECT_GAIN_ENTRY(s));
+    if (ret < 0)
+        return ret;
+    install_kernel(s, inlink->channels, 0);
+    return 0;
 }
 
 static int filter_frame(AVFilterLink *inlink, AVFrame *frame)
 {
     AVFilterContext *ctx = inlink->dst;
     FIREqualizerContext *s = ctx->priv;
-    int ch;
-
-    if (!s->min_phase) {
-        for (ch = 0; ch + 1 < inlink->channels && s->fft_ctx; ch += 2) {
-            fast_convolute2(s, s->kernel_buf, (FFTComplex *)(s->conv_buf + 2 * ch * s->rdft_len),
-                            s->conv_idx + ch, (float *) frame->extended_data[ch],
-                            (float *) frame->extended_data[ch+1], frame->nb_samples);
+    int nb_units = inlink->channels;
+
+    if (s->fft_ctx[0] && !s->min_phase)
+        nb_units -= inlink->channels / 2;
+
+#if HAVE_THREADS
+    if (s->builder_started) {
+        pthread_mutex_lock(&s->builder_lock);
+        if (s->kernel_ready) {
+            install_kernel(s, inlink->channels, 1);
+            s->kernel_ready = 0;
+            pthread_cond_signal(&s->builder_cond);
         }
-
-        for ( ; ch < inlink->channels; ch++) {
-            fast_convolute(s, s->kernel_buf + (s->multi ? ch * s->rdft_len : 0),
-                        s->conv_buf + 2 * ch * s->rdft_len, s->conv_idx + ch,
-                        (float *) frame->extended_data[ch], frame->nb_samples);
-        }
-    } else {
-        for (ch = 0; ch < inlink->channels; ch++) {
-            fast_convolute_nonlinear(s, s->kernel_buf + (s->multi ? ch * s->rdft_len : 0),
-                                     s->conv_buf + 2 * ch * s->rdft_len, s->conv_idx + ch,
-                                     (float *) frame->extended_data[ch], frame->nb_samples);
+        pthread_mutex_unlock(&s->builder_lock);
+    }
+#endif
+
+    if (s->xfade) {
+        av_fast_malloc(&s->xfade_buf, &s->xfade_buf_size,
+                       inlink->channels * frame->nb_samples * sizeof(*s->xfade_buf));
+        if (!s->xfade_buf) {
+            s->xfade_buf_size = 0;
+            av_frame_free(&frame);
+            return AVERROR(ENOMEM);
         }
     }
 
+    ctx->internal->execute(ctx, filter_channels, frame, NULL, FFMIN(nb_units, s->nb_threads));
+    s->xfade = 0;
+
     s->next_pts = AV_NOPTS_VALUE;
     if (frame->pts != AV_NOPTS_VALUE) {
         s->next_pts = frame->pts + av_rescale_q(frame->nb_samples, av_make_q(1, inlink->sample_rate), inlink->time_base);
@@ -899,6 +1074,129 @@ static int request_frame(AVFilterLink *outlink)
     return ret;
 }
 
+#if HAVE_THREADS
+static void *attribute_align_arg builder_thread(void *arg)
+{
+    AVFilterContext *ctx = arg;
+    FIREqualizerContext *s = ctx->priv;
+
+    pthread_mutex_lock(&s->builder_lock);
+    while (!s->builder_exit) {
+        char *gain, *gain_entry;
+        int ret;
+
+        if (!s->build_pending || s->kernel_ready) {
+            pthread_cond_wait(&s->builder_cond, &s->builder_lock);
+            continue;
+        }
+
+        /* only the latest request is built */
+        gain       = s->pending_gain;
+        gain_entry = s->pending_gain_entry;
+        s->pending_gain = s->pending_gain_entry = NULL;
+        s->build_pending = 0;
+        pthread_mutex_unlock(&s->builder_lock);
+
+        ret = generate_kernel(ctx, gain, gain_entry);
+        if (ret < 0)
+            av_log(ctx, AV_LOG_ERROR, "building the kernel failed, keeping the previous one.\n");
+        av_freep(&gain);
+        av_freep(&gain_entry);
+
+        pthread_mutex_lock(&s->builder_lock);
+        s->kernel_ready = ret >= 0;
+    }
+    pthread_mutex_unlock(&s->builder_lock);
+
+    return NULL;
+}
+
+/* errors in the expressions are reported here, even when the kernel is built
+ * in the background */
+static int check_expressions(AVFilterContext *ctx, const char *gain, const char *gain_entry)
+{
+    const char *gain_entry_func_names[] = { "entry", NULL };
+    const char *gain_func_names[] = { "gain_interpolate", "cubic_interpolate", NULL };
+    double (*gain_entry_funcs[])(void *, double, double) = { entry_func, NULL };
+    double (*gain_funcs[])(void *, double) = { gain_interpolate_func, cubic_interpolate_func, NULL };
+    AVExpr *expr;
+    int ret;
+
+    if (gain_entry) {
+        if ((ret = av_expr_parse(&expr, gain_entry, NULL, NULL, NULL,
+                                 gain_entry_func_names, gain_entry_funcs, 0, ctx)) < 0)
+            return ret;
+        av_expr_free(expr);
+    }
+    if ((ret = av_expr_parse(&expr, gain, var_names,
+                             gain_func_names, gain_funcs, NULL, NULL, 0, ctx)) < 0)
+        return ret;
+    av_expr_free(expr);
+    return 0;
+}
+
+/* hand the new kernel to the builder thread, started on the first request */
+static int request_kernel(AVFilterContext *ctx, const char *gain, const char *gain_entry)
+{
+    FIREqualizerContext *s = ctx->priv;
+    char *pending_gain = av_strdup(gain);
+    char *pending_gain_entry = gain_entry ? av_strdup(gain_entry) : NULL;
+    int ret;
+
+    if (!pending_gain || (gain_entry && !pending_gain_entry)) {
+        ret = AVERROR(ENOMEM);
+        goto fail;
+    }
+
+    if (!s->builder_started) {
+        pthread_mutex_init(&s->builder_lock, NULL);
+        pthread_cond_init(&s->builder_cond, NULL);
+        if ((ret = pthread_create(&s->builder, NULL, builder_thread, ctx))) {
+            pthread_cond_destroy(&s->builder_cond);
+            pthread_mutex_destroy(&s->builder_lock);
+            ret = AVERROR(ret);
+            goto fail;
+        }
+        s->builder_started = 1;
+    }
+
+    pthread_mutex_lock(&s->builder_lock);
+    av_freep(&s->pending_gain);
+    av_freep(&s->pending_gain_entry);
+    s->pending_gain       = pending_gain;
+    s->pending_gain_entry = pending_gain_entry;
+    s->build_pending      = 1;
+    pthread_cond_signal(&s->builder_cond);
+    pthread_mutex_unlock(&s->builder_lock);
+    return 0;
+
+fail:
+    av_freep(&pending_gain);
+    av_freep(&pending_gain_entry);
+    return ret;
+}
+#endif
+
+/* keep the kernel in use until the next frame has been crossfaded from it */
+static int update_kernel(AVFilterContext *ctx, const char *gain, const char *gain_entry)
+{
+    FIREqualizerContext *s = ctx->priv;
+    int ret;
+
+#if HAVE_THREADS
+    if (s->async) {
+        if ((ret = check_expressions(ctx, gain, gain_entry)) < 0)
+            return ret;
+        return request_kernel(ctx, gain, gain_entry);
+    }
+#endif
+
+    ret = generate_kernel(ctx, gain, gain_entry);
+    if (ret >= 0)
+        install_kernel(s, ctx->inputs[0]->channels, 1);
+    return ret;
+}
+
 static int process_command(AVFilterContext *ctx, const char *cmd, const char *args,
                            char *res, int res_len, int flags)
 {
@@ -917,7 +1215,7 @@ static int process_command(AVFilterContext *ctx, const char *cmd, const char *ar
         if (!gain_cmd)
             return AVERROR(ENOMEM);
 
-        ret = generate_kernel(ctx, gain_cmd, SELECT_GAIN_ENTRY(s));
+        ret = update_kernel(ctx, gain_cmd, SELECT_GAIN_ENTRY(s));
         if (ret >= 0) {
             av_freep(&s->gain_cmd);
             s->gain_cmd = gain_cmd;
@@ -936,7 +1234,7 @@ static int process_command(AVFilterContext *ctx, const char *cmd, const char *ar
         if (!gain_entry_cmd)
             return AVERROR(ENOMEM);
 
-        ret = generate_kernel(ctx, SELECT_GAIN(s), gain_entry_cmd);
+        ret = update_kernel(ctx, SELECT_GAIN(s), gain_entry_cmd);
         if (ret >= 0) {
             av_freep(&s->gain_entry_cmd);
             s->gain_entry_cmd = gain_entry_cmd;
@@ -978,4 +1276,5 @@ AVFilter ff_af_firequalizer = {
     .inputs             = firequalizer_inputs,
     .outputs            = firequalizer_outputs,
     .priv_class         = &firequalizer_class,
+    .flags              = AVFILTER_FLAG_SLICE_THREADS,
 };
@@ -20,6 +20,7 @@
 
 /* http://k.ylo.ph/2016/04/04/loudnorm.html */
 
+#include "libavutil/audio_fifo.h"
 #include "libavutil/opt.h"
 #include "avfilter.h"
 #include "internal.h"
@@ -31,6 +32,7 @@ enum FrameType {
     INNER_FRAME,
     FINAL_FRAME,
     LINEAR_MODE,
+    LOOKAHEAD_MODE,
     FRAME_NB
 };
 
@@ -60,6 +62,7 @@ typedef struct LoudNormContext {
     double measured_thresh;
     double offset;
     int linear;
+    int64_t lookahead;
     int dual_mono;
     enum PrintFormat print_format;
 
@@ -93,6 +96,9 @@ typedef struct LoudNormContext {
 
     FFEBUR128State *r128_in;
     FFEBUR128State *r128_out;
+
+    AVAudioFifo *lookahead_fifo;
+    int64_t lookahead_samples;
 } LoudNormContext;
 
 #define OFFSET(x) offsetof(LoudNormContext, x)
@@ -114,6 +120,7 @@ static const AVOption loudnorm_options[] = {
     { "measured_thresh",  "measured threshold of input file",  OFFSET(measured_thresh),  AV_OPT_TYPE_DOUBLE,  {.dbl = -70.},   -99.,        0.,  FLAGS },
     { "offset",           "set offset gain",                   OFFSET(offset),           AV_OPT_TYPE_DOUBLE,  {.dbl =  0.},    -99.,       99.,  FLAGS },
     { "linear",           "normalize linearly if possible",    OFFSET(linear),           AV_OPT_TYPE_BOOL,    {.i64 =  1},        0,         1,  FLAGS },
+    { "lookahead",        "measure and normalize linearly in one pass", OFFSET(lookahead), AV_OPT_TYPE_DURATION, {.i64 = 0},  0, 3600000000LL, FLAGS },
     { "dual_mono",        "treat mono input as dual-mono",     OFFSET(dual_mono),        AV_OPT_TYPE_BOOL,    {.i64 =  0},        0,         1,  FLAGS },
     { "print_format",     "set print format for stats",        OFFSET(print_format),     AV_OPT_TYPE_INT,     {.i64 =  NONE},  NONE,  PF_NB -1,  FLAGS, "print_format" },
     {     "none",         0,                                   0,                        AV_OPT_TYPE_CONST,   {.i64 =  NONE},     0,         0,  FLAGS, "print_format" },
@@ -406,6 +413,80 @@ static void true_peak_limiter(LoudNormContext *s, double *out, int nb_samples, i
     }
 }
 
+/**
+ * Derive the linear gain from what has been measured so far, limited so
+ * that the output sample peak does not exceed the target. Unlike the
+ * dynamic mode no true peak limiter runs afterwards, so inter-sample peaks
+ * may still exceed it slightly.
+ */
+static void lookahead_set_gain(AVFilterContext *ctx)
+{
+    LoudNormContext *s = ctx->priv;
+    double global, lra, peak = 0.;
+    int c;
+
+    ff_ebur128_loudness_global(s->r128_in, &global);
+    ff_ebur128_loudness_range(s->r128_in, &lra);
+    for (c = 0; c < s->channels; c++) {
+        double tmp;
+        ff_ebur128_sample_peak(s->r128_in, c, &tmp);
+        peak = FFMAX(peak, tmp);
+    }
+
+    s->offset = 1.;
+    if (isfinite(global) && global > -70.) {
+        s->offset = pow(10., (s->target_i - global) / 20.);
+        if (peak * s->offset > s->target_tp)
+            s->offset = s->target_tp / peak;
+    }
+    if (lra > s->target_lra)
+        av_log(ctx, AV_LOG_WARNING, "Measured LRA %.2f LU exceeds the target, "
+               "it is left untouched by linear normalization.\n", lra);
+
+    av_log(ctx, AV_LOG_VERBOSE, "lookahead: I:%.2f LUFS peak:%.2f dBFS gain:%.2f dB\n",
+           global, 20. * log10(peak), 20. * log10(s->offset));
+    s->frame_type = LINEAR_MODE;
+}
+
+/**
+ * Apply the linear gain to all the samples queued in the lookahead FIFO and
+ * send them in frames of 100ms.
+ */
+static int lookahead_flush(AVFilterContext *ctx)
+{
+    LoudNormContext *s = ctx->priv;
+    AVFilterLink *inlink  = ctx->inputs[0];
+    AVFilterLink *outlink = ctx->outputs[0];
+    const int max_samples = frame_size(inlink->sample_rate, 100);
+    int ret;
+
+    lookahead_set_gain(ctx);
+
+    while (av_audio_fifo_size(s->lookahead_fifo) > 0) {
+        const int nb_samples = FFMIN(av_audio_fifo_size(s->lookahead_fifo), max_samples);
+        AVFrame *out = ff_get_audio_buffer(outlink, nb_samples);
+        double *dst;
+        int n;
+
+        if (!out)
+            return AVERROR(ENOMEM);
+        av_audio_fifo_read(s->lookahead_fifo, (void **)out->extended_data, nb_samples);
+
+        dst = (double *)out->data[0];
+        for (n = 0; n < nb_samples * inlink->channels; n++)
+            dst[n] *= s->offset;
+        ff_ebur128_add_frames_double(s->r128_out, dst, nb_samples);
+
+        out->pts = s->pts;
+        s->pts += nb_samples;
+        ret = ff_filter_frame(outlink, out);
+        if (ret < 0)
+            return ret;
+    }
+
+    return 0;
+}
+
 static int filter_frame(AVFilterLink *inlink, AVFrame *in)
 {
     AVFilterContext *ctx = inlink->dst;
@@ -420,6 +501,21 @@ static int filter_frame(AVFilterLink *inlink, AVFrame *in)
     double gain, gain_next, env_global, env_shortterm,
     global, shortterm, lra, relative_threshold;
 
+    if (s->frame_type == LOOKAHEAD_MODE) {
+        int ret;
+
+        if (s->pts == AV_NOPTS_VALUE)
+            s->pts = in->pts;
+        ff_ebur128_add_frames_double(s->r128_in, (const double *)in->data[0], in->nb_samples);
+        ret = av_audio_fifo_write(s->lookahead_fifo, (void **)in->extended_data, in->nb_samples);
+        av_frame_free(&in);
+        if (ret < 0)
+            return ret;
+        if (av_audio_fifo_size(s->lookahead_fifo) < s->lookahead_samples)
+            return 0;
+        return lookahead_flush(ctx);
+    }
+
     if (av_frame_is_writable(in)) {
         out = in;
     } else {
@@ -645,7 +741,11 @@ static int request_frame(AVFilterLink *outlink)
     LoudNormContext *s = ctx->priv;
 
     ret = ff_request_frame(inlink);
-    if (ret == AVERROR_EOF && s->frame_type == INNER_FRAME) {
+    if (ret == AVERROR_EOF && s->frame_type == LOOKAHEAD_MODE) {
+        if (!s->lookahead_fifo || !av_audio_fifo_size(s->lookahead_fifo))
+            return ret;
+        ret = lookahead_flush(ctx);
+    } else if (ret == AVERROR_EOF && s->frame_type == INNER_FRAME) {
         double *src;
         double *buf;
         int nb_samples, n, c, offset;
@@ -710,7 +810,7 @@ static int query_formats(AVFilterContext *ctx)
     if (ret < 0)
         return ret;
 
-    if (s->frame_type != LINEAR_MODE) {
+    if (s->frame_type != LINEAR_MODE && s->frame_type != LOOKAHEAD_MODE) {
         formats = ff_make_format_list(input_srate);
         if (!formats)
             return AVERROR(ENOMEM);
@@ -759,7 +859,20 @@ static int config_input(AVFilterLink *inlink)
 
     init_gaussian_filter(s);
 
-    if (s->frame_type != LINEAR_MODE) {
+    if (s->frame_type == LOOKAHEAD_MODE) {
+        /* the FIFO doubles its size when it grows, keep that within an int */
+        const int64_t max_samples = INT_MAX / (4 * inlink->channels * sizeof(double));
+
+        s->lookahead_samples = FFMAX(1, av_rescale(s->lookahead, inlink->sample_rate, AV_TIME_BASE));
+        if (s->lookahead_samples > max_samples) {
+            av_log(ctx, AV_LOG_WARNING, "lookahead limited to %"PRId64" samples.\n", max_samples);
+            s->lookahead_samples = max_samples;
+        }
+        s->lookahead_fifo = av_audio_fifo_alloc(inlink->format, inlink->channels,
+                                                frame_size(inlink->sample_rate, 100));
+        if (!s->lookahead_fifo)
+            return AVERROR(ENOMEM);
+    } else if (s->frame_type != LINEAR_MODE) {
         inlink->min_samples =
         inlink->max_samples =
         inlink->partial_buf_size = frame_size(inlink->sample_rate, 3000);
@@ -796,6 +909,9 @@ static av_cold int init(AVFilterContext *ctx)
                 s->offset = offset;
             }
         }
+
+        if (s->frame_type != LINEAR_MODE && s->lookahead)
+            s->frame_type = LOOKAHEAD_MODE;
     }
 
     return 0;
@@ -898,6 +1014,8 @@ end:
     av_freep(&s->limiter_buf);
     av_freep(&s->prev_smp);
     av_freep(&s->buf);
+    if (s->lookahead_fifo)
+        av_audio_fifo_free(s->lookahead_fifo);
 }
 
 static const AVFilterPad avfilter_af_loudnorm_inputs[] = {
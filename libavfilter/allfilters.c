@@ -243,6 +243,7 @@ extern AVFilter ff_vf_format;
 extern AVFilter ff_vf_fps;
 extern AVFilter ff_vf_framepack;
 extern AVFilter ff_vf_framerate;
+extern AVFilter ff_vf_framestats;
 extern AVFilter ff_vf_framestep;
 extern AVFilter ff_vf_freezedetect;
 extern AVFilter ff_vf_freezeframes;
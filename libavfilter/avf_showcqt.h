@@ -80,9 +80,12 @@ typedef struct ShowCQTContext {
                                     int len, int fft_len);
     void                (*permute_coeffs)(float *v, int len);
     void                (*draw_bar)(AVFrame *out, const float *h, const float *rcp_h,
-                                    const ColorFloat *c, int bar_h, float bar_t);
-    void                (*draw_axis)(AVFrame *out, AVFrame *axis, const ColorFloat *c, int off);
-    void                (*draw_sono)(AVFrame *out, AVFrame *sono, int off, int idx);
+                                    const ColorFloat *c, int bar_h, float bar_t,
+                                    int y_start, int y_end);
+    void                (*draw_axis)(AVFrame *out, AVFrame *axis, const ColorFloat *c, int off,
+                                     int y_start, int y_end);
+    void                (*draw_sono)(AVFrame *out, AVFrame *sono, int off, int idx,
+                                     int y_start, int y_end);
     void                (*update_sono)(AVFrame *sono, const ColorFloat *c, int idx);
     /* performance debugging */
     int64_t             fft_time;
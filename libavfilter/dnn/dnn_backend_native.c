@@ -113,7 +113,7 @@ static DNNReturnType set_input_output_native(void *model, DNNData *input, const
 // layers_num,layer_type,layer_parameterss,layer_type,layer_parameters...
 // For CONV layer: activation_function, input_num, output_num, kernel_size, kernel, biases
 // For DEPTH_TO_SPACE layer: block_size
-DNNModel *ff_dnn_load_model_native(const char *model_filename)
+DNNModel *ff_dnn_load_model_native(const char *model_filename, AVFilterContext *filter_ctx)
 {
     DNNModel *model = NULL;
     char header_expected[] = "FFMPEGDNNNATIVE";
@@ -179,6 +179,7 @@ DNNModel *ff_dnn_load_model_native(const char *model_filename)
         return NULL;
     }
     model->model = (void *)network;
+    network->filter_ctx = filter_ctx;
 
     avio_seek(model_file_context, file_size - 8, SEEK_SET);
     network->layers_num = (int32_t)avio_rl32(model_file_context);
@@ -276,7 +277,8 @@ DNNReturnType ff_dnn_execute_model_native(const DNNModel *model, DNNData *output
         layer_funcs[layer_type].pf_exec(network->operands,
                                   network->layers[layer].input_operand_indexes,
                                   network->layers[layer].output_operand_index,
-                                  network->layers[layer].params);
+                                  network->layers[layer].params,
+                                  network->filter_ctx);
     }
 
     for (uint32_t i = 0; i < nb; ++i) {
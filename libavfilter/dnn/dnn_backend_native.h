@@ -112,9 +112,10 @@ typedef struct ConvolutionalNetwork{
     int32_t operands_num;
     int32_t *output_indexes;
     uint32_t nb_output;
+    AVFilterContext *filter_ctx;
 } ConvolutionalNetwork;
 
-DNNModel *ff_dnn_load_model_native(const char *model_filename);
+DNNModel *ff_dnn_load_model_native(const char *model_filename, AVFilterContext *filter_ctx);
 
 DNNReturnType ff_dnn_execute_model_native(const DNNModel *model, DNNData *outputs, uint32_t nb_output);
 
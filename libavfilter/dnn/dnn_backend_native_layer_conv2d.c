@@ -19,6 +19,7 @@
  */
 
 #include "libavutil/avassert.h"
+#include "libavfilter/internal.h"
 #include "dnn_backend_native_layer_conv2d.h"
 
 #define CLAMP_TO_EDGE(x, w) ((x) < 0 ? 0 : ((x) >= (w) ? (w - 1) : (x)))
@@ -83,39 +84,35 @@ int dnn_load_layer_conv2d(Layer *layer, AVIOContext *model_file_context, int fil
     return dnn_size;
 }
 
-int dnn_execute_layer_conv2d(DnnOperand *operands, const int32_t *input_operand_indexes,
-                             int32_t output_operand_index, const void *parameters)
-{
+typedef struct ThreadData{
+    const float *input;
     float *output;
-    int32_t input_operand_index = input_operand_indexes[0];
-    int number = operands[input_operand_index].dims[0];
-    int height = operands[input_operand_index].dims[1];
-    int width = operands[input_operand_index].dims[2];
-    int channel = operands[input_operand_index].dims[3];
-    const float *input = operands[input_operand_index].data;
-    const ConvolutionalParams *conv_params = (const ConvolutionalParams *)parameters;
+    const ConvolutionalParams *conv_params;
+    int height, width;
+    int pad_size;
+} ThreadData;
+
+static int dnn_execute_layer_conv2d_slice(AVFilterContext *ctx, void *arg,
+                                          int jobnr, int nb_jobs)
+{
+    const ThreadData *td = arg;
+    const ConvolutionalParams *conv_params = td->conv_params;
+    const float *input = td->input;
+    const int height = td->height;
+    const int width = td->width;
+    const int pad_size = td->pad_size;
+    const int slice_start = pad_size + ((height - pad_size * 2) *  jobnr     ) / nb_jobs;
+    const int slice_end   = pad_size + ((height - pad_size * 2) * (jobnr + 1)) / nb_jobs;
 
     int radius = conv_params->kernel_size >> 1;
     int src_linesize = width * conv_params->input_num;
     int filter_linesize = conv_params->kernel_size * conv_params->input_num;
     int filter_size = conv_params->kernel_size * filter_linesize;
-    int pad_size = (conv_params->padding_method == VALID) ? (conv_params->kernel_size - 1) / 2 * conv_params->dilation : 0;
-
-    DnnOperand *output_operand = &operands[output_operand_index];
-    output_operand->dims[0] = number;
-    output_operand->dims[1] = height - pad_size * 2;
-    output_operand->dims[2] = width - pad_size * 2;
-    output_operand->dims[3] = conv_params->output_num;
-    output_operand->data_type = operands[input_operand_index].data_type;
-    output_operand->length = calculate_operand_data_length(output_operand);
-    output_operand->data = av_realloc(output_operand->data, output_operand->length);
-    if (!output_operand->data)
-        return -1;
-    output = output_operand->data;
 
-    av_assert0(channel == conv_params->input_num);
+    float *output = td->output + (slice_start - pad_size) *
+                    (width - pad_size * 2) * conv_params->output_num;
 
-    for (int y = pad_size; y < height - pad_size; ++y) {
+    for (int y = slice_start; y < slice_end; ++y) {
         for (int x = pad_size; x < width - pad_size; ++x) {
             for (int n_filter = 0; n_filter < conv_params->output_num; ++n_filter) {
                 if (conv_params->has_bias)
@@ -165,3 +162,46 @@ int dnn_execute_layer_conv2d(DnnOperand *operands, const int32_t *input_operand_
     }
     return 0;
 }
+
+int dnn_execute_layer_conv2d(DnnOperand *operands, const int32_t *input_operand_indexes,
+                             int32_t output_operand_index, const void *parameters,
+                             AVFilterContext *filter_ctx)
+{
+    int32_t input_operand_index = input_operand_indexes[0];
+    int number = operands[input_operand_index].dims[0];
+    int height = operands[input_operand_index].dims[1];
+    int width = operands[input_operand_index].dims[2];
+    int channel = operands[input_operand_index].dims[3];
+    const ConvolutionalParams *conv_params = (const ConvolutionalParams *)parameters;
+    int pad_size = (conv_params->padding_method == VALID) ? (conv_params->kernel_size - 1) / 2 * conv_params->dilation : 0;
+    ThreadData td;
+
+    DnnOperand *output_operand = &operands[output_operand_index];
+    output_operand->dims[0] = number;
+    output_operand->dims[1] = height - pad_size * 2;
+    output_operand->dims[2] = width - pad_size * 2;
+    output_operand->dims[3] = conv_params->output_num;
+    output_operand->data_type = operands[input_operand_index].data_type;
+    output_operand->length = calculate_operand_data_length(output_operand);
+    output_operand->data = av_realloc(output_operand->data, output_operand->length);
+    if (!output_operand->data)
+        return -1;
+
+    av_assert0(channel == conv_params->input_num);
+
+    td.input = operands[input_operand_index].data;
+    td.output = output_operand->data;
+    td.conv_params = conv_params;
+    td.height = height;
+    td.width = width;
+    td.pad_size = pad_size;
+
+    // every job gets at least one output row
+    if (filter_ctx)
+        filter_ctx->internal->execute(filter_ctx, dnn_execute_layer_conv2d_slice, &td, NULL,
+                                      av_clip(height - pad_size * 2, 1, ff_filter_get_nb_threads(filter_ctx)));
+    else
+        dnn_execute_layer_conv2d_slice(NULL, &td, 0, 1);
+
+    return 0;
+}
@@ -46,6 +46,7 @@
 #include <float.h>
 #include <limits.h>
 #include <math.h>               /* You may have to define _USE_MATH_DEFINES if you use MSVC */
+#include <string.h>
 
 #include "libavutil/common.h"
 #include "libavutil/mem.h"
@@ -317,6 +318,10 @@ static void ebur128_filter_##type(FFEBUR128State* st, const type** srcs,
                                   size_t src_index, size_t frames,                 \
                                   int stride) {                                    \
     double* audio_data = st->d->audio_data + st->d->audio_data_index;              \
+    const double a1 = st->d->a[1], a2 = st->d->a[2];                               \
+    const double a3 = st->d->a[3], a4 = st->d->a[4];                               \
+    const double b0 = st->d->b[0], b1 = st->d->b[1], b2 = st->d->b[2];             \
+    const double b3 = st->d->b[3], b4 = st->d->b[4];                               \
     size_t i, c;                                                                   \
                                                                                    \
     if ((st->mode & FF_EBUR128_MODE_SAMPLE_PEAK) == FF_EBUR128_MODE_SAMPLE_PEAK) { \
@@ -336,29 +341,37 @@ static void ebur128_filter_##type(FFEBUR128State* st, const type** srcs,
     }                                                                              \
     for (c = 0; c < st->channels; ++c) {                                           \
         int ci = st->d->channel_map[c] - 1;                                        \
+        double v0, v1, v2, v3, v4;                                                 \
         if (ci < 0) continue;                                                      \
         else if (ci == FF_EBUR128_DUAL_MONO - 1) ci = 0; /*dual mono */            \
+        /* keep the filter state in locals, it cannot alias audio_data */          \
+        v1 = st->d->v[ci][1];                                                      \
+        v2 = st->d->v[ci][2];                                                      \
+        v3 = st->d->v[ci][3];                                                      \
+        v4 = st->d->v[ci][4];                                                      \
         for (i = 0; i < frames; ++i) {                                             \
-            st->d->v[ci][0] = (double) (srcs[c][src_index + i * stride] / scaling_factor) \
-                         - st->d->a[1] * st->d->v[ci][1]                           \
-                         - st->d->a[2] * st->d->v[ci][2]                           \
-                         - st->d->a[3] * st->d->v[ci][3]                           \
-                         - st->d->a[4] * st->d->v[ci][4];                          \
+            v0 = (double) (srcs[c][src_index + i * stride] / scaling_factor)       \
+                         - a1 * v1                                                 \
+                         - a2 * v2                                                 \
+                         - a3 * v3                                                 \
+                         - a4 * v4;                                                \
             audio_data[i * st->channels + c] =                                     \
-                           st->d->b[0] * st->d->v[ci][0]                           \
-                         + st->d->b[1] * st->d->v[ci][1]                           \
-                         + st->d->b[2] * st->d->v[ci][2]                           \
-                         + st->d->b[3] * st->d->v[ci][3]                           \
-                         + st->d->b[4] * st->d->v[ci][4];                          \
-            st->d->v[ci][4] = st->d->v[ci][3];                                     \
-            st->d->v[ci][3] = st->d->v[ci][2];                                     \
-            st->d->v[ci][2] = st->d->v[ci][1];                                     \
-            st->d->v[ci][1] = st->d->v[ci][0];                                     \
+                           b0 * v0                                                 \
+                         + b1 * v1                                                 \
+                         + b2 * v2                                                 \
+                         + b3 * v3                                                 \
+                         + b4 * v4;                                                \
+            v4 = v3;                                                               \
+            v3 = v2;                                                               \
+            v2 = v1;                                                               \
+            v1 = v0;                                                               \
         }                                                                          \
-        st->d->v[ci][4] = fabs(st->d->v[ci][4]) < DBL_MIN ? 0.0 : st->d->v[ci][4]; \
-        st->d->v[ci][3] = fabs(st->d->v[ci][3]) < DBL_MIN ? 0.0 : st->d->v[ci][3]; \
-        st->d->v[ci][2] = fabs(st->d->v[ci][2]) < DBL_MIN ? 0.0 : st->d->v[ci][2]; \
-        st->d->v[ci][1] = fabs(st->d->v[ci][1]) < DBL_MIN ? 0.0 : st->d->v[ci][1]; \
+        if (frames)                                                                \
+            st->d->v[ci][0] = v1;                                                  \
+        st->d->v[ci][4] = fabs(v4) < DBL_MIN ? 0.0 : v4;                           \
+        st->d->v[ci][3] = fabs(v3) < DBL_MIN ? 0.0 : v3;                           \
+        st->d->v[ci][2] = fabs(v2) < DBL_MIN ? 0.0 : v2;                           \
+        st->d->v[ci][1] = fabs(v1) < DBL_MIN ? 0.0 : v1;                           \
     }                                                                              \
 }
 EBUR128_FILTER(short, -((double)SHRT_MIN))
@@ -767,3 +780,106 @@ int ff_ebur128_sample_peak(FFEBUR128State * st,
     *out = st->d->sample_peak[channel_number];
     return 0;
 }
+
+#define TRUE_PEAK_TAPS  49
+#define TRUE_PEAK_CHUNK 1024
+
+struct FFEBUR128TruePeak {
+    unsigned int channels;
+    /** Oversampling factor. */
+    int factor;
+    /** Number of input samples each output sample depends on. */
+    int phase_taps;
+    /** Filter coefficients, oldest input sample first, with the
+     *  coefficients of all phases interleaved. */
+    double *coeffs;
+    /** The last phase_taps - 1 input samples followed by the current
+     *  chunk, for each channel. */
+    double *history;
+};
+
+FFEBUR128TruePeak *ff_ebur128_true_peak_init(unsigned int channels,
+                                             unsigned long samplerate)
+{
+    FFEBUR128TruePeak *tp;
+    const int factor = samplerate < 96000 ? 4 : samplerate < 192000 ? 2 : 1;
+    int j;
+
+    tp = av_mallocz(sizeof(*tp));
+    if (!tp)
+        return NULL;
+    tp->channels   = channels;
+    tp->factor     = factor;
+    tp->phase_taps = (TRUE_PEAK_TAPS + factor - 1) / factor;
+    tp->coeffs     = av_calloc(tp->phase_taps * factor, sizeof(*tp->coeffs));
+    tp->history    = av_calloc(channels * (tp->phase_taps - 1 + TRUE_PEAK_CHUNK),
+                               sizeof(*tp->history));
+    if (!tp->coeffs || !tp->history) {
+        ff_ebur128_true_peak_destroy(&tp);
+        return NULL;
+    }
+
+    /* Hann-windowed sinc cut at the input Nyquist frequency; tap j of the
+     * zero-stuffed signal belongs to phase j % factor. */
+    for (j = 0; j < TRUE_PEAK_TAPS; j++) {
+        const double m = j - (TRUE_PEAK_TAPS - 1) / 2.0;
+        double c = 1.0;
+
+        if (fabs(m) > ALMOST_ZERO)
+            c = sin(m * M_PI / factor) / (m * M_PI / factor);
+        c *= 0.5 * (1.0 - cos(2.0 * M_PI * j / (TRUE_PEAK_TAPS - 1)));
+        if (fabs(c) > ALMOST_ZERO)
+            tp->coeffs[(tp->phase_taps - 1 - j / factor) * factor + j % factor] = c;
+    }
+
+    return tp;
+}
+
+void ff_ebur128_true_peak_destroy(FFEBUR128TruePeak ** tp)
+{
+    if (!*tp)
+        return;
+    av_free((*tp)->coeffs);
+    av_free((*tp)->history);
+    av_freep(tp);
+}
+
+void ff_ebur128_true_peak_add_frames_double(FFEBUR128TruePeak * tp,
+                                            const double *src, size_t frames,
+                                            double *peaks)
+{
+    const int factor = tp->factor;
+    const int phase_taps = tp->phase_taps;
+    const int history = phase_taps - 1;
+    unsigned int c;
+
+    for (c = 0; c < tp->channels; c++) {
+        double *x = tp->history + c * (history + TRUE_PEAK_CHUNK);
+        double peak = 0.0;
+        size_t done = 0;
+
+        while (done < frames) {
+            const size_t n = FFMIN(frames - done, TRUE_PEAK_CHUNK);
+            size_t i;
+
+            for (i = 0; i < n; i++)
+                x[history + i] = src[(done + i) * tp->channels + c];
+
+            for (i = 0; i < n; i++) {
+                const double *h = tp->coeffs;
+                double sum[4] = { 0.0 };
+                int f, k;
+
+                for (k = 0; k < phase_taps; k++, h += factor)
+                    for (f = 0; f < factor; f++)
+                        sum[f] += h[f] * x[i + k];
+                for (f = 0; f < factor; f++)
+                    peak = FFMAX(peak, fabs(sum[f]));
+            }
+
+            memmove(x, x + n, history * sizeof(*x));
+            done += n;
+        }
+        peaks[c] = peak;
+    }
+}
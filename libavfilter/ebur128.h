@@ -293,4 +293,38 @@ int ff_ebur128_sample_peak(FFEBUR128State * st,
  */
 int ff_ebur128_relative_threshold(FFEBUR128State * st, double *out);
 
+/** \brief Polyphase FIR oversampler used for true-peak measurement.
+ *
+ *  The audio is oversampled 4 times below 96 kHz and 2 times below 192 kHz
+ *  through a 49-tap windowed sinc, as suggested in ITU-R BS.1770-4 Annex 2.
+ */
+typedef struct FFEBUR128TruePeak FFEBUR128TruePeak;
+
+/** \brief Initialize a true-peak oversampler.
+ *
+ *  @param channels the number of channels.
+ *  @param samplerate the sample rate.
+ *  @return an initialized oversampler on success, NULL on error.
+ */
+FFEBUR128TruePeak *ff_ebur128_true_peak_init(unsigned int channels,
+                                             unsigned long samplerate);
+
+/** \brief Destroy a true-peak oversampler.
+ *
+ *  @param tp pointer to the oversampler, set to NULL on return.
+ */
+void ff_ebur128_true_peak_destroy(FFEBUR128TruePeak ** tp);
+
+/** \brief Oversample interleaved frames and measure their peaks.
+ *
+ *  @param tp true-peak oversampler
+ *  @param src array of source frames. Channels must be interleaved.
+ *  @param frames number of frames.
+ *  @param peaks set to the maximum absolute oversampled value of each
+ *               channel in these frames (1.0 is 0 dBTP).
+ */
+void ff_ebur128_true_peak_add_frames_double(FFEBUR128TruePeak * tp,
+                                            const double *src, size_t frames,
+                                            double *peaks);
+
 #endif                          /* AVFILTER_EBUR128_H */
@@ -37,9 +37,9 @@
 #include "libavutil/xga_font_data.h"
 #include "libavutil/opt.h"
 #include "libavutil/timestamp.h"
-#include "libswresample/swresample.h"
 #include "audio.h"
 #include "avfilter.h"
+#include "ebur128.h"
 #include "formats.h"
 #include "internal.h"
 
@@ -86,6 +86,9 @@ struct integrator {
     double sum_kept_powers;         ///< sum of the powers (weighted sums) above absolute threshold
     int nb_kept_powers;             ///< number of sum above absolute threshold
     struct hist_entry *histogram;   ///< histogram of the powers, used to compute LRA and I
+    int gate_hist_pos;              ///< histogram position of the relative threshold
+    double gated_energy;            ///< sum of the histogram energies from gate_hist_pos
+    int nb_gated;                   ///< number of histogram entries from gate_hist_pos
 };
 
 struct rect { int x, y, w, h; };
@@ -98,11 +101,7 @@ typedef struct EBUR128Context {
     double *true_peaks;             ///< true peaks per channel
     double *sample_peaks;           ///< sample peaks per channel
     double *true_peaks_per_frame;   ///< true peaks in a frame per channel
-#if CONFIG_SWRESAMPLE
-    SwrContext *swr_ctx;            ///< over-sampling context for true peak metering
-    double *swr_buf;                ///< resampled audio data for true peak metering
-    int swr_linesize;
-#endif
+    FFEBUR128TruePeak *true_peak;   ///< polyphase oversampler for true peak metering
 
     /* video  */
     int do_video;                   ///< 1 if video output enabled, 0 otherwise
@@ -390,10 +389,7 @@ static int config_audio_input(AVFilterLink *inlink)
 
     /* Force 100ms framing in case of metadata injection: the frames must have
      * a granularity of the window overlap to be accurately exploited.
-     * As for the true peaks mode, it just simplifies the resampling buffer
-     * allocation and the lookup in it (since sample buffers differ in size, it
-     * can be more complex to integrate in the one-sample loop of
-     * filter_frame()). */
+     * The true peaks per frame are also reported over these 100ms. */
     if (ebur128->metadata || (ebur128->peak_mode & PEAK_MODE_TRUE_PEAKS))
         inlink->min_samples =
         inlink->max_samples =
@@ -439,31 +435,14 @@ static int config_audio_output(AVFilterLink *outlink)
             return AVERROR(ENOMEM);
     }
 
-#if CONFIG_SWRESAMPLE
     if (ebur128->peak_mode & PEAK_MODE_TRUE_PEAKS) {
-        int ret;
-
-        ebur128->swr_buf    = av_malloc_array(nb_channels, 19200 * sizeof(double));
         ebur128->true_peaks = av_calloc(nb_channels, sizeof(*ebur128->true_peaks));
         ebur128->true_peaks_per_frame = av_calloc(nb_channels, sizeof(*ebur128->true_peaks_per_frame));
-        ebur128->swr_ctx    = swr_alloc();
-        if (!ebur128->swr_buf || !ebur128->true_peaks ||
-            !ebur128->true_peaks_per_frame || !ebur128->swr_ctx)
+        ebur128->true_peak  = ff_ebur128_true_peak_init(nb_channels, outlink->sample_rate);
+        if (!ebur128->true_peaks || !ebur128->true_peaks_per_frame ||
+            !ebur128->true_peak)
             return AVERROR(ENOMEM);
-
-        av_opt_set_int(ebur128->swr_ctx, "in_channel_layout",    outlink->channel_layout, 0);
-        av_opt_set_int(ebur128->swr_ctx, "in_sample_rate",       outlink->sample_rate, 0);
-        av_opt_set_sample_fmt(ebur128->swr_ctx, "in_sample_fmt", outlink->format, 0);
-
-        av_opt_set_int(ebur128->swr_ctx, "out_channel_layout",    outlink->channel_layout, 0);
-        av_opt_set_int(ebur128->swr_ctx, "out_sample_rate",       192000, 0);
-        av_opt_set_sample_fmt(ebur128->swr_ctx, "out_sample_fmt", outlink->format, 0);
-
-        ret = swr_init(ebur128->swr_ctx);
-        if (ret < 0)
-            return ret;
     }
-#endif
 
     if (ebur128->peak_mode & PEAK_MODE_SAMPLES_PEAKS) {
         ebur128->sample_peaks = av_calloc(nb_channels, sizeof(*ebur128->sample_peaks));
@@ -506,12 +485,6 @@ static av_cold int init(AVFilterContext *ctx)
             ebur128->loglevel = AV_LOG_INFO;
     }
 
-    if (!CONFIG_SWRESAMPLE && (ebur128->peak_mode & PEAK_MODE_TRUE_PEAKS)) {
-        av_log(ctx, AV_LOG_ERROR,
-               "True-peak mode requires libswresample to be performed\n");
-        return AVERROR(EINVAL);
-    }
-
     // if meter is  +9 scale, scale range is from -18 LU to  +9 LU (or 3*9)
     // if meter is +18 scale, scale range is from -36 LU to +18 LU (or 3*18)
     ebur128->scale_range = 3 * ebur128->meter;
@@ -561,7 +534,10 @@ static av_cold int init(AVFilterContext *ctx)
 #define HIST_POS(power) (int)(((power) - ABS_THRES) * HIST_GRAIN)
 
 /* loudness and power should be set such as loudness = -0.691 +
- * 10*log10(power), we just avoid doing that calculus two times */
+ * 10*log10(power), we just avoid doing that calculus two times.
+ * The count and energy sums of the histogram entries above the relative
+ * threshold are updated as the threshold moves, so that the gated values
+ * never need a scan of the whole histogram. */
 static int gate_update(struct integrator *integ, double power,
                        double loudness, int gate_thres)
 {
@@ -572,6 +548,10 @@ static int gate_update(struct integrator *integ, double power,
     /* update powers histograms by incrementing current power count */
     ipower = av_clip(HIST_POS(loudness), 0, HIST_SIZE - 1);
     integ->histogram[ipower].count++;
+    if (ipower >= integ->gate_hist_pos) {
+        integ->nb_gated++;
+        integ->gated_energy += integ->histogram[ipower].energy;
+    }
 
     /* compute relative threshold and get its position in the histogram */
     integ->sum_kept_powers += power;
@@ -582,93 +562,137 @@ static int gate_update(struct integrator *integ, double power,
     integ->rel_threshold = LOUDNESS(relative_threshold) + gate_thres;
     gate_hist_pos = av_clip(HIST_POS(integ->rel_threshold), 0, HIST_SIZE - 1);
 
+    /* move the gate to its new position in the histogram */
+    for (; integ->gate_hist_pos < gate_hist_pos; integ->gate_hist_pos++) {
+        const struct hist_entry *h = &integ->histogram[integ->gate_hist_pos];
+        integ->nb_gated     -= h->count;
+        integ->gated_energy -= h->count * h->energy;
+    }
+    for (; integ->gate_hist_pos > gate_hist_pos; integ->gate_hist_pos--) {
+        const struct hist_entry *h = &integ->histogram[integ->gate_hist_pos - 1];
+        integ->nb_gated     += h->count;
+        integ->gated_energy += h->count * h->energy;
+    }
+
     return gate_hist_pos;
 }
 
-static int filter_frame(AVFilterLink *inlink, AVFrame *insamples)
+/**
+ * Apply the K-weighting filters to nb_samples interleaved samples and add
+ * them to the 400ms and 3s integrators.
+ *
+ * Channels are processed one after the other, so that the filter states and
+ * window sums stay in registers for the whole run.
+ */
+static void filter_samples(EBUR128Context *ebur128, const double *samples, int nb_samples)
 {
-    int i, ch, idx_insample;
-    AVFilterContext *ctx = inlink->dst;
-    EBUR128Context *ebur128 = ctx->priv;
     const int nb_channels = ebur128->nb_channels;
-    const int nb_samples  = insamples->nb_samples;
-    const double *samples = (double *)insamples->data[0];
-    AVFrame *pic = ebur128->outpicref;
-
-#if CONFIG_SWRESAMPLE
-    if (ebur128->peak_mode & PEAK_MODE_TRUE_PEAKS) {
-        const double *swr_samples = ebur128->swr_buf;
-        int ret = swr_convert(ebur128->swr_ctx, (uint8_t**)&ebur128->swr_buf, 19200,
-                              (const uint8_t **)insamples->data, nb_samples);
-        if (ret < 0)
-            return ret;
-        for (ch = 0; ch < nb_channels; ch++)
-            ebur128->true_peaks_per_frame[ch] = 0.0;
-        for (idx_insample = 0; idx_insample < ret; idx_insample++) {
-            for (ch = 0; ch < nb_channels; ch++) {
-                ebur128->true_peaks[ch] = FFMAX(ebur128->true_peaks[ch], fabs(*swr_samples));
-                ebur128->true_peaks_per_frame[ch] = FFMAX(ebur128->true_peaks_per_frame[ch],
-                                                          fabs(*swr_samples));
-                swr_samples++;
-            }
+    int ch, i;
+
+    for (ch = 0; ch < nb_channels; ch++) {
+        const double *src = samples + ch;
+        double *cache_400  = ebur128->i400.cache[ch];
+        double *cache_3000 = ebur128->i3000.cache[ch];
+        double *x = ebur128->x + ch*3;
+        double *y = ebur128->y + ch*3;
+        double *z = ebur128->z + ch*3;
+        double x0 = x[0], x1 = x[1], x2 = x[2];
+        double y0 = y[0], y1 = y[1], y2 = y[2];
+        double z0 = z[0], z1 = z[1], z2 = z[2];
+        double sum_400  = ebur128->i400.sum[ch];
+        double sum_3000 = ebur128->i3000.sum[ch];
+        int bin_id_400  = ebur128->i400.cache_pos;
+        int bin_id_3000 = ebur128->i3000.cache_pos;
+
+        if (ebur128->peak_mode & PEAK_MODE_SAMPLES_PEAKS) {
+            double peak = ebur128->sample_peaks[ch];
+
+            for (i = 0; i < nb_samples; i++)
+                peak = FFMAX(peak, fabs(src[i * nb_channels]));
+            ebur128->sample_peaks[ch] = peak;
         }
-    }
-#endif
 
-    for (idx_insample = 0; idx_insample < nb_samples; idx_insample++) {
-        const int bin_id_400  = ebur128->i400.cache_pos;
-        const int bin_id_3000 = ebur128->i3000.cache_pos;
-
-#define MOVE_TO_NEXT_CACHED_ENTRY(time) do {                \
-    ebur128->i##time.cache_pos++;                           \
-    if (ebur128->i##time.cache_pos == I##time##_BINS) {     \
-        ebur128->i##time.filled    = 1;                     \
-        ebur128->i##time.cache_pos = 0;                     \
-    }                                                       \
-} while (0)
-
-        MOVE_TO_NEXT_CACHED_ENTRY(400);
-        MOVE_TO_NEXT_CACHED_ENTRY(3000);
+        if (!ebur128->ch_weighting[ch])
+            continue;
 
-        for (ch = 0; ch < nb_channels; ch++) {
+        for (i = 0; i < nb_samples; i++) {
             double bin;
 
-            if (ebur128->peak_mode & PEAK_MODE_SAMPLES_PEAKS)
-                ebur128->sample_peaks[ch] = FFMAX(ebur128->sample_peaks[ch], fabs(*samples));
-
-            ebur128->x[ch * 3] = *samples++; // set X[i]
-
-            if (!ebur128->ch_weighting[ch])
-                continue;
+            x0 = src[i * nb_channels];
 
             /* Y[i] = X[i]*b0 + X[i-1]*b1 + X[i-2]*b2 - Y[i-1]*a1 - Y[i-2]*a2 */
-#define FILTER(Y, X, name) do {                                                 \
-            double *dst = ebur128->Y + ch*3;                                    \
-            double *src = ebur128->X + ch*3;                                    \
-            dst[2] = dst[1];                                                    \
-            dst[1] = dst[0];                                                    \
-            dst[0] = src[0]*name##_B0 + src[1]*name##_B1 + src[2]*name##_B2     \
-                                      - dst[1]*name##_A1 - dst[2]*name##_A2;    \
-} while (0)
-
-            // TODO: merge both filters in one?
-            FILTER(y, x, PRE);  // apply pre-filter
-            ebur128->x[ch * 3 + 2] = ebur128->x[ch * 3 + 1];
-            ebur128->x[ch * 3 + 1] = ebur128->x[ch * 3    ];
-            FILTER(z, y, RLB);  // apply RLB-filter
+            y2 = y1;
+            y1 = y0;
+            y0 = x0*PRE_B0 + x1*PRE_B1 + x2*PRE_B2 - y1*PRE_A1 - y2*PRE_A2;
+            x2 = x1;
+            x1 = x0;
+            z2 = z1;
+            z1 = z0;
+            z0 = y0*RLB_B0 + y1*RLB_B1 + y2*RLB_B2 - z1*RLB_A1 - z2*RLB_A2;
 
-            bin = ebur128->z[ch * 3] * ebur128->z[ch * 3];
+            bin = z0 * z0;
 
             /* add the new value, and limit the sum to the cache size (400ms or 3s)
              * by removing the oldest one */
-            ebur128->i400.sum [ch] = ebur128->i400.sum [ch] + bin - ebur128->i400.cache [ch][bin_id_400];
-            ebur128->i3000.sum[ch] = ebur128->i3000.sum[ch] + bin - ebur128->i3000.cache[ch][bin_id_3000];
+            sum_400  = sum_400  + bin - cache_400 [bin_id_400];
+            sum_3000 = sum_3000 + bin - cache_3000[bin_id_3000];
 
             /* override old cache entry with the new value */
-            ebur128->i400.cache [ch][bin_id_400 ] = bin;
-            ebur128->i3000.cache[ch][bin_id_3000] = bin;
+            cache_400 [bin_id_400 ] = bin;
+            cache_3000[bin_id_3000] = bin;
+
+            if (++bin_id_400 == I400_BINS)
+                bin_id_400 = 0;
+            if (++bin_id_3000 == I3000_BINS)
+                bin_id_3000 = 0;
         }
 
+        x[0] = x0; x[1] = x1; x[2] = x2;
+        y[0] = y0; y[1] = y1; y[2] = y2;
+        z[0] = z0; z[1] = z1; z[2] = z2;
+        ebur128->i400.sum[ch]  = sum_400;
+        ebur128->i3000.sum[ch] = sum_3000;
+    }
+
+#define MOVE_CACHE_POS(time) do {                                   \
+    ebur128->i##time.cache_pos += nb_samples;                       \
+    if (ebur128->i##time.cache_pos >= I##time##_BINS) {             \
+        ebur128->i##time.filled     = 1;                            \
+        ebur128->i##time.cache_pos -= I##time##_BINS;               \
+    }                                                               \
+} while (0)
+
+    MOVE_CACHE_POS(400);
+    MOVE_CACHE_POS(3000);
+}
+
+static int filter_frame(AVFilterLink *inlink, AVFrame *insamples)
+{
+    int i, ch, idx_insample;
+    AVFilterContext *ctx = inlink->dst;
+    EBUR128Context *ebur128 = ctx->priv;
+    const int nb_channels = ebur128->nb_channels;
+    const int nb_samples  = insamples->nb_samples;
+    const double *samples = (double *)insamples->data[0];
+    AVFrame *pic = ebur128->outpicref;
+
+    if (ebur128->peak_mode & PEAK_MODE_TRUE_PEAKS) {
+        ff_ebur128_true_peak_add_frames_double(ebur128->true_peak, samples, nb_samples,
+                                               ebur128->true_peaks_per_frame);
+        for (ch = 0; ch < nb_channels; ch++)
+            ebur128->true_peaks[ch] = FFMAX(ebur128->true_peaks[ch],
+                                            ebur128->true_peaks_per_frame[ch]);
+    }
+
+    for (idx_insample = 0; idx_insample < nb_samples; idx_insample++) {
+        /* process all the samples up to the next gating block at once */
+        const int run = FFMIN(nb_samples - idx_insample, 4800 - ebur128->sample_count);
+
+        filter_samples(ebur128, samples, run);
+        samples               += run * nb_channels;
+        idx_insample          += run - 1;
+        ebur128->sample_count += run - 1;
+
         /* For integrated loudness, gating blocks are 400ms long with 75%
          * overlap (see BS.1770-2 p5), so a re-computation is needed each 100ms
          * (4800 samples at 48kHz). */
@@ -699,20 +723,13 @@ static int filter_frame(AVFilterLink *inlink, AVFrame *insamples)
 #define I_GATE_THRES -10  // initially defined to -8 LU in the first EBU standard
 
             if (loudness_400 >= ABS_THRES) {
-                double integrated_sum = 0;
-                int nb_integrated = 0;
-                int gate_hist_pos = gate_update(&ebur128->i400, power_400,
-                                                loudness_400, I_GATE_THRES);
-
-                /* compute integrated loudness by summing the histogram values
-                 * above the relative threshold */
-                for (i = gate_hist_pos; i < HIST_SIZE; i++) {
-                    const int nb_v = ebur128->i400.histogram[i].count;
-                    nb_integrated  += nb_v;
-                    integrated_sum += nb_v * ebur128->i400.histogram[i].energy;
-                }
-                if (nb_integrated) {
-                    ebur128->integrated_loudness = LOUDNESS(integrated_sum / nb_integrated);
+                gate_update(&ebur128->i400, power_400, loudness_400, I_GATE_THRES);
+
+                /* integrated loudness from the histogram values above the
+                 * relative threshold */
+                if (ebur128->i400.nb_gated) {
+                    ebur128->integrated_loudness = LOUDNESS(ebur128->i400.gated_energy /
+                                                            ebur128->i400.nb_gated);
                     /* dual-mono correction */
                     if (nb_channels == 1 && ebur128->dual_mono) {
                         ebur128->integrated_loudness -= ebur128->pan_law;
@@ -728,12 +745,10 @@ static int filter_frame(AVFilterLink *inlink, AVFrame *insamples)
             /* XXX: example code in EBU 3342 is ">=" but formula in BS.1770
              * specs is ">" */
             if (loudness_3000 >= ABS_THRES) {
-                int nb_powers = 0;
                 int gate_hist_pos = gate_update(&ebur128->i3000, power_3000,
                                                 loudness_3000, LRA_GATE_THRES);
+                const int nb_powers = ebur128->i3000.nb_gated;
 
-                for (i = gate_hist_pos; i < HIST_SIZE; i++)
-                    nb_powers += ebur128->i3000.histogram[i].count;
                 if (nb_powers) {
                     int n, nb_pow;
 
@@ -993,10 +1008,7 @@ static av_cold void uninit(AVFilterContext *ctx)
     for (i = 0; i < ctx->nb_outputs; i++)
         av_freep(&ctx->output_pads[i].name);
     av_frame_free(&ebur128->outpicref);
-#if CONFIG_SWRESAMPLE
-    av_freep(&ebur128->swr_buf);
-    swr_free(&ebur128->swr_ctx);
-#endif
+    ff_ebur128_true_peak_destroy(&ebur128->true_peak);
 }
 
 static const AVFilterPad ebur128_inputs[] = {
@@ -33,6 +33,7 @@
 #include "avfilter.h"
 #include "audio.h"
 #include "formats.h"
+#include "framestats.h"
 #include "internal.h"
 #include "video.h"
 #include "scene_sad.h"
@@ -282,13 +283,17 @@ static double get_scene_score(AVFilterContext *ctx, AVFrame *frame)
         uint64_t sad = 0;
         double mafd, diff;
         uint64_t count = 0;
+        int have_sad = ff_frame_stats_sad(frame, prev_picref, select->nb_planes, &sad);
 
         for (int plane = 0; plane < select->nb_planes; plane++) {
             uint64_t plane_sad;
-            select->sad(prev_picref->data[plane], prev_picref->linesize[plane],
-                    frame->data[plane], frame->linesize[plane],
-                    select->width[plane], select->height[plane], &plane_sad);
-            sad += plane_sad;
+            if (!have_sad) {
+                ff_scene_sad_threaded(ctx, select->sad,
+                                      prev_picref->data[plane], prev_picref->linesize[plane],
+                                      frame->data[plane], frame->linesize[plane],
+                                      select->width[plane], select->height[plane], &plane_sad);
+                sad += plane_sad;
+            }
             count += select->width[plane] * select->height[plane];
         }
 
@@ -552,6 +557,6 @@ AVFilter ff_vf_select = {
     .priv_size     = sizeof(SelectContext),
     .priv_class    = &select_class,
     .inputs        = avfilter_vf_select_inputs,
-    .flags         = AVFILTER_FLAG_DYNAMIC_OUTPUTS,
+    .flags         = AVFILTER_FLAG_DYNAMIC_OUTPUTS | AVFILTER_FLAG_SLICE_THREADS,
 };
 #endif /* CONFIG_SELECT_FILTER */
@@ -0,0 +1,128 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @file
+ * Frame statistics computed once by the framestats filter and shared by the
+ * detection filters through AV_FRAME_DATA_FRAME_STATS side data.
+ */
+
+#ifndef AVFILTER_FRAMESTATS_H
+#define AVFILTER_FRAMESTATS_H
+
+#include <stdint.h>
+
+#include "libavutil/frame.h"
+
+/**
+ * Header of the side data, followed by nb_rows row sums and nb_cols column
+ * sums of plane 0 as uint64_t, then by nb_bins histogram bins of plane 0 as
+ * uint32_t.
+ */
+typedef struct FrameStats {
+    int format;
+    int width;
+    int height;
+
+    /**
+     * pts of the frame the SADs were computed against, AV_NOPTS_VALUE if
+     * there was none
+     */
+    int64_t prev_pts;
+    /**
+     * number of planes in sad: only the luma plane for planar YUV, all
+     * the planes otherwise
+     */
+    int nb_planes;
+    /**
+     * SAD of each plane against the previous frame, over the width of the
+     * plane in samples as given by av_image_get_linesize()
+     */
+    uint64_t sad[4];
+
+    /**
+     * number of row and column sums, 0 if plane 0 holds more than one
+     * component
+     */
+    int nb_rows;
+    int nb_cols;
+    /**
+     * number of histogram bins, 256 for an 8 bit plane 0 holding a single
+     * component, 0 otherwise
+     */
+    int nb_bins;
+} FrameStats;
+
+static inline const uint64_t *ff_frame_stats_rows(const FrameStats *s)
+{
+    return (const uint64_t *)(s + 1);
+}
+
+static inline const uint64_t *ff_frame_stats_cols(const FrameStats *s)
+{
+    return ff_frame_stats_rows(s) + s->nb_rows;
+}
+
+static inline const uint32_t *ff_frame_stats_hist(const FrameStats *s)
+{
+    return (const uint32_t *)(ff_frame_stats_cols(s) + s->nb_cols);
+}
+
+/**
+ * Get the statistics attached to frame.
+ *
+ * @return the statistics, or NULL if there are none or they were computed
+ *         for a frame of another format or size
+ */
+static inline const FrameStats *ff_frame_stats_get(const AVFrame *frame)
+{
+    const AVFrameSideData *sd = av_frame_get_side_data(frame, AV_FRAME_DATA_FRAME_STATS);
+    const FrameStats *s;
+
+    if (!sd || sd->size < sizeof(*s))
+        return NULL;
+    s = (const FrameStats *)sd->data;
+    if (s->format != frame->format || s->width != frame->width ||
+        s->height != frame->height)
+        return NULL;
+    return s;
+}
+
+/**
+ * Get the SAD of the first nb_planes planes of frame against prev from the
+ * statistics attached to frame.
+ *
+ * @return 1 and the SAD in sad, or 0 if the statistics are missing or were
+ *         not computed against prev
+ */
+static inline int ff_frame_stats_sad(const AVFrame *frame, const AVFrame *prev,
+                                     int nb_planes, uint64_t *sad)
+{
+    const FrameStats *s = ff_frame_stats_get(frame);
+
+    if (!s || s->prev_pts == AV_NOPTS_VALUE || s->prev_pts != prev->pts ||
+        s->nb_planes < nb_planes)
+        return 0;
+
+    *sad = 0;
+    for (int plane = 0; plane < nb_planes; plane++)
+        *sad += s->sad[plane];
+    return 1;
+}
+
+#endif /* AVFILTER_FRAMESTATS_H */
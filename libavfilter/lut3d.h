@@ -0,0 +1,51 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef AVFILTER_LUT3D_H
+#define AVFILTER_LUT3D_H
+
+#include <stddef.h>
+
+enum interp_mode {
+    INTERPOLATE_NEAREST,
+    INTERPOLATE_TRILINEAR,
+    INTERPOLATE_TETRAHEDRAL,
+    NB_INTERP_MODE
+};
+
+/* the rows passed to the interp functions are padded to this many pixels */
+#define LUT3D_ROW_ALIGN 8
+
+typedef struct LUT3DDSPContext {
+    /**
+     * Interpolate the 3D LUT at w points.
+     *
+     * @param dst     r, g and b output rows, stride floats apart
+     * @param src     r, g and b LUT coordinates in [0, lutsize - 1], stride
+     *                floats apart; padded with valid coordinates up to a
+     *                multiple of LUT3D_ROW_ALIGN, as is dst
+     * @param lut     lutsize^3 r, g, b triplets, b varying fastest
+     */
+    void (*interp[NB_INTERP_MODE])(float *dst, const float *src, ptrdiff_t stride,
+                                   const float *lut, int lutsize, int w);
+} LUT3DDSPContext;
+
+void ff_lut3d_dsp_init(LUT3DDSPContext *dsp);
+void ff_lut3d_dsp_init_x86(LUT3DDSPContext *dsp);
+
+#endif /* AVFILTER_LUT3D_H */
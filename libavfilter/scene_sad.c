@@ -21,8 +21,19 @@
  * Scene SAD functions
  */
 
+#include "internal.h"
 #include "scene_sad.h"
 
+#define MAX_SAD_JOBS 64
+
+typedef struct ThreadData {
+    ff_scene_sad_fn sad;
+    const uint8_t *src1, *src2;
+    ptrdiff_t stride1, stride2;
+    ptrdiff_t width, height;
+    uint64_t sums[MAX_SAD_JOBS];
+} ThreadData;
+
 void ff_scene_sad16_c(SCENE_SAD_PARAMS)
 {
     uint64_t sad = 0;
@@ -70,3 +81,39 @@ ff_scene_sad_fn ff_scene_sad_get_fn(int depth)
     return sad;
 }
 
+static int scene_sad_slice(AVFilterContext *ctx, void *arg, int jobnr, int nb_jobs)
+{
+    ThreadData *td = arg;
+    const ptrdiff_t slice_start = (td->height *  jobnr   ) / nb_jobs;
+    const ptrdiff_t slice_end   = (td->height * (jobnr+1)) / nb_jobs;
+
+    td->sad(td->src1 + slice_start * td->stride1, td->stride1,
+            td->src2 + slice_start * td->stride2, td->stride2,
+            td->width, slice_end - slice_start, &td->sums[jobnr]);
+    return 0;
+}
+
+void ff_scene_sad_threaded(AVFilterContext *ctx, ff_scene_sad_fn sad,
+                           SCENE_SAD_PARAMS)
+{
+    ThreadData td;
+    int nb_jobs = FFMIN3(height, ff_filter_get_nb_threads(ctx), MAX_SAD_JOBS);
+
+    if (nb_jobs <= 1) {
+        sad(src1, stride1, src2, stride2, width, height, sum);
+        return;
+    }
+
+    td.sad     = sad;
+    td.src1    = src1;
+    td.src2    = src2;
+    td.stride1 = stride1;
+    td.stride2 = stride2;
+    td.width   = width;
+    td.height  = height;
+    ctx->internal->execute(ctx, scene_sad_slice, &td, NULL, nb_jobs);
+
+    *sum = 0;
+    for (int i = 0; i < nb_jobs; i++)
+        *sum += td.sums[i];
+}
@@ -41,4 +41,12 @@ ff_scene_sad_fn ff_scene_sad_get_fn_x86(int depth);
 
 ff_scene_sad_fn ff_scene_sad_get_fn(int depth);
 
+/**
+ * Compute the SAD of a plane by splitting its rows across the slice
+ * threads of the given filter context. The result is identical to calling
+ * sad directly on the whole plane.
+ */
+void ff_scene_sad_threaded(AVFilterContext *ctx, ff_scene_sad_fn sad,
+                           SCENE_SAD_PARAMS);
+
 #endif /* AVFILTER_SCENE_SAD_H */
@@ -0,0 +1,144 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @file
+ * Measure the cost of the atempo filter per second of input audio.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "libavutil/channel_layout.h"
+#include "libavutil/frame.h"
+#include "libavutil/lfg.h"
+#include "libavutil/time.h"
+
+#include "libavfilter/avfilter.h"
+#include "libavfilter/buffersink.h"
+#include "libavfilter/buffersrc.h"
+
+#define SAMPLE_RATE 48000
+#define CHANNELS    2
+#define FRAME_SIZE  1024
+
+static int drain(AVFilterContext *sink, AVFrame *out, int64_t *nb_out)
+{
+    int ret;
+
+    while ((ret = av_buffersink_get_frame(sink, out)) >= 0) {
+        *nb_out += out->nb_samples;
+        av_frame_unref(out);
+    }
+    return ret == AVERROR(EAGAIN) || ret == AVERROR_EOF ? 0 : ret;
+}
+
+static int run(double tempo, int seconds, double *ms_per_second)
+{
+    AVFilterGraph *graph = avfilter_graph_alloc();
+    AVFilterContext *src, *atempo, *sink;
+    AVFrame *in = av_frame_alloc(), *out = av_frame_alloc();
+    int64_t nb_in = 0, nb_out = 0, t0;
+    char args[256];
+    AVLFG lfg;
+    int i, ret;
+
+    if (!graph || !in || !out) {
+        ret = AVERROR(ENOMEM);
+        goto end;
+    }
+
+    snprintf(args, sizeof(args),
+             "sample_rate=%d:sample_fmt=flt:channel_layout=stereo", SAMPLE_RATE);
+    if ((ret = avfilter_graph_create_filter(&src, avfilter_get_by_name("abuffer"),
+                                            "src", args, NULL, graph)) < 0)
+        goto end;
+    snprintf(args, sizeof(args), "tempo=%f", tempo);
+    if ((ret = avfilter_graph_create_filter(&atempo, avfilter_get_by_name("atempo"),
+                                            "atempo", args, NULL, graph)) < 0)
+        goto end;
+    if ((ret = avfilter_graph_create_filter(&sink, avfilter_get_by_name("abuffersink"),
+                                            "sink", NULL, NULL, graph)) < 0)
+        goto end;
+    if ((ret = avfilter_link(src, 0, atempo, 0)) < 0 ||
+        (ret = avfilter_link(atempo, 0, sink, 0)) < 0 ||
+        (ret = avfilter_graph_config(graph, NULL)) < 0)
+        goto end;
+
+    av_lfg_init(&lfg, 0xdeadbeef);
+    t0 = av_gettime_relative();
+    while (nb_in < (int64_t)seconds * SAMPLE_RATE) {
+        float *samples;
+
+        in->format         = AV_SAMPLE_FMT_FLT;
+        in->channel_layout = AV_CH_LAYOUT_STEREO;
+        in->channels       = CHANNELS;
+        in->sample_rate    = SAMPLE_RATE;
+        in->nb_samples     = FRAME_SIZE;
+        in->pts            = nb_in;
+        if ((ret = av_frame_get_buffer(in, 0)) < 0)
+            goto end;
+        samples = (float *)in->data[0];
+        for (i = 0; i < FRAME_SIZE * CHANNELS; i++)
+            samples[i] = (float)av_lfg_get(&lfg) / UINT32_MAX - 0.5f;
+        nb_in += FRAME_SIZE;
+
+        if ((ret = av_buffersrc_add_frame(src, in)) < 0 ||
+            (ret = drain(sink, out, &nb_out)) < 0)
+            goto end;
+    }
+    if ((ret = av_buffersrc_add_frame(src, NULL)) < 0 ||
+        (ret = drain(sink, out, &nb_out)) < 0)
+        goto end;
+    *ms_per_second = (av_gettime_relative() - t0) / 1000.0 / seconds;
+
+    if (!nb_out)
+        ret = AVERROR_BUG;
+
+end:
+    av_frame_free(&in);
+    av_frame_free(&out);
+    avfilter_graph_free(&graph);
+    return ret;
+}
+
+int main(int argc, char **argv)
+{
+    static const double tempos[] = { 0.5, 0.8, 1.25, 2.0, 4.0 };
+    int seconds = 10;
+    int i, ret;
+
+    if (argc > 1)
+        seconds = atoi(argv[1]);
+    if (seconds <= 0) {
+        fprintf(stderr, "Usage: %s [seconds]\n", argv[0]);
+        return 1;
+    }
+
+    for (i = 0; i < FF_ARRAY_ELEMS(tempos); i++) {
+        double ms;
+
+        if ((ret = run(tempos[i], seconds, &ms)) < 0) {
+            fprintf(stderr, "tempo %.2f: %s\n", tempos[i], av_err2str(ret));
+            return 1;
+        }
+        printf("tempo %.2f: %.3f ms per second of audio\n", tempos[i], ms);
+    }
+
+    return 0;
+}
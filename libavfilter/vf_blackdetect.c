@@ -25,9 +25,11 @@
  */
 
 #include <float.h>
+#include "libavutil/mem.h"
 #include "libavutil/opt.h"
 #include "libavutil/timestamp.h"
 #include "avfilter.h"
+#include "framestats.h"
 #include "internal.h"
 
 typedef struct BlackDetectContext {
@@ -44,6 +46,8 @@ typedef struct BlackDetectContext {
     unsigned int pixel_black_th_i;
 
     unsigned int nb_black_pixels;   ///< number of black pixels counted so far
+    unsigned int *counter;          ///< per-job black pixel counts
+    int nb_threads;
 } BlackDetectContext;
 
 #define OFFSET(x) offsetof(BlackDetectContext, x)
@@ -91,6 +95,12 @@ static int config_input(AVFilterLink *inlink)
     AVFilterContext *ctx = inlink->dst;
     BlackDetectContext *blackdetect = ctx->priv;
 
+    blackdetect->nb_threads = ff_filter_get_nb_threads(ctx);
+    av_freep(&blackdetect->counter);
+    blackdetect->counter = av_calloc(blackdetect->nb_threads, sizeof(*blackdetect->counter));
+    if (!blackdetect->counter)
+        return AVERROR(ENOMEM);
+
     blackdetect->black_min_duration =
         blackdetect->black_min_duration_time / av_q2d(inlink->time_base);
 
@@ -136,18 +146,51 @@ static int request_frame(AVFilterLink *outlink)
     return ret;
 }
 
+static int black_counter(AVFilterContext *ctx, void *arg,
+                         int jobnr, int nb_jobs)
+{
+    BlackDetectContext *blackdetect = ctx->priv;
+    const unsigned int threshold = blackdetect->pixel_black_th_i;
+    unsigned int *counterp = &blackdetect->counter[jobnr];
+    AVFrame *in = arg;
+    const int linesize = in->linesize[0];
+    const int w = in->width;
+    const int h = in->height;
+    const int start = (h * jobnr) / nb_jobs;
+    const int end = (h * (jobnr+1)) / nb_jobs;
+    const uint8_t *p = in->data[0] + start * linesize;
+    unsigned int counter = 0;
+
+    for (int i = start; i < end; i++) {
+        for (int x = 0; x < w; x++)
+            counter += p[x] <= threshold;
+        p += linesize;
+    }
+
+    *counterp = counter;
+
+    return 0;
+}
+
 static int filter_frame(AVFilterLink *inlink, AVFrame *picref)
 {
     AVFilterContext *ctx = inlink->dst;
     BlackDetectContext *blackdetect = ctx->priv;
     double picture_black_ratio = 0;
-    const uint8_t *p = picref->data[0];
-    int x, i;
+    const int nb_jobs = FFMAX(1, FFMIN(inlink->h, blackdetect->nb_threads));
+    const FrameStats *stats = ff_frame_stats_get(picref);
+
+    if (stats && stats->nb_bins) {
+        const uint32_t *hist = ff_frame_stats_hist(stats);
+        const int max = FFMIN(blackdetect->pixel_black_th_i, stats->nb_bins - 1);
 
-    for (i = 0; i < inlink->h; i++) {
-        for (x = 0; x < inlink->w; x++)
-            blackdetect->nb_black_pixels += p[x] <= blackdetect->pixel_black_th_i;
-        p += picref->linesize[0];
+        for (int i = 0; i <= max; i++)
+            blackdetect->nb_black_pixels += hist[i];
+    } else {
+        ctx->internal->execute(ctx, black_counter, picref, NULL, nb_jobs);
+
+        for (int i = 0; i < nb_jobs; i++)
+            blackdetect->nb_black_pixels += blackdetect->counter[i];
     }
 
     picture_black_ratio = (double)blackdetect->nb_black_pixels / (inlink->w * inlink->h);
@@ -180,6 +223,13 @@ static int filter_frame(AVFilterLink *inlink, AVFrame *picref)
     return ff_filter_frame(inlink->dst->outputs[0], picref);
 }
 
+static av_cold void uninit(AVFilterContext *ctx)
+{
+    BlackDetectContext *blackdetect = ctx->priv;
+
+    av_freep(&blackdetect->counter);
+}
+
 static const AVFilterPad blackdetect_inputs[] = {
     {
         .name          = "default",
@@ -206,5 +256,7 @@ AVFilter ff_vf_blackdetect = {
     .query_formats = query_formats,
     .inputs        = blackdetect_inputs,
     .outputs       = blackdetect_outputs,
+    .uninit        = uninit,
     .priv_class    = &blackdetect_class,
+    .flags         = AVFILTER_FLAG_SLICE_THREADS,
 };
@@ -29,6 +29,7 @@
 
 #include "avfilter.h"
 #include "formats.h"
+#include "framestats.h"
 #include "internal.h"
 #include "video.h"
 
@@ -166,6 +167,8 @@ static int filter_frame(AVFilterLink *inlink, AVFrame *frame)
     AVDictionary **metadata;
     int outliers, last_y;
     int limit = lrint(s->limit);
+    const FrameStats *stats = ff_frame_stats_get(frame);
+    const uint64_t *rows = NULL, *cols = NULL;
 
     // ignore first 2 frames - they may be empty
     if (++s->frame_nb > 0) {
@@ -180,10 +183,17 @@ static int filter_frame(AVFilterLink *inlink, AVFrame *frame)
             s->frame_nb = 1;
         }
 
-#define FIND(DST, FROM, NOEND, INC, STEP0, STEP1, LEN) \
+        // use the line sums of framestats when available
+        if (stats && stats->nb_rows) {
+            rows = ff_frame_stats_rows(stats);
+            cols = ff_frame_stats_cols(stats);
+        }
+
+#define FIND(DST, FROM, NOEND, INC, STEP0, STEP1, LEN, SUMS) \
         outliers = 0;\
         for (last_y = y = FROM; NOEND; y = y INC) {\
-            if (checkline(ctx, frame->data[0] + STEP0 * y, STEP1, LEN, bpp) > limit) {\
+            if ((SUMS ? (int)(SUMS[y] / (LEN)) \
+                      : checkline(ctx, frame->data[0] + STEP0 * y, STEP1, LEN, bpp)) > limit) {\
                 if (++outliers > s->max_outliers) { \
                     DST = last_y;\
                     break;\
@@ -192,10 +202,10 @@ static int filter_frame(AVFilterLink *inlink, AVFrame *frame)
                 last_y = y INC;\
         }
 
-        FIND(s->y1,                 0,               y < s->y1, +1, frame->linesize[0], bpp, frame->width);
-        FIND(s->y2, frame->height - 1, y > FFMAX(s->y2, s->y1), -1, frame->linesize[0], bpp, frame->width);
-        FIND(s->x1,                 0,               y < s->x1, +1, bpp, frame->linesize[0], frame->height);
-        FIND(s->x2,  frame->width - 1, y > FFMAX(s->x2, s->x1), -1, bpp, frame->linesize[0], frame->height);
+        FIND(s->y1,                 0,               y < s->y1, +1, frame->linesize[0], bpp, frame->width,  rows);
+        FIND(s->y2, frame->height - 1, y > FFMAX(s->y2, s->y1), -1, frame->linesize[0], bpp, frame->width,  rows);
+        FIND(s->x1,                 0,               y < s->x1, +1, bpp, frame->linesize[0], frame->height, cols);
+        FIND(s->x2,  frame->width - 1, y > FFMAX(s->x2, s->x1), -1, bpp, frame->linesize[0], frame->height, cols);
 
 
         // round x and y (up), important for yuv colorspaces
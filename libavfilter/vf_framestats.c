@@ -0,0 +1,298 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @file
+ * Compute the frame statistics used by the detection filters once, and
+ * attach them to the frames as side data.
+ */
+
+#include <string.h>
+
+#include "libavutil/imgutils.h"
+#include "libavutil/mem.h"
+#include "libavutil/pixdesc.h"
+
+#include "avfilter.h"
+#include "formats.h"
+#include "framestats.h"
+#include "internal.h"
+#include "scene_sad.h"
+#include "video.h"
+
+typedef struct FrameStatsContext {
+    ptrdiff_t width[4];
+    ptrdiff_t height[4];
+    int nb_planes;
+    int depth;
+    int nb_rows, nb_cols, nb_bins;
+    ff_scene_sad_fn sad;
+    AVFrame *prev;
+
+    int nb_jobs;
+    uint64_t (*sads)[4];    ///< SADs of each job
+    uint64_t *cols;         ///< column sums of each job
+    uint32_t *hist;         ///< histogram of each job
+} FrameStatsContext;
+
+typedef struct ThreadData {
+    const AVFrame *in;
+    uint64_t *rows;
+} ThreadData;
+
+static int query_formats(AVFilterContext *ctx)
+{
+    static const enum AVPixelFormat pix_fmts[] = {
+        AV_PIX_FMT_GRAY8,
+        AV_PIX_FMT_YUV410P, AV_PIX_FMT_YUV411P,
+        AV_PIX_FMT_YUV420P, AV_PIX_FMT_YUVJ420P,
+        AV_PIX_FMT_YUV422P, AV_PIX_FMT_YUVJ422P,
+        AV_PIX_FMT_YUV440P, AV_PIX_FMT_YUVJ440P,
+        AV_PIX_FMT_YUV444P, AV_PIX_FMT_YUVJ444P,
+        AV_PIX_FMT_YUVJ411P,
+        AV_PIX_FMT_YUV420P9,  AV_PIX_FMT_YUV422P9,  AV_PIX_FMT_YUV444P9,
+        AV_PIX_FMT_YUV420P10, AV_PIX_FMT_YUV422P10, AV_PIX_FMT_YUV444P10,
+        AV_PIX_FMT_YUV420P12, AV_PIX_FMT_YUV422P12, AV_PIX_FMT_YUV444P12,
+        AV_PIX_FMT_YUV420P14, AV_PIX_FMT_YUV422P14, AV_PIX_FMT_YUV444P14,
+        AV_PIX_FMT_YUV420P16, AV_PIX_FMT_YUV422P16, AV_PIX_FMT_YUV444P16,
+        AV_PIX_FMT_NV12, AV_PIX_FMT_NV21,
+        AV_PIX_FMT_RGB24, AV_PIX_FMT_BGR24,
+        AV_PIX_FMT_RGBA, AV_PIX_FMT_BGRA, AV_PIX_FMT_ABGR,
+        AV_PIX_FMT_NONE
+    };
+
+    AVFilterFormats *fmts_list = ff_make_format_list(pix_fmts);
+    if (!fmts_list)
+        return AVERROR(ENOMEM);
+    return ff_set_common_formats(ctx, fmts_list);
+}
+
+static int config_input(AVFilterLink *inlink)
+{
+    AVFilterContext *ctx = inlink->dst;
+    FrameStatsContext *s = ctx->priv;
+    const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(inlink->format);
+    /* the planes the scene SAD of select and scdet is computed on */
+    int is_yuv = !(desc->flags & AV_PIX_FMT_FLAG_RGB) &&
+                 (desc->flags & AV_PIX_FMT_FLAG_PLANAR) &&
+                 desc->nb_components >= 3;
+
+    s->depth = desc->comp[0].depth;
+    s->nb_planes = is_yuv ? 1 : av_pix_fmt_count_planes(inlink->format);
+
+    for (int plane = 0; plane < s->nb_planes; plane++) {
+        ptrdiff_t line_size = av_image_get_linesize(inlink->format, inlink->w, plane);
+        int vsub = desc->log2_chroma_h;
+
+        s->width[plane] = line_size >> (s->depth > 8);
+        s->height[plane] = plane == 1 || plane == 2 ? AV_CEIL_RSHIFT(inlink->h, vsub) : inlink->h;
+    }
+
+    s->sad = ff_scene_sad_get_fn(s->depth == 8 ? 8 : 16);
+    if (!s->sad)
+        return AVERROR(EINVAL);
+
+    /* row and column sums as averaged by cropdetect, black pixels counts */
+    if (!(desc->flags & AV_PIX_FMT_FLAG_RGB) &&
+        desc->comp[0].step == (s->depth > 8 ? 2 : 1)) {
+        s->nb_rows = inlink->h;
+        s->nb_cols = inlink->w;
+        s->nb_bins = s->depth == 8 ? 256 : 0;
+    } else {
+        s->nb_rows = s->nb_cols = s->nb_bins = 0;
+    }
+
+    s->nb_jobs = FFMAX(1, FFMIN(inlink->h, ff_filter_get_nb_threads(ctx)));
+
+    av_freep(&s->sads);
+    av_freep(&s->cols);
+    av_freep(&s->hist);
+    s->sads = av_calloc(s->nb_jobs, sizeof(*s->sads));
+    if (!s->sads)
+        return AVERROR(ENOMEM);
+    if (s->nb_cols) {
+        s->cols = av_calloc(s->nb_jobs * s->nb_cols, sizeof(*s->cols));
+        if (!s->cols)
+            return AVERROR(ENOMEM);
+    }
+    if (s->nb_bins) {
+        s->hist = av_calloc(s->nb_jobs * s->nb_bins, sizeof(*s->hist));
+        if (!s->hist)
+            return AVERROR(ENOMEM);
+    }
+
+    av_frame_free(&s->prev);
+
+    return 0;
+}
+
+#define LINE_SUMS(type)                                                       \
+    for (int y = start; y < end; y++) {                                       \
+        const type *src = (const type *)(in->data[0] + y * in->linesize[0]);  \
+        uint64_t sum = 0;                                                     \
+                                                                              \
+        for (int x = 0; x < s->nb_cols; x++) {                                \
+            sum     += src[x];                                                \
+            cols[x] += src[x];                                                \
+            if (hist)                                                         \
+                hist[src[x]]++;                                               \
+        }                                                                     \
+        td->rows[y] = sum;                                                    \
+    }
+
+static int stats_slice(AVFilterContext *ctx, void *arg, int jobnr, int nb_jobs)
+{
+    FrameStatsContext *s = ctx->priv;
+    ThreadData *td = arg;
+    const AVFrame *in = td->in;
+    const AVFrame *prev = s->prev;
+
+    for (int plane = 0; plane < s->nb_planes && prev; plane++) {
+        const ptrdiff_t start = (s->height[plane] *  jobnr   ) / nb_jobs;
+        const ptrdiff_t end   = (s->height[plane] * (jobnr+1)) / nb_jobs;
+
+        s->sad(prev->data[plane] + start * prev->linesize[plane], prev->linesize[plane],
+               in->data[plane]   + start * in->linesize[plane],   in->linesize[plane],
+               s->width[plane], end - start, &s->sads[jobnr][plane]);
+    }
+
+    if (s->nb_rows) {
+        const int start = (s->nb_rows *  jobnr   ) / nb_jobs;
+        const int end   = (s->nb_rows * (jobnr+1)) / nb_jobs;
+        uint64_t *cols = s->cols + jobnr * s->nb_cols;
+        uint32_t *hist = s->nb_bins ? s->hist + jobnr * s->nb_bins : NULL;
+
+        memset(cols, 0, s->nb_cols * sizeof(*cols));
+        if (hist)
+            memset(hist, 0, s->nb_bins * sizeof(*hist));
+
+        if (s->depth > 8) {
+            LINE_SUMS(uint16_t)
+        } else {
+            LINE_SUMS(uint8_t)
+        }
+    }
+
+    return 0;
+}
+
+static int filter_frame(AVFilterLink *inlink, AVFrame *in)
+{
+    AVFilterContext *ctx = inlink->dst;
+    FrameStatsContext *s = ctx->priv;
+    const size_t size = sizeof(FrameStats) +
+                        (s->nb_rows + s->nb_cols) * sizeof(uint64_t) +
+                        s->nb_bins * sizeof(uint32_t);
+    AVFrameSideData *sd;
+    FrameStats *stats;
+    uint64_t *cols;
+    uint32_t *hist;
+    ThreadData td;
+
+    if (s->prev && (s->prev->width  != in->width ||
+                    s->prev->height != in->height))
+        av_frame_free(&s->prev);
+
+    av_frame_remove_side_data(in, AV_FRAME_DATA_FRAME_STATS);
+    sd = av_frame_new_side_data(in, AV_FRAME_DATA_FRAME_STATS, size);
+    if (!sd) {
+        av_frame_free(&in);
+        return AVERROR(ENOMEM);
+    }
+    stats = (FrameStats *)sd->data;
+    memset(stats, 0, sizeof(*stats));
+
+    td.in   = in;
+    td.rows = (uint64_t *)(stats + 1);
+    ctx->internal->execute(ctx, stats_slice, &td, NULL, s->nb_jobs);
+    emms_c();
+
+    stats->format    = in->format;
+    stats->width     = in->width;
+    stats->height    = in->height;
+    stats->prev_pts  = s->prev ? s->prev->pts : AV_NOPTS_VALUE;
+    stats->nb_planes = s->nb_planes;
+    stats->nb_rows   = s->nb_rows;
+    stats->nb_cols   = s->nb_cols;
+    stats->nb_bins   = s->nb_bins;
+
+    for (int i = 0; i < s->nb_jobs && s->prev; i++)
+        for (int plane = 0; plane < s->nb_planes; plane++)
+            stats->sad[plane] += s->sads[i][plane];
+
+    cols = (uint64_t *)ff_frame_stats_cols(stats);
+    hist = (uint32_t *)ff_frame_stats_hist(stats);
+    if (s->nb_cols)
+        memcpy(cols, s->cols, s->nb_cols * sizeof(*cols));
+    if (s->nb_bins)
+        memcpy(hist, s->hist, s->nb_bins * sizeof(*hist));
+    for (int i = 1; i < s->nb_jobs; i++) {
+        for (int x = 0; x < s->nb_cols; x++)
+            cols[x] += s->cols[i * s->nb_cols + x];
+        for (int x = 0; x < s->nb_bins; x++)
+            hist[x] += s->hist[i * s->nb_bins + x];
+    }
+
+    av_frame_free(&s->prev);
+    s->prev = av_frame_clone(in);
+    if (!s->prev) {
+        av_frame_free(&in);
+        return AVERROR(ENOMEM);
+    }
+
+    return ff_filter_frame(ctx->outputs[0], in);
+}
+
+static av_cold void uninit(AVFilterContext *ctx)
+{
+    FrameStatsContext *s = ctx->priv;
+
+    av_frame_free(&s->prev);
+    av_freep(&s->sads);
+    av_freep(&s->cols);
+    av_freep(&s->hist);
+}
+
+static const AVFilterPad framestats_inputs[] = {
+    {
+        .name         = "default",
+        .type         = AVMEDIA_TYPE_VIDEO,
+        .config_props = config_input,
+        .filter_frame = filter_frame,
+    },
+    { NULL }
+};
+
+static const AVFilterPad framestats_outputs[] = {
+    {
+        .name = "default",
+        .type = AVMEDIA_TYPE_VIDEO,
+    },
+    { NULL }
+};
+
+AVFilter ff_vf_framestats = {
+    .name          = "framestats",
+    .description   = NULL_IF_CONFIG_SMALL("Compute frame statistics for the detection filters."),
+    .priv_size     = sizeof(FrameStatsContext),
+    .uninit        = uninit,
+    .query_formats = query_formats,
+    .inputs        = framestats_inputs,
+    .outputs       = framestats_outputs,
+    .flags         = AVFILTER_FLAG_SLICE_THREADS,
+};
@@ -124,17 +124,19 @@ static av_cold void uninit(AVFilterContext *ctx)
     av_frame_free(&s->reference_frame);
 }
 
-static int is_frozen(FreezeDetectContext *s, AVFrame *reference, AVFrame *frame)
+static int is_frozen(AVFilterContext *ctx, AVFrame *reference, AVFrame *frame)
 {
+    FreezeDetectContext *s = ctx->priv;
     uint64_t sad = 0;
     uint64_t count = 0;
     double mafd;
     for (int plane = 0; plane < 4; plane++) {
         if (s->width[plane]) {
             uint64_t plane_sad;
-            s->sad(frame->data[plane], frame->linesize[plane],
-                   reference->data[plane], reference->linesize[plane],
-                   s->width[plane], s->height[plane], &plane_sad);
+            ff_scene_sad_threaded(ctx, s->sad,
+                                  frame->data[plane], frame->linesize[plane],
+                                  reference->data[plane], reference->linesize[plane],
+                                  s->width[plane], s->height[plane], &plane_sad);
             sad += plane_sad;
             count += s->width[plane] * s->height[plane];
         }
@@ -175,7 +177,7 @@ static int activate(AVFilterContext *ctx)
             else
                 duration = av_rescale_q(frame->pts - s->reference_frame->pts, inlink->time_base, AV_TIME_BASE_Q);
 
-            frozen = is_frozen(s, s->reference_frame, frame);
+            frozen = is_frozen(ctx, s->reference_frame, frame);
             if (duration >= s->duration) {
                 if (!s->frozen)
                     set_meta(s, frame, "lavfi.freezedetect.freeze_start", av_ts2timestr(s->reference_frame->pts, &inlink->time_base));
@@ -232,4 +234,5 @@ AVFilter ff_vf_freezedetect = {
     .inputs        = freezedetect_inputs,
     .outputs       = freezedetect_outputs,
     .activate      = activate,
+    .flags         = AVFILTER_FLAG_SLICE_THREADS,
 };
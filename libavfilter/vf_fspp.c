@@ -146,45 +146,53 @@ static void mul_thrmat_c(int16_t *thr_adr_noq, int16_t *thr_adr, int q)
         thr_adr[a] = q * thr_adr_noq[a];
 }
 
-static void filter(FSPPContext *p, uint8_t *dst, uint8_t *src,
-                   int dst_stride, int src_stride,
-                   int width, int height,
-                   uint8_t *qp_store, int qp_stride, int is_luma)
+typedef struct ThreadData {
+    uint8_t *dst;
+    int dst_stride;
+    int width, height;
+    uint8_t *qp_store;
+    int qp_stride;
+    int is_luma;
+} ThreadData;
+
+static int filter_slice(AVFilterContext *ctx, void *arg, int jobnr, int nb_jobs)
 {
+    FSPPContext *p = ctx->priv;
+    ThreadData *td = arg;
+    uint8_t *dst = td->dst;
+    const int dst_stride = td->dst_stride;
+    const int width = td->width, height = td->height;
+    uint8_t *qp_store = td->qp_store;
+    const int qp_stride = td->qp_stride;
+    const int is_luma = td->is_luma;
     int x, x0, y, es, qy, t;
 
     const int stride = is_luma ? p->temp_stride : (width + 16);
     const int step = 6 - p->log2_count;
     const int qpsh = 4 - p->hsub * !is_luma;
     const int qpsv = 4 - p->vsub * !is_luma;
+    const int nb_bands = (height + 15) / 8;
+    const int band_start = 8 * ((nb_bands *  jobnr   ) / nb_jobs);
+    const int band_end   = jobnr == nb_jobs - 1 ? height + 8 :
+                           8 * ((nb_bands * (jobnr+1)) / nb_jobs);
+    int16_t *temp = p->temp + jobnr * TEMP_ROWS * p->temp_stride;
+    int prev_q = p->prev_q;
 
     DECLARE_ALIGNED(32, int32_t, block_align)[4 * 8 * BLOCKSZ + 4 * 8 * BLOCKSZ];
+    DECLARE_ALIGNED(8, uint64_t, threshold_mtx)[8 * 2];
     int16_t *block  = (int16_t *)block_align;
     int16_t *block3 = (int16_t *)(block_align + 4 * 8 * BLOCKSZ);
 
-    memset(block3, 0, 4 * 8 * BLOCKSZ);
-
-    if (!src || !dst) return;
-
-    for (y = 0; y < height; y++) {
-        int index = 8 + 8 * stride + y * stride;
-        memcpy(p->src + index, src + y * src_stride, width);
-        for (x = 0; x < 8; x++) {
-            p->src[index         - x - 1] = p->src[index +         x    ];
-            p->src[index + width + x    ] = p->src[index + width - x - 1];
-        }
-    }
-
-    for (y = 0; y < 8; y++) {
-        memcpy(p->src + (     7 - y    ) * stride, p->src + (     y + 8    ) * stride, stride);
-        memcpy(p->src + (height + 8 + y) * stride, p->src + (height - y + 7) * stride, stride);
-    }
-    //FIXME (try edge emu)
+    memset(block_align, 0, sizeof(block_align));
+    memcpy(threshold_mtx, p->threshold_mtx, sizeof(threshold_mtx));
 
-    for (y = 8; y < 24; y++)
-        memset(p->temp + 8 + y * stride, 0, width * sizeof(int16_t));
+    for (y = 0; y < 24; y++)
+        memset(temp + 8 + y * stride, 0, width * sizeof(int16_t));
 
-    for (y = step; y < height + 8; y += step) {    //step= 1,2
+    /* The rows of a band are accumulated from the 8 rows above it, so every
+     * slice but the first starts one band early and only clears the ring
+     * buffer where the skipped store would. */
+    for (y = FFMAX(band_start - 8, step); y < band_end; y += step) {    //step= 1,2
         const int y1 = y - 8 + step;                 //l5-7  l4-6;
         qy = y - 4;
 
@@ -198,7 +206,7 @@ static void filter(FSPPContext *p, uint8_t *dst, uint8_t *src,
             p->row_fdct(block + 8 * 8, p->src + y * stride + 8 + x0 + 2 - (y&1), stride, 2 * (BLOCKSZ - 1));
 
             if (p->qp)
-                p->column_fidct((int16_t *)(&p->threshold_mtx[0]), block + 0 * 8, block3 + 0 * 8, 8 * (BLOCKSZ - 1)); //yes, this is a HOTSPOT
+                p->column_fidct((int16_t *)(&threshold_mtx[0]), block + 0 * 8, block3 + 0 * 8, 8 * (BLOCKSZ - 1)); //yes, this is a HOTSPOT
             else
                 for (x = 0; x < 8 * (BLOCKSZ - 1); x += 8) {
                     t = x + x0 - 2;                    //correct t=x+x0-2-(y&1), but its the same
@@ -208,10 +216,10 @@ static void filter(FSPPContext *p, uint8_t *dst, uint8_t *src,
                     t = qp_store[qy + (t >> qpsh)];
                     t = ff_norm_qscale(t, p->qscale_type);
 
-                    if (t != p->prev_q) p->prev_q = t, p->mul_thrmat((int16_t *)(&p->threshold_mtx_noq[0]), (int16_t *)(&p->threshold_mtx[0]), t);
-                    p->column_fidct((int16_t *)(&p->threshold_mtx[0]), block + x * 8, block3 + x * 8, 8); //yes, this is a HOTSPOT
+                    if (t != prev_q) prev_q = t, p->mul_thrmat((int16_t *)(&p->threshold_mtx_noq[0]), (int16_t *)(&threshold_mtx[0]), t);
+                    p->column_fidct((int16_t *)(&threshold_mtx[0]), block + x * 8, block3 + x * 8, 8); //yes, this is a HOTSPOT
                 }
-            p->row_idct(block3 + 0 * 8, p->temp + (y & 15) * stride + x0 + 2 - (y & 1), stride, 2 * (BLOCKSZ - 1));
+            p->row_idct(block3 + 0 * 8, temp + (y & 15) * stride + x0 + 2 - (y & 1), stride, 2 * (BLOCKSZ - 1));
             memmove(block,  block  + (BLOCKSZ - 1) * 64, 8 * 8 * sizeof(int16_t)); //cycling
             memmove(block3, block3 + (BLOCKSZ - 1) * 64, 6 * 8 * sizeof(int16_t));
         }
@@ -220,28 +228,76 @@ static void filter(FSPPContext *p, uint8_t *dst, uint8_t *src,
         if (es > 8)
             p->row_fdct(block + 8 * 8, p->src + y * stride + 8 + x0 + 2 - (y & 1), stride, (es - 4) >> 2);
 
-        p->column_fidct((int16_t *)(&p->threshold_mtx[0]), block, block3, es&(~1));
+        p->column_fidct((int16_t *)(&threshold_mtx[0]), block, block3, es&(~1));
         if (es > 3)
-            p->row_idct(block3 + 0 * 8, p->temp + (y & 15) * stride + x0 + 2 - (y & 1), stride, es >> 2);
+            p->row_idct(block3 + 0 * 8, temp + (y & 15) * stride + x0 + 2 - (y & 1), stride, es >> 2);
 
         if (!(y1 & 7) && y1) {
-            if (y1 & 8)
-                p->store_slice(dst + (y1 - 8) * dst_stride, p->temp + 8 + 8 * stride,
+            if (y1 < band_start) {
+                const int rows = y1 & 8 ? 16 : 8;
+                int16_t *ring = temp + 8 + (y1 & 8 ? 0 : 16) * stride;
+
+                for (x = 0; x < rows; x++)
+                    memset(ring + x * stride, 0, FFALIGN(width, 8) * sizeof(int16_t));
+            } else if (y1 & 8)
+                p->store_slice(dst + (y1 - 8) * dst_stride, temp + 8 + 8 * stride,
                                dst_stride, stride, width, 8, 5 - p->log2_count);
             else
-                p->store_slice2(dst + (y1 - 8) * dst_stride, p->temp + 8 + 0 * stride,
+                p->store_slice2(dst + (y1 - 8) * dst_stride, temp + 8 + 0 * stride,
                                 dst_stride, stride, width, 8, 5 - p->log2_count);
         }
     }
 
-    if (y & 7) {  // height % 8 != 0
+    if (jobnr == nb_jobs - 1 && (y & 7)) {  // height % 8 != 0
         if (y & 8)
-            p->store_slice(dst + ((y - 8) & ~7) * dst_stride, p->temp + 8 + 8 * stride,
+            p->store_slice(dst + ((y - 8) & ~7) * dst_stride, temp + 8 + 8 * stride,
                            dst_stride, stride, width, y&7, 5 - p->log2_count);
         else
-            p->store_slice2(dst + ((y - 8) & ~7) * dst_stride, p->temp + 8 + 0 * stride,
+            p->store_slice2(dst + ((y - 8) & ~7) * dst_stride, temp + 8 + 0 * stride,
                             dst_stride, stride, width, y&7, 5 - p->log2_count);
     }
+    emms_c();
+
+    return 0;
+}
+
+static void filter(AVFilterContext *ctx, uint8_t *dst, uint8_t *src,
+                   int dst_stride, int src_stride,
+                   int width, int height,
+                   uint8_t *qp_store, int qp_stride, int is_luma)
+{
+    FSPPContext *p = ctx->priv;
+    ThreadData td;
+    int x, y;
+
+    const int stride = is_luma ? p->temp_stride : (width + 16);
+
+    if (!src || !dst) return;
+
+    for (y = 0; y < height; y++) {
+        int index = 8 + 8 * stride + y * stride;
+        memcpy(p->src + index, src + y * src_stride, width);
+        for (x = 0; x < 8; x++) {
+            p->src[index         - x - 1] = p->src[index +         x    ];
+            p->src[index + width + x    ] = p->src[index + width - x - 1];
+        }
+    }
+
+    for (y = 0; y < 8; y++) {
+        memcpy(p->src + (     7 - y    ) * stride, p->src + (     y + 8    ) * stride, stride);
+        memcpy(p->src + (height + 8 + y) * stride, p->src + (height - y + 7) * stride, stride);
+    }
+    //FIXME (try edge emu)
+
+    td.dst        = dst;
+    td.dst_stride = dst_stride;
+    td.width      = width;
+    td.height     = height;
+    td.qp_store   = qp_store;
+    td.qp_stride  = qp_stride;
+    td.is_luma    = is_luma;
+    ctx->internal->execute(ctx, filter_slice, &td, NULL,
+                           FFMIN((height + 15) / 8, p->nb_threads));
 }
 
 static void column_fidct_c(int16_t *thr_adr, int16_t *data, int16_t *output, int cnt)
@@ -518,8 +574,9 @@ static int config_input(AVFilterLink *inlink)
     fspp->hsub = desc->log2_chroma_w;
     fspp->vsub = desc->log2_chroma_h;
 
+    fspp->nb_threads = ff_filter_get_nb_threads(ctx);
     fspp->temp_stride = FFALIGN(inlink->w + 16, 16);
-    fspp->temp = av_malloc_array(fspp->temp_stride, h * sizeof(*fspp->temp));
+    fspp->temp = av_malloc_array(fspp->temp_stride, fspp->nb_threads * TEMP_ROWS * sizeof(*fspp->temp));
     fspp->src  = av_malloc_array(fspp->temp_stride, h * sizeof(*fspp->src));
 
     if (!fspp->temp || !fspp->src)
@@ -634,13 +691,12 @@ static int filter_frame(AVFilterLink *inlink, AVFrame *in)
                 out->height = in->height;
             }
 
-            filter(fspp, out->data[0], in->data[0], out->linesize[0], in->linesize[0],
+            filter(ctx, out->data[0], in->data[0], out->linesize[0], in->linesize[0],
                    inlink->w, inlink->h, qp_table, qp_stride, 1);
-            filter(fspp, out->data[1], in->data[1], out->linesize[1], in->linesize[1],
+            filter(ctx, out->data[1], in->data[1], out->linesize[1], in->linesize[1],
                    cw,        ch,        qp_table, qp_stride, 0);
-            filter(fspp, out->data[2], in->data[2], out->linesize[2], in->linesize[2],
+            filter(ctx, out->data[2], in->data[2], out->linesize[2], in->linesize[2],
                    cw,        ch,        qp_table, qp_stride, 0);
-            emms_c();
         }
     }
 
@@ -689,5 +745,5 @@ AVFilter ff_vf_fspp = {
     .inputs          = fspp_inputs,
     .outputs         = fspp_outputs,
     .priv_class      = &fspp_class,
-    .flags           = AVFILTER_FLAG_SUPPORT_TIMELINE_INTERNAL,
+    .flags           = AVFILTER_FLAG_SUPPORT_TIMELINE_INTERNAL | AVFILTER_FLAG_SLICE_THREADS,
 };
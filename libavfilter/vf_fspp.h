@@ -27,6 +27,7 @@
 
 #define BLOCKSZ 12
 #define MAX_LEVEL 5
+#define TEMP_ROWS 24 /* rows of the per-thread accumulation ring buffer */
 
 #define DCTSIZE 8
 #define DCTSIZE_S "8"
@@ -60,11 +61,12 @@ typedef struct FSPPContext {
     int hsub;
     int vsub;
     int temp_stride;
+    int nb_threads;
     int qp;
     int qscale_type;
     int prev_q;
     uint8_t *src;
-    int16_t *temp;
+    int16_t *temp;      ///< one TEMP_ROWS ring buffer per slice thread
     uint8_t *non_b_qp_table;
     int non_b_qp_alloc_size;
     int use_bframe_qp;
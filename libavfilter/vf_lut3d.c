@@ -38,6 +38,7 @@
 #include "formats.h"
 #include "framesync.h"
 #include "internal.h"
+#include "lut3d.h"
 #include "video.h"
 
 #define R 0
@@ -45,13 +46,6 @@
 #define B 2
 #define A 3
 
-enum interp_mode {
-    INTERPOLATE_NEAREST,
-    INTERPOLATE_TRILINEAR,
-    INTERPOLATE_TETRAHEDRAL,
-    NB_INTERP_MODE
-};
-
 struct rgbvec {
     float r, g, b;
 };
@@ -60,6 +54,8 @@ struct rgbvec {
  * of 512x512 (64x64x64) */
 #define MAX_LEVEL 256
 #define PRELUT_SIZE 65536
+#define MAX_INTAB_DEPTH 12
+#define LINE_BLOCK 256
 
 typedef struct Lut3DPreLut {
     int size;
@@ -76,11 +72,17 @@ typedef struct LUT3DContext {
     uint8_t rgba_map[4];
     int step;
     avfilter_action_func *interp;
+    LUT3DDSPContext dsp;
+    void (*interp_row)(float *dst, const float *src, ptrdiff_t stride,
+                       const float *lut, int lutsize, int w);
     struct rgbvec scale;
     struct rgbvec *lut;
     int lutsize;
     int lutsize2;
     Lut3DPreLut prelut;
+    float *intab[3];            ///< input value to LUT coordinate, per component
+    int intab_depth;
+    int intab_lutsize;
 #if CONFIG_HALDCLUT_FILTER
     uint8_t clut_rgba_map[4];
     int clut_step;
@@ -144,37 +146,36 @@ static inline struct rgbvec lerp(const struct rgbvec *v0, const struct rgbvec *v
 
 #define NEAR(x) ((int)((x) + .5))
 #define PREV(x) ((int)(x))
-#define NEXT(x) (FFMIN((int)(x) + 1, lut3d->lutsize - 1))
+#define NEXT(x) (FFMIN((int)(x) + 1, lutsize - 1))
 
 /**
  * Get the nearest defined point
  */
-static inline struct rgbvec interp_nearest(const LUT3DContext *lut3d,
+static inline struct rgbvec interp_nearest(const struct rgbvec *lut, int lutsize,
                                            const struct rgbvec *s)
 {
-    return lut3d->lut[NEAR(s->r) * lut3d->lutsize2 + NEAR(s->g) * lut3d->lutsize + NEAR(s->b)];
+    return lut[NEAR(s->r) * lutsize * lutsize + NEAR(s->g) * lutsize + NEAR(s->b)];
 }
 
 /**
  * Interpolate using the 8 vertices of a cube
  * @see https://en.wikipedia.org/wiki/Trilinear_interpolation
  */
-static inline struct rgbvec interp_trilinear(const LUT3DContext *lut3d,
+static inline struct rgbvec interp_trilinear(const struct rgbvec *lut, int lutsize,
                                              const struct rgbvec *s)
 {
-    const int lutsize2 = lut3d->lutsize2;
-    const int lutsize  = lut3d->lutsize;
+    const int lutsize2 = lutsize * lutsize;
     const int prev[] = {PREV(s->r), PREV(s->g), PREV(s->b)};
     const int next[] = {NEXT(s->r), NEXT(s->g), NEXT(s->b)};
     const struct rgbvec d = {s->r - prev[0], s->g - prev[1], s->b - prev[2]};
-    const struct rgbvec c000 = lut3d->lut[prev[0] * lutsize2 + prev[1] * lutsize + prev[2]];
-    const struct rgbvec c001 = lut3d->lut[prev[0] * lutsize2 + prev[1] * lutsize + next[2]];
-    const struct rgbvec c010 = lut3d->lut[prev[0] * lutsize2 + next[1] * lutsize + prev[2]];
-    const struct rgbvec c011 = lut3d->lut[prev[0] * lutsize2 + next[1] * lutsize + next[2]];
-    const struct rgbvec c100 = lut3d->lut[next[0] * lutsize2 + prev[1] * lutsize + prev[2]];
-    const struct rgbvec c101 = lut3d->lut[next[0] * lutsize2 + prev[1] * lutsize + next[2]];
-    const struct rgbvec c110 = lut3d->lut[next[0] * lutsize2 + next[1] * lutsize + prev[2]];
-    const struct rgbvec c111 = lut3d->lut[next[0] * lutsize2 + next[1] * lutsize + next[2]];
+    const struct rgbvec c000 = lut[prev[0] * lutsize2 + prev[1] * lutsize + prev[2]];
+    const struct rgbvec c001 = lut[prev[0] * lutsize2 + prev[1] * lutsize + next[2]];
+    const struct rgbvec c010 = lut[prev[0] * lutsize2 + next[1] * lutsize + prev[2]];
+    const struct rgbvec c011 = lut[prev[0] * lutsize2 + next[1] * lutsize + next[2]];
+    const struct rgbvec c100 = lut[next[0] * lutsize2 + prev[1] * lutsize + prev[2]];
+    const struct rgbvec c101 = lut[next[0] * lutsize2 + prev[1] * lutsize + next[2]];
+    const struct rgbvec c110 = lut[next[0] * lutsize2 + next[1] * lutsize + prev[2]];
+    const struct rgbvec c111 = lut[next[0] * lutsize2 + next[1] * lutsize + next[2]];
     const struct rgbvec c00  = lerp(&c000, &c100, d.r);
     const struct rgbvec c10  = lerp(&c010, &c110, d.r);
     const struct rgbvec c01  = lerp(&c001, &c101, d.r);
@@ -189,53 +190,52 @@ static inline struct rgbvec interp_trilinear(const LUT3DContext *lut3d,
  * Tetrahedral interpolation. Based on code found in Truelight Software Library paper.
  * @see http://www.filmlight.ltd.uk/pdf/whitepapers/FL-TL-TN-0057-SoftwareLib.pdf
  */
-static inline struct rgbvec interp_tetrahedral(const LUT3DContext *lut3d,
+static inline struct rgbvec interp_tetrahedral(const struct rgbvec *lut, int lutsize,
                                                const struct rgbvec *s)
 {
-    const int lutsize2 = lut3d->lutsize2;
-    const int lutsize  = lut3d->lutsize;
+    const int lutsize2 = lutsize * lutsize;
     const int prev[] = {PREV(s->r), PREV(s->g), PREV(s->b)};
     const int next[] = {NEXT(s->r), NEXT(s->g), NEXT(s->b)};
     const struct rgbvec d = {s->r - prev[0], s->g - prev[1], s->b - prev[2]};
-    const struct rgbvec c000 = lut3d->lut[prev[0] * lutsize2 + prev[1] * lutsize + prev[2]];
-    const struct rgbvec c111 = lut3d->lut[next[0] * lutsize2 + next[1] * lutsize + next[2]];
+    const struct rgbvec c000 = lut[prev[0] * lutsize2 + prev[1] * lutsize + prev[2]];
+    const struct rgbvec c111 = lut[next[0] * lutsize2 + next[1] * lutsize + next[2]];
     struct rgbvec c;
     if (d.r > d.g) {
         if (d.g > d.b) {
-            const struct rgbvec c100 = lut3d->lut[next[0] * lutsize2 + prev[1] * lutsize + prev[2]];
-            const struct rgbvec c110 = lut3d->lut[next[0] * lutsize2 + next[1] * lutsize + prev[2]];
+            const struct rgbvec c100 = lut[next[0] * lutsize2 + prev[1] * lutsize + prev[2]];
+            const struct rgbvec c110 = lut[next[0] * lutsize2 + next[1] * lutsize + prev[2]];
             c.r = (1-d.r) * c000.r + (d.r-d.g) * c100.r + (d.g-d.b) * c110.r + (d.b) * c111.r;
             c.g = (1-d.r) * c000.g + (d.r-d.g) * c100.g + (d.g-d.b) * c110.g + (d.b) * c111.g;
             c.b = (1-d.r) * c000.b + (d.r-d.g) * c100.b + (d.g-d.b) * c110.b + (d.b) * c111.b;
         } else if (d.r > d.b) {
-            const struct rgbvec c100 = lut3d->lut[next[0] * lutsize2 + prev[1] * lutsize + prev[2]];
-            const struct rgbvec c101 = lut3d->lut[next[0] * lutsize2 + prev[1] * lutsize + next[2]];
+            const struct rgbvec c100 = lut[next[0] * lutsize2 + prev[1] * lutsize + prev[2]];
+            const struct rgbvec c101 = lut[next[0] * lutsize2 + prev[1] * lutsize + next[2]];
             c.r = (1-d.r) * c000.r + (d.r-d.b) * c100.r + (d.b-d.g) * c101.r + (d.g) * c111.r;
             c.g = (1-d.r) * c000.g + (d.r-d.b) * c100.g + (d.b-d.g) * c101.g + (d.g) * c111.g;
             c.b = (1-d.r) * c000.b + (d.r-d.b) * c100.b + (d.b-d.g) * c101.b + (d.g) * c111.b;
         } else {
-            const struct rgbvec c001 = lut3d->lut[prev[0] * lutsize2 + prev[1] * lutsize + next[2]];
-            const struct rgbvec c101 = lut3d->lut[next[0] * lutsize2 + prev[1] * lutsize + next[2]];
+            const struct rgbvec c001 = lut[prev[0] * lutsize2 + prev[1] * lutsize + next[2]];
+            const struct rgbvec c101 = lut[next[0] * lutsize2 + prev[1] * lutsize + next[2]];
             c.r = (1-d.b) * c000.r + (d.b-d.r) * c001.r + (d.r-d.g) * c101.r + (d.g) * c111.r;
             c.g = (1-d.b) * c000.g + (d.b-d.r) * c001.g + (d.r-d.g) * c101.g + (d.g) * c111.g;
             c.b = (1-d.b) * c000.b + (d.b-d.r) * c001.b + (d.r-d.g) * c101.b + (d.g) * c111.b;
         }
     } else {
         if (d.b > d.g) {
-            const struct rgbvec c001 = lut3d->lut[prev[0] * lutsize2 + prev[1] * lutsize + next[2]];
-            const struct rgbvec c011 = lut3d->lut[prev[0] * lutsize2 + next[1] * lutsize + next[2]];
+            const struct rgbvec c001 = lut[prev[0] * lutsize2 + prev[1] * lutsize + next[2]];
+            const struct rgbvec c011 = lut[prev[0] * lutsize2 + next[1] * lutsize + next[2]];
             c.r = (1-d.b) * c000.r + (d.b-d.g) * c001.r + (d.g-d.r) * c011.r + (d.r) * c111.r;
             c.g = (1-d.b) * c000.g + (d.b-d.g) * c001.g + (d.g-d.r) * c011.g + (d.r) * c111.g;
             c.b = (1-d.b) * c000.b + (d.b-d.g) * c001.b + (d.g-d.r) * c011.b + (d.r) * c111.b;
         } else if (d.b > d.r) {
-            const struct rgbvec c010 = lut3d->lut[prev[0] * lutsize2 + next[1] * lutsize + prev[2]];
-            const struct rgbvec c011 = lut3d->lut[prev[0] * lutsize2 + next[1] * lutsize + next[2]];
+            const struct rgbvec c010 = lut[prev[0] * lutsize2 + next[1] * lutsize + prev[2]];
+            const struct rgbvec c011 = lut[prev[0] * lutsize2 + next[1] * lutsize + next[2]];
             c.r = (1-d.g) * c000.r + (d.g-d.b) * c010.r + (d.b-d.r) * c011.r + (d.r) * c111.r;
             c.g = (1-d.g) * c000.g + (d.g-d.b) * c010.g + (d.b-d.r) * c011.g + (d.r) * c111.g;
             c.b = (1-d.g) * c000.b + (d.g-d.b) * c010.b + (d.b-d.r) * c011.b + (d.r) * c111.b;
         } else {
-            const struct rgbvec c010 = lut3d->lut[prev[0] * lutsize2 + next[1] * lutsize + prev[2]];
-            const struct rgbvec c110 = lut3d->lut[next[0] * lutsize2 + next[1] * lutsize + prev[2]];
+            const struct rgbvec c010 = lut[prev[0] * lutsize2 + next[1] * lutsize + prev[2]];
+            const struct rgbvec c110 = lut[next[0] * lutsize2 + next[1] * lutsize + prev[2]];
             c.r = (1-d.g) * c000.r + (d.g-d.r) * c010.r + (d.r-d.b) * c110.r + (d.b) * c111.r;
             c.g = (1-d.g) * c000.g + (d.g-d.r) * c010.g + (d.r-d.b) * c110.g + (d.b) * c111.g;
             c.b = (1-d.g) * c000.b + (d.g-d.r) * c010.b + (d.r-d.b) * c110.b + (d.b) * c111.b;
@@ -272,10 +272,94 @@ static inline struct rgbvec apply_prelut(const Lut3DPreLut *prelut,
     return c;
 }
 
-#define DEFINE_INTERP_FUNC_PLANAR(name, nbits, depth)                                                  \
-static int interp_##nbits##_##name##_p##depth(AVFilterContext *ctx, void *arg, int jobnr, int nb_jobs) \
+/**
+ * Fill the per-component tables mapping every integer input value to its
+ * (pre-LUT applied, scaled and clipped) coordinate in the 3D LUT, so that
+ * integer formats up to MAX_INTAB_DEPTH bits skip that work per pixel.
+ */
+static int update_intab(LUT3DContext *lut3d)
+{
+    const Lut3DPreLut *prelut = &lut3d->prelut;
+    const int size = 1 << lut3d->intab_depth;
+    const float lut_max = lut3d->lutsize - 1;
+    const float scale_f = 1.0f / (size - 1);
+    const float scale[3] = { lut3d->scale.r * lut_max,
+                             lut3d->scale.g * lut_max,
+                             lut3d->scale.b * lut_max };
+    int c, i;
+
+    for (c = 0; c < 3; c++) {
+        if (!lut3d->intab[c]) {
+            lut3d->intab[c] = av_malloc_array(1 << MAX_INTAB_DEPTH, sizeof(*lut3d->intab[c]));
+            if (!lut3d->intab[c])
+                return AVERROR(ENOMEM);
+        }
+        for (i = 0; i < size; i++) {
+            float v = i * scale_f;
+            if (prelut->size > 0)
+                v = prelut_interp_1d_linear(prelut, c, v);
+            lut3d->intab[c][i] = av_clipf(v * scale[c], 0, lut_max);
+        }
+    }
+    lut3d->intab_lutsize = lut3d->lutsize;
+    return 0;
+}
+
+#define DEFINE_INTERP_ROW(name)                                                     \
+static void interp_row_##name(float *dst, const float *src, ptrdiff_t stride,      \
+                              const float *lut, int lutsize, int w)                 \
+{                                                                                   \
+    int x;                                                                          \
+                                                                                    \
+    for (x = 0; x < w; x++) {                                                       \
+        const struct rgbvec s = { src[x], src[x + stride], src[x + 2 * stride] };   \
+        const struct rgbvec c = interp_##name((const struct rgbvec *)lut,           \
+                                              lutsize, &s);                         \
+        dst[x]              = c.r;                                                  \
+        dst[x + stride]     = c.g;                                                  \
+        dst[x + 2 * stride] = c.b;                                                  \
+    }                                                                               \
+}
+
+DEFINE_INTERP_ROW(nearest)
+DEFINE_INTERP_ROW(trilinear)
+DEFINE_INTERP_ROW(tetrahedral)
+
+#if CONFIG_LUT3D_FILTER || CONFIG_HALDCLUT_FILTER
+av_cold void ff_lut3d_dsp_init(LUT3DDSPContext *dsp)
+{
+    dsp->interp[INTERPOLATE_NEAREST]     = interp_row_nearest;
+    dsp->interp[INTERPOLATE_TRILINEAR]   = interp_row_trilinear;
+    dsp->interp[INTERPOLATE_TETRAHEDRAL] = interp_row_tetrahedral;
+
+    if (ARCH_X86)
+        ff_lut3d_dsp_init_x86(dsp);
+}
+#endif
+
+/**
+ * Interpolate a block of n pixels from their LUT coordinates in the first
+ * n elements of each LINE_BLOCK sized row of coords into rgb.
+ */
+static inline void interp_block(const LUT3DContext *lut3d, float *rgb,
+                                float *coords, int n)
+{
+    int x;
+
+    /* the SIMD versions process the rows in whole registers */
+    for (x = n; x < FFALIGN(n, LUT3D_ROW_ALIGN); x++) {
+        coords[x]                  = 0.0f;
+        coords[x + LINE_BLOCK]     = 0.0f;
+        coords[x + 2 * LINE_BLOCK] = 0.0f;
+    }
+    lut3d->interp_row(rgb, coords, LINE_BLOCK, (const float *)lut3d->lut,
+                      lut3d->lutsize, n);
+}
+
+#define DEFINE_INTERP_FUNC_PLANAR(nbits, depth)                                                        \
+static int interp_##nbits##_p##depth(AVFilterContext *ctx, void *arg, int jobnr, int nb_jobs)          \
 {                                                                                                      \
-    int x, y;                                                                                          \
+    int x, x0, y;                                                                                      \
     const LUT3DContext *lut3d = ctx->priv;                                                             \
     const Lut3DPreLut *prelut = &lut3d->prelut;                                                        \
     const ThreadData *td = arg;                                                                        \
@@ -297,6 +381,12 @@ static int interp_##nbits##_##name##_p##depth(AVFilterContext *ctx, void *arg, i
     const float scale_r = lut3d->scale.r * lut_max;                                                    \
     const float scale_g = lut3d->scale.g * lut_max;                                                    \
     const float scale_b = lut3d->scale.b * lut_max;                                                    \
+    const float *intab_r = lut3d->intab[0];                                                            \
+    const float *intab_g = lut3d->intab[1];                                                            \
+    const float *intab_b = lut3d->intab[2];                                                            \
+    const int in_max = (1<<depth) - 1;                                                                 \
+    LOCAL_ALIGNED_32(float, coords, [3 * LINE_BLOCK]);                                                 \
+    LOCAL_ALIGNED_32(float, rgb,    [3 * LINE_BLOCK]);                                                 \
                                                                                                        \
     for (y = slice_start; y < slice_end; y++) {                                                        \
         uint##nbits##_t *dstg = (uint##nbits##_t *)grow;                                               \
@@ -307,20 +397,31 @@ static int interp_##nbits##_##name##_p##depth(AVFilterContext *ctx, void *arg, i
         const uint##nbits##_t *srcb = (const uint##nbits##_t *)srcbrow;                                \
         const uint##nbits##_t *srcr = (const uint##nbits##_t *)srcrrow;                                \
         const uint##nbits##_t *srca = (const uint##nbits##_t *)srcarow;                                \
-        for (x = 0; x < in->width; x++) {                                                              \
-            const struct rgbvec rgb = {srcr[x] * scale_f,                                              \
-                                       srcg[x] * scale_f,                                              \
-                                       srcb[x] * scale_f};                                             \
-            const struct rgbvec prelut_rgb = apply_prelut(prelut, &rgb);                               \
-            const struct rgbvec scaled_rgb = {av_clipf(prelut_rgb.r * scale_r, 0, lut_max),            \
-                                              av_clipf(prelut_rgb.g * scale_g, 0, lut_max),            \
-                                              av_clipf(prelut_rgb.b * scale_b, 0, lut_max)};           \
-            struct rgbvec vec = interp_##name(lut3d, &scaled_rgb);                                     \
-            dstr[x] = av_clip_uintp2(vec.r * (float)((1<<depth) - 1), depth);                          \
-            dstg[x] = av_clip_uintp2(vec.g * (float)((1<<depth) - 1), depth);                          \
-            dstb[x] = av_clip_uintp2(vec.b * (float)((1<<depth) - 1), depth);                          \
-            if (!direct && in->linesize[3])                                                            \
-                dsta[x] = srca[x];                                                                     \
+        for (x0 = 0; x0 < in->width; x0 += LINE_BLOCK) {                                               \
+            const int n = FFMIN(LINE_BLOCK, in->width - x0);                                           \
+            for (x = 0; x < n; x++) {                                                                  \
+                if (depth <= MAX_INTAB_DEPTH) {                                                        \
+                    coords[x]                  = intab_r[FFMIN(srcr[x0 + x], in_max)];                 \
+                    coords[x + LINE_BLOCK]     = intab_g[FFMIN(srcg[x0 + x], in_max)];                 \
+                    coords[x + 2 * LINE_BLOCK] = intab_b[FFMIN(srcb[x0 + x], in_max)];                 \
+                } else {                                                                               \
+                    const struct rgbvec rgb = {srcr[x0 + x] * scale_f,                                 \
+                                               srcg[x0 + x] * scale_f,                                 \
+                                               srcb[x0 + x] * scale_f};                                \
+                    const struct rgbvec prelut_rgb = apply_prelut(prelut, &rgb);                       \
+                    coords[x]                  = av_clipf(prelut_rgb.r * scale_r, 0, lut_max);         \
+                    coords[x + LINE_BLOCK]     = av_clipf(prelut_rgb.g * scale_g, 0, lut_max);         \
+                    coords[x + 2 * LINE_BLOCK] = av_clipf(prelut_rgb.b * scale_b, 0, lut_max);         \
+                }                                                                                      \
+            }                                                                                          \
+            interp_block(lut3d, rgb, coords, n);                                                       \
+            for (x = 0; x < n; x++) {                                                                  \
+                dstr[x0 + x] = av_clip_uintp2(rgb[x]                  * (float)((1<<depth) - 1), depth); \
+                dstg[x0 + x] = av_clip_uintp2(rgb[x + LINE_BLOCK]     * (float)((1<<depth) - 1), depth); \
+                dstb[x0 + x] = av_clip_uintp2(rgb[x + 2 * LINE_BLOCK] * (float)((1<<depth) - 1), depth); \
+                if (!direct && in->linesize[3])                                                        \
+                    dsta[x0 + x] = srca[x0 + x];                                                       \
+            }                                                                                          \
         }                                                                                              \
         grow += out->linesize[0];                                                                      \
         brow += out->linesize[1];                                                                      \
@@ -334,34 +435,17 @@ static int interp_##nbits##_##name##_p##depth(AVFilterContext *ctx, void *arg, i
     return 0;                                                                                          \
 }
 
-DEFINE_INTERP_FUNC_PLANAR(nearest,     8, 8)
-DEFINE_INTERP_FUNC_PLANAR(trilinear,   8, 8)
-DEFINE_INTERP_FUNC_PLANAR(tetrahedral, 8, 8)
-
-DEFINE_INTERP_FUNC_PLANAR(nearest,     16, 9)
-DEFINE_INTERP_FUNC_PLANAR(trilinear,   16, 9)
-DEFINE_INTERP_FUNC_PLANAR(tetrahedral, 16, 9)
-
-DEFINE_INTERP_FUNC_PLANAR(nearest,     16, 10)
-DEFINE_INTERP_FUNC_PLANAR(trilinear,   16, 10)
-DEFINE_INTERP_FUNC_PLANAR(tetrahedral, 16, 10)
+DEFINE_INTERP_FUNC_PLANAR(8, 8)
+DEFINE_INTERP_FUNC_PLANAR(16, 9)
+DEFINE_INTERP_FUNC_PLANAR(16, 10)
+DEFINE_INTERP_FUNC_PLANAR(16, 12)
+DEFINE_INTERP_FUNC_PLANAR(16, 14)
+DEFINE_INTERP_FUNC_PLANAR(16, 16)
 
-DEFINE_INTERP_FUNC_PLANAR(nearest,     16, 12)
-DEFINE_INTERP_FUNC_PLANAR(trilinear,   16, 12)
-DEFINE_INTERP_FUNC_PLANAR(tetrahedral, 16, 12)
-
-DEFINE_INTERP_FUNC_PLANAR(nearest,     16, 14)
-DEFINE_INTERP_FUNC_PLANAR(trilinear,   16, 14)
-DEFINE_INTERP_FUNC_PLANAR(tetrahedral, 16, 14)
-
-DEFINE_INTERP_FUNC_PLANAR(nearest,     16, 16)
-DEFINE_INTERP_FUNC_PLANAR(trilinear,   16, 16)
-DEFINE_INTERP_FUNC_PLANAR(tetrahedral, 16, 16)
-
-#define DEFINE_INTERP_FUNC_PLANAR_FLOAT(name, depth)                                                   \
-static int interp_##name##_pf##depth(AVFilterContext *ctx, void *arg, int jobnr, int nb_jobs)          \
+#define DEFINE_INTERP_FUNC_PLANAR_FLOAT(depth)                                                         \
+static int interp_pf##depth(AVFilterContext *ctx, void *arg, int jobnr, int nb_jobs)                   \
 {                                                                                                      \
-    int x, y;                                                                                          \
+    int x, x0, y;                                                                                      \
     const LUT3DContext *lut3d = ctx->priv;                                                             \
     const Lut3DPreLut *prelut = &lut3d->prelut;                                                        \
     const ThreadData *td = arg;                                                                        \
@@ -382,6 +466,8 @@ static int interp_##name##_pf##depth(AVFilterContext *ctx, void *arg, int jobnr,
     const float scale_r = lut3d->scale.r * lut_max;                                                    \
     const float scale_g = lut3d->scale.g * lut_max;                                                    \
     const float scale_b = lut3d->scale.b * lut_max;                                                    \
+    LOCAL_ALIGNED_32(float, coords, [3 * LINE_BLOCK]);                                                 \
+    LOCAL_ALIGNED_32(float, rgb,    [3 * LINE_BLOCK]);                                                 \
                                                                                                        \
     for (y = slice_start; y < slice_end; y++) {                                                        \
         float *dstg = (float *)grow;                                                                   \
@@ -392,20 +478,25 @@ static int interp_##name##_pf##depth(AVFilterContext *ctx, void *arg, int jobnr,
         const float *srcb = (const float *)srcbrow;                                                    \
         const float *srcr = (const float *)srcrrow;                                                    \
         const float *srca = (const float *)srcarow;                                                    \
-        for (x = 0; x < in->width; x++) {                                                              \
-            const struct rgbvec rgb = {sanitizef(srcr[x]),                                             \
-                                       sanitizef(srcg[x]),                                             \
-                                       sanitizef(srcb[x])};                                            \
-            const struct rgbvec prelut_rgb = apply_prelut(prelut, &rgb);                               \
-            const struct rgbvec scaled_rgb = {av_clipf(prelut_rgb.r * scale_r, 0, lut_max),            \
-                                              av_clipf(prelut_rgb.g * scale_g, 0, lut_max),            \
-                                              av_clipf(prelut_rgb.b * scale_b, 0, lut_max)};           \
-            struct rgbvec vec = interp_##name(lut3d, &scaled_rgb);                                     \
-            dstr[x] = vec.r;                                                                           \
-            dstg[x] = vec.g;                                                                           \
-            dstb[x] = vec.b;                                                                           \
-            if (!direct && in->linesize[3])                                                            \
-                dsta[x] = srca[x];                                                                     \
+        for (x0 = 0; x0 < in->width; x0 += LINE_BLOCK) {                                               \
+            const int n = FFMIN(LINE_BLOCK, in->width - x0);                                           \
+            for (x = 0; x < n; x++) {                                                                  \
+                const struct rgbvec rgb = {sanitizef(srcr[x0 + x]),                                    \
+                                           sanitizef(srcg[x0 + x]),                                    \
+                                           sanitizef(srcb[x0 + x])};                                   \
+                const struct rgbvec prelut_rgb = apply_prelut(prelut, &rgb);                           \
+                coords[x]                  = av_clipf(prelut_rgb.r * scale_r, 0, lut_max);             \
+                coords[x + LINE_BLOCK]     = av_clipf(prelut_rgb.g * scale_g, 0, lut_max);             \
+                coords[x + 2 * LINE_BLOCK] = av_clipf(prelut_rgb.b * scale_b, 0, lut_max);             \
+            }                                                                                          \
+            interp_block(lut3d, rgb, coords, n);                                                       \
+            for (x = 0; x < n; x++) {                                                                  \
+                dstr[x0 + x] = rgb[x];                                                                 \
+                dstg[x0 + x] = rgb[x + LINE_BLOCK];                                                    \
+                dstb[x0 + x] = rgb[x + 2 * LINE_BLOCK];                                                \
+                if (!direct && in->linesize[3])                                                        \
+                    dsta[x0 + x] = srca[x0 + x];                                                       \
+            }                                                                                          \
         }                                                                                              \
         grow += out->linesize[0];                                                                      \
         brow += out->linesize[1];                                                                      \
@@ -419,14 +510,12 @@ static int interp_##name##_pf##depth(AVFilterContext *ctx, void *arg, int jobnr,
     return 0;                                                                                          \
 }
 
-DEFINE_INTERP_FUNC_PLANAR_FLOAT(nearest,     32)
-DEFINE_INTERP_FUNC_PLANAR_FLOAT(trilinear,   32)
-DEFINE_INTERP_FUNC_PLANAR_FLOAT(tetrahedral, 32)
+DEFINE_INTERP_FUNC_PLANAR_FLOAT(32)
 
-#define DEFINE_INTERP_FUNC(name, nbits)                                                             \
-static int interp_##nbits##_##name(AVFilterContext *ctx, void *arg, int jobnr, int nb_jobs)         \
+#define DEFINE_INTERP_FUNC(nbits)                                                                   \
+static int interp_##nbits(AVFilterContext *ctx, void *arg, int jobnr, int nb_jobs)                  \
 {                                                                                                   \
-    int x, y;                                                                                       \
+    int x, x0, y;                                                                                   \
     const LUT3DContext *lut3d = ctx->priv;                                                          \
     const Lut3DPreLut *prelut = &lut3d->prelut;                                                     \
     const ThreadData *td = arg;                                                                     \
@@ -447,24 +536,43 @@ static int interp_##nbits##_##name(AVFilterContext *ctx, void *arg, int jobnr, i
     const float scale_r = lut3d->scale.r * lut_max;                                                 \
     const float scale_g = lut3d->scale.g * lut_max;                                                 \
     const float scale_b = lut3d->scale.b * lut_max;                                                 \
+    const float *intab_r = lut3d->intab[0];                                                         \
+    const float *intab_g = lut3d->intab[1];                                                         \
+    const float *intab_b = lut3d->intab[2];                                                         \
+    LOCAL_ALIGNED_32(float, coords, [3 * LINE_BLOCK]);                                              \
+    LOCAL_ALIGNED_32(float, rgb,    [3 * LINE_BLOCK]);                                              \
                                                                                                     \
     for (y = slice_start; y < slice_end; y++) {                                                     \
         uint##nbits##_t *dst = (uint##nbits##_t *)dstrow;                                           \
         const uint##nbits##_t *src = (const uint##nbits##_t *)srcrow;                               \
-        for (x = 0; x < in->width * step; x += step) {                                              \
-            const struct rgbvec rgb = {src[x + r] * scale_f,                                        \
-                                       src[x + g] * scale_f,                                        \
-                                       src[x + b] * scale_f};                                       \
-            const struct rgbvec prelut_rgb = apply_prelut(prelut, &rgb);                            \
-            const struct rgbvec scaled_rgb = {av_clipf(prelut_rgb.r * scale_r, 0, lut_max),         \
-                                              av_clipf(prelut_rgb.g * scale_g, 0, lut_max),         \
-                                              av_clipf(prelut_rgb.b * scale_b, 0, lut_max)};        \
-            struct rgbvec vec = interp_##name(lut3d, &scaled_rgb);                                  \
-            dst[x + r] = av_clip_uint##nbits(vec.r * (float)((1<<nbits) - 1));                      \
-            dst[x + g] = av_clip_uint##nbits(vec.g * (float)((1<<nbits) - 1));                      \
-            dst[x + b] = av_clip_uint##nbits(vec.b * (float)((1<<nbits) - 1));                      \
-            if (!direct && step == 4)                                                               \
-                dst[x + a] = src[x + a];                                                            \
+        for (x0 = 0; x0 < in->width; x0 += LINE_BLOCK) {                                            \
+            const int n = FFMIN(LINE_BLOCK, in->width - x0);                                        \
+            const uint##nbits##_t *s = src + x0 * step;                                             \
+            uint##nbits##_t *d = dst + x0 * step;                                                   \
+            for (x = 0; x < n; x++, s += step) {                                                    \
+                if (nbits <= MAX_INTAB_DEPTH) {                                                     \
+                    coords[x]                  = intab_r[s[r]];                                     \
+                    coords[x + LINE_BLOCK]     = intab_g[s[g]];                                     \
+                    coords[x + 2 * LINE_BLOCK] = intab_b[s[b]];                                     \
+                } else {                                                                            \
+                    const struct rgbvec rgb = {s[r] * scale_f,                                      \
+                                               s[g] * scale_f,                                      \
+                                               s[b] * scale_f};                                     \
+                    const struct rgbvec prelut_rgb = apply_prelut(prelut, &rgb);                    \
+                    coords[x]                  = av_clipf(prelut_rgb.r * scale_r, 0, lut_max);      \
+                    coords[x + LINE_BLOCK]     = av_clipf(prelut_rgb.g * scale_g, 0, lut_max);      \
+                    coords[x + 2 * LINE_BLOCK] = av_clipf(prelut_rgb.b * scale_b, 0, lut_max);      \
+                }                                                                                   \
+            }                                                                                       \
+            interp_block(lut3d, rgb, coords, n);                                                    \
+            s = src + x0 * step;                                                                    \
+            for (x = 0; x < n; x++, s += step, d += step) {                                         \
+                d[r] = av_clip_uint##nbits(rgb[x]                  * (float)((1<<nbits) - 1));      \
+                d[g] = av_clip_uint##nbits(rgb[x + LINE_BLOCK]     * (float)((1<<nbits) - 1));      \
+                d[b] = av_clip_uint##nbits(rgb[x + 2 * LINE_BLOCK] * (float)((1<<nbits) - 1));      \
+                if (!direct && step == 4)                                                           \
+                    d[a] = s[a];                                                                    \
+            }                                                                                       \
         }                                                                                           \
         dstrow += out->linesize[0];                                                                 \
         srcrow += in ->linesize[0];                                                                 \
@@ -472,13 +580,8 @@ static int interp_##nbits##_##name(AVFilterContext *ctx, void *arg, int jobnr, i
     return 0;                                                                                       \
 }
 
-DEFINE_INTERP_FUNC(nearest,     8)
-DEFINE_INTERP_FUNC(trilinear,   8)
-DEFINE_INTERP_FUNC(tetrahedral, 8)
-
-DEFINE_INTERP_FUNC(nearest,     16)
-DEFINE_INTERP_FUNC(trilinear,   16)
-DEFINE_INTERP_FUNC(tetrahedral, 16)
+DEFINE_INTERP_FUNC(8)
+DEFINE_INTERP_FUNC(16)
 
 #define MAX_LINE_SIZE 512
 
@@ -1068,29 +1171,25 @@ static int config_input(AVFilterLink *inlink)
     isfloat = desc->flags & AV_PIX_FMT_FLAG_FLOAT;
     ff_fill_rgba_map(lut3d->rgba_map, inlink->format);
     lut3d->step = av_get_padded_bits_per_pixel(desc) >> (3 + is16bit);
+    lut3d->intab_depth = !isfloat && depth <= MAX_INTAB_DEPTH ? depth : 0;
+    lut3d->intab_lutsize = 0;
+
+    if (planar && !isfloat) {
+        switch (depth) {
+        case  8: lut3d->interp = interp_8_p8;   break;
+        case  9: lut3d->interp = interp_16_p9;  break;
+        case 10: lut3d->interp = interp_16_p10; break;
+        case 12: lut3d->interp = interp_16_p12; break;
+        case 14: lut3d->interp = interp_16_p14; break;
+        case 16: lut3d->interp = interp_16_p16; break;
+        }
+    } else if (isfloat) { lut3d->interp = interp_pf32;
+    } else if (is16bit) { lut3d->interp = interp_16;
+    } else {              lut3d->interp = interp_8; }
 
-#define SET_FUNC(name) do {                                     \
-    if (planar && !isfloat) {                                   \
-        switch (depth) {                                        \
-        case  8: lut3d->interp = interp_8_##name##_p8;   break; \
-        case  9: lut3d->interp = interp_16_##name##_p9;  break; \
-        case 10: lut3d->interp = interp_16_##name##_p10; break; \
-        case 12: lut3d->interp = interp_16_##name##_p12; break; \
-        case 14: lut3d->interp = interp_16_##name##_p14; break; \
-        case 16: lut3d->interp = interp_16_##name##_p16; break; \
-        }                                                       \
-    } else if (isfloat) { lut3d->interp = interp_##name##_pf32; \
-    } else if (is16bit) { lut3d->interp = interp_16_##name;     \
-    } else {       lut3d->interp = interp_8_##name; }           \
-} while (0)
-
-    switch (lut3d->interpolation) {
-    case INTERPOLATE_NEAREST:     SET_FUNC(nearest);        break;
-    case INTERPOLATE_TRILINEAR:   SET_FUNC(trilinear);      break;
-    case INTERPOLATE_TETRAHEDRAL: SET_FUNC(tetrahedral);    break;
-    default:
-        av_assert0(0);
-    }
+    av_assert0(lut3d->interpolation >= 0 && lut3d->interpolation < NB_INTERP_MODE);
+    ff_lut3d_dsp_init(&lut3d->dsp);
+    lut3d->interp_row = lut3d->dsp.interp[lut3d->interpolation];
 
     return 0;
 }
@@ -1103,6 +1202,12 @@ static AVFrame *apply_lut(AVFilterLink *inlink, AVFrame *in)
     AVFrame *out;
     ThreadData td;
 
+    if (lut3d->intab_depth && lut3d->intab_lutsize != lut3d->lutsize &&
+        update_intab(lut3d) < 0) {
+        av_frame_free(&in);
+        return NULL;
+    }
+
     if (av_frame_is_writable(in)) {
         out = in;
     } else {
@@ -1202,6 +1307,7 @@ static av_cold void lut3d_uninit(AVFilterContext *ctx)
 
     for (i = 0; i < 3; i++) {
         av_freep(&lut3d->prelut.lut[i]);
+        av_freep(&lut3d->intab[i]);
     }
 }
 
@@ -1443,6 +1549,8 @@ static int update_apply_clut(FFFrameSync *fs)
     else
         update_clut_packed(ctx->priv, second);
     out = apply_lut(inlink, master);
+    if (!out)
+        return AVERROR(ENOMEM);
     return ff_filter_frame(ctx->outputs[0], out);
 }
 
@@ -1457,8 +1565,11 @@ static av_cold int haldclut_init(AVFilterContext *ctx)
 static av_cold void haldclut_uninit(AVFilterContext *ctx)
 {
     LUT3DContext *lut3d = ctx->priv;
+    int i;
     ff_framesync_uninit(&lut3d->fs);
     av_freep(&lut3d->lut);
+    for (i = 0; i < 3; i++)
+        av_freep(&lut3d->intab[i]);
 }
 
 static const AVOption haldclut_options[] = {
@@ -30,6 +30,7 @@
 #include "formats.h"
 #include "internal.h"
 #include "video.h"
+#include "vf_nnedi.h"
 
 typedef struct FrameData {
     uint8_t *paddedp[3];
@@ -43,8 +44,8 @@ typedef struct FrameData {
     int field[3];
 
     int32_t *lcount[3];
-    float *input;
-    float *temp;
+    float **input;  ///< per-job network input buffers
+    float **temp;   ///< per-job scratch buffers
 } FrameData;
 
 typedef struct NNEDIContext {
@@ -59,6 +60,7 @@ typedef struct NNEDIContext {
     int64_t cur_pts;
 
     AVFloatDSPContext *fdsp;
+    NNEDIDSPContext dsp;
     int nb_planes;
     int linesize[4];
     int planeheight[4];
@@ -82,10 +84,11 @@ typedef struct NNEDIContext {
     int fapprox;
 
     int max_value;
+    int nb_threads;
 
     void (*copy_pad)(const AVFrame *, FrameData *, struct NNEDIContext *, int);
-    void (*evalfunc_0)(struct NNEDIContext *, FrameData *);
-    void (*evalfunc_1)(struct NNEDIContext *, FrameData *);
+    void (*evalfunc_0)(struct NNEDIContext *, FrameData *, int, int);
+    void (*evalfunc_1)(struct NNEDIContext *, FrameData *, int, int);
 
     // Functions used in evalfunc_0
     void (*readpixels)(const uint8_t *, const int, float *);
@@ -95,7 +98,6 @@ typedef struct NNEDIContext {
     // Functions used in evalfunc_1
     void (*extract)(const uint8_t *, const int, const int, const int, float *, float *);
     void (*dot_prod)(struct NNEDIContext *, const float *, const float *, float *, const int, const int, const float *);
-    void (*expfunc)(float *, const int);
     void (*wae5)(const float *, const int, float *);
 
     FrameData frame_data;
@@ -154,6 +156,7 @@ static int config_input(AVFilterLink *inlink)
     const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(inlink->format);
     int ret;
 
+    s->nb_threads = ff_filter_get_nb_threads(ctx);
     s->nb_planes = av_pix_fmt_count_planes(inlink->format);
     if ((ret = av_image_fill_linesizes(s->linesize, inlink->format, inlink->w)) < 0)
         return ret;
@@ -283,14 +286,14 @@ static void dot_prods(NNEDIContext *s, const float *dataf, const float *weightsf
     const int16_t *data = (int16_t *)dataf;
     const int16_t *weights = (int16_t *)weightsf;
     const float *wf = (float *)&weights[n * len];
-    int i, j;
+    int32_t sums[2 * 256];
+    int i;
 
+    s->dsp.dot_prods(sums, data, weights, n, len);
     for (i = 0; i < n; i++) {
-        int sum = 0, off = ((i >> 2) << 3) + (i & 3);
-        for (j = 0; j < len; j++)
-            sum += data[j] * weights[i * len + j];
+        const int off = ((i >> 2) << 3) + (i & 3);
 
-        vals[i] = sum * wf[off] * scale[0] + wf[off + 4];
+        vals[i] = sums[i] * wf[off] * scale[0] + wf[off + 4];
     }
 }
 
@@ -385,16 +388,14 @@ static void compute_network0new(NNEDIContext *s, const float *datai, const float
     int16_t *data = (int16_t *)datai;
     int16_t *ws = (int16_t *)weights;
     float *wf = (float *)&ws[4 * 64];
+    int32_t sums[4];
     float vals[8];
     int mask, i, j;
 
+    s->dsp.dot_prods(sums, data, ws, 4, 64);
     for (i = 0; i < 4; i++) {
-        int sum = 0;
-        float t;
+        const float t = sums[i] * wf[i] + wf[4 + i];
 
-        for (j = 0; j < 64; j++)
-            sum += data[j] * ws[(i << 3) + ((j >> 3) << 5) + (j & 7)];
-        t = sum * wf[i] + wf[4 + i];
         vals[i] = t / (1.0f + FFABS(t));
     }
 
@@ -415,11 +416,19 @@ static void compute_network0new(NNEDIContext *s, const float *datai, const float
     ((int *)d)[0] = mask;
 }
 
-static void evalfunc_0(NNEDIContext *s, FrameData *frame_data)
+/**
+ * Return the first line at or after start with the given parity.
+ */
+static int first_line(const int start, const int parity)
+{
+    return start + ((start & 1) != parity);
+}
+
+static void evalfunc_0(NNEDIContext *s, FrameData *frame_data, int jobnr, int nb_jobs)
 {
-    float *input = frame_data->input;
+    float *input = frame_data->input[jobnr];
     const float *weights0 = s->weights0;
-    float *temp = frame_data->temp;
+    float *temp = frame_data->temp[jobnr];
     uint8_t *tempu = (uint8_t *)temp;
     int plane, x, y;
 
@@ -433,6 +442,8 @@ static void evalfunc_0(NNEDIContext *s, FrameData *frame_data)
 
         uint8_t *dstp = (uint8_t *)frame_data->dstp[plane];
         const int dst_stride = frame_data->dst_stride[plane] / sizeof(uint8_t);
+        const int slice_start = ((height - 12) *  jobnr   ) / nb_jobs;
+        const int slice_end   = ((height - 12) * (jobnr+1)) / nb_jobs;
         const uint8_t *src3p;
         int ystart, ystop;
         int32_t *lcount;
@@ -440,15 +451,15 @@ static void evalfunc_0(NNEDIContext *s, FrameData *frame_data)
         if (!(s->process_plane & (1 << plane)))
             continue;
 
-        for (y = 1 - frame_data->field[plane]; y < height - 12; y += 2) {
+        for (y = first_line(slice_start, 1 - frame_data->field[plane]); y < slice_end; y += 2) {
             memcpy(dstp + y * dst_stride,
                    srcp + 32 + (6 + y) * src_stride,
                    (width - 64) * sizeof(uint8_t));
 
         }
 
-        ystart = 6 + frame_data->field[plane];
-        ystop = height - 6;
+        ystart = 6 + first_line(slice_start, frame_data->field[plane]);
+        ystop = 6 + slice_end;
         srcp += ystart * src_stride;
         dstp += (ystart - 6) * dst_stride - 32;
         src3p = srcp - src_stride * 3;
@@ -549,7 +560,7 @@ static void extract_m8_i16(const uint8_t *srcp, const int stride, const int xdia
 static const float exp_lo = -80.0f;
 static const float exp_hi = +80.0f;
 
-static void e2_m16(float *s, const int n)
+static void e2_m16(float *s, int n)
 {
     int i;
 
@@ -557,6 +568,29 @@ static void e2_m16(float *s, const int n)
         s[i] = exp(av_clipf(s[i], exp_lo, exp_hi));
 }
 
+static void dot_prods_c(int32_t *sums, const int16_t *data,
+                        const int16_t *weights, int n, int len)
+{
+    int i, j;
+
+    for (i = 0; i < n; i++) {
+        int sum = 0;
+
+        for (j = 0; j < len; j++)
+            sum += data[j] * weights[i * len + j];
+        sums[i] = sum;
+    }
+}
+
+void ff_nnedi_init(NNEDIDSPContext *dsp)
+{
+    dsp->dot_prods = dot_prods_c;
+    dsp->exp       = e2_m16;
+
+    if (ARCH_X86)
+        ff_nnedi_init_x86(dsp);
+}
+
 const float min_weight_sum = 1e-10f;
 
 static void weighted_avg_elliott_mul5_m16(const float *w, const int n, float *mstd)
@@ -575,10 +609,10 @@ static void weighted_avg_elliott_mul5_m16(const float *w, const int n, float *ms
 }
 
 
-static void evalfunc_1(NNEDIContext *s, FrameData *frame_data)
+static void evalfunc_1(NNEDIContext *s, FrameData *frame_data, int jobnr, int nb_jobs)
 {
-    float *input = frame_data->input;
-    float *temp = frame_data->temp;
+    float *input = frame_data->input[jobnr];
+    float *temp = frame_data->temp[jobnr];
     float **weights1 = s->weights1;
     const int qual = s->qual;
     const int asize = s->asize;
@@ -599,8 +633,10 @@ static void evalfunc_1(NNEDIContext *s, FrameData *frame_data)
         uint8_t *dstp = (uint8_t *)frame_data->dstp[plane];
         const int dst_stride = frame_data->dst_stride[plane] / sizeof(uint8_t);
 
-        const int ystart = frame_data->field[plane];
-        const int ystop = height - 12;
+        const int slice_start = ((height - 12) *  jobnr   ) / nb_jobs;
+        const int slice_end   = ((height - 12) * (jobnr+1)) / nb_jobs;
+        const int ystart = first_line(slice_start, frame_data->field[plane]);
+        const int ystop = slice_end;
         const uint8_t *srcpp;
 
         if (!(s->process_plane & (1 << plane)))
@@ -620,7 +656,7 @@ static void evalfunc_1(NNEDIContext *s, FrameData *frame_data)
                 s->extract((const uint8_t *)(srcpp + x), src_stride, xdia, ydia, mstd, input);
                 for (i = 0; i < qual; i++) {
                     s->dot_prod(s, input, weights1[i], temp, nns * 2, asize, mstd + 2);
-                    s->expfunc(temp, nns);
+                    s->dsp.exp(temp, nns);
                     s->wae5(temp, nns, mstd);
                 }
 
@@ -675,8 +711,6 @@ static void select_functions(NNEDIContext *s)
         s->extract = extract_m8;
         s->dot_prod = dot_prod;
     }
-
-    s->expfunc = e2_m16;
 }
 
 static int modnpf(const int m, const int n)
@@ -686,6 +720,20 @@ static int modnpf(const int m, const int n)
     return m + n - (m % n);
 }
 
+static int filter_slice(AVFilterContext *ctx, void *arg, int jobnr, int nb_jobs)
+{
+    NNEDIContext *s = ctx->priv;
+    FrameData *frame_data = arg;
+
+    // Handles prescreening and the cubic interpolation.
+    s->evalfunc_0(s, frame_data, jobnr, nb_jobs);
+
+    // The rest.
+    s->evalfunc_1(s, frame_data, jobnr, nb_jobs);
+
+    return 0;
+}
+
 static int get_frame(AVFilterContext *ctx, int is_second)
 {
     NNEDIContext *s = ctx->priv;
@@ -766,27 +814,37 @@ static int get_frame(AVFilterContext *ctx, int is_second)
     }
 
     if (!frame_data->input) {
-        frame_data->input = av_malloc(512 * sizeof(float));
+        frame_data->input = av_calloc(s->nb_threads, sizeof(*frame_data->input));
         if (!frame_data->input)
             return AVERROR(ENOMEM);
     }
-    // evalfunc_0 requires at least padded_width[0] bytes.
-    // evalfunc_1 requires at least 512 floats.
     if (!frame_data->temp) {
-        temp_size = FFMAX(frame_data->padded_width[0], 512 * sizeof(float));
-        frame_data->temp = av_malloc(temp_size);
+        frame_data->temp = av_calloc(s->nb_threads, sizeof(*frame_data->temp));
         if (!frame_data->temp)
             return AVERROR(ENOMEM);
     }
 
+    for (int i = 0; i < s->nb_threads; i++) {
+        if (!frame_data->input[i]) {
+            frame_data->input[i] = av_malloc(512 * sizeof(float));
+            if (!frame_data->input[i])
+                return AVERROR(ENOMEM);
+        }
+        // evalfunc_0 requires at least padded_width[0] bytes.
+        // evalfunc_1 requires at least 512 floats.
+        if (!frame_data->temp[i]) {
+            temp_size = FFMAX(frame_data->padded_width[0], 512 * sizeof(float));
+            frame_data->temp[i] = av_malloc(temp_size);
+            if (!frame_data->temp[i])
+                return AVERROR(ENOMEM);
+        }
+    }
+
     // Copy src to a padded "frame" in frame_data and mirror the edges.
     s->copy_pad(src, frame_data, s, field_n);
 
-    // Handles prescreening and the cubic interpolation.
-    s->evalfunc_0(s, frame_data);
-
-    // The rest.
-    s->evalfunc_1(s, frame_data);
+    ctx->internal->execute(ctx, filter_slice, frame_data, NULL,
+                           FFMIN(s->planeheight[1], s->nb_threads));
 
     return 0;
 }
@@ -1020,6 +1078,7 @@ static av_cold int init(AVFilterContext *ctx)
         }
         // Factor mean removal and 1.0/127.5 scaling
         // into first layer weights. scale to int16 range
+        // and store them one neuron after the other
         for (j = 0; j < 4; j++) {
             double scale, mval = 0.0;
 
@@ -1027,7 +1086,7 @@ static av_cold int init(AVFilterContext *ctx)
                 mval = FFMAX(mval, FFABS((bdw[offt[j * 64 + k]] - mean[j]) / 127.5));
             scale = 32767.0 / mval;
             for (k = 0; k < 64; k++)
-                ws[offt[j * 64 + k]] = roundds(((bdw[offt[j * 64 + k]] - mean[j]) / 127.5) * scale);
+                ws[j * 64 + k] = roundds(((bdw[offt[j * 64 + k]] - mean[j]) / 127.5) * scale);
             wf[j] = (float)(mval / 32767.0);
         }
         memcpy(wf + 4, bdw + 4 * 64, (dims0new - 4 * 64) * sizeof(float));
@@ -1146,6 +1205,7 @@ static av_cold int init(AVFilterContext *ctx)
     s->max_value = 65535 >> 8;
 
     select_functions(s);
+    ff_nnedi_init(&s->dsp);
 
     s->fdsp = avpriv_float_dsp_alloc(0);
     if (!s->fdsp)
@@ -1171,6 +1231,12 @@ static av_cold void uninit(AVFilterContext *ctx)
         av_freep(&s->frame_data.lcount[i]);
     }
 
+    for (i = 0; i < s->nb_threads; i++) {
+        if (s->frame_data.input)
+            av_freep(&s->frame_data.input[i]);
+        if (s->frame_data.temp)
+            av_freep(&s->frame_data.temp[i]);
+    }
     av_freep(&s->frame_data.input);
     av_freep(&s->frame_data.temp);
     av_freep(&s->fdsp);
@@ -1207,5 +1273,5 @@ AVFilter ff_vf_nnedi = {
     .query_formats = query_formats,
     .inputs        = inputs,
     .outputs       = outputs,
-    .flags         = AVFILTER_FLAG_SUPPORT_TIMELINE_INTERNAL,
+    .flags         = AVFILTER_FLAG_SUPPORT_TIMELINE_INTERNAL | AVFILTER_FLAG_SLICE_THREADS,
 };
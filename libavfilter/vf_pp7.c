@@ -197,33 +197,33 @@ static int softthresh_c(PP7Context *p, int16_t *src, int qp)
     return (a + (1 << 11)) >> 12;
 }
 
-static void filter(PP7Context *p, uint8_t *dst, uint8_t *src,
-                   int dst_stride, int src_stride,
-                   int width, int height,
-                   uint8_t *qp_store, int qp_stride, int is_luma)
+typedef struct ThreadData {
+    uint8_t *dst;
+    int dst_stride;
+    int width, height;
+    uint8_t *qp_store;
+    int qp_stride;
+    int is_luma;
+} ThreadData;
+
+static int filter_slice(AVFilterContext *ctx, void *arg, int jobnr, int nb_jobs)
 {
-    int x, y;
+    PP7Context *p = ctx->priv;
+    ThreadData *td = arg;
+    uint8_t *dst = td->dst;
+    const int dst_stride = td->dst_stride;
+    const int width = td->width, height = td->height;
+    const int is_luma = td->is_luma;
     const int stride = is_luma ? p->temp_stride : ((width + 16 + 15) & (~15));
+    const int slice_start = (height *  jobnr   ) / nb_jobs;
+    const int slice_end   = (height * (jobnr+1)) / nb_jobs;
     uint8_t *p_src = p->src + 8 * stride;
-    int16_t *block = (int16_t *)p->src;
-    int16_t *temp  = (int16_t *)(p->src + 32);
-
-    if (!src || !dst) return;
-    for (y = 0; y < height; y++) {
-        int index = 8 + 8 * stride + y * stride;
-        memcpy(p_src + index, src + y * src_stride, width);
-        for (x = 0; x < 8; x++) {
-            p_src[index         - x - 1]= p_src[index +         x    ];
-            p_src[index + width + x    ]= p_src[index + width - x - 1];
-        }
-    }
-    for (y = 0; y < 8; y++) {
-        memcpy(p_src + (    7 - y     ) * stride, p_src + (    y + 8     ) * stride, stride);
-        memcpy(p_src + (height + 8 + y) * stride, p_src + (height - y + 7) * stride, stride);
-    }
-    //FIXME (try edge emu)
+    uint8_t *scratch = p->scratch + jobnr * 8 * p->temp_stride;
+    int16_t *block = (int16_t *)scratch;
+    int16_t *temp  = (int16_t *)(scratch + 32);
+    int x, y;
 
-    for (y = 0; y < height; y++) {
+    for (y = slice_start; y < slice_end; y++) {
         for (x = -8; x < 0; x += 4) {
             const int index = x + y * stride + (8 - 3) * (1 + stride) + 8; //FIXME silly offset
             uint8_t *src  = p_src + index;
@@ -239,7 +239,7 @@ static void filter(PP7Context *p, uint8_t *dst, uint8_t *src,
             if (p->qp)
                 qp = p->qp;
             else {
-                qp = qp_store[ (FFMIN(x, width - 1) >> qps) + (FFMIN(y, height - 1) >> qps) * qp_stride];
+                qp = td->qp_store[ (FFMIN(x, width - 1) >> qps) + (FFMIN(y, height - 1) >> qps) * td->qp_stride];
                 qp = ff_norm_qscale(qp, p->qscale_type);
             }
             for (; x < end; x++) {
@@ -261,6 +261,46 @@ static void filter(PP7Context *p, uint8_t *dst, uint8_t *src,
             }
         }
     }
+    emms_c();
+
+    return 0;
+}
+
+static void filter(AVFilterContext *ctx, uint8_t *dst, uint8_t *src,
+                   int dst_stride, int src_stride,
+                   int width, int height,
+                   uint8_t *qp_store, int qp_stride, int is_luma)
+{
+    PP7Context *p = ctx->priv;
+    ThreadData td;
+    int x, y;
+    const int stride = is_luma ? p->temp_stride : ((width + 16 + 15) & (~15));
+    uint8_t *p_src = p->src + 8 * stride;
+
+    if (!src || !dst) return;
+    for (y = 0; y < height; y++) {
+        int index = 8 + 8 * stride + y * stride;
+        memcpy(p_src + index, src + y * src_stride, width);
+        for (x = 0; x < 8; x++) {
+            p_src[index         - x - 1]= p_src[index +         x    ];
+            p_src[index + width + x    ]= p_src[index + width - x - 1];
+        }
+    }
+    for (y = 0; y < 8; y++) {
+        memcpy(p_src + (    7 - y     ) * stride, p_src + (    y + 8     ) * stride, stride);
+        memcpy(p_src + (height + 8 + y) * stride, p_src + (height - y + 7) * stride, stride);
+    }
+    //FIXME (try edge emu)
+
+    td.dst        = dst;
+    td.dst_stride = dst_stride;
+    td.width      = width;
+    td.height     = height;
+    td.qp_store   = qp_store;
+    td.qp_stride  = qp_stride;
+    td.is_luma    = is_luma;
+    ctx->internal->execute(ctx, filter_slice, &td, NULL,
+                           FFMIN(height, p->nb_threads));
 }
 
 static int query_formats(AVFilterContext *ctx)
@@ -291,10 +331,12 @@ static int config_input(AVFilterLink *inlink)
     pp7->hsub = desc->log2_chroma_w;
     pp7->vsub = desc->log2_chroma_h;
 
+    pp7->nb_threads = ff_filter_get_nb_threads(ctx);
     pp7->temp_stride = FFALIGN(inlink->w + 16, 16);
     pp7->src = av_malloc_array(pp7->temp_stride,  (h + 8) * sizeof(uint8_t));
+    pp7->scratch = av_malloc_array(pp7->temp_stride, 8 * pp7->nb_threads);
 
-    if (!pp7->src)
+    if (!pp7->src || !pp7->scratch)
         return AVERROR(ENOMEM);
 
     init_thres2(pp7);
@@ -349,13 +391,12 @@ static int filter_frame(AVFilterLink *inlink, AVFrame *in)
 
         if (qp_table || pp7->qp) {
 
-            filter(pp7, out->data[0], in->data[0], out->linesize[0], in->linesize[0],
+            filter(ctx, out->data[0], in->data[0], out->linesize[0], in->linesize[0],
                    inlink->w, inlink->h, qp_table, qp_stride, 1);
-            filter(pp7, out->data[1], in->data[1], out->linesize[1], in->linesize[1],
+            filter(ctx, out->data[1], in->data[1], out->linesize[1], in->linesize[1],
                    cw,        ch,        qp_table, qp_stride, 0);
-            filter(pp7, out->data[2], in->data[2], out->linesize[2], in->linesize[2],
+            filter(ctx, out->data[2], in->data[2], out->linesize[2], in->linesize[2],
                    cw,        ch,        qp_table, qp_stride, 0);
-            emms_c();
         }
     }
 
@@ -373,6 +414,7 @@ static av_cold void uninit(AVFilterContext *ctx)
 {
     PP7Context *pp7 = ctx->priv;
     av_freep(&pp7->src);
+    av_freep(&pp7->scratch);
 }
 
 static const AVFilterPad pp7_inputs[] = {
@@ -402,5 +444,5 @@ AVFilter ff_vf_pp7 = {
     .inputs          = pp7_inputs,
     .outputs         = pp7_outputs,
     .priv_class      = &pp7_class,
-    .flags           = AVFILTER_FLAG_SUPPORT_TIMELINE_INTERNAL,
+    .flags           = AVFILTER_FLAG_SUPPORT_TIMELINE_INTERNAL | AVFILTER_FLAG_SLICE_THREADS,
 };
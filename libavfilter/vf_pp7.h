@@ -34,7 +34,9 @@ typedef struct PP7Context {
     int hsub;
     int vsub;
     int temp_stride;
+    int nb_threads;
     uint8_t *src;
+    uint8_t *scratch;   ///< per-thread DCT scratch, 8 * temp_stride bytes each
 
     int (*requantize)(struct PP7Context *p, int16_t *src, int qp);
     void (*dctB)(int16_t *dst, int16_t *src);
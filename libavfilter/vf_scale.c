@@ -524,6 +524,10 @@ static int config_props(AVFilterLink *outlink)
         inlink0->h == outlink->h &&
         !scale->out_color_matrix &&
         scale->in_range == scale->out_range &&
+        !av_dict_get(scale->opts, "src_transfer",  NULL, 0) &&
+        !av_dict_get(scale->opts, "dst_transfer",  NULL, 0) &&
+        !av_dict_get(scale->opts, "src_primaries", NULL, 0) &&
+        !av_dict_get(scale->opts, "dst_primaries", NULL, 0) &&
         inlink0->format == outlink->format)
         ;
     else {
@@ -546,6 +550,7 @@ static int config_props(AVFilterLink *outlink)
             av_opt_set_int(*s, "sws_flags", scale->flags, 0);
             av_opt_set_int(*s, "param0", scale->param[0], 0);
             av_opt_set_int(*s, "param1", scale->param[1], 0);
+            av_opt_set_int(*s, "threads", ff_filter_get_nb_threads(ctx), 0);
             if (scale->in_range != AVCOL_RANGE_UNSPECIFIED)
                 av_opt_set_int(*s, "src_range",
                                scale->in_range == AVCOL_RANGE_JPEG, 0);
@@ -658,6 +663,7 @@ static int scale_frame(AVFilterLink *link, AVFrame *in, AVFrame **frame_out)
     const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(link->format);
     char buf[32];
     int in_range;
+    int64_t val;
     int frame_changed;
 
     *frame_out = NULL;
@@ -746,6 +752,14 @@ scale:
 
     in_range = in->color_range;
 
+    /* tag the output with the characteristics the scaler converted to */
+    if (av_opt_get_int(scale->sws, "dst_transfer", 0, &val) >= 0 &&
+        val != AVCOL_TRC_UNSPECIFIED)
+        out->color_trc = val;
+    if (av_opt_get_int(scale->sws, "dst_primaries", 0, &val) >= 0 &&
+        val != AVCOL_PRI_UNSPECIFIED)
+        out->color_primaries = val;
+
     if (   scale->in_color_matrix
         || scale->out_color_matrix
         || scale-> in_range != AVCOL_RANGE_UNSPECIFIED
@@ -29,6 +29,7 @@
 
 #include "avfilter.h"
 #include "filters.h"
+#include "framestats.h"
 #include "scene_sad.h"
 
 typedef struct SCDetContext {
@@ -124,13 +125,17 @@ static double get_scene_score(AVFilterContext *ctx, AVFrame *frame)
         uint64_t sad = 0;
         double mafd, diff;
         uint64_t count = 0;
+        int have_sad = ff_frame_stats_sad(frame, prev_picref, s->nb_planes, &sad);
 
         for (int plane = 0; plane < s->nb_planes; plane++) {
             uint64_t plane_sad;
-            s->sad(prev_picref->data[plane], prev_picref->linesize[plane],
-                    frame->data[plane], frame->linesize[plane],
-                    s->width[plane], s->height[plane], &plane_sad);
-            sad += plane_sad;
+            if (!have_sad) {
+                ff_scene_sad_threaded(ctx, s->sad,
+                                      prev_picref->data[plane], prev_picref->linesize[plane],
+                                      frame->data[plane], frame->linesize[plane],
+                                      s->width[plane], s->height[plane], &plane_sad);
+                sad += plane_sad;
+            }
             count += s->width[plane] * s->height[plane];
         }
 
@@ -221,4 +226,5 @@ AVFilter ff_vf_scdet = {
     .inputs        = scdet_inputs,
     .outputs       = scdet_outputs,
     .activate      = activate,
+    .flags         = AVFILTER_FLAG_SLICE_THREADS,
 };
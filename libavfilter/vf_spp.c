@@ -234,41 +234,41 @@ static inline void add_block(uint16_t *dst, int linesize, const int16_t block[64
     }
 }
 
-static void filter(SPPContext *p, uint8_t *dst, uint8_t *src,
-                   int dst_linesize, int src_linesize, int width, int height,
-                   const uint8_t *qp_table, int qp_stride, int is_luma, int depth)
+typedef struct ThreadData {
+    uint8_t *dst;
+    int dst_linesize;
+    int width, height;
+    const uint8_t *qp_table;
+    int qp_stride;
+    int is_luma;
+    int depth;
+} ThreadData;
+
+static int filter_slice(AVFilterContext *ctx, void *arg, int jobnr, int nb_jobs)
 {
+    SPPContext *p = ctx->priv;
+    ThreadData *td = arg;
+    uint8_t *dst = td->dst;
+    const int dst_linesize = td->dst_linesize;
+    const int width = td->width, height = td->height;
+    const int is_luma = td->is_luma, depth = td->depth;
     int x, y, i;
     const int count = 1 << p->log2_count;
     const int linesize = is_luma ? p->temp_linesize : FFALIGN(width+16, 16);
+    const int sample_bytes = (depth+7) / 8;
+    const int nb_bands = (height + 15) / 8;
+    const int band_start = 8 * ((nb_bands *  jobnr   ) / nb_jobs);
+    const int band_end   = 8 * ((nb_bands * (jobnr+1)) / nb_jobs);
+    uint16_t *temp = p->temp + jobnr * p->temp_linesize * p->temp_height;
     DECLARE_ALIGNED(16, uint64_t, block_align)[32];
     int16_t *block  = (int16_t *)block_align;
     int16_t *block2 = (int16_t *)(block_align + 16);
-    uint16_t *psrc16 = (uint16_t*)p->src;
-    const int sample_bytes = (depth+7) / 8;
 
-    for (y = 0; y < height; y++) {
-        int index = 8 + 8*linesize + y*linesize;
-        memcpy(p->src + index*sample_bytes, src + y*src_linesize, width*sample_bytes);
-        if (sample_bytes == 1) {
-            for (x = 0; x < 8; x++) {
-                p->src[index         - x - 1] = p->src[index +         x    ];
-                p->src[index + width + x    ] = p->src[index + width - x - 1];
-            }
-        } else {
-            for (x = 0; x < 8; x++) {
-                psrc16[index         - x - 1] = psrc16[index +         x    ];
-                psrc16[index + width + x    ] = psrc16[index + width - x - 1];
-            }
-        }
-    }
-    for (y = 0; y < 8; y++) {
-        memcpy(p->src + (       7-y)*linesize * sample_bytes, p->src + (       y+8)*linesize * sample_bytes, linesize * sample_bytes);
-        memcpy(p->src + (height+8+y)*linesize * sample_bytes, p->src + (height-y+7)*linesize * sample_bytes, linesize * sample_bytes);
-    }
-
-    for (y = 0; y < height + 8; y += 8) {
-        memset(p->temp + (8 + y) * linesize, 0, 8 * linesize * sizeof(*p->temp));
+    /* The rows stored for a band also receive the contributions of the
+     * previous band, so each slice starts one band early without storing
+     * it. */
+    for (y = FFMAX(band_start - 8, 0); y < band_end; y += 8) {
+        memset(temp + (8 + y) * linesize, 0, 8 * linesize * sizeof(*temp));
         for (x = 0; x < width + 8; x += 8) {
             int qp;
 
@@ -276,7 +276,7 @@ static void filter(SPPContext *p, uint8_t *dst, uint8_t *src,
                 qp = p->qp;
             } else{
                 const int qps = 3 + is_luma;
-                qp = qp_table[(FFMIN(x, width - 1) >> qps) + (FFMIN(y, height - 1) >> qps) * qp_stride];
+                qp = td->qp_table[(FFMIN(x, width - 1) >> qps) + (FFMIN(y, height - 1) >> qps) * td->qp_stride];
                 qp = FFMAX(1, ff_norm_qscale(qp, p->qscale_type));
             }
             for (i = 0; i < count; i++) {
@@ -287,23 +287,69 @@ static void filter(SPPContext *p, uint8_t *dst, uint8_t *src,
                 p->dct->fdct(block);
                 p->requantize(block2, block, qp, p->dct->idct_permutation);
                 p->dct->idct(block2);
-                add_block(p->temp + index, linesize, block2);
+                add_block(temp + index, linesize, block2);
             }
         }
-        if (y) {
+        if (y >= band_start && y) {
             if (sample_bytes == 1) {
-                p->store_slice(dst + (y - 8) * dst_linesize, p->temp + 8 + y*linesize,
+                p->store_slice(dst + (y - 8) * dst_linesize, temp + 8 + y*linesize,
                                dst_linesize, linesize, width,
                                FFMIN(8, height + 8 - y), MAX_LEVEL - p->log2_count,
                                ldither);
             } else {
-                store_slice16_c((uint16_t*)(dst + (y - 8) * dst_linesize), p->temp + 8 + y*linesize,
+                store_slice16_c((uint16_t*)(dst + (y - 8) * dst_linesize), temp + 8 + y*linesize,
                                 dst_linesize/2, linesize, width,
                                 FFMIN(8, height + 8 - y), MAX_LEVEL - p->log2_count,
                                 ldither, depth);
             }
         }
     }
+    emms_c();
+
+    return 0;
+}
+
+static void filter(AVFilterContext *ctx, uint8_t *dst, uint8_t *src,
+                   int dst_linesize, int src_linesize, int width, int height,
+                   const uint8_t *qp_table, int qp_stride, int is_luma, int depth)
+{
+    SPPContext *p = ctx->priv;
+    ThreadData td;
+    int x, y;
+    const int linesize = is_luma ? p->temp_linesize : FFALIGN(width+16, 16);
+    uint16_t *psrc16 = (uint16_t*)p->src;
+    const int sample_bytes = (depth+7) / 8;
+
+    for (y = 0; y < height; y++) {
+        int index = 8 + 8*linesize + y*linesize;
+        memcpy(p->src + index*sample_bytes, src + y*src_linesize, width*sample_bytes);
+        if (sample_bytes == 1) {
+            for (x = 0; x < 8; x++) {
+                p->src[index         - x - 1] = p->src[index +         x    ];
+                p->src[index + width + x    ] = p->src[index + width - x - 1];
+            }
+        } else {
+            for (x = 0; x < 8; x++) {
+                psrc16[index         - x - 1] = psrc16[index +         x    ];
+                psrc16[index + width + x    ] = psrc16[index + width - x - 1];
+            }
+        }
+    }
+    for (y = 0; y < 8; y++) {
+        memcpy(p->src + (       7-y)*linesize * sample_bytes, p->src + (       y+8)*linesize * sample_bytes, linesize * sample_bytes);
+        memcpy(p->src + (height+8+y)*linesize * sample_bytes, p->src + (height-y+7)*linesize * sample_bytes, linesize * sample_bytes);
+    }
+
+    td.dst          = dst;
+    td.dst_linesize = dst_linesize;
+    td.width        = width;
+    td.height       = height;
+    td.qp_table     = qp_table;
+    td.qp_stride    = qp_stride;
+    td.is_luma      = is_luma;
+    td.depth        = depth;
+    ctx->internal->execute(ctx, filter_slice, &td, NULL,
+                           FFMIN((height + 15) / 8, p->nb_threads));
 }
 
 static int query_formats(AVFilterContext *ctx)
@@ -333,7 +379,8 @@ static int query_formats(AVFilterContext *ctx)
 
 static int config_input(AVFilterLink *inlink)
 {
-    SPPContext *s = inlink->dst->priv;
+    AVFilterContext *ctx = inlink->dst;
+    SPPContext *s = ctx->priv;
     const int h = FFALIGN(inlink->h + 16, 16);
     const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(inlink->format);
     const int bps = desc->comp[0].depth;
@@ -346,8 +393,10 @@ static int config_input(AVFilterLink *inlink)
 
     s->hsub = desc->log2_chroma_w;
     s->vsub = desc->log2_chroma_h;
+    s->nb_threads = ff_filter_get_nb_threads(ctx);
     s->temp_linesize = FFALIGN(inlink->w + 16, 16);
-    s->temp = av_malloc_array(s->temp_linesize, h * sizeof(*s->temp));
+    s->temp_height = h;
+    s->temp = av_malloc_array(s->temp_linesize, s->nb_threads * h * sizeof(*s->temp));
     s->src  = av_malloc_array(s->temp_linesize, h * sizeof(*s->src) * 2);
 
     if (!s->temp || !s->src)
@@ -424,13 +473,12 @@ static int filter_frame(AVFilterLink *inlink, AVFrame *in)
                 out->height = in->height;
             }
 
-            filter(s, out->data[0], in->data[0], out->linesize[0], in->linesize[0], inlink->w, inlink->h, qp_table, qp_stride, 1, depth);
+            filter(ctx, out->data[0], in->data[0], out->linesize[0], in->linesize[0], inlink->w, inlink->h, qp_table, qp_stride, 1, depth);
 
             if (out->data[2]) {
-                filter(s, out->data[1], in->data[1], out->linesize[1], in->linesize[1], cw,        ch,        qp_table, qp_stride, 0, depth);
-                filter(s, out->data[2], in->data[2], out->linesize[2], in->linesize[2], cw,        ch,        qp_table, qp_stride, 0, depth);
+                filter(ctx, out->data[1], in->data[1], out->linesize[1], in->linesize[1], cw,        ch,        qp_table, qp_stride, 0, depth);
+                filter(ctx, out->data[2], in->data[2], out->linesize[2], in->linesize[2], cw,        ch,        qp_table, qp_stride, 0, depth);
             }
-            emms_c();
         }
     }
 
@@ -525,5 +573,5 @@ AVFilter ff_vf_spp = {
     .outputs         = spp_outputs,
     .process_command = process_command,
     .priv_class      = &spp_class,
-    .flags           = AVFILTER_FLAG_SUPPORT_TIMELINE_INTERNAL,
+    .flags           = AVFILTER_FLAG_SUPPORT_TIMELINE_INTERNAL | AVFILTER_FLAG_SLICE_THREADS,
 };
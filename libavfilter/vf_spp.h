@@ -35,8 +35,10 @@ typedef struct SPPContext {
     int mode;
     int qscale_type;
     int temp_linesize;
+    int temp_height;
+    int nb_threads;
     uint8_t *src;
-    uint16_t *temp;
+    uint16_t *temp;     ///< one accumulation buffer per slice thread
     AVDCT *dct;
     int8_t *non_b_qp_table;
     int non_b_qp_alloc_size;
@@ -47,10 +47,11 @@ typedef struct USPPContext {
     uint8_t *src[3];
     uint16_t *temp[3];
     int outbuf_size;
-    uint8_t *outbuf;
+    uint8_t *outbuf[BLOCK*BLOCK];
     AVCodecContext *avctx_enc[BLOCK*BLOCK];
-    AVFrame *frame;
-    AVFrame *frame_dec;
+    AVFrame *frame[BLOCK*BLOCK];
+    AVFrame *frame_dec[BLOCK*BLOCK];
+    int nb_threads;
     uint8_t *non_b_qp_table;
     int non_b_qp_alloc_size;
     int use_bframe_qp;
@@ -180,13 +181,97 @@ static void store_slice_c(uint8_t *dst, const uint16_t *src,
     }
 }
 
-static void filter(USPPContext *p, uint8_t *dst[3], uint8_t *src[3],
+typedef struct ThreadData {
+    int width, height;
+    int plane;
+} ThreadData;
+
+static int encode_slice(AVFilterContext *ctx, void *arg, int jobnr, int nb_jobs)
+{
+    USPPContext *p = ctx->priv;
+    const int count = 1 << p->log2_count;
+    const int slice_start = (count *  jobnr   ) / nb_jobs;
+    const int slice_end   = (count * (jobnr+1)) / nb_jobs;
+
+    for (int i = slice_start; i < slice_end; i++) {
+        const int x1 = offset[i+count-1][0];
+        const int y1 = offset[i+count-1][1];
+        const int x1c = x1 >> p->hsub;
+        const int y1c = y1 >> p->vsub;
+        AVFrame *frame = p->frame[i];
+        AVPacket pkt = {0};
+        int got_pkt_ptr;
+        int ret;
+
+        av_init_packet(&pkt);
+        pkt.data = p->outbuf[jobnr];
+        pkt.size = p->outbuf_size;
+
+        frame->data[0] = p->src[0] + x1   + y1   * frame->linesize[0];
+        frame->data[1] = p->src[1] + x1c  + y1c  * frame->linesize[1];
+        frame->data[2] = p->src[2] + x1c  + y1c  * frame->linesize[2];
+        frame->format  = p->avctx_enc[i]->pix_fmt;
+
+        ret = avcodec_encode_video2(p->avctx_enc[i], &pkt, frame, &got_pkt_ptr);
+        if (ret < 0) {
+            av_log(p->avctx_enc[i], AV_LOG_ERROR, "Encoding failed\n");
+            p->frame_dec[i] = NULL;
+            continue;
+        }
+
+        p->frame_dec[i] = p->avctx_enc[i]->coded_frame;
+    }
+
+    return 0;
+}
+
+static int accumulate_slice(AVFilterContext *ctx, void *arg, int jobnr, int nb_jobs)
+{
+    USPPContext *p = ctx->priv;
+    ThreadData *td = arg;
+    const int count = 1 << p->log2_count;
+    const int plane = td->plane;
+    const int is_chroma = !!plane;
+    const int hsub = is_chroma ? p->hsub : 0;
+    const int vsub = is_chroma ? p->vsub : 0;
+    const int w = AV_CEIL_RSHIFT(td->width,  hsub);
+    const int h = AV_CEIL_RSHIFT(td->height, vsub);
+    const int block = BLOCK >> hsub;
+    const int slice_start = (h *  jobnr   ) / nb_jobs;
+    const int slice_end   = (h * (jobnr+1)) / nb_jobs;
+    uint16_t *temp = p->temp[plane];
+    const int temp_stride = p->temp_stride[plane];
+
+    for (int i = 0; i < count; i++) {
+        const int x1 = offset[i+count-1][0] >> hsub;
+        const int y1 = offset[i+count-1][1] >> vsub;
+        const AVFrame *frame_dec = p->frame_dec[i];
+        const uint8_t *src;
+        int linesize;
+
+        if (!frame_dec)
+            continue;
+
+        linesize = frame_dec->linesize[plane];
+        src = frame_dec->data[plane] + (block - x1) + (block - y1) * linesize;
+
+        for (int y = slice_start; y < slice_end; y++)
+            for (int x = 0; x < w; x++)
+                temp[x + y * temp_stride] += src[x + y * linesize];
+    }
+
+    return 0;
+}
+
+static void filter(AVFilterContext *ctx, uint8_t *dst[3], uint8_t *src[3],
                    int dst_stride[3], int src_stride[3], int width,
                    int height, uint8_t *qp_store, int qp_stride)
 {
+    USPPContext *p = ctx->priv;
+    ThreadData td;
     int x, y, i, j;
     const int count = 1<<p->log2_count;
-    int ret;
+    int quality;
 
     for (i = 0; i < 3; i++) {
         int is_chroma = !!i;
@@ -211,12 +296,13 @@ static void filter(USPPContext *p, uint8_t *dst[3], uint8_t *src[3],
             memcpy(p->src[i] + (h+block  +y) * stride, p->src[i] + (h-y+block-1) * stride, stride);
         }
 
-        p->frame->linesize[i] = stride;
+        for (j = 0; j < count; j++)
+            p->frame[j]->linesize[i] = stride;
         memset(p->temp[i], 0, (h + 2 * block) * stride * sizeof(int16_t));
     }
 
     if (p->qp)
-        p->frame->quality = p->qp * FF_QP2LAMBDA;
+        quality = p->qp * FF_QP2LAMBDA;
     else {
         int qpsum=0;
         int qpcount = (height>>4) * (height>>4);
@@ -225,56 +311,26 @@ static void filter(USPPContext *p, uint8_t *dst[3], uint8_t *src[3],
             for (x = 0; x < (width>>4); x++)
                 qpsum += qp_store[x + y * qp_stride];
         }
-        p->frame->quality = ff_norm_qscale((qpsum + qpcount/2) / qpcount, p->qscale_type) * FF_QP2LAMBDA;
+        quality = ff_norm_qscale((qpsum + qpcount/2) / qpcount, p->qscale_type) * FF_QP2LAMBDA;
     }
 //    init per MB qscale stuff FIXME
-    p->frame->height = height + BLOCK;
-    p->frame->width  = width + BLOCK;
-
     for (i = 0; i < count; i++) {
-        const int x1 = offset[i+count-1][0];
-        const int y1 = offset[i+count-1][1];
-        const int x1c = x1 >> p->hsub;
-        const int y1c = y1 >> p->vsub;
-        const int BLOCKc = BLOCK >> p->hsub;
-        int offset;
-        AVPacket pkt = {0};
-        int got_pkt_ptr;
-
-        av_init_packet(&pkt);
-        pkt.data = p->outbuf;
-        pkt.size = p->outbuf_size;
-
-        p->frame->data[0] = p->src[0] + x1   + y1   * p->frame->linesize[0];
-        p->frame->data[1] = p->src[1] + x1c  + y1c  * p->frame->linesize[1];
-        p->frame->data[2] = p->src[2] + x1c  + y1c  * p->frame->linesize[2];
-        p->frame->format  = p->avctx_enc[i]->pix_fmt;
-
-        ret = avcodec_encode_video2(p->avctx_enc[i], &pkt, p->frame, &got_pkt_ptr);
-        if (ret < 0) {
-            av_log(p->avctx_enc[i], AV_LOG_ERROR, "Encoding failed\n");
-            continue;
-        }
-
-        p->frame_dec = p->avctx_enc[i]->coded_frame;
-
-        offset = (BLOCK-x1) + (BLOCK-y1) * p->frame_dec->linesize[0];
-
-        for (y = 0; y < height; y++)
-            for (x = 0; x < width; x++)
-                p->temp[0][x + y * p->temp_stride[0]] += p->frame_dec->data[0][x + y * p->frame_dec->linesize[0] + offset];
-
-        if (!src[2] || !dst[2])
-            continue;
-
-        offset = (BLOCKc-x1c) + (BLOCKc-y1c) * p->frame_dec->linesize[1];
+        p->frame[i]->quality = quality;
+        p->frame[i]->height  = height + BLOCK;
+        p->frame[i]->width   = width + BLOCK;
+    }
 
-        for (y = 0; y < AV_CEIL_RSHIFT(height, p->vsub); y++) {
-            for (x = 0; x < AV_CEIL_RSHIFT(width, p->hsub); x++) {
-                p->temp[1][x + y * p->temp_stride[1]] += p->frame_dec->data[1][x + y * p->frame_dec->linesize[1] + offset];
-                p->temp[2][x + y * p->temp_stride[2]] += p->frame_dec->data[2][x + y * p->frame_dec->linesize[2] + offset];
-            }
-        }
+    /* Every shift position has its own encoder, so they are run in parallel;
+     * the decoded pictures are then summed per row band. */
+    ctx->internal->execute(ctx, encode_slice, NULL, NULL,
+                           FFMIN(count, p->nb_threads));
+
+    td.width  = width;
+    td.height = height;
+    for (i = 0; i < (src[2] && dst[2] ? 3 : 1); i++) {
+        td.plane = i;
+        ctx->internal->execute(ctx, accumulate_slice, &td, NULL,
+                               FFMIN(AV_CEIL_RSHIFT(height, i ? p->vsub : 0), p->nb_threads));
     }
 
     for (j = 0; j < 3; j++) {
@@ -324,6 +380,7 @@ static int config_input(AVFilterLink *inlink)
 
     uspp->hsub = desc->log2_chroma_w;
     uspp->vsub = desc->log2_chroma_h;
+    uspp->nb_threads = ff_filter_get_nb_threads(ctx);
 
     for (i = 0; i < 3; i++) {
         int is_chroma = !!i;
@@ -366,13 +423,16 @@ static int config_input(AVFilterLink *inlink)
             return ret;
         av_dict_free(&opts);
         av_assert0(avctx_enc->codec);
+
+        if (!(uspp->frame[i] = av_frame_alloc()))
+            return AVERROR(ENOMEM);
     }
 
     uspp->outbuf_size = (width + BLOCK) * (height + BLOCK) * 10;
-    if (!(uspp->frame = av_frame_alloc()))
-        return AVERROR(ENOMEM);
-    if (!(uspp->outbuf = av_malloc(uspp->outbuf_size)))
-        return AVERROR(ENOMEM);
+    for (i = 0; i < FFMIN(uspp->nb_threads, 1 << uspp->log2_count); i++) {
+        if (!(uspp->outbuf[i] = av_malloc(uspp->outbuf_size)))
+            return AVERROR(ENOMEM);
+    }
 
     return 0;
 }
@@ -443,7 +503,7 @@ static int filter_frame(AVFilterLink *inlink, AVFrame *in)
                 out->height = in->height;
             }
 
-            filter(uspp, out->data, in->data, out->linesize, in->linesize,
+            filter(ctx, out->data, in->data, out->linesize, in->linesize,
                    inlink->w, inlink->h, qp_table, qp_stride);
         }
     }
@@ -471,11 +531,13 @@ static av_cold void uninit(AVFilterContext *ctx)
     for (i = 0; i < (1 << uspp->log2_count); i++) {
         avcodec_close(uspp->avctx_enc[i]);
         av_freep(&uspp->avctx_enc[i]);
+        av_frame_free(&uspp->frame[i]);
     }
 
+    for (i = 0; i < FFMIN(uspp->nb_threads, 1 << uspp->log2_count); i++)
+        av_freep(&uspp->outbuf[i]);
+
     av_freep(&uspp->non_b_qp_table);
-    av_freep(&uspp->outbuf);
-    av_frame_free(&uspp->frame);
 }
 
 static const AVFilterPad uspp_inputs[] = {
@@ -505,5 +567,5 @@ AVFilter ff_vf_uspp = {
     .inputs          = uspp_inputs,
     .outputs         = uspp_outputs,
     .priv_class      = &uspp_class,
-    .flags           = AVFILTER_FLAG_SUPPORT_TIMELINE_INTERNAL,
+    .flags           = AVFILTER_FLAG_SUPPORT_TIMELINE_INTERNAL | AVFILTER_FLAG_SLICE_THREADS,
 };
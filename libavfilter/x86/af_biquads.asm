@@ -0,0 +1,203 @@
+;*****************************************************************************
+;* x86-optimized functions for biquads filters
+;*
+;* This file is part of FFmpeg.
+;*
+;* FFmpeg is free software; you can redistribute it and/or
+;* modify it under the terms of the GNU Lesser General Public
+;* License as published by the Free Software Foundation; either
+;* version 2.1 of the License, or (at your option) any later version.
+;*
+;* FFmpeg is distributed in the hope that it will be useful,
+;* but WITHOUT ANY WARRANTY; without even the implied warranty of
+;* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+;* Lesser General Public License for more details.
+;*
+;* You should have received a copy of the GNU Lesser General Public
+;* License along with FFmpeg; if not, write to the Free Software
+;* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+;******************************************************************************
+
+%include "libavutil/x86/x86util.asm"
+
+SECTION .text
+
+; transpose 4 rows of 4 floats held in the low halves of %1-%4, %5 is scratch
+%macro TRANSPOSE4x4PS_XMM 5
+    unpcklps xm%5, xm%1, xm%2
+    unpckhps xm%1, xm%1, xm%2
+    unpcklps xm%2, xm%3, xm%4
+    unpckhps xm%3, xm%3, xm%4
+    movlhps  xm%4, xm%1, xm%3
+    movhlps  xm%3, xm%3, xm%1
+    movlhps  xm%1, xm%5, xm%2
+    movhlps  xm%2, xm%2, xm%5
+    SWAP %3, %4
+%endmacro
+
+; transpose 4 rows of 4 doubles, %5 is scratch
+%macro TRANSPOSE4x4PD 5
+    unpcklpd   m%5, m%1, m%2
+    unpckhpd   m%1, m%1, m%2
+    unpcklpd   m%2, m%3, m%4
+    unpckhpd   m%3, m%3, m%4
+    vperm2f128 m%4, m%5, m%2, 0x20
+    vperm2f128 m%5, m%5, m%2, 0x31
+    vperm2f128 m%2, m%1, m%3, 0x20
+    vperm2f128 m%1, m%1, m%3, 0x31
+    SWAP %1, %4
+    SWAP %3, %5
+%endmacro
+
+; filter one sample of every lane held in m%1, in place
+; m0 = i1, m1 = i2, m2 = o1, m3 = o2
+%macro BIQUAD_SAMPLE 1
+    mulpd  m4, m1, [coeffsq + 2*32]
+    mulpd  m5, m0, [coeffsq + 1*32]
+    addpd  m4, m5
+    mulpd  m5, m%1, [coeffsq + 0*32]
+    addpd  m4, m5
+    mulpd  m5, m3, [coeffsq + 4*32]
+    addpd  m4, m5
+    mulpd  m5, m2, [coeffsq + 3*32]
+    addpd  m4, m5
+    mova   m1, m0
+    mova   m0, m%1
+    mova   m3, m2
+    mova   m2, m4
+    mulpd  m4, [coeffsq + 5*32]
+    mulpd  m%1, [coeffsq + 6*32]
+    addpd  m%1, m4
+%endmacro
+
+;------------------------------------------------------------------------------
+; void ff_biquad_lanes_<fmt>(uint8_t *const *dst, uint8_t *const *src, int len,
+;                            double *state, const double *coeffs)
+;------------------------------------------------------------------------------
+
+%macro BIQUAD_LANES 1 ; fmt
+%ifidn %1, flt
+%define bps 4
+%define bps_log2 2
+%else
+%define bps 8
+%define bps_log2 3
+%endif
+cglobal biquad_lanes_%1, 5, 13, 12, dst, src, len, state, coeffs, s0, s1, s2, s3, d0, d1, d2, d3
+    movsxdifnidn lenq, lend
+    mov        s0q, [srcq + 0*gprsize]
+    mov        s1q, [srcq + 1*gprsize]
+    mov        s2q, [srcq + 2*gprsize]
+    mov        s3q, [srcq + 3*gprsize]
+    mov        d0q, [dstq + 0*gprsize]
+    mov        d1q, [dstq + 1*gprsize]
+    mov        d2q, [dstq + 2*gprsize]
+    mov        d3q, [dstq + 3*gprsize]
+    DEFINE_ARGS dst, tail, len, state, coeffs, s0, s1, s2, s3, d0, d1, d2, d3
+    ; the last len % 4 samples are filtered one at a time
+    lea      tailq, [lenq*bps]
+    and       lenq, ~3
+    shl       lenq, bps_log2
+    sub      tailq, lenq
+    add        s0q, lenq
+    add        s1q, lenq
+    add        s2q, lenq
+    add        s3q, lenq
+    add        d0q, lenq
+    add        d1q, lenq
+    add        d2q, lenq
+    add        d3q, lenq
+    neg       lenq
+
+    movu        m0, [stateq + 0*32]
+    movu        m1, [stateq + 1*32]
+    movu        m2, [stateq + 2*32]
+    movu        m3, [stateq + 3*32]
+    test      lenq, lenq
+    jz .tail
+
+ALIGN 16
+.loop:
+%ifidn %1, flt
+    movu       xm6, [s0q + lenq]
+    movu       xm7, [s1q + lenq]
+    movu       xm8, [s2q + lenq]
+    movu       xm9, [s3q + lenq]
+    TRANSPOSE4x4PS_XMM 6, 7, 8, 9, 10
+%assign i 6
+%rep 4
+    cvtps2pd   m11, xm %+ i
+    BIQUAD_SAMPLE 11
+    cvtpd2ps  xm %+ i, m11
+%assign i i+1
+%endrep
+    TRANSPOSE4x4PS_XMM 6, 7, 8, 9, 10
+    movu [d0q + lenq], xm6
+    movu [d1q + lenq], xm7
+    movu [d2q + lenq], xm8
+    movu [d3q + lenq], xm9
+%else
+    movu        m6, [s0q + lenq]
+    movu        m7, [s1q + lenq]
+    movu        m8, [s2q + lenq]
+    movu        m9, [s3q + lenq]
+    TRANSPOSE4x4PD 6, 7, 8, 9, 10
+    BIQUAD_SAMPLE 6
+    BIQUAD_SAMPLE 7
+    BIQUAD_SAMPLE 8
+    BIQUAD_SAMPLE 9
+    TRANSPOSE4x4PD 6, 7, 8, 9, 10
+    movu [d0q + lenq], m6
+    movu [d1q + lenq], m7
+    movu [d2q + lenq], m8
+    movu [d3q + lenq], m9
+%endif
+    add       lenq, 4*bps
+    jl .loop
+
+.tail:
+    cmp       lenq, tailq
+    jge .end
+%ifidn %1, flt
+    movss      xm6, [s0q + lenq]
+    insertps   xm6, [s1q + lenq], 0x10
+    insertps   xm6, [s2q + lenq], 0x20
+    insertps   xm6, [s3q + lenq], 0x30
+    cvtps2pd    m6, xm6
+    BIQUAD_SAMPLE 6
+    cvtpd2ps   xm6, m6
+    movss  [d0q + lenq], xm6
+    extractps [d1q + lenq], xm6, 1
+    extractps [d2q + lenq], xm6, 2
+    extractps [d3q + lenq], xm6, 3
+%else
+    movsd      xm6, [s0q + lenq]
+    movhpd     xm6, [s1q + lenq]
+    movsd      xm7, [s2q + lenq]
+    movhpd     xm7, [s3q + lenq]
+    vinsertf128 m6, m6, xm7, 1
+    BIQUAD_SAMPLE 6
+    vextractf128 xm7, m6, 1
+    movsd  [d0q + lenq], xm6
+    movhpd [d1q + lenq], xm6
+    movsd  [d2q + lenq], xm7
+    movhpd [d3q + lenq], xm7
+%endif
+    add       lenq, bps
+    jmp .tail
+
+.end:
+    movu [stateq + 0*32], m0
+    movu [stateq + 1*32], m1
+    movu [stateq + 2*32], m2
+    movu [stateq + 3*32], m3
+    RET
+%endmacro
+
+%if ARCH_X86_64
+%if HAVE_AVX_EXTERNAL
+INIT_YMM avx
+BIQUAD_LANES flt
+BIQUAD_LANES dbl
+%endif
+%endif
@@ -0,0 +1,201 @@
+;*****************************************************************************
+;* x86-optimized functions for lut3d filter
+;*
+;* This file is part of FFmpeg.
+;*
+;* FFmpeg is free software; you can redistribute it and/or
+;* modify it under the terms of the GNU Lesser General Public
+;* License as published by the Free Software Foundation; either
+;* version 2.1 of the License, or (at your option) any later version.
+;*
+;* FFmpeg is distributed in the hope that it will be useful,
+;* but WITHOUT ANY WARRANTY; without even the implied warranty of
+;* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+;* Lesser General Public License for more details.
+;*
+;* You should have received a copy of the GNU Lesser General Public
+;* License along with FFmpeg; if not, write to the Free Software
+;* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+;******************************************************************************
+
+%include "libavutil/x86/x86util.asm"
+
+%if ARCH_X86_64 && HAVE_AVX2_EXTERNAL
+
+SECTION_RODATA 32
+
+pd_1: times 8 dd 1
+ps_1: times 8 dd 1.0
+
+SECTION .text
+
+;-----------------------------------------------------------------------------
+; void ff_lut3d_<interp>_avx2(float *dst, const float *src, ptrdiff_t stride,
+;                            const float *lut, int lutsize, int w)
+;
+; Same results as interp_trilinear() and interp_tetrahedral(), the products
+; are summed in the same order. 8 pixels per iteration.
+;-----------------------------------------------------------------------------
+
+; in:  m0, m1, m2 r, g, b coordinates
+; out: m0, m1, m2 r, g, b fractions
+;      m3 offset of the previous point in floats
+;      m6, m7, m8 r, g, b offsets to the next point in floats, 0 on the edge
+%macro LUT3D_COORDS 0
+    cvttps2dq           m3, m0
+    cvttps2dq           m4, m1
+    cvttps2dq           m5, m2
+    cvtdq2ps            m9, m3
+    cvtdq2ps           m10, m4
+    cvtdq2ps           m11, m5
+    subps               m0, m9
+    subps               m1, m10
+    subps               m2, m11
+    paddd               m6, m3, [pd_1]
+    paddd               m7, m4, [pd_1]
+    paddd               m8, m5, [pd_1]
+    pminsd              m6, m15
+    pminsd              m7, m15
+    pminsd              m8, m15
+    psubd               m6, m3
+    psubd               m7, m4
+    psubd               m8, m5
+    pmulld              m3, m14
+    pmulld              m4, m13
+    pmulld              m6, m14
+    pmulld              m7, m13
+    paddd               m9, m5, m5
+    paddd              m10, m8, m8
+    paddd               m3, m4
+    paddd               m3, m5
+    paddd               m8, m10
+    paddd               m3, m9
+%endmacro
+
+; GATHER dst, offsets, component
+%macro GATHER 3
+    pcmpeqd            m11, m11
+    vgatherdps          %1, [lutq + %2*4 + %3*4], m11
+%endmacro
+
+; LERP v0, v1, f: v0 += (v1 - v0) * f
+%macro LERP 3
+    subps               %2, %1
+    mulps               %2, %3
+    addps               %1, %2
+%endmacro
+
+; SORT2 d0, d1, s0, s1: order the pairs by decreasing d
+%macro SORT2 4
+    cmpps               m9, %1, %2, 1
+    vblendvps          m10, %1, %2, m9
+    vblendvps           %2, %2, %1, m9
+    mova                %1, m10
+    vblendvps          m10, %3, %4, m9
+    vblendvps           %4, %4, %3, m9
+    mova                %3, m10
+%endmacro
+
+%macro LUT3D_FUNC 1
+cglobal lut3d_%1, 6, 7, 16, dst, src, stride, lut, lutsize, w, tmp
+    test                wd, wd
+    jle .end
+    shl            strideq, 2
+    lea               tmpd, [lutsizeq - 1]
+    movd              xm15, tmpd
+    vpbroadcastd       m15, xm15
+    lea               tmpd, [lutsizeq*3]
+    movd              xm13, tmpd
+    vpbroadcastd       m13, xm13
+    imul              tmpd, lutsized
+    movd              xm14, tmpd
+    vpbroadcastd       m14, xm14
+.loop:
+    movu                m0, [srcq]
+    movu                m1, [srcq + strideq]
+    movu                m2, [srcq + strideq*2]
+    LUT3D_COORDS
+%ifidn %1, trilinear
+%assign comp 0
+%rep 3
+    GATHER              m4, m3, comp
+    paddd              m12, m3, m6
+    GATHER              m5, m12, comp
+    LERP                m4, m5, m0              ; c00
+    paddd              m12, m3, m7
+    GATHER              m5, m12, comp
+    paddd              m12, m6
+    GATHER              m9, m12, comp
+    LERP                m5, m9, m0              ; c10
+    LERP                m4, m5, m1              ; c0
+    paddd              m12, m3, m8
+    GATHER              m5, m12, comp
+    paddd              m12, m6
+    GATHER              m9, m12, comp
+    LERP                m5, m9, m0              ; c01
+    paddd              m12, m3, m8
+    paddd              m12, m7
+    GATHER              m9, m12, comp
+    paddd              m12, m6
+    GATHER             m10, m12, comp
+    LERP                m9, m10, m0             ; c11
+    LERP                m5, m9, m1              ; c1
+    LERP                m4, m5, m2
+%if comp == 0
+    movu            [dstq], m4
+%elif comp == 1
+    movu  [dstq + strideq], m4
+%else
+    movu [dstq + strideq*2], m4
+%endif
+%assign comp comp+1
+%endrep
+%else ; tetrahedral
+    ; sort the axes by decreasing fraction, the weights of the 4 vertices
+    ; are then 1 - dmax, dmax - dmid, dmid - dmin and dmin
+    SORT2               m0, m1, m6, m7
+    SORT2               m0, m2, m6, m8
+    SORT2               m1, m2, m7, m8
+    paddd               m6, m3
+    paddd               m7, m6
+    paddd               m8, m7
+    movaps             m12, [ps_1]
+    subps              m12, m0
+    subps               m0, m1
+    subps               m1, m2
+%assign comp 0
+%rep 3
+    GATHER              m4, m3, comp
+    mulps               m4, m12
+    GATHER              m5, m6, comp
+    mulps               m5, m0
+    addps               m4, m5
+    GATHER              m5, m7, comp
+    mulps               m5, m1
+    addps               m4, m5
+    GATHER              m5, m8, comp
+    mulps               m5, m2
+    addps               m4, m5
+%if comp == 0
+    movu            [dstq], m4
+%elif comp == 1
+    movu  [dstq + strideq], m4
+%else
+    movu [dstq + strideq*2], m4
+%endif
+%assign comp comp+1
+%endrep
+%endif
+    add               srcq, mmsize
+    add               dstq, mmsize
+    sub                 wd, mmsize/4
+    jg .loop
+.end:
+    RET
+%endmacro
+
+INIT_YMM avx2
+LUT3D_FUNC trilinear
+LUT3D_FUNC tetrahedral
+
+%endif
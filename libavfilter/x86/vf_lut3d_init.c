@@ -0,0 +1,41 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "config.h"
+
+#include "libavutil/attributes.h"
+#include "libavutil/cpu.h"
+#include "libavutil/x86/cpu.h"
+#include "libavfilter/lut3d.h"
+
+void ff_lut3d_trilinear_avx2(float *dst, const float *src, ptrdiff_t stride,
+                             const float *lut, int lutsize, int w);
+void ff_lut3d_tetrahedral_avx2(float *dst, const float *src, ptrdiff_t stride,
+                               const float *lut, int lutsize, int w);
+
+av_cold void ff_lut3d_dsp_init_x86(LUT3DDSPContext *dsp)
+{
+#if ARCH_X86_64
+    int cpu_flags = av_get_cpu_flags();
+
+    if (EXTERNAL_AVX2_FAST(cpu_flags)) {
+        dsp->interp[INTERPOLATE_TRILINEAR]   = ff_lut3d_trilinear_avx2;
+        dsp->interp[INTERPOLATE_TETRAHEDRAL] = ff_lut3d_tetrahedral_avx2;
+    }
+#endif
+}
@@ -0,0 +1,147 @@
+;*****************************************************************************
+;* x86-optimized functions for nnedi filter
+;*
+;* This file is part of FFmpeg.
+;*
+;* FFmpeg is free software; you can redistribute it and/or modify
+;* it under the terms of the GNU General Public License as published by
+;* the Free Software Foundation; either version 2 of the License, or
+;* (at your option) any later version.
+;*
+;* FFmpeg is distributed in the hope that it will be useful,
+;* but WITHOUT ANY WARRANTY; without even the implied warranty of
+;* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+;* GNU General Public License for more details.
+;*
+;* You should have received a copy of the GNU General Public License along
+;* with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+;* 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+;******************************************************************************
+
+%include "libavutil/x86/x86util.asm"
+
+SECTION_RODATA 32
+
+ps_exp_lo: times 8 dd -80.0
+ps_exp_hi: times 8 dd  80.0
+ps_log2e:  times 8 dd 1.44269504088896341
+ps_ln2_hi: times 8 dd 0.693359375
+ps_ln2_lo: times 8 dd -2.12194440e-4
+ps_exp_p0: times 8 dd 1.9875691500e-4
+ps_exp_p1: times 8 dd 1.3981999507e-3
+ps_exp_p2: times 8 dd 8.3334519073e-3
+ps_exp_p3: times 8 dd 4.1665795894e-2
+ps_exp_p4: times 8 dd 1.6666665459e-1
+ps_exp_p5: times 8 dd 5.0000001201e-1
+ps_1:      times 8 dd 1.0
+pd_127:    times 8 dd 127
+
+SECTION .text
+
+%macro NNEDI_FUNCS 0
+%if ARCH_X86_64
+;-----------------------------------------------------------------------------
+; void ff_nnedi_dot_prods(int32_t *sums, const int16_t *data,
+;                         const int16_t *weights, int n, int len)
+;-----------------------------------------------------------------------------
+cglobal nnedi_dot_prods, 5, 9, 6, sums, data, weights, n, len, w1, w2, w3, j
+    movsxdifnidn      lenq, lend
+    add               lenq, lenq
+    add              dataq, lenq
+.loop_n:
+    add           weightsq, lenq
+    lea                w1q, [weightsq + lenq]
+    lea                w2q, [weightsq + lenq*2]
+    lea                w3q, [w1q + lenq*2]
+    mov                 jq, lenq
+    neg                 jq
+    pxor                m0, m0
+    pxor                m1, m1
+    pxor                m2, m2
+    pxor                m3, m3
+.loop_len:
+    mova                m4, [dataq + jq]
+    pmaddwd             m5, m4, [weightsq + jq]
+    paddd               m0, m5
+    pmaddwd             m5, m4, [w1q + jq]
+    paddd               m1, m5
+    pmaddwd             m5, m4, [w2q + jq]
+    paddd               m2, m5
+    pmaddwd             m4, [w3q + jq]
+    paddd               m3, m4
+    add                 jq, mmsize
+    jl .loop_len
+
+    ; sum the dwords of each accumulator into one dword of m0
+    punpckldq           m4, m0, m1
+    punpckhdq           m0, m1
+    paddd               m0, m4
+    punpckldq           m4, m2, m3
+    punpckhdq           m2, m3
+    paddd               m2, m4
+    punpcklqdq          m4, m0, m2
+    punpckhqdq          m0, m2
+    paddd               m0, m4
+%if mmsize == 32
+    vextracti128       xm4, m0, 1
+    paddd              xm0, xm4
+%endif
+    movu           [sumsq], xm0
+    add              sumsq, 16
+    mov           weightsq, w3q
+    sub                 nd, 4
+    jg .loop_n
+    RET
+%endif
+
+;-----------------------------------------------------------------------------
+; void ff_nnedi_exp(float *s, int n)
+;
+; exp(x) = 2^k * exp(f), with k = round(x / ln(2)) and |f| <= ln(2) / 2,
+; exp(f) is evaluated with the cephes expf() polynomial.
+;-----------------------------------------------------------------------------
+cglobal nnedi_exp, 2, 2, 5, s, n
+    movsxdifnidn        nq, nd
+    lea                 sq, [sq + nq*4]
+    neg                 nq
+.loop:
+    mova                m0, [sq + nq*4]
+    maxps               m0, [ps_exp_lo]
+    minps               m0, [ps_exp_hi]
+    mulps               m1, m0, [ps_log2e]
+    cvtps2dq            m1, m1
+    cvtdq2ps            m2, m1
+    mulps               m3, m2, [ps_ln2_hi]
+    subps               m0, m3
+    mulps               m2, [ps_ln2_lo]
+    subps               m0, m2
+    mulps               m3, m0, [ps_exp_p0]
+    addps               m3, [ps_exp_p1]
+    mulps               m3, m0
+    addps               m3, [ps_exp_p2]
+    mulps               m3, m0
+    addps               m3, [ps_exp_p3]
+    mulps               m3, m0
+    addps               m3, [ps_exp_p4]
+    mulps               m3, m0
+    addps               m3, [ps_exp_p5]
+    mulps               m4, m0, m0
+    mulps               m3, m4
+    addps               m3, m0
+    addps               m3, [ps_1]
+    paddd               m1, [pd_127]
+    pslld               m1, 23
+    mulps               m3, m1
+    mova     [sq + nq*4], m3
+    add                 nq, mmsize / 4
+    jl .loop
+    RET
+%endmacro
+
+INIT_XMM sse2
+NNEDI_FUNCS
+
+%if HAVE_AVX2_EXTERNAL
+INIT_YMM avx2
+NNEDI_FUNCS
+%endif
@@ -0,0 +1,48 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "config.h"
+
+#include "libavutil/attributes.h"
+#include "libavutil/cpu.h"
+#include "libavutil/x86/cpu.h"
+#include "libavfilter/vf_nnedi.h"
+
+void ff_nnedi_dot_prods_sse2(int32_t *sums, const int16_t *data,
+                             const int16_t *weights, int n, int len);
+void ff_nnedi_dot_prods_avx2(int32_t *sums, const int16_t *data,
+                             const int16_t *weights, int n, int len);
+
+void ff_nnedi_exp_sse2(float *s, int n);
+void ff_nnedi_exp_avx2(float *s, int n);
+
+av_cold void ff_nnedi_init_x86(NNEDIDSPContext *dsp)
+{
+    int cpu_flags = av_get_cpu_flags();
+
+    if (EXTERNAL_SSE2(cpu_flags)) {
+        if (ARCH_X86_64)
+            dsp->dot_prods = ff_nnedi_dot_prods_sse2;
+        dsp->exp = ff_nnedi_exp_sse2;
+    }
+    if (EXTERNAL_AVX2_FAST(cpu_flags)) {
+        if (ARCH_X86_64)
+            dsp->dot_prods = ff_nnedi_dot_prods_avx2;
+        dsp->exp = ff_nnedi_exp_avx2;
+    }
+}
@@ -184,6 +184,12 @@ enum AVFrameSideDataType {
      * Encoding parameters for a video frame, as described by AVVideoEncParams.
      */
     AV_FRAME_DATA_VIDEO_ENC_PARAMS,
+
+    /**
+     * Statistics of a video frame computed by the framestats filter for the
+     * detection filters after it. The layout is private to libavfilter.
+     */
+    AV_FRAME_DATA_FRAME_STATS,
 };
 
 enum AVActiveFormatDescription {
@@ -16,14 +16,31 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
  */
 
+#include <limits.h>
 #include <stdatomic.h>
 #include "slicethread.h"
+#include "threadpool.h"
+#include "cpu.h"
 #include "mem.h"
 #include "thread.h"
 #include "avassert.h"
 
 #if HAVE_PTHREADS || HAVE_W32THREADS || HAVE_OS2THREADS
 
+typedef struct WorkerPool {
+    pthread_t       *threads;
+    int             nb_workers;
+    int             refcount;       ///< protected by pool_lock
+
+    pthread_mutex_t mutex;          ///< protects everything below and the pool fields of the clients
+    pthread_cond_t  cond;
+    AVSliceThread   *clients;       ///< circular list of the contexts with jobs left
+    int             finished;
+} WorkerPool;
+
+static AVMutex pool_lock = AV_MUTEX_INITIALIZER;
+static WorkerPool *shared_pool;
+
 typedef struct WorkerContext {
     AVSliceThread   *ctx;
     pthread_mutex_t mutex;
@@ -48,8 +65,177 @@ struct AVSliceThread {
     void            *priv;
     void            (*worker_func)(void *priv, int jobnr, int threadnr, int nb_jobs, int nb_threads);
     void            (*main_func)(void *priv);
+
+    /* shared pool mode, the jobs are run by the caller and the pool workers */
+    WorkerPool      *pool;
+    AVSliceThread   *prev, *next;   ///< position in pool->clients, NULL if not in it
+    int             nb_joined;      ///< threads which took part in the current execution
+    int             nb_running;     ///< threads still running jobs of the current execution
 };
 
+static void pool_unlink_client(WorkerPool *pool, AVSliceThread *ctx)
+{
+    if (!ctx->next)
+        return;
+    if (ctx->next == ctx) {
+        pool->clients = NULL;
+    } else {
+        ctx->prev->next = ctx->next;
+        ctx->next->prev = ctx->prev;
+        if (pool->clients == ctx)
+            pool->clients = ctx->next;
+    }
+    ctx->prev = ctx->next = NULL;
+}
+
+/* Runs jobs of ctx until there are none left, as thread number threadnr */
+static void pool_run_jobs(AVSliceThread *ctx, int threadnr)
+{
+    unsigned nb_jobs = ctx->nb_jobs, job;
+
+    while ((job = atomic_fetch_add_explicit(&ctx->current_job, 1, memory_order_acq_rel)) < nb_jobs)
+        ctx->worker_func(ctx->priv, job, threadnr, nb_jobs, ctx->nb_active_threads);
+}
+
+static void *attribute_align_arg pool_worker(void *v)
+{
+    WorkerPool *pool = v;
+
+    pthread_mutex_lock(&pool->mutex);
+    while (!pool->finished) {
+        AVSliceThread *ctx = pool->clients;
+        int threadnr;
+
+        if (!ctx) {
+            pthread_cond_wait(&pool->cond, &pool->mutex);
+            continue;
+        }
+
+        /* Serve the clients in turn, each one up to its own thread count */
+        threadnr = ctx->nb_joined++;
+        ctx->nb_running++;
+        if (ctx->nb_joined == ctx->nb_active_threads)
+            pool_unlink_client(pool, ctx);
+        else
+            pool->clients = ctx->next;
+        pthread_mutex_unlock(&pool->mutex);
+
+        pool_run_jobs(ctx, threadnr);
+
+        pthread_mutex_lock(&pool->mutex);
+        pool_unlink_client(pool, ctx);
+        if (!--ctx->nb_running)
+            pthread_cond_signal(&ctx->done_cond);
+    }
+    pthread_mutex_unlock(&pool->mutex);
+
+    return NULL;
+}
+
+static void pool_execute(AVSliceThread *ctx)
+{
+    WorkerPool *pool = ctx->pool;
+
+    pthread_mutex_lock(&pool->mutex);
+    ctx->nb_joined  = 1;
+    ctx->nb_running = 1;
+    if (ctx->nb_active_threads > 1) {
+        if (pool->clients) {
+            ctx->next = pool->clients;
+            ctx->prev = pool->clients->prev;
+            ctx->prev->next = ctx->next->prev = ctx;
+        } else {
+            pool->clients = ctx->prev = ctx->next = ctx;
+        }
+        for (int i = 1; i < ctx->nb_active_threads; i++)
+            pthread_cond_signal(&pool->cond);
+    }
+    pthread_mutex_unlock(&pool->mutex);
+
+    pool_run_jobs(ctx, 0);
+
+    pthread_mutex_lock(&pool->mutex);
+    pool_unlink_client(pool, ctx);
+    ctx->nb_running--;
+    while (ctx->nb_running)
+        pthread_cond_wait(&ctx->done_cond, &pool->mutex);
+    pthread_mutex_unlock(&pool->mutex);
+}
+
+static void pool_free(WorkerPool *pool, int nb_workers)
+{
+    pthread_mutex_lock(&pool->mutex);
+    pool->finished = 1;
+    pthread_cond_broadcast(&pool->cond);
+    pthread_mutex_unlock(&pool->mutex);
+
+    for (int i = 0; i < nb_workers; i++)
+        pthread_join(pool->threads[i], NULL);
+
+    pthread_cond_destroy(&pool->cond);
+    pthread_mutex_destroy(&pool->mutex);
+    av_freep(&pool->threads);
+    av_free(pool);
+}
+
+/* Must be called with pool_lock held */
+static void pool_unref(WorkerPool *pool)
+{
+    if (!--pool->refcount)
+        pool_free(pool, pool->nb_workers);
+}
+
+int av_thread_pool_init(int nb_workers)
+{
+    WorkerPool *pool;
+    int ret = 0;
+
+    if (nb_workers < 0)
+        return AVERROR(EINVAL);
+    if (!nb_workers)
+        nb_workers = av_cpu_count();
+
+    ff_mutex_lock(&pool_lock);
+    if (shared_pool) {
+        ret = AVERROR(EEXIST);
+        goto end;
+    }
+
+    pool = av_mallocz(sizeof(*pool));
+    if (!pool || !(pool->threads = av_calloc(nb_workers, sizeof(*pool->threads)))) {
+        av_free(pool);
+        ret = AVERROR(ENOMEM);
+        goto end;
+    }
+    pthread_mutex_init(&pool->mutex, NULL);
+    pthread_cond_init(&pool->cond, NULL);
+
+    for (int i = 0; i < nb_workers; i++) {
+        if (ret = pthread_create(&pool->threads[i], NULL, pool_worker, pool)) {
+            pool_free(pool, i);
+            ret = AVERROR(ret);
+            goto end;
+        }
+    }
+
+    pool->nb_workers = nb_workers;
+    pool->refcount   = 1;
+    shared_pool      = pool;
+
+end:
+    ff_mutex_unlock(&pool_lock);
+    return ret;
+}
+
+void av_thread_pool_uninit(void)
+{
+    ff_mutex_lock(&pool_lock);
+    if (shared_pool)
+        pool_unref(shared_pool);
+    shared_pool = NULL;
+    ff_mutex_unlock(&pool_lock);
+}
+
 static int run_jobs(AVSliceThread *ctx)
 {
     unsigned nb_jobs    = ctx->nb_jobs;
@@ -91,15 +277,41 @@ static void *attribute_align_arg thread_worker(void *v)
     }
 }
 
-int avpriv_slicethread_create(AVSliceThread **pctx, void *priv,
+static int slicethread_create(AVSliceThread **pctx, void *priv,
                               void (*worker_func)(void *priv, int jobnr, int threadnr, int nb_jobs, int nb_threads),
                               void (*main_func)(void *priv),
-                              int nb_threads)
+                              int nb_threads, int shared)
 {
-    AVSliceThread *ctx;
+    AVSliceThread *ctx = NULL;
     int nb_workers, i;
 
     av_assert0(nb_threads >= 0);
+
+    /* Pool workers join only when they are idle, so the jobs of a shared
+     * context may all end up running one after the other on the caller */
+    if (shared) {
+        ff_mutex_lock(&pool_lock);
+        if (shared_pool) {
+            *pctx = ctx = av_mallocz(sizeof(*ctx));
+            if (!ctx) {
+                ff_mutex_unlock(&pool_lock);
+                return AVERROR(ENOMEM);
+            }
+            shared_pool->refcount++;
+            ctx->pool        = shared_pool;
+            ctx->priv        = priv;
+            ctx->worker_func = worker_func;
+            ctx->nb_threads  = FFMIN(nb_threads ? nb_threads : INT_MAX,
+                                     shared_pool->nb_workers + 1);
+            atomic_init(&ctx->first_job, 0);
+            atomic_init(&ctx->current_job, 0);
+            pthread_cond_init(&ctx->done_cond, NULL);
+        }
+        ff_mutex_unlock(&pool_lock);
+        if (ctx)
+            return ctx->nb_threads;
+    }
+
     if (!nb_threads) {
         int nb_cpus = av_cpu_count();
         if (nb_cpus > 1)
@@ -161,6 +373,21 @@ int avpriv_slicethread_create(AVSliceThread **pctx, void *priv,
     return nb_threads;
 }
 
+int avpriv_slicethread_create(AVSliceThread **pctx, void *priv,
+                              void (*worker_func)(void *priv, int jobnr, int threadnr, int nb_jobs, int nb_threads),
+                              void (*main_func)(void *priv),
+                              int nb_threads)
+{
+    return slicethread_create(pctx, priv, worker_func, main_func, nb_threads, 0);
+}
+
+int avpriv_slicethread_create_shared(AVSliceThread **pctx, void *priv,
+                                     void (*worker_func)(void *priv, int jobnr, int threadnr, int nb_jobs, int nb_threads),
+                                     int nb_threads)
+{
+    return slicethread_create(pctx, priv, worker_func, NULL, nb_threads, 1);
+}
+
 void avpriv_slicethread_execute(AVSliceThread *ctx, int nb_jobs, int execute_main)
 {
     int nb_workers, i, is_last = 0;
@@ -168,6 +395,13 @@ void avpriv_slicethread_execute(AVSliceThread *ctx, int nb_jobs, int execute_mai
     av_assert0(nb_jobs > 0);
     ctx->nb_jobs           = nb_jobs;
     ctx->nb_active_threads = FFMIN(nb_jobs, ctx->nb_threads);
+
+    if (ctx->pool) {
+        atomic_store_explicit(&ctx->current_job, 0, memory_order_relaxed);
+        pool_execute(ctx);
+        return;
+    }
+
     atomic_store_explicit(&ctx->first_job, 0, memory_order_relaxed);
     atomic_store_explicit(&ctx->current_job, ctx->nb_active_threads, memory_order_relaxed);
     nb_workers             = ctx->nb_active_threads;
@@ -205,6 +439,15 @@ void avpriv_slicethread_free(AVSliceThread **pctx)
         return;
 
     ctx = *pctx;
+    if (ctx->pool) {
+        ff_mutex_lock(&pool_lock);
+        pool_unref(ctx->pool);
+        ff_mutex_unlock(&pool_lock);
+        pthread_cond_destroy(&ctx->done_cond);
+        av_freep(pctx);
+        return;
+    }
+
     nb_workers = ctx->nb_threads;
     if (!ctx->main_func)
         nb_workers--;
@@ -242,6 +485,14 @@ int avpriv_slicethread_create(AVSliceThread **pctx, void *priv,
     return AVERROR(EINVAL);
 }
 
+int avpriv_slicethread_create_shared(AVSliceThread **pctx, void *priv,
+                                     void (*worker_func)(void *priv, int jobnr, int threadnr, int nb_jobs, int nb_threads),
+                                     int nb_threads)
+{
+    *pctx = NULL;
+    return AVERROR(EINVAL);
+}
+
 void avpriv_slicethread_execute(AVSliceThread *ctx, int nb_jobs, int execute_main)
 {
     av_assert0(0);
@@ -252,4 +503,13 @@ void avpriv_slicethread_free(AVSliceThread **pctx)
     av_assert0(!pctx || !*pctx);
 }
 
+int av_thread_pool_init(int nb_workers)
+{
+    return AVERROR(ENOSYS);
+}
+
+void av_thread_pool_uninit(void)
+{
+}
+
 #endif /* HAVE_PTHREADS || HAVE_W32THREADS || HAVE_OS32THREADS */
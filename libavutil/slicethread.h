@@ -35,6 +35,17 @@ int avpriv_slicethread_create(AVSliceThread **pctx, void *priv,
                               void (*main_func)(void *priv),
                               int nb_threads);
 
+/**
+ * Create slice threading context for jobs which never wait on each other.
+ * Once the shared worker pool is set up (see threadpool.h), such contexts
+ * submit their jobs to it instead of starting their own threads. The jobs
+ * may then run one after the other on the calling thread.
+ * @see avpriv_slicethread_create()
+ */
+int avpriv_slicethread_create_shared(AVSliceThread **pctx, void *priv,
+                                     void (*worker_func)(void *priv, int jobnr, int threadnr, int nb_jobs, int nb_threads),
+                                     int nb_threads);
+
 /**
  * Execute slice threading.
  * @param ctx slice threading context
@@ -0,0 +1,169 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * This test program runs several slice threading contexts concurrently,
+ * with and without the shared worker pool, and checks that every job runs
+ * exactly once and that no thread number is used twice at the same time.
+ * Alongside them, contexts whose jobs all wait for each other to start check
+ * that those still get all their threads while the pool is busy.
+ */
+
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "libavutil/error.h"
+#include "libavutil/lfg.h"
+#include "libavutil/slicethread.h"
+#include "libavutil/thread.h"
+#include "libavutil/threadpool.h"
+
+#define NB_CLIENTS        4
+#define NB_DEPENDENT      2
+#define DEPENDENT_THREADS 4
+#define MAX_JOBS          64
+#define NB_ROUNDS         200
+#define MAX_THREADS       1024
+
+typedef struct Client {
+    AVSliceThread *thread;
+    int nb_threads;
+    atomic_int runs[MAX_JOBS];
+    atomic_int busy[MAX_THREADS];
+    atomic_int errors;
+    unsigned seed;
+
+    /* jobs of dependent clients wait until all of them have started */
+    int dependent;
+    int started;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+} Client;
+
+static void worker_func(void *priv, int jobnr, int threadnr, int nb_jobs, int nb_threads)
+{
+    Client *c = priv;
+
+    if (threadnr < 0 || threadnr >= nb_threads || nb_threads > c->nb_threads ||
+        atomic_exchange(&c->busy[threadnr], 1)) {
+        atomic_fetch_add(&c->errors, 1);
+        return;
+    }
+    atomic_fetch_add(&c->runs[jobnr], 1);
+    atomic_store(&c->busy[threadnr], 0);
+
+    if (c->dependent) {
+        pthread_mutex_lock(&c->lock);
+        c->started++;
+        pthread_cond_broadcast(&c->cond);
+        while (c->started < nb_jobs)
+            pthread_cond_wait(&c->cond, &c->lock);
+        pthread_mutex_unlock(&c->lock);
+    }
+}
+
+static void *client_main(void *arg)
+{
+    Client *c = arg;
+    AVLFG lfg;
+
+    av_lfg_init(&lfg, c->seed);
+    for (int i = 0; i < NB_ROUNDS; i++) {
+        int nb_jobs = c->dependent ? c->nb_threads : av_lfg_get(&lfg) % MAX_JOBS + 1;
+
+        for (int j = 0; j < MAX_JOBS; j++)
+            atomic_store(&c->runs[j], 0);
+        c->started = 0;
+        avpriv_slicethread_execute(c->thread, nb_jobs, 0);
+        for (int j = 0; j < MAX_JOBS; j++)
+            if (atomic_load(&c->runs[j]) != (j < nb_jobs))
+                atomic_fetch_add(&c->errors, 1);
+    }
+    return NULL;
+}
+
+static int run_clients(void)
+{
+    static Client clients[NB_CLIENTS + NB_DEPENDENT];
+    pthread_t threads[NB_CLIENTS + NB_DEPENDENT];
+    int ret = 0;
+
+    for (int i = 0; i < NB_CLIENTS + NB_DEPENDENT; i++) {
+        Client *c = &clients[i];
+
+        memset(c, 0, sizeof(*c));
+        c->seed = i;
+        if (i < NB_CLIENTS) {
+            c->nb_threads = avpriv_slicethread_create_shared(&c->thread, c, worker_func,
+                                                             i ? 2 * i : 0);
+        } else {
+            c->dependent = 1;
+            pthread_mutex_init(&c->lock, NULL);
+            pthread_cond_init(&c->cond, NULL);
+            c->nb_threads = avpriv_slicethread_create(&c->thread, c, worker_func,
+                                                      NULL, DEPENDENT_THREADS);
+            if (c->nb_threads != DEPENDENT_THREADS)
+                c->nb_threads = -1;
+        }
+        if (c->nb_threads < 0 || c->nb_threads > MAX_THREADS) {
+            fprintf(stderr, "avpriv_slicethread_create failed.\n");
+            return 1;
+        }
+    }
+
+    for (int i = 0; i < NB_CLIENTS + NB_DEPENDENT; i++) {
+        if (pthread_create(&threads[i], NULL, client_main, &clients[i])) {
+            fprintf(stderr, "pthread_create failed.\n");
+            return 1;
+        }
+    }
+
+    for (int i = 0; i < NB_CLIENTS + NB_DEPENDENT; i++) {
+        pthread_join(threads[i], NULL);
+        ret |= !!atomic_load(&clients[i].errors);
+        avpriv_slicethread_free(&clients[i].thread);
+        if (clients[i].dependent) {
+            pthread_cond_destroy(&clients[i].cond);
+            pthread_mutex_destroy(&clients[i].lock);
+        }
+    }
+
+    return ret;
+}
+
+int main(void)
+{
+    int ret;
+
+    if (run_clients())
+        return 1;
+
+    if ((ret = av_thread_pool_init(3)) < 0) {
+        fprintf(stderr, "av_thread_pool_init failed.\n");
+        return 2;
+    }
+    if (av_thread_pool_init(3) != AVERROR(EEXIST))
+        return 3;
+    ret = run_clients();
+    av_thread_pool_uninit();
+    if (ret)
+        return 4;
+
+    return 0;
+}
@@ -0,0 +1,194 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <limits.h>
+#include <math.h>
+#include <stdio.h>
+
+#include "libavutil/common.h"
+#include "libavutil/lfg.h"
+#include "libavutil/mathematics.h"
+#include "libavutil/mem.h"
+#include "libavutil/tx.h"
+
+enum { FFT, RDFT, DCT };
+
+static const char * const kind_names[] = { "fft", "rdft", "dct" };
+
+static const int lengths[] = {
+    2, 4, 8, 16, 32, 64, 128, 256, 512, 1024, 2048,
+    6, 12, 20, 24, 40, 60, 120, 480, 960,
+};
+
+/* Number of real values read and written by a transform */
+static void io_size(int kind, int inv, int len, int *in, int *out)
+{
+    switch (kind) {
+    case FFT:
+        *in = *out = 2*len;
+        break;
+    case RDFT:
+        *in  = inv ? len + 2 : len;
+        *out = inv ? len : len + 2;
+        break;
+    case DCT:
+        *in = *out = len;
+        break;
+    }
+}
+
+static void ref_transform(int kind, int inv, int len, double scale,
+                          double *out, const double *in)
+{
+    for (int k = 0; k < len; k++) {
+        double re = 0, im = 0;
+
+        switch (kind) {
+        case FFT:
+            for (int n = 0; n < len; n++) {
+                double a = 2*M_PI * n * k / len * (inv ? 1 : -1);
+                re += in[2*n] * cos(a) - in[2*n + 1] * sin(a);
+                im += in[2*n] * sin(a) + in[2*n + 1] * cos(a);
+            }
+            out[2*k]     = re;
+            out[2*k + 1] = im;
+            break;
+        case RDFT:
+            if (!inv) {
+                if (k > len/2)
+                    break;
+                for (int n = 0; n < len; n++) {
+                    re += in[n] * cos(2*M_PI * n * k / len);
+                    im -= in[n] * sin(2*M_PI * n * k / len);
+                }
+                out[2*k]     = re * scale;
+                out[2*k + 1] = im * scale;
+            } else {
+                re = in[0] + in[len] * (k & 1 ? -1 : 1);
+                for (int n = 1; n < len/2; n++) {
+                    double a = 2*M_PI * n * k / len;
+                    re += 2 * (in[2*n] * cos(a) - in[2*n + 1] * sin(a));
+                }
+                out[k] = re * scale;
+            }
+            break;
+        case DCT:
+            if (!inv) {
+                for (int n = 0; n < len; n++)
+                    re += in[n] * cos(M_PI * (n + 0.5) * k / len);
+            } else {
+                re = in[0] * 0.5;
+                for (int n = 1; n < len; n++)
+                    re += in[n] * cos(M_PI * (k + 0.5) * n / len);
+            }
+            out[k] = re * scale;
+            break;
+        }
+    }
+}
+
+static int test(AVLFG *lfg, int kind, int dbl, int inv, int len, double scale)
+{
+    static const enum AVTXType types[][2] = {
+        { AV_TX_FLOAT_FFT,  AV_TX_DOUBLE_FFT  },
+        { AV_TX_FLOAT_RDFT, AV_TX_DOUBLE_RDFT },
+        { AV_TX_FLOAT_DCT,  AV_TX_DOUBLE_DCT  },
+    };
+    const size_t sample_size = dbl ? sizeof(double) : sizeof(float);
+    const double eps = dbl ? 1e-10 : 2e-5;
+    double *ref_in, *ref_out, max_ref = 0, max_err = 0;
+    AVTXContext *ctx = NULL;
+    av_tx_fn fn;
+    void *in, *out;
+    int in_size, out_size, ret = 1;
+
+    io_size(kind, inv, len, &in_size, &out_size);
+
+    ref_in  = av_malloc_array(in_size,  sizeof(*ref_in));
+    ref_out = av_malloc_array(out_size, sizeof(*ref_out));
+    in      = av_malloc_array(in_size,  sample_size);
+    out     = av_malloc_array(out_size, sample_size);
+    if (!ref_in || !ref_out || !in || !out)
+        goto end;
+
+    for (int i = 0; i < in_size; i++) {
+        ref_in[i] = av_lfg_get(lfg) / (double)UINT_MAX - 0.5;
+        if (dbl)
+            ((double *)in)[i] = ref_in[i];
+        else
+            ((float *)in)[i] = ref_in[i] = (float)ref_in[i];
+    }
+
+    if (kind == FFT) {
+        scale = 1.0;
+        ret = av_tx_init(&ctx, &fn, types[kind][dbl], inv, len, NULL, 0);
+    } else if (dbl) {
+        ret = av_tx_init(&ctx, &fn, types[kind][dbl], inv, len, &scale, 0);
+    } else {
+        float scalef = scale;
+        ret = av_tx_init(&ctx, &fn, types[kind][dbl], inv, len, &scalef, 0);
+    }
+    if (ret < 0) {
+        fprintf(stderr, "%s len %d inv %d: init failed\n",
+                kind_names[kind], len, inv);
+        goto end;
+    }
+
+    fn(ctx, out, in, sample_size);
+    ref_transform(kind, inv, len, scale, ref_out, ref_in);
+
+    for (int i = 0; i < out_size; i++) {
+        double v = dbl ? ((double *)out)[i] : ((float *)out)[i];
+        max_ref = FFMAX(max_ref, fabs(ref_out[i]));
+        max_err = FFMAX(max_err, fabs(ref_out[i] - v));
+    }
+
+    ret = max_err > eps * max_ref;
+    if (ret)
+        fprintf(stderr, "%s %s len %d inv %d: error %g for a peak of %g\n",
+                kind_names[kind], dbl ? "double" : "float", len, inv,
+                max_err, max_ref);
+
+end:
+    av_tx_uninit(&ctx);
+    av_free(ref_in);
+    av_free(ref_out);
+    av_free(in);
+    av_free(out);
+    return ret;
+}
+
+int main(void)
+{
+    AVLFG lfg;
+    int ret = 0;
+
+    av_lfg_init(&lfg, 1);
+
+    for (int i = 0; i < FF_ARRAY_ELEMS(lengths); i++) {
+        for (int dbl = 0; dbl < 2; dbl++) {
+            for (int inv = 0; inv < 2; inv++) {
+                ret |= test(&lfg, FFT,  dbl, inv, lengths[i], 1.0);
+                ret |= test(&lfg, RDFT, dbl, inv, 2*lengths[i], 0.5);
+                ret |= test(&lfg, DCT,  dbl, inv, 2*lengths[i], 2.0);
+            }
+        }
+    }
+
+    return ret;
+}
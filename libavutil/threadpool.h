@@ -0,0 +1,55 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef AVUTIL_THREADPOOL_H
+#define AVUTIL_THREADPOOL_H
+
+/**
+ * @file
+ * Process wide pool of worker threads.
+ *
+ * By default, every filter graph, scaling context and resampling context
+ * using slice threading starts its own threads. Once the pool is set up, the
+ * ones created afterwards submit their jobs to it instead, which bounds the
+ * total number of threads however many of them are open. The calling thread
+ * of each context takes part in its own jobs, and idle workers join the
+ * contexts with pending jobs in turn, each up to its own thread count.
+ *
+ * Since a context gets no more than the workers which happen to be idle,
+ * only jobs which never wait on each other run on the pool. Codec slice and
+ * frame threading keep their own threads, as some decoders run their slices
+ * concurrently and synchronize them on each other's progress.
+ */
+
+/**
+ * Set up the shared worker pool.
+ *
+ * @param nb_workers number of worker threads, 0 for the number of CPUs
+ * @return 0 on success, AVERROR(EEXIST) if the pool is already set up,
+ *         another negative AVERROR code on failure
+ */
+int av_thread_pool_init(int nb_workers);
+
+/**
+ * Stop attaching new contexts to the shared worker pool. Its threads exit
+ * once the contexts still using it are freed. Does nothing if the pool is
+ * not set up.
+ */
+void av_thread_pool_uninit(void);
+
+#endif /* AVUTIL_THREADPOOL_H */
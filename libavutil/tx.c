@@ -16,6 +16,7 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
  */
 
+#include "config.h"
 #include "tx_priv.h"
 
 int ff_tx_type_is_mdct(enum AVTXType type)
@@ -30,6 +31,28 @@ int ff_tx_type_is_mdct(enum AVTXType type)
     }
 }
 
+int ff_tx_type_is_rdft(enum AVTXType type)
+{
+    switch (type) {
+    case AV_TX_FLOAT_RDFT:
+    case AV_TX_DOUBLE_RDFT:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+int ff_tx_type_is_dct(enum AVTXType type)
+{
+    switch (type) {
+    case AV_TX_FLOAT_DCT:
+    case AV_TX_DOUBLE_DCT:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
 /* Calculates the modular multiplicative inverse, not fast, replace */
 static av_always_inline int mulinv(int n, int m)
 {
@@ -116,6 +139,7 @@ av_cold void av_tx_uninit(AVTXContext **ctx)
     av_free((*ctx)->exptab);
     av_free((*ctx)->revtab);
     av_free((*ctx)->tmp);
+    av_free((*ctx)->rtmp);
 
     av_freep(ctx);
 }
@@ -131,11 +155,17 @@ av_cold int av_tx_init(AVTXContext **ctx, av_tx_fn *tx, enum AVTXType type,
     switch (type) {
     case AV_TX_FLOAT_FFT:
     case AV_TX_FLOAT_MDCT:
+    case AV_TX_FLOAT_RDFT:
+    case AV_TX_FLOAT_DCT:
         if ((err = ff_tx_init_mdct_fft_float(s, tx, type, inv, len, scale, flags)))
             goto fail;
+        if (ARCH_X86)
+            ff_tx_init_float_x86(s);
         break;
     case AV_TX_DOUBLE_FFT:
     case AV_TX_DOUBLE_MDCT:
+    case AV_TX_DOUBLE_RDFT:
+    case AV_TX_DOUBLE_DCT:
         if ((err = ff_tx_init_mdct_fft_double(s, tx, type, inv, len, scale, flags)))
             goto fail;
         break;
@@ -72,6 +72,34 @@ enum AVTXType {
      * Stride must be a non-zero multiple of sizeof(int32_t).
      */
     AV_TX_INT32_MDCT = 5,
+    /**
+     * Real to complex and complex to real DFT with sample data type of float
+     * and a scale type of float, NULL meaning 1.0.
+     * The forward transform turns len real samples into len/2 + 1 complex
+     * (AVComplexFloat) coefficients, the inverse transform does the reverse.
+     * The inverse output is not 1/len normalized. Length must be even.
+     * The stride parameter is ignored.
+     */
+    AV_TX_FLOAT_RDFT = 6,
+    /**
+     * Same as AV_TX_FLOAT_RDFT with data and scale type of double.
+     */
+    AV_TX_DOUBLE_RDFT = 7,
+    /**
+     * Real to real DCT with sample data type of float and a scale type of
+     * float, NULL meaning 1.0. Both arrays hold len samples.
+     * The forward transform is a DCT-II:
+     *     X[k] = sum(x[n] * cos(M_PI * (n + 0.5) * k / len))
+     * The inverse transform is a DCT-III:
+     *     x[n] = X[0] / 2 + sum(X[k] * cos(M_PI * (n + 0.5) * k / len))
+     * so the inverse of the forward transform is scaled by len / 2.
+     * Length must be even. The stride parameter is ignored.
+     */
+    AV_TX_FLOAT_DCT = 8,
+    /**
+     * Same as AV_TX_FLOAT_DCT with data and scale type of double.
+     */
+    AV_TX_DOUBLE_DCT = 9,
 };
 
 /**
@@ -95,6 +123,7 @@ typedef void (*av_tx_fn)(AVTXContext *s, void *out, void *in, ptrdiff_t stride);
  * Initialize a transform context with the given configuration
  * Currently power of two lengths from 2 to 131072 are supported, along with
  * any length decomposable to a power of two and either 3, 5 or 15.
+ * For the RDFT and DCT types, half the length must be one of those.
  *
  * @param ctx the context to allocate, will be NULL on error
  * @param tx pointer to the transform function pointer to set
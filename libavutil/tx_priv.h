@@ -112,10 +112,19 @@ struct AVTXContext {
     FFTComplex *tmp;    /* Temporary buffer needed for all compound transforms */
     int        *pfatab; /* Input/Output mapping for compound transforms */
     int        *revtab; /* Input mapping for power of two transforms */
+
+    /* Power of two FFT of 1 << nbits samples, permuted with revtab */
+    void (*ptwo_fft)(FFTComplex *z, int nbits);
+
+    av_tx_fn    cfft;   /* Complex FFT of half the length of real transforms */
+    FFTComplex *rtmp;   /* Temporary buffer needed for real transforms */
+    double      scale;  /* Output scale of RDFTs */
 };
 
 /* Shared functions */
 int ff_tx_type_is_mdct(enum AVTXType type);
+int ff_tx_type_is_rdft(enum AVTXType type);
+int ff_tx_type_is_dct(enum AVTXType type);
 int ff_tx_gen_compound_mapping(AVTXContext *s);
 int ff_tx_gen_ptwo_revtab(AVTXContext *s);
 
@@ -146,6 +155,8 @@ int ff_tx_init_mdct_fft_int32(AVTXContext *s, av_tx_fn *tx,
                               enum AVTXType type, int inv, int len,
                               const void *scale, uint64_t flags);
 
+void ff_tx_init_float_x86(AVTXContext *s);
+
 typedef struct CosTabsInitOnce {
     void (*func)(void);
     AVOnce control;
@@ -359,6 +359,11 @@ static void (* const fft_dispatch[])(FFTComplex*) = {
     fft1024, fft2048, fft4096, fft8192, fft16384, fft32768, fft65536, fft131072
 };
 
+static void ptwo_fft(FFTComplex *z, int nbits)
+{
+    fft_dispatch[nbits](z);
+}
+
 #define DECL_COMP_FFT(N)                                                       \
 static void compound_fft_##N##xM(AVTXContext *s, void *_out,                   \
                                  void *_in, ptrdiff_t stride)                  \
@@ -367,7 +372,7 @@ static void compound_fft_##N##xM(AVTXContext *s, void *_out,                   \
     FFTComplex *in = _in;                                                      \
     FFTComplex *out = _out;                                                    \
     FFTComplex fft##N##in[N];                                                  \
-    void (*fftp)(FFTComplex *z) = fft_dispatch[av_log2(m)];                    \
+    const int mb = av_log2(m);                                                 \
                                                                                \
     for (int i = 0; i < m; i++) {                                              \
         for (int j = 0; j < N; j++)                                            \
@@ -376,7 +381,7 @@ static void compound_fft_##N##xM(AVTXContext *s, void *_out,                   \
     }                                                                          \
                                                                                \
     for (int i = 0; i < N; i++)                                                \
-        fftp(s->tmp + m*i);                                                    \
+        s->ptwo_fft(s->tmp + m*i, mb);                                         \
                                                                                \
     for (int i = 0; i < N*m; i++)                                              \
         out[i] = s->tmp[out_map[i]];                                           \
@@ -394,7 +399,7 @@ static void monolithic_fft(AVTXContext *s, void *_out, void *_in,
     int m = s->m, mb = av_log2(m);
     for (int i = 0; i < m; i++)
         out[s->revtab[i]] = in[i];
-    fft_dispatch[mb](out);
+    s->ptwo_fft(out, mb);
 }
 
 #define DECL_COMP_IMDCT(N)                                                     \
@@ -406,7 +411,7 @@ static void compound_imdct_##N##xM(AVTXContext *s, void *_dst, void *_src,     \
     const int m = s->m, len8 = N*m >> 1;                                       \
     const int *in_map = s->pfatab, *out_map = in_map + N*m;                    \
     const FFTSample *src = _src, *in1, *in2;                                   \
-    void (*fftp)(FFTComplex *) = fft_dispatch[av_log2(m)];                     \
+    const int mb = av_log2(m);                                                 \
                                                                                \
     stride /= sizeof(*src); /* To convert it from bytes */                     \
     in1 = src;                                                                 \
@@ -422,7 +427,7 @@ static void compound_imdct_##N##xM(AVTXContext *s, void *_dst, void *_src,     \
     }                                                                          \
                                                                                \
     for (int i = 0; i < N; i++)                                                \
-        fftp(s->tmp + m*i);                                                    \
+        s->ptwo_fft(s->tmp + m*i, mb);                                         \
                                                                                \
     for (int i = 0; i < len8; i++) {                                           \
         const int i0 = len8 + i, i1 = len8 - i - 1;                            \
@@ -447,7 +452,7 @@ static void compound_mdct_##N##xM(AVTXContext *s, void *_dst, void *_src,      \
     FFTComplex *exp = s->exptab, tmp, fft##N##in[N];                           \
     const int m = s->m, len4 = N*m, len3 = len4 * 3, len8 = len4 >> 1;         \
     const int *in_map = s->pfatab, *out_map = in_map + N*m;                    \
-    void (*fftp)(FFTComplex *) = fft_dispatch[av_log2(m)];                     \
+    const int mb = av_log2(m);                                                 \
                                                                                \
     stride /= sizeof(*dst);                                                    \
                                                                                \
@@ -468,7 +473,7 @@ static void compound_mdct_##N##xM(AVTXContext *s, void *_dst, void *_src,      \
     }                                                                          \
                                                                                \
     for (int i = 0; i < N; i++)                                                \
-        fftp(s->tmp + m*i);                                                    \
+        s->ptwo_fft(s->tmp + m*i, mb);                                         \
                                                                                \
     for (int i = 0; i < len8; i++) {                                           \
         const int i0 = len8 + i, i1 = len8 - i - 1;                            \
@@ -493,7 +498,7 @@ static void monolithic_imdct(AVTXContext *s, void *_dst, void *_src,
     FFTComplex *z = _dst, *exp = s->exptab;
     const int m = s->m, len8 = m >> 1;
     const FFTSample *src = _src, *in1, *in2;
-    void (*fftp)(FFTComplex *) = fft_dispatch[av_log2(m)];
+    const int mb = av_log2(m);
 
     stride /= sizeof(*src);
     in1 = src;
@@ -504,7 +509,7 @@ static void monolithic_imdct(AVTXContext *s, void *_dst, void *_src,
         CMUL3(z[s->revtab[i]], tmp, exp[i]);
     }
 
-    fftp(z);
+    s->ptwo_fft(z, mb);
 
     for (int i = 0; i < len8; i++) {
         const int i0 = len8 + i, i1 = len8 - i - 1;
@@ -522,7 +527,7 @@ static void monolithic_mdct(AVTXContext *s, void *_dst, void *_src,
     FFTSample *src = _src, *dst = _dst;
     FFTComplex *exp = s->exptab, tmp, *z = _dst;
     const int m = s->m, len4 = m, len3 = len4 * 3, len8 = len4 >> 1;
-    void (*fftp)(FFTComplex *) = fft_dispatch[av_log2(m)];
+    const int mb = av_log2(m);
 
     stride /= sizeof(*dst);
 
@@ -539,7 +544,7 @@ static void monolithic_mdct(AVTXContext *s, void *_dst, void *_src,
              exp[i].re, exp[i].im);
     }
 
-    fftp(z);
+    s->ptwo_fft(z, mb);
 
     for (int i = 0; i < len8; i++) {
         const int i0 = len8 + i, i1 = len8 - i - 1;
@@ -553,6 +558,154 @@ static void monolithic_mdct(AVTXContext *s, void *_dst, void *_src,
     }
 }
 
+#ifndef TX_INT32
+/* Turns the FFT of len2 complex samples, made of the len2*2 real input, into
+ * the len2 + 1 first coefficients of the real input DFT, in place */
+static void rdft_post(FFTComplex *z, const FFTComplex *tw, int len2,
+                      FFTSample scale)
+{
+    const FFTSample fac = scale * 0.5f;
+    FFTComplex z0 = z[0];
+
+    z[0]    = (FFTComplex){ (z0.re + z0.im) * scale, 0 };
+    z[len2] = (FFTComplex){ (z0.re - z0.im) * scale, 0 };
+
+    for (int k = 1; k <= len2 >> 1; k++) {
+        const FFTComplex a = z[k], b = z[len2 - k];
+        FFTComplex e = { fac * (a.re + b.re),  fac * (a.im - b.im) };
+        FFTComplex o = { fac * (a.im + b.im), -fac * (a.re - b.re) }, t;
+
+        CMUL3(t, o, tw[k]);
+        z[k]        = (FFTComplex){ e.re + t.re, e.im + t.im };
+        z[len2 - k] = (FFTComplex){ e.re - t.re, t.im - e.im };
+    }
+}
+
+/* Inverse of rdft_post(), dst and src may be equal */
+static void rdft_pre(FFTComplex *dst, const FFTComplex *src,
+                     const FFTComplex *tw, int len2, FFTSample scale)
+{
+    const FFTSample x0 = src[0].re, xn = src[len2].re;
+
+    dst[0] = (FFTComplex){ (x0 + xn) * scale, (x0 - xn) * scale };
+
+    for (int k = 1; k <= len2 >> 1; k++) {
+        const FFTComplex a = src[k], b = src[len2 - k];
+        FFTComplex e = { scale * (a.re + b.re), scale * (a.im - b.im) };
+        FFTComplex o = { scale * (a.re - b.re), scale * (a.im + b.im) }, t;
+
+        CMUL3(t, o, tw[k]);
+        dst[k]        = (FFTComplex){ e.re - t.im, e.im + t.re };
+        dst[len2 - k] = (FFTComplex){ e.re + t.im, t.re - e.im };
+    }
+}
+
+static void rdft_r2c(AVTXContext *s, void *_out, void *_in, ptrdiff_t stride)
+{
+    FFTComplex *out = _out;
+    const int len2 = s->n*s->m;
+
+    s->cfft(s, out, _in, sizeof(*out));
+    rdft_post(out, s->exptab, len2, s->scale);
+}
+
+static void rdft_c2r(AVTXContext *s, void *_out, void *_in, ptrdiff_t stride)
+{
+    const int len2 = s->n*s->m;
+
+    rdft_pre(s->rtmp, _in, s->exptab, len2, s->scale);
+    s->cfft(s, _out, s->rtmp, sizeof(FFTComplex));
+}
+
+/* Computed with a DFT of the even samples followed by the reversed odd ones,
+ * as described in J. Makhoul, "A fast cosine transform in one and two
+ * dimensions", 1980 */
+static void dct_ii(AVTXContext *s, void *_out, void *_in, ptrdiff_t stride)
+{
+    FFTSample *src = _in, *dst = _out;
+    const int len2 = s->n*s->m, len = len2*2;
+    const FFTComplex *exp = s->exptab + (len2 >> 1) + 1;
+    FFTComplex *z = s->rtmp, *v = z + FFALIGN(len2 + 1, 8);
+    FFTSample *vs = (FFTSample *)v;
+
+    for (int i = 0; i < len2; i++) {
+        vs[i]           = src[2*i];
+        vs[len - 1 - i] = src[2*i + 1];
+    }
+
+    s->cfft(s, z, v, sizeof(*z));
+    rdft_post(z, s->exptab, len2, 1);
+
+    dst[0] = z[0].re * exp[0].re;
+    for (int k = 1; k <= len2; k++) {
+        FFTComplex t;
+        CMUL3(t, z[k], exp[k]);
+        dst[k] = t.re;
+        if (k < len2)
+            dst[len - k] = -t.im;
+    }
+}
+
+static void dct_iii(AVTXContext *s, void *_out, void *_in, ptrdiff_t stride)
+{
+    FFTSample *src = _in, *dst = _out;
+    const int len2 = s->n*s->m, len = len2*2;
+    const FFTComplex *exp = s->exptab + (len2 >> 1) + 1;
+    FFTComplex *z = s->rtmp, *v = z + FFALIGN(len2 + 1, 8);
+    FFTSample *vs = (FFTSample *)v;
+
+    z[0] = (FFTComplex){ src[0] * exp[0].re, src[0] * exp[0].im };
+    for (int k = 1; k <= len2; k++) {
+        FFTComplex t = { src[k], -src[len - k] };
+        CMUL3(z[k], t, exp[k]);
+    }
+
+    rdft_pre(z, z, s->exptab, len2, 1);
+    s->cfft(s, v, z, sizeof(*z));
+
+    for (int i = 0; i < len2; i++) {
+        dst[2*i]     = vs[i];
+        dst[2*i + 1] = vs[len - 1 - i];
+    }
+}
+
+static int gen_real_exptab(AVTXContext *s, int len2, int is_dct, double scale)
+{
+    const int len4 = len2 >> 1;
+    const double sign = s->inv ? 1.0 : -1.0;
+    FFTComplex *exp;
+
+    if (!(s->exptab = av_malloc_array(len4 + 1 + (is_dct ? len2 + 1 : 0),
+                                      sizeof(*s->exptab))))
+        return AVERROR(ENOMEM);
+
+    /* exp(-2*pi*i*k/len), conjugated for inverse transforms */
+    for (int k = 0; k <= len4; k++) {
+        const double alpha = M_PI * k / len2;
+        s->exptab[k].re = cos(alpha);
+        s->exptab[k].im = sign * sin(alpha);
+    }
+
+    if (!is_dct) {
+        s->scale = scale;
+        return 0;
+    }
+
+    /* exp(-pi*i*k/(2*len)), conjugated and halved for the DCT-III */
+    exp = s->exptab + len4 + 1;
+    scale *= s->inv ? 0.5 : 1.0;
+    for (int k = 0; k <= len2; k++) {
+        const double alpha = M_PI_4 * k / len2;
+        exp[k].re = cos(alpha) * scale;
+        exp[k].im = sign * sin(alpha) * scale;
+    }
+
+    s->scale = 1.0;
+
+    return 0;
+}
+#endif /* TX_INT32 */
+
 static int gen_mdct_exptab(AVTXContext *s, int len4, double scale)
 {
     const double theta = (scale < 0 ? len4 : 0) + 1.0/8.0;
@@ -575,9 +728,16 @@ int TX_NAME(ff_tx_init_mdct_fft)(AVTXContext *s, av_tx_fn *tx,
                                  const void *scale, uint64_t flags)
 {
     const int is_mdct = ff_tx_type_is_mdct(type);
+    const int is_real = ff_tx_type_is_rdft(type) || ff_tx_type_is_dct(type);
     int err, n = 1, m = 1, max_ptwo = 1 << (FF_ARRAY_ELEMS(fft_dispatch) - 1);
 
-    if (is_mdct)
+    if (is_real && (len & 1)) {
+        av_log(NULL, AV_LOG_ERROR, "Real transforms need an even length, "
+               "got %i!\n", len);
+        return AVERROR(EINVAL);
+    }
+
+    if (is_mdct || is_real)
         len >>= 1;
 
 #define CHECK_FACTOR(DST, FACTOR, SRC)                                         \
@@ -600,6 +760,7 @@ int TX_NAME(ff_tx_init_mdct_fft)(AVTXContext *s, av_tx_fn *tx,
     s->m = m;
     s->inv = inv;
     s->type = type;
+    s->ptwo_fft = ptwo_fft;
 
     /* Filter out direct 3, 5 and 15 transforms, too niche */
     if (len > 1 || m == 1) {
@@ -627,7 +788,8 @@ int TX_NAME(ff_tx_init_mdct_fft)(AVTXContext *s, av_tx_fn *tx,
     if (n != 1)
         init_cos_tabs(0);
     if (m != 1) {
-        ff_tx_gen_ptwo_revtab(s);
+        if ((err = ff_tx_gen_ptwo_revtab(s)))
+            return err;
         for (int i = 4; i <= av_log2(m); i++)
             init_cos_tabs(i);
     }
@@ -635,5 +797,19 @@ int TX_NAME(ff_tx_init_mdct_fft)(AVTXContext *s, av_tx_fn *tx,
     if (is_mdct)
         return gen_mdct_exptab(s, n*m, *((SCALE_TYPE *)scale));
 
+#ifndef TX_INT32
+    if (is_real) {
+        const int len2 = n*m, is_dct = ff_tx_type_is_dct(type);
+        if (!(s->rtmp = av_malloc_array(FFALIGN(len2 + 1, 8) + len2,
+                                        sizeof(*s->rtmp))))
+            return AVERROR(ENOMEM);
+        s->cfft = *tx;
+        *tx = is_dct ? inv ? dct_iii  : dct_ii :
+                       inv ? rdft_c2r : rdft_r2c;
+        return gen_real_exptab(s, len2, is_dct,
+                               scale ? *((SCALE_TYPE *)scale) : 1.0);
+    }
+#endif
+
     return 0;
 }
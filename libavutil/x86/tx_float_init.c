@@ -0,0 +1,91 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#define TX_FLOAT
+#include "config.h"
+
+#include "libavutil/attributes.h"
+#include "libavutil/cpu.h"
+#include "libavutil/tx_priv.h"
+#include "cpu.h"
+
+void ff_tx_fft_float_sse(FFTComplex *z, int nbits);
+void ff_tx_fft_float_avx(FFTComplex *z, int nbits);
+
+/* The SSE transforms read the inputs of each 4-point FFT as {0, 2, 1, 3} */
+static void gen_revtab_sse(AVTXContext *s)
+{
+    const int m = s->m;
+
+    for (int i = 0; i < m; i++) {
+        int k = -split_radix_permutation(i, m, s->inv) & (m - 1);
+        s->revtab[k] = (i & ~3) | ((i >> 1) & 1) | ((i << 1) & 2);
+    }
+}
+
+static const int avx_tab[] = {
+    0, 4, 1, 5, 8, 12, 9, 13, 2, 6, 3, 7, 10, 14, 11, 15
+};
+
+static int is_second_half_of_fft32(int i, int n)
+{
+    if (n <= 32)
+        return i >= 16;
+    else if (i < n/2)
+        return is_second_half_of_fft32(i, n/2);
+    else if (i < 3*n/4)
+        return is_second_half_of_fft32(i - n/2, n/4);
+    else
+        return is_second_half_of_fft32(i - 3*n/4, n/4);
+}
+
+/* The AVX transforms do two 8 or 4-point FFTs per register, same order as
+ * the lavc AVX FFT. Not selected until checkasm has passed on AVX hardware. */
+static av_unused void gen_revtab_avx(AVTXContext *s)
+{
+    const int m = s->m;
+
+    for (int i = 0; i < m; i += 16) {
+        if (is_second_half_of_fft32(i, m)) {
+            for (int k = 0; k < 16; k++) {
+                int j = -split_radix_permutation(i + k, m, s->inv) & (m - 1);
+                s->revtab[j] = i + avx_tab[k];
+            }
+        } else {
+            for (int k = 0; k < 16; k++) {
+                int j = -split_radix_permutation(i + k, m, s->inv) & (m - 1);
+                int l = i + k;
+                s->revtab[j] = (l & ~7) | ((l >> 1) & 3) | ((l << 2) & 4);
+            }
+        }
+    }
+}
+
+av_cold void ff_tx_init_float_x86(AVTXContext *s)
+{
+    int cpu_flags = av_get_cpu_flags();
+    int nbits = av_log2(s->m);
+
+    if (nbits < 2)
+        return;
+
+    if (EXTERNAL_SSE(cpu_flags)) {
+        s->ptwo_fft = ff_tx_fft_float_sse;
+        gen_revtab_sse(s);
+    }
+}
@@ -87,6 +87,9 @@ static const AVOption options[]={
 {"linear_interp"        , "enable linear interpolation" , OFFSET(linear_interp)  , AV_OPT_TYPE_BOOL , {.i64=1                     }, 0      , 1         , PARAM },
 {"exact_rational"       , "enable exact rational"       , OFFSET(exact_rational) , AV_OPT_TYPE_BOOL , {.i64=1                     }, 0      , 1         , PARAM },
 {"cutoff"               , "set cutoff frequency ratio"  , OFFSET(cutoff)         , AV_OPT_TYPE_DOUBLE,{.dbl=0.                    }, 0      , 1         , PARAM },
+{"threads"              , "set the number of resampling threads", OFFSET(nb_threads), AV_OPT_TYPE_INT, {.i64=1                     }, 0      , INT_MAX   , PARAM },
+{"swr_threads"          , "set the number of resampling threads", OFFSET(nb_threads), AV_OPT_TYPE_INT, {.i64=1                     }, 0      , INT_MAX   , PARAM },
+{"low_delay"            , "keep the resampling latency within 1 ms", OFFSET(low_delay), AV_OPT_TYPE_BOOL, {.i64=0                     }, 0      , 1         , PARAM },
 
 /* duplicate option in order to work with avconv */
 {"resample_cutoff"      , "set cutoff frequency ratio"  , OFFSET(cutoff)         , AV_OPT_TYPE_DOUBLE,{.dbl=0.                    }, 0      , 1         , PARAM },
@@ -280,13 +280,28 @@ static void resample_free(ResampleContext **cc){
     ResampleContext *c = *cc;
     if(!c)
         return;
+    avpriv_slicethread_free(&c->slicethread);
     av_freep(&c->filter_bank);
     av_freep(cc);
 }
 
+static void resample_channels(void *priv, int jobnr, int threadnr, int nb_jobs, int nb_threads)
+{
+    ResampleContext *c = priv;
+    /* the last channel updates the context and is resampled afterwards */
+    const int nb_channels = c->job.dst->ch_count - 1;
+    const int start = (nb_channels *  jobnr   ) / nb_jobs;
+    const int end   = (nb_channels * (jobnr+1)) / nb_jobs;
+    int i;
+
+    for (i = start; i < end; i++)
+        c->job.func(c, c->job.dst->ch[i], c->job.src->ch[i], c->job.n, 0);
+}
+
 static ResampleContext *resample_init(ResampleContext *c, int out_rate, int in_rate, int filter_size, int phase_shift, int linear,
                                     double cutoff0, enum AVSampleFormat format, enum SwrFilterType filter_type, double kaiser_beta,
-                                    double precision, int cheby, int exact_rational)
+                                    double precision, int cheby, int exact_rational, int nb_threads,
+                                    int low_delay)
 {
     double cutoff = cutoff0? cutoff0 : 0.97;
     double factor= FFMIN(out_rate * cutoff / in_rate, 1.0);
@@ -294,6 +309,11 @@ static ResampleContext *resample_init(ResampleContext *c, int out_rate, int in_r
     int phase_count_compensation = phase_count;
     int filter_length = FFMAX((int)ceil(filter_size/factor), 1);
 
+    /* the filter is centered on each output sample, so it looks half its
+     * length ahead; keep that within 1 ms of input */
+    if (low_delay)
+        filter_length = FFMIN(filter_length, FFMAX(2 * in_rate / 1000, 1));
+
     if (filter_length > 1)
         filter_length = FFALIGN(filter_length, 2);
 
@@ -344,7 +364,7 @@ static ResampleContext *resample_init(ResampleContext *c, int out_rate, int in_r
         c->linear        = linear;
         c->factor        = factor;
         c->filter_length = filter_length;
-        c->filter_alloc  = FFALIGN(c->filter_length, 8);
+        c->filter_alloc  = FFALIGN(c->filter_length, 16);
         c->filter_bank   = av_calloc(c->filter_alloc, (phase_count+1)*c->felem_size);
         c->filter_type   = filter_type;
         c->kaiser_beta   = kaiser_beta;
@@ -373,6 +393,20 @@ static ResampleContext *resample_init(ResampleContext *c, int out_rate, int in_r
 
     swri_resample_dsp_init(c);
 
+    if (!c->nb_threads || c->threads_option != nb_threads) {
+        avpriv_slicethread_free(&c->slicethread);
+        c->threads_option = nb_threads;
+        c->nb_threads     = 1;
+        if (nb_threads != 1) {
+            /* without thread support, channels are simply resampled in turn */
+            int ret = avpriv_slicethread_create_shared(&c->slicethread, c, resample_channels, nb_threads);
+            if (ret > 1)
+                c->nb_threads = ret;
+            else
+                avpriv_slicethread_free(&c->slicethread);
+        }
+    }
+
     return c;
 error:
     av_freep(&c->filter_bank);
@@ -494,8 +528,19 @@ static int multiple_resample(ResampleContext *c, AudioData *dst, int dst_size, A
              * when frac and dst_incr_mod are zero */
             resample_func = (c->linear && (c->frac || c->dst_incr_mod)) ?
                             c->dsp.resample_linear : c->dsp.resample_common;
-            for (i = 0; i < dst->ch_count; i++)
-                *consumed = resample_func(c, dst->ch[i], src->ch[i], dst_size, i+1 == dst->ch_count);
+            if (c->slicethread && dst->ch_count > 2) {
+                /* every channel but the last one only reads the context */
+                c->job.dst  = dst;
+                c->job.src  = src;
+                c->job.n    = dst_size;
+                c->job.func = resample_func;
+                avpriv_slicethread_execute(c->slicethread, FFMIN(c->nb_threads, dst->ch_count - 1), 0);
+                i = dst->ch_count - 1;
+                *consumed = resample_func(c, dst->ch[i], src->ch[i], dst_size, 1);
+            } else {
+                for (i = 0; i < dst->ch_count; i++)
+                    *consumed = resample_func(c, dst->ch[i], src->ch[i], dst_size, i+1 == dst->ch_count);
+            }
         }
     }
 
@@ -543,6 +588,10 @@ static int64_t get_out_samples(struct SwrContext *s, int in_samples) {
     return num;
 }
 
+static int get_input_padding(struct ResampleContext *c) {
+    return c->input_padding;
+}
+
 static int resample_flush(struct SwrContext *s) {
     ResampleContext *c = s->resample;
     AudioData *a= &s->in_buffer;
@@ -619,4 +668,5 @@ struct Resampler const swri_resampler={
   get_delay,
   invert_initial_buffer,
   get_out_samples,
+  get_input_padding,
 };
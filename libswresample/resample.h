@@ -24,6 +24,7 @@
 
 #include "libavutil/log.h"
 #include "libavutil/samplefmt.h"
+#include "libavutil/slicethread.h"
 
 #include "swresample_internal.h"
 
@@ -58,6 +59,19 @@ typedef struct ResampleContext {
         int (*resample_linear)(struct ResampleContext *c, void *dst,
                                const void *src, int n, int update_ctx);
     } dsp;
+    int input_padding;  ///< input samples the dsp functions may read past the end of the source
+
+    /* channel threading, must stay after the fields used by the asm */
+    AVSliceThread *slicethread;
+    int threads_option;
+    int nb_threads;
+    struct {
+        AudioData *dst;
+        AudioData *src;
+        int n;
+        int (*func)(struct ResampleContext *c, void *dst,
+                    const void *src, int n, int update_ctx);
+    } job;
 } ResampleContext;
 
 void swri_resample_dsp_init(ResampleContext *c);
@@ -67,6 +67,7 @@ void swri_resample_dsp_init(ResampleContext *c)
         c->dsp.resample_linear = resample_linear_double;
         break;
     }
+    c->input_padding = 0;
 
     if (ARCH_X86) swri_resample_dsp_x86_init(c);
     else if (ARCH_ARM) swri_resample_dsp_arm_init(c);
@@ -30,7 +30,8 @@
 #include <soxr.h>
 
 static struct ResampleContext *create(struct ResampleContext *c, int out_rate, int in_rate, int filter_size, int phase_shift, int linear,
-        double cutoff, enum AVSampleFormat format, enum SwrFilterType filter_type, double kaiser_beta, double precision, int cheby, int exact_rational){
+        double cutoff, enum AVSampleFormat format, enum SwrFilterType filter_type, double kaiser_beta, double precision, int cheby, int exact_rational,
+        int nb_threads, int low_delay){
     soxr_error_t error;
 
     soxr_datatype_t type =
@@ -45,7 +46,10 @@ static struct ResampleContext *create(struct ResampleContext *c, int out_rate, i
 
     soxr_io_spec_t io_spec = soxr_io_spec(type, type);
 
-    soxr_quality_spec_t q_spec = soxr_quality_spec((int)((precision-2)/4), (SOXR_HI_PREC_CLOCK|SOXR_ROLLOFF_NONE)*!!cheby);
+    soxr_runtime_spec_t r_spec = soxr_runtime_spec(nb_threads);
+
+    soxr_quality_spec_t q_spec = soxr_quality_spec((int)((precision-2)/4) | (low_delay ? SOXR_MINIMUM_PHASE : 0),
+                                                   (SOXR_HI_PREC_CLOCK|SOXR_ROLLOFF_NONE)*!!cheby);
     q_spec.precision = precision;
 #if !defined SOXR_VERSION /* Deprecated @ March 2013: */
     q_spec.bw_pc = cutoff? FFMAX(FFMIN(cutoff,.995),.8)*100 : q_spec.bw_pc;
@@ -55,7 +59,7 @@ static struct ResampleContext *create(struct ResampleContext *c, int out_rate, i
 
     soxr_delete((soxr_t)c);
     c = (struct ResampleContext *)
-        soxr_create(in_rate, out_rate, 0, &error, &io_spec, &q_spec, 0);
+        soxr_create(in_rate, out_rate, 0, &error, &io_spec, &q_spec, &r_spec);
     if (!c)
         av_log(NULL, AV_LOG_ERROR, "soxr_create: %s\n", error);
     return c;
@@ -125,6 +129,6 @@ static int64_t get_out_samples(struct SwrContext *s, int in_samples){
 
 struct Resampler const swri_soxr_resampler={
     create, destroy, process, flush, NULL /* set_compensation */, get_delay,
-    invert_initial_buffer, get_out_samples
+    invert_initial_buffer, get_out_samples, NULL /* get_input_padding */
 };
 
@@ -27,7 +27,7 @@
 
 #include <float.h>
 
-#define ALIGN 32
+#define ALIGN 64
 
 #include "libavutil/ffversion.h"
 const char swr_ffversion[] = "FFmpeg version " FFMPEG_VERSION;
@@ -272,7 +272,7 @@ av_cold int swr_init(struct SwrContext *s){
     }
 
     if (s->out_sample_rate!=s->in_sample_rate || (s->flags & SWR_FLAG_RESAMPLE)){
-        s->resample = s->resampler->init(s->resample, s->out_sample_rate, s->in_sample_rate, s->filter_size, s->phase_shift, s->linear_interp, s->cutoff, s->int_sample_fmt, s->filter_type, s->kaiser_beta, s->precision, s->cheby, s->exact_rational);
+        s->resample = s->resampler->init(s->resample, s->out_sample_rate, s->in_sample_rate, s->filter_size, s->phase_shift, s->linear_interp, s->cutoff, s->int_sample_fmt, s->filter_type, s->kaiser_beta, s->precision, s->cheby, s->exact_rational, s->nb_threads, s->low_delay);
         if (!s->resample) {
             av_log(s, AV_LOG_ERROR, "Failed to initialize resampler\n");
             return AVERROR(ENOMEM);
@@ -390,6 +390,21 @@ av_assert0(s->out.ch_count);
             goto fail;
     }
 
+    if (s->low_delay) {
+        /* real-time input mostly comes in 10 ms blocks; size the buffers for
+         * those now, swri_realloc_audio() only ever grows them */
+        int in_block  = s->in_sample_rate  / 100 + 1;
+        int out_block = s->out_sample_rate / 100 + 1;
+
+        if (   (ret = swri_realloc_audio(&s->postin, in_block)) < 0
+            || (ret = swri_realloc_audio(&s->midbuf, s->resample_first ? out_block : in_block)) < 0
+            || (ret = swri_realloc_audio(&s->preout, out_block)) < 0)
+            goto fail;
+        /* plus the up to 2 ms of history kept for the filter */
+        if (s->resample && (ret = swri_realloc_audio(&s->in_buffer, in_block + s->in_sample_rate / 500 + 2)) < 0)
+            goto fail;
+    }
+
     return 0;
 fail:
     swr_close(s);
@@ -489,7 +504,7 @@ static int resample(SwrContext *s, AudioData *out_param, int out_count,
     AudioData in, out, tmp;
     int ret_sum=0;
     int border=0;
-    int padless = ARCH_X86 && s->engine == SWR_ENGINE_SWR ? 7 : 0;
+    int padless = s->resampler->get_input_padding ? s->resampler->get_input_padding(s->resample) : 0;
 
     av_assert1(s->in_buffer.ch_count == in_param->ch_count);
     av_assert1(s->in_buffer.planar   == in_param->planar);
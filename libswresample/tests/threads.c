@@ -0,0 +1,204 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * Resample 64 channels from 48 kHz to 44.1 kHz with several thread counts,
+ * print the processing cost per second of audio and check that the output
+ * is bit-identical to the single threaded run.
+ *
+ * Usage: threads [seconds]
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libavutil/error.h"
+#include "libavutil/lfg.h"
+#include "libavutil/mem.h"
+#include "libavutil/opt.h"
+#include "libavutil/samplefmt.h"
+#include "libavutil/time.h"
+
+#include "libswresample/swresample.h"
+
+#define CHANNELS    64
+#define IN_RATE     48000
+#define OUT_RATE    44100
+#define CHUNK       1024
+
+static const int threads[] = { 1, 2, 4, 8 };
+
+static const enum AVSampleFormat formats[] = {
+    AV_SAMPLE_FMT_S16P, AV_SAMPLE_FMT_FLTP, AV_SAMPLE_FMT_DBLP,
+};
+
+static void fill_input(uint8_t **data, enum AVSampleFormat fmt, int nb_samples)
+{
+    AVLFG lfg;
+    int ch, i;
+
+    av_lfg_init(&lfg, 0x5752);
+    for (ch = 0; ch < CHANNELS; ch++) {
+        for (i = 0; i < nb_samples; i++) {
+            const double v = ((int)av_lfg_get(&lfg) >> 1) / (double)(1 << 30);
+
+            switch (fmt) {
+            case AV_SAMPLE_FMT_S16P: ((int16_t *)data[ch])[i] = lrint(v * 16384); break;
+            case AV_SAMPLE_FMT_FLTP: ((float   *)data[ch])[i] = v * 0.5;          break;
+            case AV_SAMPLE_FMT_DBLP: ((double  *)data[ch])[i] = v * 0.5;          break;
+            }
+        }
+    }
+}
+
+/**
+ * Convert the whole input in CHUNK sized calls and flush.
+ *
+ * @return the number of output samples, or a negative error code
+ */
+static int convert(enum AVSampleFormat fmt, int nb_threads, uint8_t **in,
+                   int in_samples, uint8_t **out, int out_size)
+{
+    const int bps = av_get_bytes_per_sample(fmt);
+    SwrContext *swr = swr_alloc();
+    uint8_t *in_ptr[CHANNELS], *out_ptr[CHANNELS];
+    int done = 0, pos, ch, ret;
+
+    if (!swr)
+        return AVERROR(ENOMEM);
+    av_opt_set_int(swr, "ich",     CHANNELS,   0);
+    av_opt_set_int(swr, "och",     CHANNELS,   0);
+    av_opt_set_int(swr, "isr",     IN_RATE,    0);
+    av_opt_set_int(swr, "osr",     OUT_RATE,   0);
+    av_opt_set_sample_fmt(swr, "isf", fmt,     0);
+    av_opt_set_sample_fmt(swr, "osf", fmt,     0);
+    av_opt_set_sample_fmt(swr, "tsf", fmt,     0);
+    av_opt_set_int(swr, "threads", nb_threads, 0);
+    ret = swr_init(swr);
+    if (ret < 0)
+        goto end;
+
+    for (pos = 0; pos < in_samples; pos += CHUNK) {
+        const int n = FFMIN(CHUNK, in_samples - pos);
+
+        for (ch = 0; ch < CHANNELS; ch++) {
+            in_ptr[ch]  = in[ch]  + pos  * bps;
+            out_ptr[ch] = out[ch] + done * bps;
+        }
+        ret = swr_convert(swr, out_ptr, out_size - done, (const uint8_t **)in_ptr, n);
+        if (ret < 0)
+            goto end;
+        done += ret;
+    }
+
+    for (ch = 0; ch < CHANNELS; ch++)
+        out_ptr[ch] = out[ch] + done * bps;
+    ret = swr_convert(swr, out_ptr, out_size - done, NULL, 0);
+    if (ret < 0)
+        goto end;
+    done += ret;
+    ret = done;
+end:
+    swr_free(&swr);
+    return ret;
+}
+
+static int run_test(enum AVSampleFormat fmt, int in_samples)
+{
+    const int out_size = av_rescale_rnd(in_samples, OUT_RATE, IN_RATE, AV_ROUND_UP) + 256;
+    const int bps = av_get_bytes_per_sample(fmt);
+    uint8_t **in = NULL, **ref = NULL, **out = NULL;
+    int ref_samples = 0, i, ch, ret;
+
+    ret = av_samples_alloc_array_and_samples(&in, NULL, CHANNELS, in_samples, fmt, 0);
+    if (ret < 0)
+        goto end;
+    ret = av_samples_alloc_array_and_samples(&ref, NULL, CHANNELS, out_size, fmt, 0);
+    if (ret < 0)
+        goto end;
+    ret = av_samples_alloc_array_and_samples(&out, NULL, CHANNELS, out_size, fmt, 0);
+    if (ret < 0)
+        goto end;
+    fill_input(in, fmt, in_samples);
+
+    for (i = 0; i < FF_ARRAY_ELEMS(threads); i++) {
+        uint8_t **dst = i ? out : ref;
+        int64_t t = av_gettime_relative();
+
+        ret = convert(fmt, threads[i], in, in_samples, dst, out_size);
+        if (ret < 0)
+            goto end;
+        t = av_gettime_relative() - t;
+
+        printf("%s %d threads: %.2f ms per second of audio\n",
+               av_get_sample_fmt_name(fmt), threads[i],
+               t / 1000.0 * IN_RATE / in_samples);
+
+        if (!i) {
+            ref_samples = ret;
+            continue;
+        }
+        if (ret != ref_samples) {
+            fprintf(stderr, "%s %d threads: %d samples, expected %d\n",
+                    av_get_sample_fmt_name(fmt), threads[i], ret, ref_samples);
+            ret = AVERROR_BUG;
+            goto end;
+        }
+        for (ch = 0; ch < CHANNELS; ch++) {
+            if (memcmp(ref[ch], out[ch], ref_samples * bps)) {
+                fprintf(stderr, "%s %d threads: channel %d differs from 1 thread\n",
+                        av_get_sample_fmt_name(fmt), threads[i], ch);
+                ret = AVERROR_BUG;
+                goto end;
+            }
+        }
+    }
+    ret = 0;
+
+end:
+    if (in)
+        av_freep(&in[0]);
+    av_freep(&in);
+    if (ref)
+        av_freep(&ref[0]);
+    av_freep(&ref);
+    if (out)
+        av_freep(&out[0]);
+    av_freep(&out);
+    return ret;
+}
+
+int main(int argc, char **argv)
+{
+    const double seconds = argc > 1 ? atof(argv[1]) : 1.0;
+    const int in_samples = FFMAX(1, seconds * IN_RATE);
+    int i, ret, err = 0;
+
+    for (i = 0; i < FF_ARRAY_ELEMS(formats); i++) {
+        ret = run_test(formats[i], in_samples);
+        if (ret < 0) {
+            fprintf(stderr, "%s failed: %s\n",
+                    av_get_sample_fmt_name(formats[i]), av_err2str(ret));
+            err = 1;
+        }
+    }
+
+    return err;
+}
@@ -201,8 +201,12 @@ cglobal resample_common_%1, 1, 7, 2, ctx, phase_count, dst, frac, \
     movd                      [dstq], m0
 %else ; float/double
     ; horizontal sum & store
-%if mmsize == 32
-    vextractf128                 xm1, m0, 0x1
+%if mmsize == 64
+    vextractf64x4                ym1, m0, 0x1
+    addp%4                       ym0, ym1
+%endif
+%if mmsize >= 32
+    vextractf128                 xm1, ym0, 0x1
     addp%4                       xm0, xm1
 %endif
     movhlps                      xm1, xm0
@@ -486,9 +490,15 @@ cglobal resample_linear_%1, 1, 7, 5, ctx, min_filter_length_x4, filter2, \
     ; - unix64: eax=r6[filter1], edx=r2[todo]
 %else ; float/double
     ; val += (v2 - val) * (FELEML) frac / c->src_incr;
-%if mmsize == 32
-    vextractf128                 xm1, m0, 0x1
-    vextractf128                 xm3, m2, 0x1
+%if mmsize == 64
+    vextractf64x4                ym1, m0, 0x1
+    vextractf64x4                ym3, m2, 0x1
+    addp%4                       ym0, ym1
+    addp%4                       ym2, ym3
+%endif
+%if mmsize >= 32
+    vextractf128                 xm1, ym0, 0x1
+    vextractf128                 xm3, ym2, 0x1
     addp%4                       xm0, xm1
     addp%4                       xm2, xm3
 %endif
@@ -593,6 +603,10 @@ RESAMPLE_FNS float, 4, 2, s, pf_1
 INIT_XMM fma4
 RESAMPLE_FNS float, 4, 2, s, pf_1
 %endif
+%if HAVE_AVX512_EXTERNAL
+INIT_ZMM avx512
+RESAMPLE_FNS float, 4, 2, s, pf_1
+%endif
 
 %if ARCH_X86_32
 INIT_MMX mmxext
@@ -617,3 +631,7 @@ RESAMPLE_FNS double, 8, 3, d, pdbl_1
 INIT_YMM fma3
 RESAMPLE_FNS double, 8, 3, d, pdbl_1
 %endif
+%if HAVE_AVX512_EXTERNAL
+INIT_ZMM avx512
+RESAMPLE_FNS double, 8, 3, d, pdbl_1
+%endif
@@ -41,60 +41,87 @@ RESAMPLE_FUNCS(float,  sse);
 RESAMPLE_FUNCS(float,  avx);
 RESAMPLE_FUNCS(float,  fma3);
 RESAMPLE_FUNCS(float,  fma4);
+RESAMPLE_FUNCS(float,  avx512);
 RESAMPLE_FUNCS(double, sse2);
 RESAMPLE_FUNCS(double, avx);
 RESAMPLE_FUNCS(double, fma3);
+RESAMPLE_FUNCS(double, avx512);
 
 av_cold void swri_resample_dsp_x86_init(ResampleContext *c)
 {
     int av_unused mm_flags = av_get_cpu_flags();
+    int mmsize = 0;
 
     switch(c->format){
     case AV_SAMPLE_FMT_S16P:
         if (ARCH_X86_32 && EXTERNAL_MMXEXT(mm_flags)) {
             c->dsp.resample_linear = ff_resample_linear_int16_mmxext;
             c->dsp.resample_common = ff_resample_common_int16_mmxext;
+            mmsize = 8;
         }
         if (EXTERNAL_SSE2(mm_flags)) {
             c->dsp.resample_linear = ff_resample_linear_int16_sse2;
             c->dsp.resample_common = ff_resample_common_int16_sse2;
+            mmsize = 16;
         }
         if (EXTERNAL_XOP(mm_flags)) {
             c->dsp.resample_linear = ff_resample_linear_int16_xop;
             c->dsp.resample_common = ff_resample_common_int16_xop;
+            mmsize = 16;
         }
         break;
     case AV_SAMPLE_FMT_FLTP:
         if (EXTERNAL_SSE(mm_flags)) {
             c->dsp.resample_linear = ff_resample_linear_float_sse;
             c->dsp.resample_common = ff_resample_common_float_sse;
+            mmsize = 16;
         }
         if (EXTERNAL_AVX_FAST(mm_flags)) {
             c->dsp.resample_linear = ff_resample_linear_float_avx;
             c->dsp.resample_common = ff_resample_common_float_avx;
+            mmsize = 32;
         }
         if (EXTERNAL_FMA3_FAST(mm_flags)) {
             c->dsp.resample_linear = ff_resample_linear_float_fma3;
             c->dsp.resample_common = ff_resample_common_float_fma3;
+            mmsize = 32;
         }
         if (EXTERNAL_FMA4(mm_flags)) {
             c->dsp.resample_linear = ff_resample_linear_float_fma4;
             c->dsp.resample_common = ff_resample_common_float_fma4;
+            mmsize = 32;
+        }
+        if (EXTERNAL_AVX512(mm_flags)) {
+            c->dsp.resample_linear = ff_resample_linear_float_avx512;
+            c->dsp.resample_common = ff_resample_common_float_avx512;
+            mmsize = 64;
         }
         break;
     case AV_SAMPLE_FMT_DBLP:
         if (EXTERNAL_SSE2(mm_flags)) {
             c->dsp.resample_linear = ff_resample_linear_double_sse2;
             c->dsp.resample_common = ff_resample_common_double_sse2;
+            mmsize = 16;
         }
         if (EXTERNAL_AVX_FAST(mm_flags)) {
             c->dsp.resample_linear = ff_resample_linear_double_avx;
             c->dsp.resample_common = ff_resample_common_double_avx;
+            mmsize = 32;
         }
         if (EXTERNAL_FMA3_FAST(mm_flags)) {
             c->dsp.resample_linear = ff_resample_linear_double_fma3;
             c->dsp.resample_common = ff_resample_common_double_fma3;
+            mmsize = 32;
+        }
+        if (EXTERNAL_AVX512(mm_flags)) {
+            c->dsp.resample_linear = ff_resample_linear_double_avx512;
+            c->dsp.resample_common = ff_resample_common_double_avx512;
+            mmsize = 64;
         }
         break;
     }
+
+    /* the asm loops step through the filter in whole registers */
+    if (mmsize)
+        c->input_padding = mmsize / c->felem_size - 1;
 }
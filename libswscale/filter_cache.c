@@ -0,0 +1,189 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @file
+ * Process wide cache of the filter coefficients computed by initFilter(),
+ * shared by all scaling contexts.
+ *
+ * The tables only depend on the parameters in SwsFilterParams, so contexts
+ * created with a geometry seen before copy them instead of recomputing them.
+ * Entries are immutable once added; the least recently used ones are
+ * evicted when the cache exceeds its entry count or size limits, and all of
+ * them are freed by sws_filter_cache_flush().
+ */
+
+#include <string.h>
+
+#include "libavutil/mem.h"
+#include "libavutil/thread.h"
+
+#include "swscale.h"
+#include "swscale_internal.h"
+
+#define CACHE_ENTRIES 128
+#define CACHE_MAX_SIZE (32 << 20)
+
+typedef struct FilterCacheEntry {
+    SwsFilterParams params;
+    uint32_t hash;
+    int16_t *filter;
+    int32_t *filter_pos;
+    int filter_size;
+    size_t size;            ///< size of filter and filter_pos in bytes
+    uint64_t last_used;
+} FilterCacheEntry;
+
+static AVMutex cache_mutex = AV_MUTEX_INITIALIZER;
+static FilterCacheEntry cache[CACHE_ENTRIES];
+static size_t cache_size;
+static uint64_t cache_clock;
+static int64_t cache_hits, cache_misses, cache_init_time;
+
+static uint32_t params_hash(const SwsFilterParams *p)
+{
+    const uint8_t *b = (const uint8_t *)p;
+    uint32_t h = 2166136261U;
+    int i;
+
+    for (i = 0; i < sizeof(*p); i++)
+        h = (h ^ b[i]) * 16777619U;
+    return h;
+}
+
+static void entry_free(FilterCacheEntry *e)
+{
+    av_freep(&e->filter);
+    av_freep(&e->filter_pos);
+    cache_size -= e->size;
+    e->size = 0;
+}
+
+/* sizes of the tables allocated by initFilter() */
+static size_t filter_bytes(const SwsFilterParams *p, int filter_size)
+{
+    return (size_t)(p->dstW + 15) * filter_size * sizeof(int16_t);
+}
+
+static size_t filter_pos_bytes(const SwsFilterParams *p)
+{
+    return (size_t)(p->dstW + 15) * sizeof(int32_t);
+}
+
+int ff_sws_filter_cache_get(const SwsFilterParams *p, int16_t **filter,
+                            int32_t **filter_pos, int *filter_size)
+{
+    const uint32_t hash = params_hash(p);
+    int i, ret = 0;
+
+    ff_mutex_lock(&cache_mutex);
+    for (i = 0; i < CACHE_ENTRIES; i++) {
+        FilterCacheEntry *e = &cache[i];
+
+        if (!e->filter || e->hash != hash || memcmp(&e->params, p, sizeof(*p)))
+            continue;
+
+        *filter     = av_memdup(e->filter,     filter_bytes(p, e->filter_size));
+        *filter_pos = av_memdup(e->filter_pos, filter_pos_bytes(p));
+        if (!*filter || !*filter_pos) {
+            av_freep(filter);
+            av_freep(filter_pos);
+            ret = AVERROR(ENOMEM);
+            break;
+        }
+        *filter_size = e->filter_size;
+        e->last_used = ++cache_clock;
+        cache_hits++;
+        ret = 1;
+        break;
+    }
+    ff_mutex_unlock(&cache_mutex);
+    return ret;
+}
+
+void ff_sws_filter_cache_add(const SwsFilterParams *p, const int16_t *filter,
+                             const int32_t *filter_pos, int filter_size,
+                             int64_t init_time)
+{
+    const size_t size = filter_bytes(p, filter_size) + filter_pos_bytes(p);
+    FilterCacheEntry *e;
+    int i;
+
+    ff_mutex_lock(&cache_mutex);
+    cache_misses++;
+    cache_init_time += init_time;
+    if (size > CACHE_MAX_SIZE / 4)
+        goto end;
+
+    /* evict the least recently used entries until there is a free slot
+     * and the new entry fits */
+    for (;;) {
+        FilterCacheEntry *free_slot = NULL, *lru = NULL;
+
+        for (i = 0; i < CACHE_ENTRIES; i++) {
+            if (!cache[i].filter)
+                free_slot = &cache[i];
+            else if (!lru || cache[i].last_used < lru->last_used)
+                lru = &cache[i];
+        }
+        if (free_slot && cache_size + size <= CACHE_MAX_SIZE) {
+            e = free_slot;
+            break;
+        }
+        entry_free(lru);
+    }
+
+    e->filter     = av_memdup(filter,     filter_bytes(p, filter_size));
+    e->filter_pos = av_memdup(filter_pos, filter_pos_bytes(p));
+    if (!e->filter || !e->filter_pos) {
+        av_freep(&e->filter);
+        av_freep(&e->filter_pos);
+        goto end;
+    }
+    e->params      = *p;
+    e->hash        = params_hash(p);
+    e->filter_size = filter_size;
+    e->size        = size;
+    e->last_used   = ++cache_clock;
+    cache_size    += size;
+
+end:
+    ff_mutex_unlock(&cache_mutex);
+}
+
+void sws_filter_cache_flush(void)
+{
+    int i;
+
+    ff_mutex_lock(&cache_mutex);
+    for (i = 0; i < CACHE_ENTRIES; i++)
+        entry_free(&cache[i]);
+    ff_mutex_unlock(&cache_mutex);
+}
+
+void sws_filter_cache_stats(int64_t *hits, int64_t *misses, int64_t *init_time)
+{
+    ff_mutex_lock(&cache_mutex);
+    if (hits)
+        *hits      = cache_hits;
+    if (misses)
+        *misses    = cache_misses;
+    if (init_time)
+        *init_time = cache_init_time;
+    ff_mutex_unlock(&cache_mutex);
+}
@@ -81,6 +81,40 @@ static const AVOption swscale_options[] = {
     { "uniform_color",   "blend onto a uniform color",    0,                 AV_OPT_TYPE_CONST,  { .i64  = SWS_ALPHA_BLEND_UNIFORM},INT_MIN, INT_MAX,     VE, "alphablend" },
     { "checkerboard",    "blend onto a checkerboard",     0,                 AV_OPT_TYPE_CONST,  { .i64  = SWS_ALPHA_BLEND_CHECKERBOARD},INT_MIN, INT_MAX,     VE, "alphablend" },
 
+    { "src_transfer",    "source transfer characteristics",      OFFSET(src_trc),  AV_OPT_TYPE_INT, { .i64 = AVCOL_TRC_UNSPECIFIED }, 0, AVCOL_TRC_NB - 1, VE, "transfer" },
+    { "dst_transfer",    "destination transfer characteristics", OFFSET(dst_trc),  AV_OPT_TYPE_INT, { .i64 = AVCOL_TRC_UNSPECIFIED }, 0, AVCOL_TRC_NB - 1, VE, "transfer" },
+    { "unknown",         "unspecified",                   0,                 AV_OPT_TYPE_CONST,  { .i64  = AVCOL_TRC_UNSPECIFIED  }, INT_MIN, INT_MAX,        VE, "transfer" },
+    { "bt709",           "BT.709",                        0,                 AV_OPT_TYPE_CONST,  { .i64  = AVCOL_TRC_BT709        }, INT_MIN, INT_MAX,        VE, "transfer" },
+    { "gamma22",         "gamma 2.2",                     0,                 AV_OPT_TYPE_CONST,  { .i64  = AVCOL_TRC_GAMMA22      }, INT_MIN, INT_MAX,        VE, "transfer" },
+    { "gamma28",         "gamma 2.8",                     0,                 AV_OPT_TYPE_CONST,  { .i64  = AVCOL_TRC_GAMMA28      }, INT_MIN, INT_MAX,        VE, "transfer" },
+    { "smpte170m",       "SMPTE 170M",                    0,                 AV_OPT_TYPE_CONST,  { .i64  = AVCOL_TRC_SMPTE170M    }, INT_MIN, INT_MAX,        VE, "transfer" },
+    { "smpte240m",       "SMPTE 240M",                    0,                 AV_OPT_TYPE_CONST,  { .i64  = AVCOL_TRC_SMPTE240M    }, INT_MIN, INT_MAX,        VE, "transfer" },
+    { "linear",          "linear",                        0,                 AV_OPT_TYPE_CONST,  { .i64  = AVCOL_TRC_LINEAR       }, INT_MIN, INT_MAX,        VE, "transfer" },
+    { "iec61966-2-1",    "IEC 61966-2-1 (sRGB)",          0,                 AV_OPT_TYPE_CONST,  { .i64  = AVCOL_TRC_IEC61966_2_1 }, INT_MIN, INT_MAX,        VE, "transfer" },
+    { "bt2020-10",       "BT.2020 10 bit",                0,                 AV_OPT_TYPE_CONST,  { .i64  = AVCOL_TRC_BT2020_10    }, INT_MIN, INT_MAX,        VE, "transfer" },
+    { "bt2020-12",       "BT.2020 12 bit",                0,                 AV_OPT_TYPE_CONST,  { .i64  = AVCOL_TRC_BT2020_12    }, INT_MIN, INT_MAX,        VE, "transfer" },
+    { "smpte2084",       "SMPTE ST 2084 (PQ)",            0,                 AV_OPT_TYPE_CONST,  { .i64  = AVCOL_TRC_SMPTE2084    }, INT_MIN, INT_MAX,        VE, "transfer" },
+    { "arib-std-b67",    "ARIB STD-B67 (HLG)",            0,                 AV_OPT_TYPE_CONST,  { .i64  = AVCOL_TRC_ARIB_STD_B67 }, INT_MIN, INT_MAX,        VE, "transfer" },
+
+    { "src_primaries",   "source color primaries",        OFFSET(src_prim),  AV_OPT_TYPE_INT, { .i64 = AVCOL_PRI_UNSPECIFIED }, 0, AVCOL_PRI_NB - 1, VE, "primaries" },
+    { "dst_primaries",   "destination color primaries",   OFFSET(dst_prim),  AV_OPT_TYPE_INT, { .i64 = AVCOL_PRI_UNSPECIFIED }, 0, AVCOL_PRI_NB - 1, VE, "primaries" },
+    { "unknown",         "unspecified",                   0,                 AV_OPT_TYPE_CONST,  { .i64  = AVCOL_PRI_UNSPECIFIED  }, INT_MIN, INT_MAX,        VE, "primaries" },
+    { "bt709",           "BT.709",                        0,                 AV_OPT_TYPE_CONST,  { .i64  = AVCOL_PRI_BT709        }, INT_MIN, INT_MAX,        VE, "primaries" },
+    { "bt470m",          "BT.470 M",                      0,                 AV_OPT_TYPE_CONST,  { .i64  = AVCOL_PRI_BT470M       }, INT_MIN, INT_MAX,        VE, "primaries" },
+    { "bt470bg",         "BT.470 BG",                     0,                 AV_OPT_TYPE_CONST,  { .i64  = AVCOL_PRI_BT470BG      }, INT_MIN, INT_MAX,        VE, "primaries" },
+    { "smpte170m",       "SMPTE 170M",                    0,                 AV_OPT_TYPE_CONST,  { .i64  = AVCOL_PRI_SMPTE170M    }, INT_MIN, INT_MAX,        VE, "primaries" },
+    { "smpte240m",       "SMPTE 240M",                    0,                 AV_OPT_TYPE_CONST,  { .i64  = AVCOL_PRI_SMPTE240M    }, INT_MIN, INT_MAX,        VE, "primaries" },
+    { "film",            "film",                          0,                 AV_OPT_TYPE_CONST,  { .i64  = AVCOL_PRI_FILM         }, INT_MIN, INT_MAX,        VE, "primaries" },
+    { "bt2020",          "BT.2020",                       0,                 AV_OPT_TYPE_CONST,  { .i64  = AVCOL_PRI_BT2020       }, INT_MIN, INT_MAX,        VE, "primaries" },
+    { "smpte431",        "SMPTE 431 (DCI-P3)",            0,                 AV_OPT_TYPE_CONST,  { .i64  = AVCOL_PRI_SMPTE431     }, INT_MIN, INT_MAX,        VE, "primaries" },
+    { "smpte432",        "SMPTE 432 (Display P3)",        0,                 AV_OPT_TYPE_CONST,  { .i64  = AVCOL_PRI_SMPTE432     }, INT_MIN, INT_MAX,        VE, "primaries" },
+    { "ebu3213",         "EBU Tech. 3213",                0,                 AV_OPT_TYPE_CONST,  { .i64  = AVCOL_PRI_EBU3213      }, INT_MIN, INT_MAX,        VE, "primaries" },
+
+    { "threads",         "number of threads",             OFFSET(nb_threads),AV_OPT_TYPE_INT,    { .i64  = 1                  }, 0,       INT_MAX,        VE, "threads" },
+    { "auto",            "automatic selection",           0,                 AV_OPT_TYPE_CONST,  { .i64  = 0                  }, INT_MIN, INT_MAX,        VE, "threads" },
+    { "slice_invariant", "make the output independent of slicing and threads", OFFSET(slice_invariant), AV_OPT_TYPE_BOOL, { .i64 = 0 }, 0, 1, VE },
+    { "filter_cache",    "share filter coefficients with other contexts", OFFSET(filter_cache), AV_OPT_TYPE_BOOL, { .i64 = 1 }, 0, 1, VE },
+
     { NULL }
 };
 
@@ -142,6 +142,29 @@ extern void (*deinterleaveBytes)(const uint8_t *src, uint8_t *dst1, uint8_t *dst
                                  int width, int height, int srcStride,
                                  int dst1Stride, int dst2Stride);
 
+/**
+ * Interleave two planes of native endian 16-bit samples, shifting each
+ * sample left by shift bits, e.g. for P010 chroma.
+ */
+extern void (*interleaveWords)(const uint8_t *src1, const uint8_t *src2, uint8_t *dst,
+                               int width, int height, int src1Stride,
+                               int src2Stride, int dstStride, int shift);
+
+/**
+ * Split a plane of interleaved native endian 16-bit samples in two,
+ * shifting each sample right by shift bits.
+ */
+extern void (*deinterleaveWords)(const uint8_t *src, uint8_t *dst1, uint8_t *dst2,
+                                 int width, int height, int srcStride,
+                                 int dst1Stride, int dst2Stride, int shift);
+
+/**
+ * Copy a plane of native endian 16-bit samples, shifting them left by shift
+ * bits, or right by -shift bits if shift is negative.
+ */
+extern void (*shiftWords)(const uint8_t *src, uint8_t *dst, int width, int height,
+                          int srcStride, int dstStride, int shift);
+
 extern void (*vu9_to_vu12)(const uint8_t *src1, const uint8_t *src2,
                            uint8_t *dst1, uint8_t *dst2,
                            int width, int height,
@@ -228,6 +228,23 @@ static void lumRangeFromJpeg16_c(int16_t *_dst, int width)
         dst[i] = (dst[i]*(14071/4) + (33561947<<4)/4)>>12;
 }
 
+/**
+ * Fill the error diffusion state with noise derived from the destination
+ * line only, so that the line does not depend on the ones scaled before it.
+ */
+static void seed_dither_error(SwsContext *c, int dstY)
+{
+    int i, j;
+
+    for (i = 0; i < 3; i++) {
+        uint32_t state = (uint32_t)(3 * dstY + i) * 0x9E3779B1U;
+
+        for (j = 0; j < c->dstW + 2; j++) {
+            state = state * 1664525U + 1013904223U;
+            c->dither_error[i][j] = (int)(state >> 27) - 16;
+        }
+    }
+}
 
 #define DEBUG_SWSCALE_BUFFERS 0
 #define DEBUG_BUFFERS(...)                      \
@@ -262,6 +279,7 @@ static int swscale(SwsContext *c, const uint8_t *src[],
     const int chrSrcSliceH           = AV_CEIL_RSHIFT(srcSliceH,   c->chrSrcVSubSample);
     int should_dither                = isNBPS(c->srcFormat) ||
                                        is16BPS(c->srcFormat);
+    const int dstEnd                 = c->dst_slice_end ? c->dst_slice_end : dstH;
     int lastDstY;
 
     /* vars which will change and which we need to store back in the context */
@@ -334,7 +352,7 @@ static int swscale(SwsContext *c, const uint8_t *src[],
      * will not get executed. This is not really intended but works
      * currently, so people might do it. */
     if (srcSliceY == 0) {
-        dstY         = 0;
+        dstY         = c->dst_slice_start;
         lastInLumBuf = -1;
         lastInChrBuf = -1;
     }
@@ -366,7 +384,7 @@ static int swscale(SwsContext *c, const uint8_t *src[],
         hout_slice->width = dstW;
     }
 
-    for (; dstY < dstH; dstY++) {
+    for (; dstY < dstEnd; dstY++) {
         const int chrDstY = dstY >> c->chrDstVSubSample;
         int use_mmx_vfilter= c->use_mmx_vfilter;
 
@@ -486,6 +504,9 @@ static int swscale(SwsContext *c, const uint8_t *src[],
                            yuv2packed1, yuv2packed2, yuv2packedX, yuv2anyX, use_mmx_vfilter);
         }
 
+        if (c->slice_invariant && c->dither == SWS_DITHER_ED)
+            seed_dither_error(c, dstY);
+
         {
             for (i = vStart; i < vEnd; ++i)
                 desc[i].process(c, &desc[i], dstY, 1);
@@ -737,6 +758,99 @@ static void rgb48Toxyz12(struct SwsContext *c, uint16_t *dst,
     }
 }
 
+static int scale_internal(SwsContext *c,
+                          const uint8_t * const srcSlice[], const int srcStride[],
+                          int srcSliceY, int srcSliceH,
+                          uint8_t *const dst[], const int dstStride[]);
+
+/**
+ * Scale the destination lines [dst_start, dst_end) out of the first src_h
+ * lines of a complete source picture.
+ */
+static int scale_band(SwsContext *c, const uint8_t *const src[],
+                      const int srcStride[], int src_h,
+                      uint8_t *const dst[], const int dstStride[],
+                      int dst_start, int dst_end)
+{
+    int i, ret;
+
+    if (dst_start == 0 && dst_end == c->dstH && src_h == c->srcH)
+        return scale_internal(c, src, srcStride, 0, c->srcH, dst, dstStride);
+
+    if (c->swscale == swscale) {
+        /* swscale() picks the lines the vertical filter needs for this band */
+        c->dst_slice_start = dst_start;
+        c->dst_slice_end   = dst_end;
+        ret = scale_internal(c, src, srcStride, 0, src_h, dst, dstStride);
+        c->dst_slice_start = 0;
+        c->dst_slice_end   = 0;
+    } else {
+        /* unscaled converters map source lines 1:1 to destination lines */
+        const int nb_planes = av_pix_fmt_count_planes(c->srcFormat);
+        const uint8_t *src2[4];
+
+        for (i = 0; i < 4; i++) {
+            const int vshift = (i == 1 || i == 2) ? c->chrSrcVSubSample : 0;
+
+            src2[i] = src[i];
+            if (i < nb_planes)
+                src2[i] += (dst_start >> vshift) * (ptrdiff_t)srcStride[i];
+        }
+        c->sliceDir = 1;
+        ret = scale_internal(c, src2, srcStride, dst_start, dst_end - dst_start,
+                             dst, dstStride);
+    }
+    /* the band may have stopped short of the end of the frame */
+    c->sliceDir = 0;
+    return ret;
+}
+
+void ff_sws_slice_worker(void *priv, int jobnr, int threadnr,
+                         int nb_jobs, int nb_threads)
+{
+    SwsContext *parent = priv;
+    SwsContext *c      = parent->slice_ctx[threadnr];
+    const int band_h   = parent->job.dst_end - parent->job.dst_start;
+    const int slice_h  = FFALIGN((band_h + nb_jobs - 1) / nb_jobs,
+                                 parent->dst_slice_align);
+    const int start    = parent->job.dst_start + FFMIN(jobnr * slice_h, band_h);
+    const int end      = FFMIN(start + slice_h, parent->job.dst_end);
+    int ret = 0;
+
+    if (start < end)
+        ret = scale_band(c, parent->job.src, parent->job.srcStride,
+                         parent->job.src_h, parent->job.dst,
+                         parent->job.dstStride, start, end);
+    parent->slice_ret[jobnr] = ret;
+}
+
+static int scale_threaded(SwsContext *c, const uint8_t *const src[],
+                          const int srcStride[], int src_h,
+                          uint8_t *const dst[], const int dstStride[],
+                          int dst_start, int dst_end)
+{
+    const int nb_jobs = FFMIN(c->nb_slice_ctx,
+                              (dst_end - dst_start + c->dst_slice_align - 1) /
+                              c->dst_slice_align);
+    int i, ret = 0;
+
+    c->job.src       = src;
+    c->job.srcStride = srcStride;
+    c->job.src_h     = src_h;
+    c->job.dst       = dst;
+    c->job.dstStride = dstStride;
+    c->job.dst_start = dst_start;
+    c->job.dst_end   = dst_end;
+    avpriv_slicethread_execute(c->slicethread, nb_jobs, 0);
+
+    for (i = 0; i < nb_jobs; i++) {
+        if (c->slice_ret[i] < 0)
+            return c->slice_ret[i];
+        ret += c->slice_ret[i];
+    }
+    return ret;
+}
+
 /**
  * swscale wrapper, so we don't need to export the SwsContext.
  * Assumes planar YUV to be in YUV order instead of YVU.
@@ -747,26 +861,13 @@ int attribute_align_arg sws_scale(struct SwsContext *c,
                                   int srcSliceH, uint8_t *const dst[],
                                   const int dstStride[])
 {
-    int i, ret;
-    const uint8_t *src2[4];
-    uint8_t *dst2[4];
-    uint8_t *rgb0_tmp = NULL;
     int macro_height = isBayer(c->srcFormat) ? 2 : (1 << c->chrSrcVSubSample);
-    // copy strides, so they can safely be modified
-    int srcStride2[4];
-    int dstStride2[4];
-    int srcSliceY_internal = srcSliceY;
 
     if (!srcStride || !dstStride || !dst || !srcSlice) {
         av_log(c, AV_LOG_ERROR, "One of the input parameters to sws_scale() is NULL, please check the calling code\n");
         return 0;
     }
 
-    for (i=0; i<4; i++) {
-        srcStride2[i] = srcStride[i];
-        dstStride2[i] = dstStride[i];
-    }
-
     if ((srcSliceY & (macro_height-1)) ||
         ((srcSliceH& (macro_height-1)) && srcSliceY + srcSliceH != c->srcH) ||
         srcSliceY + srcSliceH > c->srcH) {
@@ -774,6 +875,35 @@ int attribute_align_arg sws_scale(struct SwsContext *c,
         return AVERROR(EINVAL);
     }
 
+    /* a colorspace change may have set up cascaded contexts since init */
+    if (c->slicethread && !c->cascaded_context[0] &&
+        srcSliceY == 0 && srcSliceH == c->srcH)
+        return scale_threaded(c, srcSlice, srcStride, c->srcH,
+                              dst, dstStride, 0, c->dstH);
+
+    return scale_internal(c, srcSlice, srcStride, srcSliceY, srcSliceH,
+                          dst, dstStride);
+}
+
+static int scale_internal(SwsContext *c,
+                          const uint8_t * const srcSlice[], const int srcStride[],
+                          int srcSliceY, int srcSliceH,
+                          uint8_t *const dst[], const int dstStride[])
+{
+    int i, ret;
+    const uint8_t *src2[4];
+    uint8_t *dst2[4];
+    uint8_t *rgb0_tmp = NULL;
+    // copy strides, so they can safely be modified
+    int srcStride2[4];
+    int dstStride2[4];
+    int srcSliceY_internal = srcSliceY;
+
+    for (i=0; i<4; i++) {
+        srcStride2[i] = srcStride[i];
+        dstStride2[i] = dstStride[i];
+    }
+
     if (c->gamma_flag && c->cascaded_context[0]) {
         ret = sws_scale(c->cascaded_context[0],
                     srcSlice, srcStride, srcSliceY, srcSliceH,
@@ -804,6 +934,11 @@ int attribute_align_arg sws_scale(struct SwsContext *c,
                         c->cascaded_tmp, c->cascaded_tmpStride);
         if (ret < 0)
             return ret;
+        if (c->transfer_lin)
+            ff_sws_transfer_convert(c, c->cascaded_tmp[0], c->cascaded_tmpStride[0],
+                                    c->cascaded_context[0]->dstW,
+                                    c->cascaded_context[0]->dstH,
+                                    isALPHA(c->cascaded_context[0]->dstFormat) ? 4 : 3);
         ret = sws_scale(c->cascaded_context[1],
                         (const uint8_t * const * )c->cascaded_tmp, c->cascaded_tmpStride, 0, c->cascaded_context[0]->dstH,
                         dst, dstStride);
@@ -982,3 +1117,241 @@ int attribute_align_arg sws_scale(struct SwsContext *c,
     av_free(rgb0_tmp);
     return ret;
 }
+
+static int frame_alloc_pooled(SwsContext *c, AVFrame *dst)
+{
+    uint8_t *data[4];
+    int linesize[4];
+    int i, size, ret;
+
+    if (dst->format == AV_PIX_FMT_NONE) {
+        dst->format = c->dstFormat;
+    } else if (ff_sws_context_format(dst->format) != c->dstFormat) {
+        av_log(c, AV_LOG_ERROR, "Destination frame format is %s, the context expects %s\n",
+               av_get_pix_fmt_name(dst->format), av_get_pix_fmt_name(c->dstFormat));
+        return AVERROR(EINVAL);
+    }
+    dst->width  = c->dstW;
+    dst->height = c->dstH;
+
+    ret = av_image_fill_linesizes(linesize, dst->format, dst->width);
+    if (ret < 0)
+        return ret;
+    for (i = 0; i < 4; i++)
+        linesize[i] = FFALIGN(linesize[i], 32);
+
+    size = av_image_fill_pointers(data, dst->format, dst->height, NULL, linesize);
+    if (size < 0)
+        return size;
+
+    if (!c->frame_pool) {
+        /* the SIMD output functions may write past the last pixel */
+        c->frame_pool = av_buffer_pool_init(size + 64, av_buffer_alloc);
+        if (!c->frame_pool)
+            return AVERROR(ENOMEM);
+    }
+
+    dst->buf[0] = av_buffer_pool_get(c->frame_pool);
+    if (!dst->buf[0])
+        return AVERROR(ENOMEM);
+
+    av_image_fill_pointers(dst->data, dst->format, dst->height,
+                           dst->buf[0]->data, linesize);
+    for (i = 0; i < 4; i++)
+        dst->linesize[i] = linesize[i];
+    dst->extended_data = dst->data;
+    return 0;
+}
+
+int sws_frame_start(struct SwsContext *c, AVFrame *dst, const AVFrame *src)
+{
+    int ret, allocated = 0;
+
+    if (!c->frame_src) {
+        c->frame_src = av_frame_alloc();
+        c->frame_dst = av_frame_alloc();
+        if (!c->frame_src || !c->frame_dst)
+            return AVERROR(ENOMEM);
+    }
+    if (c->frame_src->buf[0] || c->frame_dst->buf[0]) {
+        av_log(c, AV_LOG_ERROR, "sws_frame_start() called without sws_frame_end()\n");
+        return AVERROR(EINVAL);
+    }
+    if (src->width != c->srcW || src->height != c->srcH) {
+        av_log(c, AV_LOG_ERROR, "Source frame is %dx%d, the context expects %dx%d\n",
+               src->width, src->height, c->srcW, c->srcH);
+        return AVERROR(EINVAL);
+    }
+    if (ff_sws_context_format(src->format) != c->srcFormat) {
+        av_log(c, AV_LOG_ERROR, "Source frame format is %s, the context expects %s\n",
+               av_get_pix_fmt_name(src->format), av_get_pix_fmt_name(c->srcFormat));
+        return AVERROR(EINVAL);
+    }
+
+    ret = av_frame_ref(c->frame_src, src);
+    if (ret < 0)
+        return ret;
+
+    if (!dst->buf[0]) {
+        if (dst->data[0]) {
+            av_log(c, AV_LOG_ERROR, "The destination frame data is not refcounted\n");
+            ret = AVERROR(EINVAL);
+            goto fail;
+        }
+        ret = frame_alloc_pooled(c, dst);
+        if (ret < 0)
+            goto fail;
+        allocated = 1;
+    } else if (dst->width != c->dstW || dst->height != c->dstH) {
+        av_log(c, AV_LOG_ERROR, "Destination frame is %dx%d, the context expects %dx%d\n",
+               dst->width, dst->height, c->dstW, c->dstH);
+        ret = AVERROR(EINVAL);
+        goto fail;
+    } else if (ff_sws_context_format(dst->format) != c->dstFormat) {
+        av_log(c, AV_LOG_ERROR, "Destination frame format is %s, the context expects %s\n",
+               av_get_pix_fmt_name(dst->format), av_get_pix_fmt_name(c->dstFormat));
+        ret = AVERROR(EINVAL);
+        goto fail;
+    }
+
+    ret = av_frame_ref(c->frame_dst, dst);
+    if (ret < 0)
+        goto fail;
+
+    return 0;
+fail:
+    if (allocated)
+        av_frame_unref(dst);
+    av_frame_unref(c->frame_src);
+    return ret;
+}
+
+void sws_frame_end(struct SwsContext *c)
+{
+    av_frame_unref(c->frame_src);
+    av_frame_unref(c->frame_dst);
+    c->src_ranges.nb_ranges = 0;
+}
+
+int sws_send_slice(struct SwsContext *c, unsigned int slice_start,
+                   unsigned int slice_height)
+{
+    const unsigned int macro_height = isBayer(c->srcFormat) ? 2 : (1 << c->chrSrcVSubSample);
+
+    if (!c->frame_src || !c->frame_src->buf[0])
+        return AVERROR(EINVAL);
+
+    if (slice_start > c->srcH || c->srcH - slice_start < slice_height ||
+        (slice_start & (macro_height - 1)) ||
+        ((slice_height & (macro_height - 1)) && slice_start + slice_height != c->srcH)) {
+        av_log(c, AV_LOG_ERROR, "Slice parameters %u, %u are invalid\n",
+               slice_start, slice_height);
+        return AVERROR(EINVAL);
+    }
+    if (!slice_height)
+        return 0;
+
+    return ff_range_add(&c->src_ranges, slice_start, slice_height);
+}
+
+unsigned int sws_receive_slice_alignment(const struct SwsContext *c)
+{
+    if (c->cascaded_context[0])
+        return c->dstH;
+    return c->dst_slice_align;
+}
+
+/**
+ * Compute the source lines [*src_start, *src_end) the destination lines
+ * [dst_start, dst_end) are computed from.
+ */
+static void band_src_lines(const SwsContext *c, int dst_start, int dst_end,
+                           int *src_start, int *src_end)
+{
+    if (dst_start == 0 && dst_end == c->dstH) {
+        *src_start = 0;
+        *src_end   = c->srcH;
+    } else if (c->swscale == swscale) {
+        const int chr_start = dst_start >> c->chrDstVSubSample;
+        const int chr_last  = (dst_end - 1) >> c->chrDstVSubSample;
+        const int lum_first = c->vLumFilterPos[dst_start];
+        const int lum_end   = c->vLumFilterPos[dst_end - 1] + c->vLumFilterSize;
+        const int chr_first = c->vChrFilterPos[chr_start];
+        const int chr_end   = c->vChrFilterPos[chr_last] + c->vChrFilterSize;
+
+        *src_start = FFMAX(0, FFMIN(lum_first, chr_first << c->chrSrcVSubSample));
+        *src_end   = FFMIN(c->srcH, FFMAX(lum_end, chr_end << c->chrSrcVSubSample));
+    } else {
+        *src_start = dst_start;
+        *src_end   = dst_end;
+    }
+}
+
+int sws_receive_slice(struct SwsContext *c, unsigned int slice_start,
+                      unsigned int slice_height)
+{
+    const unsigned int align = sws_receive_slice_alignment(c);
+    const uint8_t *src[4];
+    uint8_t *dst[4];
+    int src_start, src_end, src_h = 0;
+    int i, ret;
+
+    if (!c->frame_dst || !c->frame_dst->buf[0])
+        return AVERROR(EINVAL);
+
+    if (slice_start > c->dstH || c->dstH - slice_start < slice_height ||
+        slice_start % align ||
+        (slice_height % align && slice_start + slice_height != c->dstH)) {
+        av_log(c, AV_LOG_ERROR, "Incorrectly aligned output: %u/%u not multiples of %u\n",
+               slice_start, slice_height, align);
+        return AVERROR(EINVAL);
+    }
+    if (!slice_height)
+        return 0;
+
+    band_src_lines(c, slice_start, slice_start + slice_height,
+                   &src_start, &src_end);
+    for (i = 0; i < c->src_ranges.nb_ranges; i++) {
+        const Range *r = &c->src_ranges.ranges[i];
+
+        if (r->start <= src_start && r->start + r->len >= src_end) {
+            src_h = r->start + r->len;
+            break;
+        }
+    }
+    if (!src_h)
+        return AVERROR(EAGAIN);
+
+    for (i = 0; i < 4; i++) {
+        src[i] = c->frame_src->data[i];
+        dst[i] = c->frame_dst->data[i];
+    }
+
+    if (c->slicethread && !c->cascaded_context[0])
+        ret = scale_threaded(c, src, c->frame_src->linesize, src_h,
+                             dst, c->frame_dst->linesize,
+                             slice_start, slice_start + slice_height);
+    else
+        ret = scale_band(c, src, c->frame_src->linesize, src_h,
+                         dst, c->frame_dst->linesize,
+                         slice_start, slice_start + slice_height);
+
+    return ret < 0 ? ret : 0;
+}
+
+int sws_scale_frame(struct SwsContext *c, AVFrame *dst, const AVFrame *src)
+{
+    int ret;
+
+    ret = sws_frame_start(c, dst, src);
+    if (ret < 0)
+        return ret;
+
+    ret = sws_send_slice(c, 0, src->height);
+    if (ret >= 0)
+        ret = sws_receive_slice(c, 0, dst->height);
+
+    sws_frame_end(c);
+
+    return ret;
+}
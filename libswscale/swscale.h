@@ -30,6 +30,7 @@
 #include <stdint.h>
 
 #include "libavutil/avutil.h"
+#include "libavutil/frame.h"
 #include "libavutil/log.h"
 #include "libavutil/pixfmt.h"
 #include "version.h"
@@ -218,6 +219,108 @@ int sws_scale(struct SwsContext *c, const uint8_t *const srcSlice[],
               const int srcStride[], int srcSliceY, int srcSliceH,
               uint8_t *const dst[], const int dstStride[]);
 
+/**
+ * Scale source data from src and write the output to dst.
+ *
+ * This is merely a convenience wrapper around
+ * - sws_frame_start()
+ * - sws_send_slice(0, src->height)
+ * - sws_receive_slice(0, dst->height)
+ * - sws_frame_end()
+ *
+ * @param c   the scaling context
+ * @param dst the destination frame. See documentation for sws_frame_start()
+ *            for more details.
+ * @param src the source frame
+ *
+ * @return 0 on success, a negative AVERROR code on failure
+ */
+int sws_scale_frame(struct SwsContext *c, AVFrame *dst, const AVFrame *src);
+
+/**
+ * Initialize the scaling process for a given pair of source/destination
+ * frames. Must be called before any calls to sws_send_slice() and
+ * sws_receive_slice().
+ *
+ * This function will retain references to src and dst, so they must both
+ * use refcounted buffers (if allocated by the caller, in case of dst).
+ * A source frame whose lines are still being written while it is fed with
+ * sws_send_slice() must be refcounted, as a non-refcounted one is copied
+ * here.
+ *
+ * @param c   the scaling context
+ * @param dst The destination frame.
+ *
+ *            The data buffers may either be already allocated by the caller
+ *            or left clear, in which case they will be allocated by the
+ *            scaler from a buffer pool kept in the context, so that the
+ *            buffers of released output frames are reused.
+ *
+ *            Output data will be written into this frame in successful
+ *            sws_receive_slice() calls.
+ * @param src The source frame. The data buffers must be allocated, but the
+ *            frame data does not have to be ready at this point. Data
+ *            availability is then signalled by sws_send_slice().
+ * @return 0 on success, a negative AVERROR code on failure
+ *
+ * @see sws_frame_end()
+ */
+int sws_frame_start(struct SwsContext *c, AVFrame *dst, const AVFrame *src);
+
+/**
+ * Finish the scaling process for a pair of source/destination frames
+ * previously submitted with sws_frame_start(). Must be called after all
+ * sws_send_slice() and sws_receive_slice() calls are done, before any new
+ * sws_frame_start() calls.
+ */
+void sws_frame_end(struct SwsContext *c);
+
+/**
+ * Indicate that a horizontal slice of input data is available in the source
+ * frame previously provided to sws_frame_start(). The slices may be provided
+ * in any order, but may not overlap. For vertically subsampled pixel formats,
+ * the slices must be aligned according to subsampling.
+ *
+ * @param c   the scaling context
+ * @param slice_start first row of the slice
+ * @param slice_height number of rows in the slice
+ *
+ * @return a non-negative number on success, a negative AVERROR code on
+ *         failure.
+ */
+int sws_send_slice(struct SwsContext *c, unsigned int slice_start,
+                   unsigned int slice_height);
+
+/**
+ * Request a horizontal slice of the output data to be written into the frame
+ * previously provided to sws_frame_start().
+ *
+ * An output slice can be produced as soon as all the input lines it depends
+ * on, including the lines covered by the vertical filter, have been sent.
+ *
+ * @param c   the scaling context
+ * @param slice_start first row of the slice; must be a multiple of
+ *                    sws_receive_slice_alignment()
+ * @param slice_height number of rows in the slice; must be a multiple of
+ *                     sws_receive_slice_alignment(), except for the last slice
+ *                     (i.e. when slice_start+slice_height is equal to output
+ *                     frame height)
+ *
+ * @return a non-negative number if the data was successfully written into the output
+ *         AVERROR(EAGAIN) if more input data needs to be provided before the
+ *                         output can be produced
+ *         another negative AVERROR code on other kinds of scaling failure
+ */
+int sws_receive_slice(struct SwsContext *c, unsigned int slice_start,
+                      unsigned int slice_height);
+
+/**
+ * @return alignment required for output slices requested with sws_receive_slice().
+ *         Slice offsets and sizes passed to sws_receive_slice() must be
+ *         multiples of the value returned from this function.
+ */
+unsigned int sws_receive_slice_alignment(const struct SwsContext *c);
+
 /**
  * @param dstRange flag indicating the while-black range of the output (1=jpeg / 0=mpeg)
  * @param srcRange flag indicating the while-black range of the input (1=jpeg / 0=mpeg)
@@ -297,6 +400,32 @@ struct SwsContext *sws_getCachedContext(struct SwsContext *context,
                                         int flags, SwsFilter *srcFilter,
                                         SwsFilter *dstFilter, const double *param);
 
+/**
+ * Get the statistics of the process wide cache of filter coefficients.
+ *
+ * Contexts initialized without user filter vectors take their filter
+ * coefficients from a cache shared by all contexts, so that creating
+ * contexts with a geometry seen before does not recompute them. This can
+ * be disabled per context with the "filter_cache" option.
+ *
+ * @param hits      if not NULL, set to the number of filters taken from
+ *                  the cache
+ * @param misses    if not NULL, set to the number of filters computed and
+ *                  added to the cache
+ * @param init_time if not NULL, set to the total time spent computing
+ *                  filters, in microseconds
+ */
+void sws_filter_cache_stats(int64_t *hits, int64_t *misses, int64_t *init_time);
+
+/**
+ * Free all the entries of the process wide cache of filter coefficients.
+ *
+ * Contexts keep their own copy of the coefficients, so this does not affect
+ * them. Call it to release the memory held by the cache, for example before
+ * unloading libswscale. The statistics are not reset.
+ */
+void sws_filter_cache_flush(void);
+
 /**
  * Convert an 8-bit paletted frame into a frame with a color depth of 32 bits.
  *
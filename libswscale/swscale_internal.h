@@ -26,11 +26,14 @@
 
 #include "libavutil/avassert.h"
 #include "libavutil/avutil.h"
+#include "libavutil/buffer.h"
 #include "libavutil/common.h"
+#include "libavutil/frame.h"
 #include "libavutil/intreadwrite.h"
 #include "libavutil/log.h"
 #include "libavutil/pixfmt.h"
 #include "libavutil/pixdesc.h"
+#include "libavutil/slicethread.h"
 #include "libavutil/ppc/util_altivec.h"
 
 #define STR(s) AV_TOSTRING(s) // AV_STRINGIFY is too long
@@ -276,6 +279,29 @@ typedef void (*yuv2anyX_fn)(struct SwsContext *c, const int16_t *lumFilter,
 struct SwsSlice;
 struct SwsFilterDescriptor;
 
+typedef struct Range {
+    unsigned int start;
+    unsigned int len;
+} Range;
+
+typedef struct RangeList {
+    Range          *ranges;
+    unsigned int nb_ranges;
+    unsigned int ranges_allocated;
+} RangeList;
+
+/**
+ * Add the interval [start, start + len) to the sorted list, merging it with
+ * its neighbours. Overlapping intervals are rejected with AVERROR(EINVAL).
+ */
+int ff_range_add(RangeList *r, unsigned int start, unsigned int len);
+
+/**
+ * Map a pixel format to the one stored in SwsContext.srcFormat/dstFormat,
+ * e.g. YUVJ formats to their YUV counterparts.
+ */
+enum AVPixelFormat ff_sws_context_format(enum AVPixelFormat format);
+
 /* This struct should be aligned on at least a 32-byte boundary. */
 typedef struct SwsContext {
     /**
@@ -309,6 +335,7 @@ typedef struct SwsContext {
     int vChrDrop;                 ///< Binary logarithm of extra vertical subsampling factor in source image chroma planes specified by user.
     int sliceDir;                 ///< Direction that slices are fed to the scaler (1 = top-to-bottom, -1 = bottom-to-top).
     double param[2];              ///< Input parameters for scaling algorithms that need them.
+    int filter_cache;             ///< Take the filter coefficients from the process wide cache.
 
     /* The cascaded_* fields allow spliting a scaler task into multiple
      * sequential steps, this is for example used to limit the maximum
@@ -321,6 +348,44 @@ typedef struct SwsContext {
     uint8_t *cascaded1_tmp[4];
     int cascaded_mainindex;
 
+    /* Slice threading: the destination is split into bands of lines which
+     * are scaled in parallel, each by one of the slice_ctx child contexts.
+     */
+    int nb_threads;               ///< Number of threads requested by the user, 0 for automatic.
+    int slice_invariant;          ///< Seed the error diffusion of each line from its index.
+    AVSliceThread *slicethread;
+    struct SwsContext **slice_ctx;
+    int *slice_ret;
+    int nb_slice_ctx;
+    int dst_slice_align;          ///< Band heights are a multiple of this, dstH if the frame cannot be split.
+    int dst_slice_start;          ///< First destination line output by a band.
+    int dst_slice_end;            ///< Destination line a band stops at, 0 for dstH.
+    struct {
+        const uint8_t *const *src;
+        const int *srcStride;
+        int src_h;                ///< Number of source lines which may be read.
+        uint8_t *const *dst;
+        const int *dstStride;
+        int dst_start;
+        int dst_end;
+    } job;
+
+    /* Frame API state, set up by sws_frame_start() */
+    AVFrame *frame_src;
+    AVFrame *frame_dst;
+    RangeList src_ranges;         ///< Source lines signalled by sws_send_slice().
+    AVBufferPool *frame_pool;     ///< Buffers for destination frames allocated by the scaler.
+
+    /* Transfer characteristics and primaries conversion, applied to the
+     * intermediate picture between cascaded_context[0] and [1]. */
+    int src_trc;                  ///< enum AVColorTransferCharacteristic
+    int dst_trc;                  ///< enum AVColorTransferCharacteristic
+    int src_prim;                 ///< enum AVColorPrimaries
+    int dst_prim;                 ///< enum AVColorPrimaries
+    float *transfer_lin;          ///< 16 bit source value to linear light, 1.0 at reference white
+    uint16_t *transfer_delin;     ///< square root of linear light to 16 bit destination value
+    float transfer_matrix[3][3];  ///< linear light primaries conversion, includes white level scaling
+
     double gamma_value;
     int gamma_flag;
     int is_internal_gamma;
@@ -862,6 +927,56 @@ void ff_get_unscaled_swscale_aarch64(SwsContext *c);
  */
 SwsFunc ff_getSwsFunc(SwsContext *c);
 
+/**
+ * @return 1 if the transfer characteristics or primaries options of the
+ *         context require a conversion, 0 otherwise
+ */
+int ff_sws_transfer_needed(SwsContext *c);
+int ff_sws_init_transfer(SwsContext *c);
+
+/**
+ * Convert the transfer characteristics and primaries of a native endian
+ * RGB48 or RGBA64 picture in place.
+ *
+ * @param step number of 16 bit components per pixel, 3 or 4
+ */
+void ff_sws_transfer_convert(SwsContext *c, uint8_t *data, int stride,
+                             int w, int h, int step);
+
+/**
+ * Parameters the coefficients computed by initFilter() depend on, used as
+ * the key of the filter cache. Must be zeroed before being filled, so that
+ * the padding compares equal.
+ */
+typedef struct SwsFilterParams {
+    int xInc, srcW, dstW;
+    int filterAlign, one;
+    int flags, cpu_flags;
+    double param[2];
+    int srcPos, dstPos;
+} SwsFilterParams;
+
+/**
+ * Look up filter coefficients in the process wide filter cache.
+ *
+ * @return 1 and newly allocated copies of the tables if found, 0 if not
+ *         found, a negative AVERROR code on allocation failure
+ */
+int ff_sws_filter_cache_get(const SwsFilterParams *p, int16_t **filter,
+                            int32_t **filter_pos, int *filter_size);
+
+/**
+ * Add a copy of freshly computed filter coefficients to the filter cache.
+ *
+ * @param init_time time spent computing them, in microseconds
+ */
+void ff_sws_filter_cache_add(const SwsFilterParams *p, const int16_t *filter,
+                             const int32_t *filter_pos, int filter_size,
+                             int64_t init_time);
+
+void ff_sws_slice_worker(void *priv, int jobnr, int threadnr,
+                         int nb_jobs, int nb_threads);
+
 void ff_sws_init_input_funcs(SwsContext *c);
 void ff_sws_init_output_funcs(SwsContext *c,
                               yuv2planar1_fn *yuv2plane1,
@@ -221,53 +221,61 @@ static int nv24ToPlanarWrapper(SwsContext *c, const uint8_t *src[],
     return srcSliceH;
 }
 
-static int planarToP01xWrapper(SwsContext *c, const uint8_t *src8[],
+static int planarToP01xWrapper(SwsContext *c, const uint8_t *src[],
                                int srcStride[], int srcSliceY,
-                               int srcSliceH, uint8_t *dstParam8[],
+                               int srcSliceH, uint8_t *dstParam[],
                                int dstStride[])
 {
     const AVPixFmtDescriptor *src_format = av_pix_fmt_desc_get(c->srcFormat);
     const AVPixFmtDescriptor *dst_format = av_pix_fmt_desc_get(c->dstFormat);
-    const uint16_t **src = (const uint16_t**)src8;
-    uint16_t *dstY = (uint16_t*)(dstParam8[0] + dstStride[0] * srcSliceY);
-    uint16_t *dstUV = (uint16_t*)(dstParam8[1] + dstStride[1] * srcSliceY / 2);
-    int x, y;
+    uint8_t *dstY  = dstParam[0] + dstStride[0] * srcSliceY;
+    uint8_t *dstUV = dstParam[1] + dstStride[1] * srcSliceY / 2;
 
     /* Calculate net shift required for values. */
-    const int shift[3] = {
+    const int shift[2] = {
         dst_format->comp[0].depth + dst_format->comp[0].shift -
         src_format->comp[0].depth - src_format->comp[0].shift,
         dst_format->comp[1].depth + dst_format->comp[1].shift -
         src_format->comp[1].depth - src_format->comp[1].shift,
-        dst_format->comp[2].depth + dst_format->comp[2].shift -
-        src_format->comp[2].depth - src_format->comp[2].shift,
     };
 
     av_assert0(!(srcStride[0] % 2 || srcStride[1] % 2 || srcStride[2] % 2 ||
                  dstStride[0] % 2 || dstStride[1] % 2));
 
-    for (y = 0; y < srcSliceH; y++) {
-        uint16_t *tdstY = dstY;
-        const uint16_t *tsrc0 = src[0];
-        for (x = c->srcW; x > 0; x--) {
-            *tdstY++ = *tsrc0++ << shift[0];
-        }
-        src[0] += srcStride[0] / 2;
-        dstY += dstStride[0] / 2;
+    shiftWords(src[0], dstY, c->srcW, srcSliceH,
+               srcStride[0], dstStride[0], shift[0]);
+    interleaveWords(src[1], src[2], dstUV, c->chrSrcW, (srcSliceH + 1) / 2,
+                    srcStride[1], srcStride[2], dstStride[1], shift[1]);
 
-        if (!(y & 1)) {
-            uint16_t *tdstUV = dstUV;
-            const uint16_t *tsrc1 = src[1];
-            const uint16_t *tsrc2 = src[2];
-            for (x = c->srcW / 2; x > 0; x--) {
-                *tdstUV++ = *tsrc1++ << shift[1];
-                *tdstUV++ = *tsrc2++ << shift[2];
-            }
-            src[1] += srcStride[1] / 2;
-            src[2] += srcStride[2] / 2;
-            dstUV += dstStride[1] / 2;
-        }
-    }
+    return srcSliceH;
+}
+
+static int p01xToPlanarWrapper(SwsContext *c, const uint8_t *src[],
+                               int srcStride[], int srcSliceY,
+                               int srcSliceH, uint8_t *dstParam[],
+                               int dstStride[])
+{
+    const AVPixFmtDescriptor *src_format = av_pix_fmt_desc_get(c->srcFormat);
+    const AVPixFmtDescriptor *dst_format = av_pix_fmt_desc_get(c->dstFormat);
+    uint8_t *dstY = dstParam[0] + dstStride[0] * srcSliceY;
+    uint8_t *dstU = dstParam[1] + dstStride[1] * srcSliceY / 2;
+    uint8_t *dstV = dstParam[2] + dstStride[2] * srcSliceY / 2;
+
+    /* Calculate net shift required for values. */
+    const int shift[2] = {
+        src_format->comp[0].depth + src_format->comp[0].shift -
+        dst_format->comp[0].depth - dst_format->comp[0].shift,
+        src_format->comp[1].depth + src_format->comp[1].shift -
+        dst_format->comp[1].depth - dst_format->comp[1].shift,
+    };
+
+    av_assert0(!(srcStride[0] % 2 || srcStride[1] % 2 ||
+                 dstStride[0] % 2 || dstStride[1] % 2 || dstStride[2] % 2));
+
+    shiftWords(src[0], dstY, c->srcW, srcSliceH,
+               srcStride[0], dstStride[0], -shift[0]);
+    deinterleaveWords(src[1], dstU, dstV, c->chrSrcW, (srcSliceH + 1) / 2,
+                      srcStride[1], dstStride[1], dstStride[2], shift[1]);
 
     return srcSliceH;
 }
@@ -306,7 +314,7 @@ static int planar8ToP01xleWrapper(SwsContext *c, const uint8_t *src[],
             uint16_t *tdstUV = dstUV;
             const uint8_t *tsrc1 = src[1];
             const uint8_t *tsrc2 = src[2];
-            for (x = c->srcW / 2; x > 0; x--) {
+            for (x = c->chrSrcW; x > 0; x--) {
                 t = *tsrc1++;
                 output_pixel(tdstUV++, t | (t << 8));
                 t = *tsrc2++;
@@ -1711,7 +1719,7 @@ static int packedCopyWrapper(SwsContext *c, const uint8_t *src[],
         }\
     } else if (shiftonly) {\
         for (i = 0; i < height; i++) {\
-            const uint8_t *dither= dithers[shift-1][i&7];\
+            const uint8_t *dither= dithers[shift-1][(y + i) & 7];\
             for (j = 0; j < length-7; j+=8) {\
                 tmp = (bswap(src[j+0]) + dither[0])>>shift; dst[j+0] = dbswap(tmp - (tmp>>dst_depth));\
                 tmp = (bswap(src[j+1]) + dither[1])>>shift; dst[j+1] = dbswap(tmp - (tmp>>dst_depth));\
@@ -1730,7 +1738,7 @@ static int packedCopyWrapper(SwsContext *c, const uint8_t *src[],
         }\
     } else {\
         for (i = 0; i < height; i++) {\
-            const uint8_t *dither= dithers[shift-1][i&7];\
+            const uint8_t *dither= dithers[shift-1][(y + i) & 7];\
             for (j = 0; j < length-7; j+=8) {\
                 tmp = bswap(src[j+0]); dst[j+0] = dbswap((tmp - (tmp>>dst_depth) + dither[0])>>shift);\
                 tmp = bswap(src[j+1]); dst[j+1] = dbswap((tmp - (tmp>>dst_depth) + dither[1])>>shift);\
@@ -1766,9 +1774,12 @@ static int planarCopyWrapper(SwsContext *c, const uint8_t *src[],
 
         if (!dst[plane])
             continue;
+        // both chroma components are interleaved in plane 1
+        if (plane == 1 && isSemiPlanarYUV(c->dstFormat))
+            length *= 2;
         // ignore palette for GRAY8
-        if (plane == 1 && !dst[2]) continue;
-        if (!src[plane] || (plane == 1 && !src[2])) {
+        if (plane == 1 && desc_dst->nb_components < 3) continue;
+        if (!src[plane] || (plane == 1 && desc_src->nb_components < 3)) {
             if (is16BPS(c->dstFormat) || isNBPS(c->dstFormat)) {
                 fillPlane16(dst[plane], dstStride[plane], length, height, y,
                         plane == 3, desc_dst->comp[plane].depth,
@@ -1811,32 +1822,16 @@ static int planarCopyWrapper(SwsContext *c, const uint8_t *src[],
                         dstPtr2 += dstStride[plane]/2;
                         srcPtr  += srcStride[plane];
                     }
+                } else if (src_depth <= dst_depth &&
+                           isBE(c->srcFormat) == HAVE_BIGENDIAN &&
+                           isBE(c->dstFormat) == HAVE_BIGENDIAN &&
+                           shiftonly) {
+                    shiftWords(srcPtr, dstPtr, length, height,
+                               srcStride[plane], dstStride[plane],
+                               dst_depth - src_depth);
                 } else if (src_depth <= dst_depth) {
                     for (i = 0; i < height; i++) {
                         j = 0;
-                        if(isBE(c->srcFormat) == HAVE_BIGENDIAN &&
-                           isBE(c->dstFormat) == HAVE_BIGENDIAN &&
-                           shiftonly) {
-                             unsigned shift = dst_depth - src_depth;
-#if HAVE_FAST_64BIT
-#define FAST_COPY_UP(shift) \
-    for (; j < length - 3; j += 4) { \
-        uint64_t v = AV_RN64A(srcPtr2 + j); \
-        AV_WN64A(dstPtr2 + j, v << shift); \
-    }
-#else
-#define FAST_COPY_UP(shift) \
-    for (; j < length - 1; j += 2) { \
-        uint32_t v = AV_RN32A(srcPtr2 + j); \
-        AV_WN32A(dstPtr2 + j, v << shift); \
-    }
-#endif
-                             switch (shift)
-                             {
-                             case 6: FAST_COPY_UP(6); break;
-                             case 7: FAST_COPY_UP(7); break;
-                             }
-                        }
 #define COPY_UP(r,w) \
     if(shiftonly){\
         for (; j < length; j++){ \
@@ -1970,6 +1965,11 @@ void ff_get_unscaled_swscale(SwsContext *c)
         (dstFormat == AV_PIX_FMT_P010 || dstFormat == AV_PIX_FMT_P016)) {
         c->swscale = planarToP01xWrapper;
     }
+    /* p01x_to_yuv420p1x */
+    if ((srcFormat == AV_PIX_FMT_P010 && dstFormat == AV_PIX_FMT_YUV420P10) ||
+        (srcFormat == AV_PIX_FMT_P016 && dstFormat == AV_PIX_FMT_YUV420P16)) {
+        c->swscale = p01xToPlanarWrapper;
+    }
     /* yuv420p_to_p01xle */
     if ((srcFormat == AV_PIX_FMT_YUV420P || srcFormat == AV_PIX_FMT_YUVA420P) &&
         (dstFormat == AV_PIX_FMT_P010LE || dstFormat == AV_PIX_FMT_P016LE)) {
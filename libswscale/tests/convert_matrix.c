@@ -0,0 +1,243 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * Print, for every pair of a set of common pixel formats, whether an
+ * unscaled conversion uses a special converter or goes through the generic
+ * scaler, and optionally how fast it runs.
+ *
+ * The output of the special converters which are lossless, between YUV
+ * formats with the same chroma subsampling and no loss of depth, is checked
+ * against a plain C conversion done with the pixel format descriptors.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "libavutil/frame.h"
+#include "libavutil/lfg.h"
+#include "libavutil/log.h"
+#include "libavutil/mem.h"
+#include "libavutil/pixdesc.h"
+#include "libavutil/time.h"
+
+#include "libswscale/swscale.h"
+#include "libswscale/swscale_internal.h"
+
+static const enum AVPixelFormat formats[] = {
+    AV_PIX_FMT_YUV420P,   AV_PIX_FMT_NV12,      AV_PIX_FMT_NV21,
+    AV_PIX_FMT_YUV420P10, AV_PIX_FMT_YUV420P12, AV_PIX_FMT_YUV420P16,
+    AV_PIX_FMT_P010,      AV_PIX_FMT_P016,
+    AV_PIX_FMT_YUV422P10, AV_PIX_FMT_YUV444P,   AV_PIX_FMT_NV24,
+    AV_PIX_FMT_GBRP,      AV_PIX_FMT_GBRP10,    AV_PIX_FMT_GBRP16,
+    AV_PIX_FMT_RGB24,     AV_PIX_FMT_RGB48,     AV_PIX_FMT_BGRA,
+};
+
+static int alloc_frame(AVFrame *frame, enum AVPixelFormat fmt, int w, int h)
+{
+    int ret;
+
+    frame->format = fmt;
+    frame->width  = w;
+    frame->height = h;
+    if ((ret = av_frame_get_buffer(frame, 0)) < 0)
+        return ret;
+    for (int p = 0; p < 4 && frame->buf[p]; p++)
+        memset(frame->buf[p]->data, 0, frame->buf[p]->size);
+    return 0;
+}
+
+static int is_lossless(enum AVPixelFormat src_fmt, enum AVPixelFormat dst_fmt)
+{
+    const AVPixFmtDescriptor *src = av_pix_fmt_desc_get(src_fmt);
+    const AVPixFmtDescriptor *dst = av_pix_fmt_desc_get(dst_fmt);
+
+    return !(src->flags & AV_PIX_FMT_FLAG_RGB) && !(dst->flags & AV_PIX_FMT_FLAG_RGB) &&
+           src->nb_components == dst->nb_components &&
+           src->log2_chroma_w == dst->log2_chroma_w &&
+           src->log2_chroma_h == dst->log2_chroma_h &&
+           src->comp[0].depth <= dst->comp[0].depth;
+}
+
+/*
+ * A lossless conversion keeps every sample in the top bits of the output,
+ * the low bits are either zero or a replication of the high ones depending
+ * on the converter.
+ */
+static int check_lossless(const AVFrame *src, const AVFrame *dst)
+{
+    const AVPixFmtDescriptor *src_desc = av_pix_fmt_desc_get(src->format);
+    const AVPixFmtDescriptor *dst_desc = av_pix_fmt_desc_get(dst->format);
+    const int shift = dst_desc->comp[0].depth - src_desc->comp[0].depth;
+    uint16_t *in  = av_malloc_array(src->width, sizeof(*in));
+    uint16_t *out = av_malloc_array(src->width, sizeof(*out));
+    int c, y, x, ret = 0;
+
+    if (!in || !out) {
+        ret = AVERROR(ENOMEM);
+        goto end;
+    }
+
+    for (c = 0; c < src_desc->nb_components; c++) {
+        const int w = c == 1 || c == 2 ? AV_CEIL_RSHIFT(src->width,  src_desc->log2_chroma_w) : src->width;
+        const int h = c == 1 || c == 2 ? AV_CEIL_RSHIFT(src->height, src_desc->log2_chroma_h) : src->height;
+
+        for (y = 0; y < h; y++) {
+            av_read_image_line2(in,  (const uint8_t **)src->data, src->linesize,
+                                src_desc, 0, y, c, w, 0, 2);
+            av_read_image_line2(out, (const uint8_t **)dst->data, dst->linesize,
+                                dst_desc, 0, y, c, w, 0, 2);
+            for (x = 0; x < w; x++) {
+                if (out[x] >> shift != in[x]) {
+                    fprintf(stderr, "%s -> %s: component %d differs at %dx%d: %d from %d\n",
+                            src_desc->name, dst_desc->name, c, x, y, out[x], in[x]);
+                    ret = -1;
+                    goto end;
+                }
+            }
+        }
+    }
+
+end:
+    av_free(in);
+    av_free(out);
+    return ret;
+}
+
+/* random samples within the depth of each component */
+static int fill_random(AVFrame *frame, AVLFG *lfg)
+{
+    const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(frame->format);
+    uint16_t *line = av_malloc_array(frame->width, sizeof(*line));
+    int c, y, x;
+
+    if (!line)
+        return AVERROR(ENOMEM);
+
+    for (c = 0; c < desc->nb_components; c++) {
+        const int w = c == 1 || c == 2 ? AV_CEIL_RSHIFT(frame->width,  desc->log2_chroma_w) : frame->width;
+        const int h = c == 1 || c == 2 ? AV_CEIL_RSHIFT(frame->height, desc->log2_chroma_h) : frame->height;
+
+        for (y = 0; y < h; y++) {
+            for (x = 0; x < w; x++)
+                line[x] = av_lfg_get(lfg) & ((1 << desc->comp[c].depth) - 1);
+            av_write_image_line2(line, frame->data, frame->linesize, desc, 0, y, c, w, 2);
+        }
+    }
+
+    av_free(line);
+    return 0;
+}
+
+int main(int argc, char **argv)
+{
+    int w     = argc > 1 ? atoi(argv[1]) : 1920;
+    int h     = argc > 2 ? atoi(argv[2]) : 1080;
+    int iters = argc > 3 ? atoi(argv[3]) : 0;
+    struct SwsContext *ref;
+    SwsFunc generic;
+    AVLFG lfg;
+    int i, j, k, ret = 0;
+
+    if (w <= 0 || h <= 0 || iters < 0) {
+        fprintf(stderr, "usage: %s [width height [iterations]]\n", argv[0]);
+        return 1;
+    }
+
+    av_log_set_level(AV_LOG_ERROR);
+
+    /* a scaling context always uses the generic scaler */
+    ref = sws_getContext(16, 16, AV_PIX_FMT_YUV420P, 32, 32, AV_PIX_FMT_YUV420P,
+                         SWS_BILINEAR, NULL, NULL, NULL);
+    if (!ref)
+        return 1;
+    generic = ref->swscale;
+    sws_freeContext(ref);
+
+    av_lfg_init(&lfg, 0xdeadbeef);
+
+    printf("%-12s %-12s %-8s %-8s", "src", "dst", "path", "check");
+    if (iters)
+        printf(" %10s", "MPix/s");
+    printf("\n");
+    for (i = 0; i < FF_ARRAY_ELEMS(formats); i++) {
+        AVFrame *src = av_frame_alloc();
+
+        if (!src || alloc_frame(src, formats[i], w, h) < 0 ||
+            fill_random(src, &lfg) < 0) {
+            av_frame_free(&src);
+            return 1;
+        }
+
+        for (j = 0; j < FF_ARRAY_ELEMS(formats); j++) {
+            AVFrame *dst = av_frame_alloc();
+            struct SwsContext *c;
+            const char *check = "-";
+            int64_t t;
+
+            if (!dst || alloc_frame(dst, formats[j], w, h) < 0) {
+                av_frame_free(&dst);
+                ret = 1;
+                continue;
+            }
+
+            c = sws_getContext(w, h, formats[i], w, h, formats[j],
+                               SWS_BILINEAR, NULL, NULL, NULL);
+            if (!c) {
+                fprintf(stderr, "%s -> %s: unsupported\n",
+                        av_get_pix_fmt_name(formats[i]),
+                        av_get_pix_fmt_name(formats[j]));
+                av_frame_free(&dst);
+                continue;
+            }
+
+            sws_scale(c, (const uint8_t * const *)src->data, src->linesize,
+                      0, h, dst->data, dst->linesize);
+
+            if (c->swscale != generic && is_lossless(formats[i], formats[j])) {
+                check = "ok";
+                if (check_lossless(src, dst) < 0) {
+                    check = "FAILED";
+                    ret = 1;
+                }
+            }
+
+            printf("%-12s %-12s %-8s %-8s",
+                   av_get_pix_fmt_name(formats[i]),
+                   av_get_pix_fmt_name(formats[j]),
+                   c->swscale == generic ? "generic" : "special", check);
+
+            if (iters) {
+                t = av_gettime_relative();
+                for (k = 0; k < iters; k++)
+                    sws_scale(c, (const uint8_t * const *)src->data, src->linesize,
+                              0, h, dst->data, dst->linesize);
+                t = av_gettime_relative() - t;
+                printf(" %10.1f", (double)w * h * iters / FFMAX(t, 1));
+            }
+            printf("\n");
+
+            sws_freeContext(c);
+            av_frame_free(&dst);
+        }
+        av_frame_free(&src);
+    }
+
+    return ret;
+}
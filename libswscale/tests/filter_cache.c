@@ -0,0 +1,178 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * Check the hits and misses of the filter cache when contexts are created
+ * with the cache enabled, disabled and after it is flushed, and that the
+ * cached coefficients give the same output as freshly computed ones.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "libavutil/frame.h"
+#include "libavutil/lfg.h"
+#include "libavutil/opt.h"
+
+#include "libswscale/swscale.h"
+
+#define SRC_W 160
+#define SRC_H 120
+#define DST_W 100
+#define DST_H 70
+
+static struct SwsContext *create(int filter_cache)
+{
+    struct SwsContext *c = sws_alloc_context();
+
+    if (!c)
+        return NULL;
+    av_opt_set_int(c, "srcw",         SRC_W,              0);
+    av_opt_set_int(c, "srch",         SRC_H,              0);
+    av_opt_set_int(c, "src_format",   AV_PIX_FMT_YUV420P, 0);
+    av_opt_set_int(c, "dstw",         DST_W,              0);
+    av_opt_set_int(c, "dsth",         DST_H,              0);
+    av_opt_set_int(c, "dst_format",   AV_PIX_FMT_YUV420P, 0);
+    av_opt_set_int(c, "sws_flags",    SWS_LANCZOS,        0);
+    av_opt_set_int(c, "filter_cache", filter_cache,       0);
+    if (sws_init_context(c, NULL, NULL) < 0)
+        sws_freeContext(c);
+    return c;
+}
+
+static AVFrame *alloc_frame(int w, int h)
+{
+    AVFrame *frame = av_frame_alloc();
+
+    if (!frame)
+        return NULL;
+    frame->format = AV_PIX_FMT_YUV420P;
+    frame->width  = w;
+    frame->height = h;
+    if (av_frame_get_buffer(frame, 0) < 0)
+        av_frame_free(&frame);
+    return frame;
+}
+
+static int scale(struct SwsContext *c, const AVFrame *src, AVFrame *dst)
+{
+    return sws_scale(c, (const uint8_t * const *)src->data, src->linesize,
+                     0, SRC_H, dst->data, dst->linesize) == DST_H ? 0 : -1;
+}
+
+static int frames_equal(const AVFrame *a, const AVFrame *b)
+{
+    for (int p = 0; p < 3; p++) {
+        int w = p ? DST_W / 2 : DST_W;
+        int h = p ? DST_H / 2 : DST_H;
+
+        for (int y = 0; y < h; y++)
+            if (memcmp(a->data[p] + y * a->linesize[p],
+                       b->data[p] + y * b->linesize[p], w))
+                return 0;
+    }
+    return 1;
+}
+
+int main(void)
+{
+    struct SwsContext *cached = NULL, *uncached = NULL, *c = NULL;
+    AVFrame *src = alloc_frame(SRC_W, SRC_H);
+    AVFrame *dst0 = alloc_frame(DST_W, DST_H);
+    AVFrame *dst1 = alloc_frame(DST_W, DST_H);
+    int64_t hits0, misses0, hits, misses;
+    AVLFG lfg;
+    int ret = 1;
+
+    if (!src || !dst0 || !dst1)
+        goto end;
+    av_lfg_init(&lfg, 1);
+    for (int p = 0; p < 3; p++)
+        for (int y = 0; y < (p ? SRC_H / 2 : SRC_H); y++)
+            for (int x = 0; x < (p ? SRC_W / 2 : SRC_W); x++)
+                src->data[p][y * src->linesize[p] + x] = av_lfg_get(&lfg);
+
+    /* the first context computes its filters and adds them to the cache */
+    sws_filter_cache_stats(&hits0, &misses0, NULL);
+    if (!(cached = create(1)))
+        goto end;
+    sws_filter_cache_stats(&hits, &misses, NULL);
+    if (hits != hits0 || misses == misses0) {
+        fprintf(stderr, "first context: %"PRId64" hits, %"PRId64" misses\n",
+                hits - hits0, misses - misses0);
+        goto end;
+    }
+    sws_freeContext(cached);
+
+    /* the second one takes all of them from the cache */
+    hits0 = hits;
+    misses0 = misses;
+    if (!(cached = create(1)))
+        goto end;
+    sws_filter_cache_stats(&hits, &misses, NULL);
+    if (hits == hits0 || misses != misses0) {
+        fprintf(stderr, "cached context: %"PRId64" hits, %"PRId64" misses\n",
+                hits - hits0, misses - misses0);
+        goto end;
+    }
+
+    /* a context with the cache disabled neither reads nor fills it */
+    hits0 = hits;
+    misses0 = misses;
+    if (!(uncached = create(0)))
+        goto end;
+    sws_filter_cache_stats(&hits, &misses, NULL);
+    if (hits != hits0 || misses != misses0) {
+        fprintf(stderr, "uncached context: %"PRId64" hits, %"PRId64" misses\n",
+                hits - hits0, misses - misses0);
+        goto end;
+    }
+
+    if (scale(cached, src, dst0) < 0 || scale(uncached, src, dst1) < 0)
+        goto end;
+    if (!frames_equal(dst0, dst1)) {
+        fprintf(stderr, "cached and computed filters give different output\n");
+        goto end;
+    }
+
+    /* after a flush, the filters are computed again */
+    sws_filter_cache_flush();
+    if (!(c = create(1)))
+        goto end;
+    sws_filter_cache_stats(&hits, &misses, NULL);
+    if (hits != hits0 || misses == misses0) {
+        fprintf(stderr, "context after flush: %"PRId64" hits, %"PRId64" misses\n",
+                hits - hits0, misses - misses0);
+        goto end;
+    }
+    if (scale(c, src, dst1) < 0 || !frames_equal(dst0, dst1)) {
+        fprintf(stderr, "output changed after flush\n");
+        goto end;
+    }
+
+    ret = 0;
+end:
+    sws_freeContext(cached);
+    sws_freeContext(uncached);
+    sws_freeContext(c);
+    sws_filter_cache_flush();
+    av_frame_free(&src);
+    av_frame_free(&dst0);
+    av_frame_free(&dst1);
+    return ret;
+}
@@ -0,0 +1,270 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * Check that feeding the frame API with source slices in arbitrary order
+ * and pulling output slices as soon as they are available gives the same
+ * picture with any number of threads, and the same picture as a single
+ * sws_scale() call unless error diffusion makes the output depend on the
+ * slicing.
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "libavutil/error.h"
+#include "libavutil/frame.h"
+#include "libavutil/imgutils.h"
+#include "libavutil/lfg.h"
+#include "libavutil/opt.h"
+#include "libavutil/pixdesc.h"
+
+#include "libswscale/swscale.h"
+
+static const struct {
+    enum AVPixelFormat src_fmt, dst_fmt;
+    int src_w, src_h, dst_w, dst_h;
+    int flags;
+    int error_diffusion;
+} tests[] = {
+    { AV_PIX_FMT_YUV420P,   AV_PIX_FMT_YUV420P,  96,  64,  96,  64, SWS_BILINEAR },
+    { AV_PIX_FMT_YUV420P,   AV_PIX_FMT_YUV420P,  96,  64,  48, 150, SWS_BICUBIC  },
+    { AV_PIX_FMT_YUV422P10, AV_PIX_FMT_YUV420P, 128, 100, 128,  40, SWS_LANCZOS  },
+    { AV_PIX_FMT_RGB24,     AV_PIX_FMT_YUV420P,  80,  60,  80,  60, SWS_BICUBIC  },
+    { AV_PIX_FMT_YUV420P,   AV_PIX_FMT_BGRA,     80,  60, 160, 121, SWS_BICUBIC  },
+    { AV_PIX_FMT_NV12,      AV_PIX_FMT_GRAY16LE, 64,  64,  33,  17, SWS_AREA     },
+    { AV_PIX_FMT_RGB48LE,   AV_PIX_FMT_RGB48LE,  64,  50,  64,  50, SWS_POINT    },
+    { AV_PIX_FMT_XYZ12LE,   AV_PIX_FMT_RGB24,    40,  30,  40,  30, SWS_BILINEAR },
+    { AV_PIX_FMT_YUV420P10, AV_PIX_FMT_YUV420P,  64,  48,  64,  48, SWS_BILINEAR },
+    { AV_PIX_FMT_YUV420P,   AV_PIX_FMT_RGB8,     80,  60,  96,  70, SWS_BICUBIC | SWS_FULL_CHR_H_INT, 1 },
+    { AV_PIX_FMT_YUV420P,   AV_PIX_FMT_MONOBLACK, 64, 48,  80,  60, SWS_BILINEAR | SWS_ERROR_DIFFUSION, 1 },
+};
+
+static int alloc_frame(AVFrame *frame, enum AVPixelFormat fmt, int w, int h)
+{
+    frame->format = fmt;
+    frame->width  = w;
+    frame->height = h;
+    return av_frame_get_buffer(frame, 0);
+}
+
+static void fill_random(AVFrame *frame, AVLFG *lfg)
+{
+    const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(frame->format);
+    int p, y, x;
+
+    for (p = 0; p < 4 && frame->data[p]; p++) {
+        const int h = (p == 1 || p == 2) ? AV_CEIL_RSHIFT(frame->height, desc->log2_chroma_h)
+                                         : frame->height;
+        for (y = 0; y < h; y++)
+            for (x = 0; x < frame->linesize[p]; x++)
+                frame->data[p][y * frame->linesize[p] + x] = av_lfg_get(lfg);
+    }
+    /* keep high bit depth samples in range */
+    if (frame->format == AV_PIX_FMT_YUV422P10)
+        for (p = 0; p < 3; p++)
+            for (y = 0; y < frame->height; y++)
+                for (x = 0; x < frame->linesize[p] / 2; x++)
+                    ((uint16_t *)(frame->data[p] + y * frame->linesize[p]))[x] &= 0x3FF;
+}
+
+static int compare(const AVFrame *a, const AVFrame *b)
+{
+    const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(a->format);
+    int linesize[4], p, y;
+
+    av_image_fill_linesizes(linesize, a->format, a->width);
+    for (p = 0; p < 4 && linesize[p]; p++) {
+        const int h = (p == 1 || p == 2) ? AV_CEIL_RSHIFT(a->height, desc->log2_chroma_h)
+                                         : a->height;
+        for (y = 0; y < h; y++)
+            if (memcmp(a->data[p] + y * a->linesize[p],
+                       b->data[p] + y * b->linesize[p], linesize[p]))
+                return 1;
+    }
+    return 0;
+}
+
+static struct SwsContext *alloc_context(int idx, int threads, int slice_invariant)
+{
+    struct SwsContext *c = sws_alloc_context();
+
+    if (!c)
+        return NULL;
+    av_opt_set_int(c, "srcw",       tests[idx].src_w,   0);
+    av_opt_set_int(c, "srch",       tests[idx].src_h,   0);
+    av_opt_set_int(c, "src_format", tests[idx].src_fmt, 0);
+    av_opt_set_int(c, "dstw",       tests[idx].dst_w,   0);
+    av_opt_set_int(c, "dsth",       tests[idx].dst_h,   0);
+    av_opt_set_int(c, "dst_format", tests[idx].dst_fmt, 0);
+    av_opt_set_int(c, "sws_flags",  tests[idx].flags | SWS_BITEXACT, 0);
+    av_opt_set_int(c, "threads",    threads, 0);
+    av_opt_set_int(c, "slice_invariant", slice_invariant, 0);
+    if (sws_init_context(c, NULL, NULL) < 0) {
+        sws_freeContext(c);
+        return NULL;
+    }
+    return c;
+}
+
+static int scale_sliced(struct SwsContext *c, AVFrame *dst, const AVFrame *src,
+                        const unsigned int *slice_start, const unsigned int *slice_h,
+                        int nb_slices)
+{
+    unsigned int align, out_y = 0;
+    int i, ret;
+
+    ret = sws_frame_start(c, dst, src);
+    if (ret < 0)
+        return ret;
+
+    align = sws_receive_slice_alignment(c);
+    for (i = 0; i < nb_slices; i++) {
+        ret = sws_send_slice(c, slice_start[i], slice_h[i]);
+        if (ret < 0)
+            break;
+
+        /* output every slice the input received so far allows */
+        while (out_y < dst->height) {
+            const unsigned int h = FFMIN(align, dst->height - out_y);
+
+            ret = sws_receive_slice(c, out_y, h);
+            if (ret == AVERROR(EAGAIN)) {
+                ret = 0;
+                break;
+            } else if (ret < 0)
+                break;
+            out_y += h;
+        }
+        if (ret < 0)
+            break;
+    }
+    sws_frame_end(c);
+    if (ret < 0)
+        return ret;
+
+    return out_y == dst->height ? 0 : AVERROR_BUG;
+}
+
+static void report_mismatch(int idx, int threads, int slice_invariant, const char *what)
+{
+    fprintf(stderr, "%s %dx%d -> %s %dx%d, %d threads, slice_invariant %d: mismatch with %s\n",
+            av_get_pix_fmt_name(tests[idx].src_fmt), tests[idx].src_w, tests[idx].src_h,
+            av_get_pix_fmt_name(tests[idx].dst_fmt), tests[idx].dst_w, tests[idx].dst_h,
+            threads, slice_invariant, what);
+}
+
+/**
+ * Scale the same randomly sliced source with each thread count. The output
+ * must not depend on the thread count. It matches a single sws_scale() call
+ * when slice_invariant is set, or when no error diffusion is involved.
+ */
+static int run_test(int idx, int slice_invariant, AVLFG *lfg)
+{
+    static const int threads[] = { 1, 3 };
+    const AVPixFmtDescriptor *src_desc = av_pix_fmt_desc_get(tests[idx].src_fmt);
+    const int macro_h = 1 << src_desc->log2_chroma_h;
+    struct SwsContext *c = NULL;
+    AVFrame *src = av_frame_alloc(), *ref = av_frame_alloc();
+    AVFrame *dst[FF_ARRAY_ELEMS(threads)] = { NULL };
+    unsigned int slice_start[256], slice_h[256];
+    int nb_slices = 0, i, y, ret;
+
+    for (i = 0; i < FF_ARRAY_ELEMS(threads); i++)
+        dst[i] = av_frame_alloc();
+    if (!src || !ref || !dst[0] || !dst[1]) {
+        ret = AVERROR(ENOMEM);
+        goto end;
+    }
+
+    ret = alloc_frame(src, tests[idx].src_fmt, tests[idx].src_w, tests[idx].src_h);
+    if (ret < 0)
+        goto end;
+    ret = alloc_frame(ref, tests[idx].dst_fmt, tests[idx].dst_w, tests[idx].dst_h);
+    if (ret < 0)
+        goto end;
+    fill_random(src, lfg);
+
+    /* split the source into randomly sized slices, sent in random order */
+    for (y = 0; y < src->height; y += slice_h[nb_slices++]) {
+        const int h = macro_h * (1 + av_lfg_get(lfg) % 8);
+
+        slice_start[nb_slices] = y;
+        slice_h[nb_slices]     = FFMIN(h, src->height - y);
+    }
+    for (i = nb_slices - 1; i > 0; i--) {
+        const int j = av_lfg_get(lfg) % (i + 1);
+        FFSWAP(unsigned int, slice_start[i], slice_start[j]);
+        FFSWAP(unsigned int, slice_h[i],     slice_h[j]);
+    }
+
+    for (i = 0; i < FF_ARRAY_ELEMS(threads); i++) {
+        c = alloc_context(idx, threads[i], slice_invariant);
+        if (!c) {
+            ret = AVERROR(EINVAL);
+            goto end;
+        }
+
+        if (!i) {
+            ret = sws_scale(c, (const uint8_t * const *)src->data, src->linesize, 0,
+                            src->height, ref->data, ref->linesize);
+            if (ret < 0)
+                goto end;
+        }
+
+        ret = scale_sliced(c, dst[i], src, slice_start, slice_h, nb_slices);
+        if (ret < 0)
+            goto end;
+        sws_freeContext(c);
+        c = NULL;
+
+        if (i && compare(dst[0], dst[i])) {
+            report_mismatch(idx, threads[i], slice_invariant, "1 thread");
+            ret = AVERROR_BUG;
+        }
+        if ((slice_invariant || !tests[idx].error_diffusion) && compare(ref, dst[i])) {
+            report_mismatch(idx, threads[i], slice_invariant, "sws_scale()");
+            ret = AVERROR_BUG;
+        }
+    }
+
+end:
+    if (ret < 0 && ret != AVERROR_BUG)
+        fprintf(stderr, "Test %d failed: %s\n", idx, av_err2str(ret));
+    sws_freeContext(c);
+    av_frame_free(&src);
+    av_frame_free(&ref);
+    for (i = 0; i < FF_ARRAY_ELEMS(threads); i++)
+        av_frame_free(&dst[i]);
+    return ret;
+}
+
+int main(void)
+{
+    AVLFG lfg;
+    int i, slice_invariant, ret = 0;
+
+    av_lfg_init(&lfg, 0xdeadbeef);
+
+    for (i = 0; i < FF_ARRAY_ELEMS(tests); i++)
+        for (slice_invariant = 0; slice_invariant < 2; slice_invariant++)
+            if (run_test(i, slice_invariant, &lfg) < 0)
+                ret = 1;
+
+    return ret;
+}
@@ -0,0 +1,178 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * Check the matrices and tables set up for the transfer characteristics and
+ * primaries conversion against published values.
+ */
+
+#include <stdio.h>
+
+#include "libswscale/swscale.h"
+#include "libswscale/transfer.c"
+
+static int check_matrix(const char *name, const double m[3][3],
+                        const double ref[3][3], double eps)
+{
+    int i, j, ret = 0;
+
+    for (i = 0; i < 3; i++) {
+        for (j = 0; j < 3; j++) {
+            if (fabs(m[i][j] - ref[i][j]) > eps) {
+                fprintf(stderr, "%s[%d][%d] = %f, expected %f\n",
+                        name, i, j, m[i][j], ref[i][j]);
+                ret = 1;
+            }
+        }
+    }
+    return ret;
+}
+
+static int test_matrices(void)
+{
+    /* IEC 61966-2-1 */
+    static const double bt709_xyz[3][3] = {
+        { 0.4124, 0.3576, 0.1805 },
+        { 0.2126, 0.7152, 0.0722 },
+        { 0.0193, 0.1192, 0.9505 },
+    };
+    /* Bradford D65 to D50, as published by B. Lindbloom */
+    static const double d65_d50[3][3] = {
+        {  1.0478112,  0.0228866, -0.0501270 },
+        {  0.0295424,  0.9904844, -0.0170491 },
+        { -0.0092345,  0.0150436,  0.7521316 },
+    };
+    const Chromaticities *bt709 = get_chromaticities(AVCOL_PRI_BT709);
+    Chromaticities d50 = *bt709;
+    double m[3][3];
+    int ret;
+
+    rgb2xyz_matrix(bt709, m);
+    ret = check_matrix("bt709 rgb2xyz", m, bt709_xyz, 2e-4);
+
+    d50.xw = 0.3457;
+    d50.yw = 0.3585;
+    wp_adapt_matrix(bt709, &d50, m);
+    ret |= check_matrix("bradford d65->d50", m, d65_d50, 5e-4);
+
+    return ret;
+}
+
+static SwsContext *alloc_transfer(int src_trc, int src_prim, int dst_trc, int dst_prim)
+{
+    SwsContext *c = sws_alloc_context();
+
+    if (!c)
+        return NULL;
+    c->src_trc  = src_trc;
+    c->src_prim = src_prim;
+    c->dst_trc  = dst_trc;
+    c->dst_prim = dst_prim;
+    if (ff_sws_init_transfer(c) < 0) {
+        sws_freeContext(c);
+        return NULL;
+    }
+    return c;
+}
+
+static int test_pq_bt2020(void)
+{
+    /* ITU-R BT.2087 linear BT.2020 to BT.709 */
+    static const double bt2020_bt709[3][3] = {
+        {  1.6605, -0.5876, -0.0728 },
+        { -0.1246,  1.1329, -0.0083 },
+        { -0.0182, -0.1006,  1.1187 },
+    };
+    SwsContext *c = alloc_transfer(AVCOL_TRC_SMPTE2084, AVCOL_PRI_BT2020,
+                                   AVCOL_TRC_BT709,     AVCOL_PRI_BT709);
+    avpriv_trc_function pq    = avpriv_get_trc_function_from_trc(AVCOL_TRC_SMPTE2084);
+    avpriv_trc_function bt709 = avpriv_get_trc_function_from_trc(AVCOL_TRC_BT709);
+    double m[3][3];
+    int ref_white, mid, i, j, ret;
+
+    if (!c)
+        return 1;
+
+    for (i = 0; i < 3; i++)
+        for (j = 0; j < 3; j++)
+            m[i][j] = c->transfer_matrix[i][j];
+    ret = check_matrix("bt2020->bt709", m, bt2020_bt709, 2e-4);
+
+    /* the BT.2408 reference white linearizes to 1.0 */
+    ref_white = lrint(pq(203.0) * (LUT_SIZE - 1));
+    if (c->transfer_lin[0] != 0.0f || fabs(c->transfer_lin[ref_white] - 1.0) > 1e-3) {
+        fprintf(stderr, "pq linearize: 0 -> %f, %d -> %f\n",
+                c->transfer_lin[0], ref_white, c->transfer_lin[ref_white]);
+        ret = 1;
+    }
+    for (i = 1; i < LUT_SIZE; i++) {
+        if (c->transfer_lin[i] < c->transfer_lin[i - 1] ||
+            c->transfer_delin[i] < c->transfer_delin[i - 1]) {
+            fprintf(stderr, "tables not monotonic at %d\n", i);
+            ret = 1;
+            break;
+        }
+    }
+
+    /* the delinearize table is indexed by the square root of linear light */
+    mid = lrint(sqrt(0.18) * (LUT_SIZE - 1));
+    i   = lrint(bt709(0.18) * (LUT_SIZE - 1));
+    if (abs(c->transfer_delin[mid] - i) > 1) {
+        fprintf(stderr, "bt709 delinearize: 0.18 -> %d, expected %d\n",
+                c->transfer_delin[mid], i);
+        ret = 1;
+    }
+
+    sws_freeContext(c);
+    return ret;
+}
+
+static int test_round_trip(void)
+{
+    SwsContext *c = alloc_transfer(AVCOL_TRC_IEC61966_2_1, AVCOL_PRI_BT709,
+                                   AVCOL_TRC_IEC61966_2_1, AVCOL_PRI_BT2020);
+    int i, max_diff = 0;
+
+    if (!c)
+        return 1;
+
+    /* linearizing and delinearizing with the same curve must be lossless
+     * up to the rounding of the square root index */
+    for (i = 0; i < LUT_SIZE; i++) {
+        const int v = c->transfer_delin[lrint(sqrt(c->transfer_lin[i]) * (LUT_SIZE - 1))];
+        max_diff = FFMAX(max_diff, abs(v - i));
+    }
+    sws_freeContext(c);
+
+    if (max_diff > 1) {
+        fprintf(stderr, "srgb round trip: max difference %d\n", max_diff);
+        return 1;
+    }
+    return 0;
+}
+
+int main(void)
+{
+    int ret = 0;
+
+    ret |= test_matrices();
+    ret |= test_pq_bt2020();
+    ret |= test_round_trip();
+
+    return ret;
+}
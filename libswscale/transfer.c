@@ -0,0 +1,300 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/**
+ * @file
+ * Transfer characteristics and primaries conversion of 16 bit RGB,
+ * run on the intermediate picture of a cascaded context.
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include "libavutil/color_utils.h"
+#include "libavutil/common.h"
+#include "libavutil/mem.h"
+#include "libavutil/pixdesc.h"
+
+#include "swscale_internal.h"
+
+#define LUT_SIZE (1 << 16)
+
+typedef struct Chromaticities {
+    double xr, yr, xg, yg, xb, yb, xw, yw;
+} Chromaticities;
+
+#define WP_D65 0.3127, 0.3290
+#define WP_C   0.3100, 0.3160
+#define WP_DCI 0.3140, 0.3510
+
+static const Chromaticities *get_chromaticities(enum AVColorPrimaries prim)
+{
+    static const Chromaticities bt709     = { 0.640, 0.330, 0.300, 0.600, 0.150, 0.060, WP_D65 };
+    static const Chromaticities bt470m    = { 0.670, 0.330, 0.210, 0.710, 0.140, 0.080, WP_C   };
+    static const Chromaticities bt470bg   = { 0.640, 0.330, 0.290, 0.600, 0.150, 0.060, WP_D65 };
+    static const Chromaticities smpte170m = { 0.630, 0.340, 0.310, 0.595, 0.155, 0.070, WP_D65 };
+    static const Chromaticities film      = { 0.681, 0.319, 0.243, 0.692, 0.145, 0.049, WP_C   };
+    static const Chromaticities bt2020    = { 0.708, 0.292, 0.170, 0.797, 0.131, 0.046, WP_D65 };
+    static const Chromaticities smpte431  = { 0.680, 0.320, 0.265, 0.690, 0.150, 0.060, WP_DCI };
+    static const Chromaticities smpte432  = { 0.680, 0.320, 0.265, 0.690, 0.150, 0.060, WP_D65 };
+    static const Chromaticities ebu3213   = { 0.630, 0.340, 0.295, 0.605, 0.155, 0.077, WP_D65 };
+
+    switch (prim) {
+    case AVCOL_PRI_BT709:     return &bt709;
+    case AVCOL_PRI_BT470M:    return &bt470m;
+    case AVCOL_PRI_BT470BG:   return &bt470bg;
+    case AVCOL_PRI_SMPTE170M:
+    case AVCOL_PRI_SMPTE240M: return &smpte170m;
+    case AVCOL_PRI_FILM:      return &film;
+    case AVCOL_PRI_BT2020:    return &bt2020;
+    case AVCOL_PRI_SMPTE431:  return &smpte431;
+    case AVCOL_PRI_SMPTE432:  return &smpte432;
+    case AVCOL_PRI_EBU3213:   return &ebu3213;
+    default:                  return NULL;
+    }
+}
+
+/*
+ * The transfer functions of libavutil take linear light in a trc specific
+ * domain: [0, 1] for SDR curves and HLG, cd/m^2 for PQ. The reference white
+ * of each domain (BT.2408 for HDR: 203 cd/m^2 for PQ, the scene light of a
+ * 75% signal for HLG) is mapped to the one of the destination; there is no
+ * tone mapping, content above the destination peak is clipped.
+ */
+static double trc_white(enum AVColorTransferCharacteristic trc)
+{
+    switch (trc) {
+    case AVCOL_TRC_SMPTE2084:    return 203.0;
+    case AVCOL_TRC_ARIB_STD_B67: return 0.2650;
+    default:                     return 1.0;
+    }
+}
+
+static double trc_peak(enum AVColorTransferCharacteristic trc)
+{
+    return trc == AVCOL_TRC_SMPTE2084 ? 10000.0 : 1.0;
+}
+
+static void invert_3x3(const double in[3][3], double out[3][3])
+{
+    double det;
+    int i, j;
+
+    out[0][0] =  (in[1][1] * in[2][2] - in[1][2] * in[2][1]);
+    out[0][1] = -(in[0][1] * in[2][2] - in[0][2] * in[2][1]);
+    out[0][2] =  (in[0][1] * in[1][2] - in[0][2] * in[1][1]);
+    out[1][0] = -(in[1][0] * in[2][2] - in[1][2] * in[2][0]);
+    out[1][1] =  (in[0][0] * in[2][2] - in[0][2] * in[2][0]);
+    out[1][2] = -(in[0][0] * in[1][2] - in[0][2] * in[1][0]);
+    out[2][0] =  (in[1][0] * in[2][1] - in[1][1] * in[2][0]);
+    out[2][1] = -(in[0][0] * in[2][1] - in[0][1] * in[2][0]);
+    out[2][2] =  (in[0][0] * in[1][1] - in[0][1] * in[1][0]);
+
+    det = in[0][0] * out[0][0] + in[0][1] * out[1][0] + in[0][2] * out[2][0];
+    for (i = 0; i < 3; i++)
+        for (j = 0; j < 3; j++)
+            out[i][j] /= det;
+}
+
+static void mul_3x3(const double a[3][3], const double b[3][3], double out[3][3])
+{
+    int i, j;
+
+    for (i = 0; i < 3; i++)
+        for (j = 0; j < 3; j++)
+            out[i][j] = a[i][0] * b[0][j] + a[i][1] * b[1][j] + a[i][2] * b[2][j];
+}
+
+static void rgb2xyz_matrix(const Chromaticities *cs, double m[3][3])
+{
+    const double xyz[3][3] = {
+        { cs->xr / cs->yr, cs->xg / cs->yg, cs->xb / cs->yb },
+        { 1.0, 1.0, 1.0 },
+        { (1.0 - cs->xr - cs->yr) / cs->yr,
+          (1.0 - cs->xg - cs->yg) / cs->yg,
+          (1.0 - cs->xb - cs->yb) / cs->yb },
+    };
+    const double w[3] = { cs->xw / cs->yw, 1.0, (1.0 - cs->xw - cs->yw) / cs->yw };
+    double inv[3][3];
+    int i, j;
+
+    invert_3x3(xyz, inv);
+    for (j = 0; j < 3; j++) {
+        const double s = inv[j][0] * w[0] + inv[j][1] * w[1] + inv[j][2] * w[2];
+        for (i = 0; i < 3; i++)
+            m[i][j] = xyz[i][j] * s;
+    }
+}
+
+/* Bradford adaptation from the white point of src to the one of dst */
+static void wp_adapt_matrix(const Chromaticities *src, const Chromaticities *dst,
+                            double m[3][3])
+{
+    static const double bradford[3][3] = {
+        {  0.8951,  0.2664, -0.1614 },
+        { -0.7502,  1.7135,  0.0367 },
+        {  0.0389, -0.0685,  1.0296 },
+    };
+    const double ws[3] = { src->xw / src->yw, 1.0, (1.0 - src->xw - src->yw) / src->yw };
+    const double wd[3] = { dst->xw / dst->yw, 1.0, (1.0 - dst->xw - dst->yw) / dst->yw };
+    double inv[3][3], tmp[3][3], scale[3][3] = { { 0 } };
+    int i;
+
+    for (i = 0; i < 3; i++) {
+        const double s = bradford[i][0] * ws[0] + bradford[i][1] * ws[1] + bradford[i][2] * ws[2];
+        const double d = bradford[i][0] * wd[0] + bradford[i][1] * wd[1] + bradford[i][2] * wd[2];
+        scale[i][i] = d / s;
+    }
+    invert_3x3(bradford, inv);
+    mul_3x3(scale, bradford, tmp);
+    mul_3x3(inv, tmp, m);
+}
+
+int ff_sws_transfer_needed(SwsContext *c)
+{
+    const int trc  = c->src_trc  != AVCOL_TRC_UNSPECIFIED &&
+                     c->dst_trc  != AVCOL_TRC_UNSPECIFIED &&
+                     c->src_trc  != c->dst_trc;
+    const int prim = c->src_prim != AVCOL_PRI_UNSPECIFIED &&
+                     c->dst_prim != AVCOL_PRI_UNSPECIFIED &&
+                     c->src_prim != c->dst_prim;
+    return trc || prim;
+}
+
+int ff_sws_init_transfer(SwsContext *c)
+{
+    enum AVColorTransferCharacteristic src_trc = c->src_trc, dst_trc = c->dst_trc;
+    avpriv_trc_function src_func, dst_func;
+    double src_white, dst_white, src_peak, dst_peak;
+    double m[3][3] = { { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 } };
+    double *enc;
+    int i, j;
+
+    /* a primaries only conversion still has to be done in linear light */
+    if (src_trc == AVCOL_TRC_UNSPECIFIED)
+        src_trc = dst_trc;
+    if (dst_trc == AVCOL_TRC_UNSPECIFIED)
+        dst_trc = src_trc;
+    if (src_trc == AVCOL_TRC_UNSPECIFIED)
+        src_trc = dst_trc = AVCOL_TRC_BT709;
+
+    src_func = avpriv_get_trc_function_from_trc(src_trc);
+    dst_func = avpriv_get_trc_function_from_trc(dst_trc);
+    if (!src_func || !dst_func) {
+        av_log(c, AV_LOG_ERROR, "Unsupported transfer characteristics conversion %s -> %s\n",
+               av_color_transfer_name(src_trc), av_color_transfer_name(dst_trc));
+        return AVERROR(EINVAL);
+    }
+    src_white = trc_white(src_trc);
+    dst_white = trc_white(dst_trc);
+    src_peak  = trc_peak(src_trc);
+    dst_peak  = trc_peak(dst_trc);
+
+    if (c->src_prim != AVCOL_PRI_UNSPECIFIED && c->dst_prim != AVCOL_PRI_UNSPECIFIED &&
+        c->src_prim != c->dst_prim) {
+        const Chromaticities *src_cs = get_chromaticities(c->src_prim);
+        const Chromaticities *dst_cs = get_chromaticities(c->dst_prim);
+        double src_m[3][3], dst_m[3][3], inv[3][3], tmp[3][3];
+
+        if (!src_cs || !dst_cs) {
+            av_log(c, AV_LOG_ERROR, "Unsupported primaries conversion %s -> %s\n",
+                   av_color_primaries_name(c->src_prim), av_color_primaries_name(c->dst_prim));
+            return AVERROR(EINVAL);
+        }
+        rgb2xyz_matrix(src_cs, src_m);
+        rgb2xyz_matrix(dst_cs, dst_m);
+        invert_3x3(dst_m, inv);
+        if (src_cs->xw != dst_cs->xw || src_cs->yw != dst_cs->yw) {
+            double wp[3][3];
+            wp_adapt_matrix(src_cs, dst_cs, wp);
+            mul_3x3(wp, src_m, tmp);
+            memcpy(src_m, tmp, sizeof(tmp));
+        }
+        mul_3x3(inv, src_m, m);
+    }
+
+    /* the destination table is indexed by the square root of linear light,
+     * for precision near black, in units of the destination peak */
+    for (i = 0; i < 3; i++)
+        for (j = 0; j < 3; j++)
+            c->transfer_matrix[i][j] = m[i][j] * dst_white / dst_peak;
+
+    c->transfer_lin   = av_malloc_array(LUT_SIZE, sizeof(*c->transfer_lin));
+    c->transfer_delin = av_malloc_array(LUT_SIZE, sizeof(*c->transfer_delin));
+    enc               = av_malloc_array(LUT_SIZE, sizeof(*enc));
+    if (!c->transfer_lin || !c->transfer_delin || !enc) {
+        av_free(enc);
+        return AVERROR(ENOMEM);
+    }
+
+    for (i = 0; i < LUT_SIZE; i++) {
+        const double x = (double)i / (LUT_SIZE - 1);
+        const double v = dst_func(dst_peak * x * x);
+        c->transfer_delin[i] = av_clip_uint16(lrint(v * (LUT_SIZE - 1)));
+    }
+
+    /* invert the source transfer function on the same kind of grid */
+    for (i = 0; i < LUT_SIZE; i++) {
+        const double x = (double)i / (LUT_SIZE - 1);
+        enc[i] = src_func(src_peak * x * x) * (LUT_SIZE - 1);
+    }
+    for (i = 0, j = 0; i < LUT_SIZE; i++) {
+        double x0, x1, lin;
+
+        while (j < LUT_SIZE - 2 && enc[j + 1] < i)
+            j++;
+        x0 = (double)j / (LUT_SIZE - 1);
+        x1 = (double)(j + 1) / (LUT_SIZE - 1);
+        x0 *= x0;
+        x1 *= x1;
+        if (i <= enc[j])
+            lin = x0;
+        else if (i >= enc[j + 1])
+            lin = x1;
+        else
+            lin = x0 + (x1 - x0) * (i - enc[j]) / (enc[j + 1] - enc[j]);
+        c->transfer_lin[i] = lin * src_peak / src_white;
+    }
+    av_free(enc);
+
+    return 0;
+}
+
+void ff_sws_transfer_convert(SwsContext *c, uint8_t *data, int stride,
+                             int w, int h, int step)
+{
+    const float *lin      = c->transfer_lin;
+    const uint16_t *delin = c->transfer_delin;
+    float m[3][3];
+    int x, y, i;
+
+    memcpy(m, c->transfer_matrix, sizeof(m));
+
+    for (y = 0; y < h; y++) {
+        uint16_t *p = (uint16_t *)(data + y * stride);
+
+        for (x = 0; x < w; x++, p += step) {
+            const float r = lin[p[0]], g = lin[p[1]], b = lin[p[2]];
+
+            for (i = 0; i < 3; i++) {
+                const float v = av_clipf(m[i][0] * r + m[i][1] * g + m[i][2] * b, 0.0f, 1.0f);
+                p[i] = delin[lrintf(sqrtf(v) * (LUT_SIZE - 1))];
+            }
+        }
+    }
+}
@@ -49,6 +49,7 @@
 #include "libavutil/mathematics.h"
 #include "libavutil/opt.h"
 #include "libavutil/pixdesc.h"
+#include "libavutil/time.h"
 #include "libavutil/aarch64/cpu.h"
 #include "libavutil/ppc/cpu.h"
 #include "libavutil/x86/asm.h"
@@ -351,8 +352,9 @@ static av_cold int initFilter(int16_t **outFilter, int32_t **filterPos,
 
     emms_c(); // FIXME should not be required but IS (even for non-MMX versions)
 
-    // NOTE: the +3 is for the MMX(+1) / SSE(+3) scaler which reads over the end
-    FF_ALLOC_ARRAY_OR_GOTO(NULL, *filterPos, (dstW + 3), sizeof(**filterPos), fail);
+    // NOTE: the +15 is for the MMX(+1) / SSE(+3) / AVX2(+7) / AVX-512(+15)
+    // scalers which read over the end
+    FF_ALLOC_ARRAY_OR_GOTO(NULL, *filterPos, (dstW + 15), sizeof(**filterPos), fail);
 
     if (FFABS(xInc - 0x10000) < 10 && srcPos == dstPos) { // unscaled
         int i;
@@ -682,10 +684,10 @@ static av_cold int initFilter(int16_t **outFilter, int32_t **filterPos,
         }
     }
 
-    // Note the +1 is for the MMX scaler which reads over the end
+    // Note the +15 is for the SIMD scalers which read over the end
     /* align at 16 for AltiVec (needed by hScale_altivec_real) */
     FF_ALLOCZ_ARRAY_OR_GOTO(NULL, *outFilter,
-                            (dstW + 3), *outFilterSize * sizeof(int16_t), fail);
+                            (dstW + 15), *outFilterSize * sizeof(int16_t), fail);
 
     /* normalize & store in outFilter */
     for (i = 0; i < dstW; i++) {
@@ -709,15 +711,12 @@ static av_cold int initFilter(int16_t **outFilter, int32_t **filterPos,
         }
     }
 
-    (*filterPos)[dstW + 0] =
-    (*filterPos)[dstW + 1] =
-    (*filterPos)[dstW + 2] = (*filterPos)[dstW - 1]; /* the MMX/SSE scaler will
-                                                      * read over the end */
-    for (i = 0; i < *outFilterSize; i++) {
-        int k = (dstW - 1) * (*outFilterSize) + i;
-        (*outFilter)[k + 1 * (*outFilterSize)] =
-        (*outFilter)[k + 2 * (*outFilterSize)] =
-        (*outFilter)[k + 3 * (*outFilterSize)] = (*outFilter)[k];
+    /* the SIMD scalers will read over the end */
+    for (i = dstW; i < dstW + 15; i++) {
+        (*filterPos)[i] = (*filterPos)[dstW - 1];
+        memcpy(*outFilter + i * (*outFilterSize),
+               *outFilter + (dstW - 1) * (*outFilterSize),
+               *outFilterSize * sizeof(**outFilter));
     }
 
     ret = 0;
@@ -730,6 +729,53 @@ fail:
     return ret;
 }
 
+/* initFilter() through the filter cache, unless it is disabled or user
+ * vectors are given */
+static av_cold int initFilterCached(int use_cache,
+                                    int16_t **outFilter, int32_t **filterPos,
+                                    int *outFilterSize, int xInc, int srcW,
+                                    int dstW, int filterAlign, int one,
+                                    int flags, int cpu_flags,
+                                    SwsVector *srcFilter, SwsVector *dstFilter,
+                                    double param[2], int srcPos, int dstPos)
+{
+    SwsFilterParams p;
+    int64_t t;
+    int ret;
+
+    if (!use_cache || srcFilter || dstFilter || (flags & SWS_PRINT_INFO))
+        return initFilter(outFilter, filterPos, outFilterSize, xInc, srcW,
+                          dstW, filterAlign, one, flags, cpu_flags,
+                          srcFilter, dstFilter, param, srcPos, dstPos);
+
+    memset(&p, 0, sizeof(p));
+    p.xInc        = xInc;
+    p.srcW        = srcW;
+    p.dstW        = dstW;
+    p.filterAlign = filterAlign;
+    p.one         = one;
+    p.flags       = flags;
+    p.cpu_flags   = cpu_flags;
+    p.param[0]    = param[0];
+    p.param[1]    = param[1];
+    p.srcPos      = srcPos;
+    p.dstPos      = dstPos;
+
+    ret = ff_sws_filter_cache_get(&p, outFilter, filterPos, outFilterSize);
+    if (ret)
+        return FFMIN(ret, 0);
+
+    t   = av_gettime_relative();
+    ret = initFilter(outFilter, filterPos, outFilterSize, xInc, srcW, dstW,
+                     filterAlign, one, flags, cpu_flags, NULL, NULL, param,
+                     srcPos, dstPos);
+    if (ret < 0)
+        return ret;
+    ff_sws_filter_cache_add(&p, *outFilter, *filterPos, *outFilterSize,
+                            av_gettime_relative() - t);
+    return 0;
+}
+
 static void fill_rgb2yuv_table(SwsContext *c, const int table[4], int dstRange)
 {
     int64_t W, V, Z, Cy, Cu, Cv;
@@ -867,6 +913,7 @@ int sws_setColorspaceDetails(struct SwsContext *c, const int inv_table[4],
     const AVPixFmtDescriptor *desc_dst;
     const AVPixFmtDescriptor *desc_src;
     int need_reinit = 0;
+    int i;
 
     handle_formats(c);
     desc_dst = av_pix_fmt_desc_get(c->dstFormat);
@@ -906,6 +953,23 @@ int sws_setColorspaceDetails(struct SwsContext *c, const int inv_table[4],
     c->dstFormatBpp = av_get_bits_per_pixel(desc_dst);
     c->srcFormatBpp = av_get_bits_per_pixel(desc_src);
 
+    /* Update the slice contexts before any of the early returns below.
+     * Conversions through cascaded contexts are never threaded, so do not
+     * let the slice contexts set up their own for a YUV matrix change. */
+    if (!c->cascaded_context[0] &&
+        !((isYUV(c->dstFormat) || isGray(c->dstFormat)) &&
+          (isYUV(c->srcFormat) || isGray(c->srcFormat)) &&
+          memcmp(c->dstColorspaceTable, c->srcColorspaceTable, sizeof(int) * 4))) {
+        for (i = 0; i < c->nb_slice_ctx; i++)
+            sws_setColorspaceDetails(c->slice_ctx[i], inv_table, srcRange,
+                                     table, dstRange, brightness,
+                                     contrast, saturation);
+    }
+
+    /* the transfer conversion cascade has a YUV side at both ends */
+    if (c->transfer_lin && c->cascaded_context[1])
+        sws_setColorspaceDetails(c->cascaded_context[1], inv_table, srcRange,
+                                 table, dstRange, 0, 1 << 16, 1 << 16);
     if (c->cascaded_context[c->cascaded_mainindex])
         return sws_setColorspaceDetails(c->cascaded_context[c->cascaded_mainindex],inv_table, srcRange,table, dstRange, brightness,  contrast, saturation);
 
@@ -1071,6 +1135,14 @@ static int handle_xyz(enum AVPixelFormat *format)
     }
 }
 
+enum AVPixelFormat ff_sws_context_format(enum AVPixelFormat format)
+{
+    handle_jpeg(&format);
+    handle_0alpha(&format);
+    handle_xyz(&format);
+    return format;
+}
+
 static void handle_formats(SwsContext *c)
 {
     c->src0Alpha |= handle_0alpha(&c->srcFormat);
@@ -1167,8 +1239,8 @@ static enum AVPixelFormat alphaless_fmt(enum AVPixelFormat fmt)
     }
 }
 
-av_cold int sws_init_context(SwsContext *c, SwsFilter *srcFilter,
-                             SwsFilter *dstFilter)
+static av_cold int context_init_single(SwsContext *c, SwsFilter *srcFilter,
+                                      SwsFilter *dstFilter)
 {
     int i;
     int usesVFilter, usesHFilter;
@@ -1278,6 +1350,58 @@ av_cold int sws_init_context(SwsContext *c, SwsFilter *srcFilter,
     if (!srcFilter)
         srcFilter = &dummyFilter;
 
+    /* Scale to RGB first and convert the transfer characteristics and
+     * primaries at the smaller of the two sizes. */
+    if (ff_sws_transfer_needed(c)) {
+        enum AVPixelFormat tmp_format = isALPHA(srcFormat) && isALPHA(dstFormat) ?
+                                        AV_PIX_FMT_RGBA64 : AV_PIX_FMT_RGB48;
+        int tmp_width, tmp_height;
+
+        ret = ff_sws_init_transfer(c);
+        if (ret < 0)
+            return ret;
+
+        if (srcW*srcH > dstW*dstH) {
+            tmp_width  = dstW;
+            tmp_height = dstH;
+        } else {
+            tmp_width  = srcW;
+            tmp_height = srcH;
+        }
+
+        ret = av_image_alloc(c->cascaded_tmp, c->cascaded_tmpStride,
+                             tmp_width, tmp_height, tmp_format, 64);
+        if (ret < 0)
+            return ret;
+
+        c->cascaded_context[0] = sws_alloc_set_opts(srcW, srcH, srcFormat,
+                                                    tmp_width, tmp_height, tmp_format,
+                                                    flags, c->param);
+        if (!c->cascaded_context[0])
+            return AVERROR(ENOMEM);
+        c->cascaded_context[0]->srcRange   = c->srcRange;
+        c->cascaded_context[0]->alphablend = c->alphablend;
+        c->cascaded_context[0]->nb_threads = c->nb_threads;
+        c->cascaded_context[0]->slice_invariant = c->slice_invariant;
+        ret = sws_init_context(c->cascaded_context[0], srcFilter, NULL);
+        if (ret < 0)
+            return ret;
+
+        c->cascaded_context[1] = sws_alloc_set_opts(tmp_width, tmp_height, tmp_format,
+                                                    dstW, dstH, dstFormat,
+                                                    flags, c->param);
+        if (!c->cascaded_context[1])
+            return AVERROR(ENOMEM);
+        c->cascaded_context[1]->dstRange   = c->dstRange;
+        c->cascaded_context[1]->dither     = c->dither;
+        c->cascaded_context[1]->nb_threads = c->nb_threads;
+        c->cascaded_context[1]->slice_invariant = c->slice_invariant;
+        ret = sws_init_context(c->cascaded_context[1], NULL, dstFilter);
+        if (ret < 0)
+            return ret;
+        return 0;
+    }
+
     c->lumXInc      = (((int64_t)srcW << 16) + (dstW >> 1)) / dstW;
     c->lumYInc      = (((int64_t)srcH << 16) + (dstH >> 1)) / dstH;
     c->dstFormatBpp = av_get_bits_per_pixel(desc_dst);
@@ -1681,7 +1805,8 @@ av_cold int sws_init_context(SwsContext *c, SwsFilter *srcFilter,
                                     PPC_ALTIVEC(cpu_flags) ? 8 :
                                     have_neon(cpu_flags)   ? 8 : 1;
 
-            if ((ret = initFilter(&c->hLumFilter, &c->hLumFilterPos,
+            if ((ret = initFilterCached(c->filter_cache,
+                           &c->hLumFilter, &c->hLumFilterPos,
                            &c->hLumFilterSize, c->lumXInc,
                            srcW, dstW, filterAlign, 1 << 14,
                            (flags & SWS_BICUBLIN) ? (flags | SWS_BICUBIC) : flags,
@@ -1690,7 +1815,8 @@ av_cold int sws_init_context(SwsContext *c, SwsFilter *srcFilter,
                            get_local_pos(c, 0, 0, 0),
                            get_local_pos(c, 0, 0, 0))) < 0)
                 goto fail;
-            if ((ret = initFilter(&c->hChrFilter, &c->hChrFilterPos,
+            if ((ret = initFilterCached(c->filter_cache,
+                           &c->hChrFilter, &c->hChrFilterPos,
                            &c->hChrFilterSize, c->chrXInc,
                            c->chrSrcW, c->chrDstW, filterAlign, 1 << 14,
                            (flags & SWS_BICUBLIN) ? (flags | SWS_BILINEAR) : flags,
@@ -1708,7 +1834,8 @@ av_cold int sws_init_context(SwsContext *c, SwsFilter *srcFilter,
                                 PPC_ALTIVEC(cpu_flags) ? 8 :
                                 have_neon(cpu_flags)   ? 2 : 1;
 
-        if ((ret = initFilter(&c->vLumFilter, &c->vLumFilterPos, &c->vLumFilterSize,
+        if ((ret = initFilterCached(c->filter_cache,
+                       &c->vLumFilter, &c->vLumFilterPos, &c->vLumFilterSize,
                        c->lumYInc, srcH, dstH, filterAlign, (1 << 12),
                        (flags & SWS_BICUBLIN) ? (flags | SWS_BICUBIC) : flags,
                        cpu_flags, srcFilter->lumV, dstFilter->lumV,
@@ -1716,7 +1843,8 @@ av_cold int sws_init_context(SwsContext *c, SwsFilter *srcFilter,
                        get_local_pos(c, 0, 0, 1),
                        get_local_pos(c, 0, 0, 1))) < 0)
             goto fail;
-        if ((ret = initFilter(&c->vChrFilter, &c->vChrFilterPos, &c->vChrFilterSize,
+        if ((ret = initFilterCached(c->filter_cache,
+                       &c->vChrFilter, &c->vChrFilterPos, &c->vChrFilterSize,
                        c->chrYInc, c->chrSrcH, c->chrDstH,
                        filterAlign, (1 << 12),
                        (flags & SWS_BICUBLIN) ? (flags | SWS_BILINEAR) : flags,
@@ -1871,6 +1999,94 @@ fail: // FIXME replace things by appropriate error codes
     return -1;
 }
 
+/* whether the destination lines of c can be computed in independent bands */
+static int can_split(const SwsContext *c)
+{
+    return !c->cascaded_context[0] &&
+           !c->srcXYZ && !c->dstXYZ && !c->src0Alpha &&
+           /* error diffusion carries state from one line to the next,
+            * unless each line starts from its own seed */
+           (c->dither != SWS_DITHER_ED || c->slice_invariant) &&
+           /* demosaicing treats the first and last line of a slice as borders */
+           !isBayer(c->srcFormat);
+}
+
+static av_cold int context_init_threaded(SwsContext *c)
+{
+    int i, ret;
+
+    ret = avpriv_slicethread_create_shared(&c->slicethread, c, ff_sws_slice_worker,
+                                           c->nb_threads);
+    if (ret == AVERROR(ENOSYS) || ret == 1) {
+        avpriv_slicethread_free(&c->slicethread);
+        return 0;
+    } else if (ret < 0)
+        return ret;
+
+    c->slice_ctx = av_mallocz_array(ret, sizeof(*c->slice_ctx));
+    c->slice_ret = av_mallocz_array(ret, sizeof(*c->slice_ret));
+    if (!c->slice_ctx || !c->slice_ret)
+        return AVERROR(ENOMEM);
+    for (i = 0; i < ret; i++) {
+        c->slice_ctx[i] = sws_alloc_context();
+        if (!c->slice_ctx[i])
+            return AVERROR(ENOMEM);
+        c->nb_slice_ctx++;
+    }
+    return 0;
+}
+
+av_cold int sws_init_context(SwsContext *c, SwsFilter *srcFilter,
+                             SwsFilter *dstFilter)
+{
+    int i, ret;
+
+    /* the cascaded contexts of a transfer conversion are threaded instead */
+    if (c->nb_threads != 1 && !ff_sws_transfer_needed(c)) {
+        ret = context_init_threaded(c);
+        if (ret < 0)
+            return ret;
+        /* take the options before context_init_single() adjusts them */
+        for (i = 0; i < c->nb_slice_ctx; i++) {
+            ret = av_opt_copy(c->slice_ctx[i], c);
+            if (ret < 0)
+                return ret;
+            c->slice_ctx[i]->nb_threads = 1;
+        }
+    }
+
+    ret = context_init_single(c, srcFilter, dstFilter);
+    if (ret < 0)
+        return ret;
+
+    c->dst_slice_align = 1 << c->chrDstVSubSample;
+    /* unscaled converters are given source slices of the band height */
+    if (c->srcW == c->dstW && c->srcH == c->dstH)
+        c->dst_slice_align = FFMAX(c->dst_slice_align, 1 << c->chrSrcVSubSample);
+    if (!can_split(c))
+        c->dst_slice_align = c->dstH;
+
+    if (!c->nb_slice_ctx)
+        return 0;
+
+    if (c->dstH < 2 * c->dst_slice_align) {
+        for (i = 0; i < c->nb_slice_ctx; i++)
+            sws_freeContext(c->slice_ctx[i]);
+        av_freep(&c->slice_ctx);
+        av_freep(&c->slice_ret);
+        c->nb_slice_ctx = 0;
+        avpriv_slicethread_free(&c->slicethread);
+        return 0;
+    }
+
+    for (i = 0; i < c->nb_slice_ctx; i++) {
+        ret = context_init_single(c->slice_ctx[i], srcFilter, dstFilter);
+        if (ret < 0)
+            return ret;
+    }
+    return 0;
+}
+
 SwsContext *sws_alloc_set_opts(int srcW, int srcH, enum AVPixelFormat srcFormat,
                                int dstW, int dstH, enum AVPixelFormat dstFormat,
                                int flags, const double *param)
@@ -2361,6 +2577,18 @@ void sws_freeContext(SwsContext *c)
     av_freep(&c->yuvTable);
     av_freep(&c->formatConvBuffer);
 
+    avpriv_slicethread_free(&c->slicethread);
+    for (i = 0; i < c->nb_slice_ctx; i++)
+        sws_freeContext(c->slice_ctx[i]);
+    av_freep(&c->slice_ctx);
+    av_freep(&c->slice_ret);
+    c->nb_slice_ctx = 0;
+
+    av_frame_free(&c->frame_src);
+    av_frame_free(&c->frame_dst);
+    av_freep(&c->src_ranges.ranges);
+    av_buffer_pool_uninit(&c->frame_pool);
+
     sws_freeContext(c->cascaded_context[0]);
     sws_freeContext(c->cascaded_context[1]);
     sws_freeContext(c->cascaded_context[2]);
@@ -2370,6 +2598,8 @@ void sws_freeContext(SwsContext *c)
 
     av_freep(&c->gamma);
     av_freep(&c->inv_gamma);
+    av_freep(&c->transfer_lin);
+    av_freep(&c->transfer_delin);
 
     ff_free_filters(c);
 
@@ -2436,3 +2666,56 @@ struct SwsContext *sws_getCachedContext(struct SwsContext *context, int srcW,
     }
     return context;
 }
+
+int ff_range_add(RangeList *rl, unsigned int start, unsigned int len)
+{
+    Range *tmp;
+    unsigned int idx;
+
+    /* find the first existing range after the new one */
+    for (idx = 0; idx < rl->nb_ranges; idx++)
+        if (rl->ranges[idx].start > start)
+            break;
+
+    /* check for overlap */
+    if (idx > 0) {
+        const Range *prev = &rl->ranges[idx - 1];
+        if (prev->start + prev->len > start)
+            return AVERROR(EINVAL);
+    }
+    if (idx < rl->nb_ranges) {
+        const Range *next = &rl->ranges[idx];
+        if (start + len > next->start)
+            return AVERROR(EINVAL);
+    }
+
+    tmp = av_fast_realloc(rl->ranges, &rl->ranges_allocated,
+                          (rl->nb_ranges + 1) * sizeof(*rl->ranges));
+    if (!tmp)
+        return AVERROR(ENOMEM);
+    rl->ranges = tmp;
+
+    memmove(rl->ranges + idx + 1, rl->ranges + idx,
+            sizeof(*rl->ranges) * (rl->nb_ranges - idx));
+    rl->ranges[idx].start = start;
+    rl->ranges[idx].len   = len;
+    rl->nb_ranges++;
+
+    /* merge with the following and the preceding range if they touch */
+    if (idx + 1 < rl->nb_ranges &&
+        rl->ranges[idx].start + rl->ranges[idx].len == rl->ranges[idx + 1].start) {
+        rl->ranges[idx].len += rl->ranges[idx + 1].len;
+        memmove(rl->ranges + idx + 1, rl->ranges + idx + 2,
+                sizeof(*rl->ranges) * (rl->nb_ranges - idx - 2));
+        rl->nb_ranges--;
+    }
+    if (idx > 0 &&
+        rl->ranges[idx - 1].start + rl->ranges[idx - 1].len == rl->ranges[idx].start) {
+        rl->ranges[idx - 1].len += rl->ranges[idx].len;
+        memmove(rl->ranges + idx, rl->ranges + idx + 1,
+                sizeof(*rl->ranges) * (rl->nb_ranges - idx - 1));
+        rl->nb_ranges--;
+    }
+
+    return 0;
+}
@@ -115,8 +115,8 @@ cglobal %2 %+ 24ToY, 6, 6, %1, dst, src, u1, u2, w, table
 %define coeff1 m5
 %define coeff2 m6
 %elif ARCH_X86_64
-    mova           m8, [%2_Ycoeff_12x4]
-    mova           m9, [%2_Ycoeff_3x56]
+    VBROADCASTI128 m8, [%2_Ycoeff_12x4]
+    VBROADCASTI128 m9, [%2_Ycoeff_3x56]
 %define coeff1 m8
 %define coeff2 m9
 %else ; x86-32 && mmsize == 16
@@ -128,10 +128,10 @@ cglobal %2 %+ 24ToY, 6, 6, %1, dst, src, u1, u2, w, table
 %else ; (ARCH_X86_64 && %0 == 3) || mmsize == 8
 .body:
 %if cpuflag(ssse3)
-    mova           m7, [shuf_rgb_12x4]
+    VBROADCASTI128 m7, [shuf_rgb_12x4]
 %define shuf_rgb1 m7
 %if ARCH_X86_64
-    mova          m10, [shuf_rgb_3x56]
+    VBROADCASTI128 m10, [shuf_rgb_3x56]
 %define shuf_rgb2 m10
 %else ; x86-32
 %define shuf_rgb2 [shuf_rgb_3x56]
@@ -146,8 +146,26 @@ cglobal %2 %+ 24ToY, 6, 6, %1, dst, src, u1, u2, w, table
 %if notcpuflag(ssse3)
     pxor           m7, m7
 %endif ; !cpuflag(ssse3)
-    mova           m4, [rgb_Yrnd]
+    VBROADCASTI128 m4, [rgb_Yrnd]
 .loop:
+%if mmsize == 32
+    ; 8 pixels, 4 per lane, so that the source and destination overreads
+    ; are the same as in the SSSE3 version
+    movu          xm0, [srcq+0]           ; (byte) { Bx, Gx, Rx }[0-3]
+    vinserti128    m0, m0, [srcq+12], 1   ; (byte) { Bx, Gx, Rx }[0-3], [4-7]
+    pshufb         m1, m0, shuf_rgb2      ; (word) { R0, B1, G1, R1, R2, B3, G3, R3 }, { R4, ... }
+    pshufb         m0, shuf_rgb1          ; (word) { B0, G0, R0, B1, B2, G2, R2, B3 }, { B4, ... }
+    add          srcq, 24
+    pmaddwd        m0, coeff1             ; (dword) { B0*BY + G0*GY, B1*BY, B2*BY + G2*GY, B3*BY }, ...
+    pmaddwd        m1, coeff2             ; (dword) { R0*RY, G1+GY + R1*RY, R2*RY, G3+GY + R3*RY }, ...
+    paddd          m0, m1                 ; (dword) { Bx*BY + Gx*GY + Rx*RY }[0-3], [4-7]
+    paddd          m0, m4                 ; += rgb_Yrnd
+    psrad          m0, 9
+    packssdw       m0, m0                 ; (word) { Y[0-3], Y[0-3] }, { Y[4-7], Y[4-7] }
+    vpermq         m0, m0, q3120          ; (word) { Y[0-7] } in the low lane
+    mova    [dstq+wq], xm0
+    add            wq, 16
+%else ; mmsize != 32
 %if cpuflag(ssse3)
     movu           m0, [srcq+0]           ; (byte) { Bx, Gx, Rx }[0-3]
     movu           m2, [srcq+12]          ; (byte) { Bx, Gx, Rx }[4-7]
@@ -189,6 +207,7 @@ cglobal %2 %+ 24ToY, 6, 6, %1, dst, src, u1, u2, w, table
     packssdw       m0, m2                 ; (word) { Y[0-7] }
     mova    [dstq+wq], m0
     add            wq, mmsize
+%endif ; mmsize == 32
     jl .loop
     REP_RET
 %endif ; (ARCH_X86_64 && %0 == 3) || mmsize == 8
@@ -199,10 +218,10 @@ cglobal %2 %+ 24ToY, 6, 6, %1, dst, src, u1, u2, w, table
 %macro RGB24_TO_UV_FN 2-3
 cglobal %2 %+ 24ToUV, 7, 7, %1, dstU, dstV, u1, src, u2, w, table
 %if ARCH_X86_64
-    mova           m8, [%2_Ucoeff_12x4]
-    mova           m9, [%2_Ucoeff_3x56]
-    mova          m10, [%2_Vcoeff_12x4]
-    mova          m11, [%2_Vcoeff_3x56]
+    VBROADCASTI128 m8, [%2_Ucoeff_12x4]
+    VBROADCASTI128 m9, [%2_Ucoeff_3x56]
+    VBROADCASTI128 m10, [%2_Vcoeff_12x4]
+    VBROADCASTI128 m11, [%2_Vcoeff_3x56]
 %define coeffU1 m8
 %define coeffU2 m9
 %define coeffV1 m10
@@ -218,10 +237,10 @@ cglobal %2 %+ 24ToUV, 7, 7, %1, dstU, dstV, u1, src, u2, w, table
 %else ; ARCH_X86_64 && %0 == 3
 .body:
 %if cpuflag(ssse3)
-    mova           m7, [shuf_rgb_12x4]
+    VBROADCASTI128 m7, [shuf_rgb_12x4]
 %define shuf_rgb1 m7
 %if ARCH_X86_64
-    mova          m12, [shuf_rgb_3x56]
+    VBROADCASTI128 m12, [shuf_rgb_3x56]
 %define shuf_rgb2 m12
 %else ; x86-32
 %define shuf_rgb2 [shuf_rgb_3x56]
@@ -236,11 +255,35 @@ cglobal %2 %+ 24ToUV, 7, 7, %1, dstU, dstV, u1, src, u2, w, table
     add         dstUq, wq
     add         dstVq, wq
     neg            wq
-    mova           m6, [rgb_UVrnd]
+    VBROADCASTI128 m6, [rgb_UVrnd]
 %if notcpuflag(ssse3)
     pxor           m7, m7
 %endif
 .loop:
+%if mmsize == 32
+    movu          xm0, [srcq+0]           ; (byte) { Bx, Gx, Rx }[0-3]
+    vinserti128    m0, m0, [srcq+12], 1   ; (byte) { Bx, Gx, Rx }[0-3], [4-7]
+    pshufb         m1, m0, shuf_rgb2      ; (word) { R0, B1, G1, R1, R2, B3, G3, R3 }, { R4, ... }
+    pshufb         m0, shuf_rgb1          ; (word) { B0, G0, R0, B1, B2, G2, R2, B3 }, { B4, ... }
+    add          srcq, 24
+    pmaddwd        m2, m0, coeffV1
+    pmaddwd        m3, m1, coeffV2
+    pmaddwd        m0, coeffU1
+    pmaddwd        m1, coeffU2
+    paddd          m0, m1                 ; (dword) { Bx*BU + Gx*GU + Rx*RU }[0-3], [4-7]
+    paddd          m2, m3                 ; (dword) { Bx*BV + Gx*GV + Rx*RV }[0-3], [4-7]
+    paddd          m0, m6                 ; += rgb_UVrnd
+    paddd          m2, m6                 ; += rgb_UVrnd
+    psrad          m0, 9
+    psrad          m2, 9
+    packssdw       m0, m0
+    packssdw       m2, m2
+    vpermq         m0, m0, q3120          ; (word) { U[0-7] } in the low lane
+    vpermq         m2, m2, q3120          ; (word) { V[0-7] } in the low lane
+    mova   [dstUq+wq], xm0
+    mova   [dstVq+wq], xm2
+    add            wq, 16
+%else ; mmsize != 32
 %if cpuflag(ssse3)
     movu           m0, [srcq+0]           ; (byte) { Bx, Gx, Rx }[0-3]
     movu           m4, [srcq+12]          ; (byte) { Bx, Gx, Rx }[4-7]
@@ -304,6 +347,7 @@ cglobal %2 %+ 24ToUV, 7, 7, %1, dstU, dstV, u1, src, u2, w, table
     mova   [dstVq+wq], m2
 %endif ; mmsize == 8/16
     add            wq, mmsize
+%endif ; mmsize == 32
     jl .loop
     REP_RET
 %endif ; ARCH_X86_64 && %0 == 3
@@ -334,12 +378,17 @@ INIT_XMM avx
 RGB24_FUNCS 11, 13
 %endif
 
+%if ARCH_X86_64 && HAVE_AVX2_EXTERNAL
+INIT_YMM avx2
+RGB24_FUNCS 11, 13
+%endif
+
 ; %1 = nr. of XMM registers
 ; %2-5 = rgba, bgra, argb or abgr (in individual characters)
 %macro RGB32_TO_Y_FN 5-6
 cglobal %2%3%4%5 %+ ToY, 6, 6, %1, dst, src, u1, u2, w, table
-    mova           m5, [rgba_Ycoeff_%2%4]
-    mova           m6, [rgba_Ycoeff_%3%5]
+    VBROADCASTI128 m5, [rgba_Ycoeff_%2%4]
+    VBROADCASTI128 m6, [rgba_Ycoeff_%3%5]
 %if %0 == 6
     jmp mangle(private_prefix %+ _ %+ %6 %+ ToY %+ SUFFIX).body
 %else ; %0 == 6
@@ -352,7 +401,7 @@ cglobal %2%3%4%5 %+ ToY, 6, 6, %1, dst, src, u1, u2, w, table
     lea          srcq, [srcq+wq*2]
     add          dstq, wq
     neg            wq
-    mova           m4, [rgb_Yrnd]
+    VBROADCASTI128 m4, [rgb_Yrnd]
     pcmpeqb        m7, m7
     psrlw          m7, 8                  ; (word) { 0x00ff } x4
 .loop:
@@ -371,7 +420,12 @@ cglobal %2%3%4%5 %+ ToY, 6, 6, %1, dst, src, u1, u2, w, table
     psrad          m0, 9
     psrad          m2, 9
     packssdw       m0, m2                 ; (word) { Y[0-7] }
+%if mmsize == 32
+    vpermq         m0, m0, q3120          ; undo the in-lane packing order
+    movu    [dstq+wq], m0                 ; the lines are only 16 byte aligned
+%else
     mova    [dstq+wq], m0
+%endif
     add            wq, mmsize
     jl .loop
     sub            wq, mmsize - 1
@@ -379,7 +433,7 @@ cglobal %2%3%4%5 %+ ToY, 6, 6, %1, dst, src, u1, u2, w, table
     add            srcq, 2*mmsize - 2
     add            dstq, mmsize - 1
 .loop2:
-    movd           m0, [srcq+wq*2+0]      ; (byte) { Bx, Gx, Rx, xx }[0-3]
+    movd          xm0, [srcq+wq*2+0]      ; (byte) { Bx, Gx, Rx, xx }[0-3]
     DEINTB          1,  0,  3,  2,  7     ; (word) { Gx, xx (m0/m2) or Bx, Rx (m1/m3) }[0-3]/[4-7]
     pmaddwd        m1, m5                 ; (dword) { Bx*BY + Rx*RY }[0-3]
     pmaddwd        m0, m6                 ; (dword) { Gx*GY }[0-3]
@@ -387,7 +441,7 @@ cglobal %2%3%4%5 %+ ToY, 6, 6, %1, dst, src, u1, u2, w, table
     paddd          m0, m1                 ; (dword) { Y[0-3] }
     psrad          m0, 9
     packssdw       m0, m0                 ; (word) { Y[0-7] }
-    movd    [dstq+wq], m0
+    movd    [dstq+wq], xm0
     add            wq, 2
     jl .loop2
 .end:
@@ -400,10 +454,10 @@ cglobal %2%3%4%5 %+ ToY, 6, 6, %1, dst, src, u1, u2, w, table
 %macro RGB32_TO_UV_FN 5-6
 cglobal %2%3%4%5 %+ ToUV, 7, 7, %1, dstU, dstV, u1, src, u2, w, table
 %if ARCH_X86_64
-    mova           m8, [rgba_Ucoeff_%2%4]
-    mova           m9, [rgba_Ucoeff_%3%5]
-    mova          m10, [rgba_Vcoeff_%2%4]
-    mova          m11, [rgba_Vcoeff_%3%5]
+    VBROADCASTI128 m8, [rgba_Ucoeff_%2%4]
+    VBROADCASTI128 m9, [rgba_Ucoeff_%3%5]
+    VBROADCASTI128 m10, [rgba_Vcoeff_%2%4]
+    VBROADCASTI128 m11, [rgba_Vcoeff_%3%5]
 %define coeffU1 m8
 %define coeffU2 m9
 %define coeffV1 m10
@@ -431,7 +485,7 @@ cglobal %2%3%4%5 %+ ToUV, 7, 7, %1, dstU, dstV, u1, src, u2, w, table
     neg            wq
     pcmpeqb        m7, m7
     psrlw          m7, 8                  ; (word) { 0x00ff } x4
-    mova           m6, [rgb_UVrnd]
+    VBROADCASTI128 m6, [rgb_UVrnd]
 .loop:
     ; FIXME check alignment and use mova
     movu           m0, [srcq+wq*2+0]      ; (byte) { Bx, Gx, Rx, xx }[0-3]
@@ -459,13 +513,20 @@ cglobal %2%3%4%5 %+ ToUV, 7, 7, %1, dstU, dstV, u1, src, u2, w, table
     psrad          m1, 9
     packssdw       m0, m4                 ; (word) { U[0-7] }
     packssdw       m2, m1                 ; (word) { V[0-7] }
+%if mmsize == 32
+    vpermq         m0, m0, q3120          ; undo the in-lane packing order
+    vpermq         m2, m2, q3120
+%endif
 %if mmsize == 8
     mova   [dstUq+wq], m0
     mova   [dstVq+wq], m2
-%else ; mmsize == 16
+%elif mmsize == 16
     mova   [dstUq+wq], m0
     mova   [dstVq+wq], m2
-%endif ; mmsize == 8/16
+%else ; mmsize == 32, the lines are only 16 byte aligned
+    movu   [dstUq+wq], m0
+    movu   [dstVq+wq], m2
+%endif ; mmsize == 8/16/32
     add            wq, mmsize
     jl .loop
     sub            wq, mmsize - 1
@@ -474,7 +535,7 @@ cglobal %2%3%4%5 %+ ToUV, 7, 7, %1, dstU, dstV, u1, src, u2, w, table
     add            dstUq, mmsize - 1
     add            dstVq, mmsize - 1
 .loop2:
-    movd           m0, [srcq+wq*2]        ; (byte) { Bx, Gx, Rx, xx }[0-3]
+    movd          xm0, [srcq+wq*2]        ; (byte) { Bx, Gx, Rx, xx }[0-3]
     DEINTB          1,  0,  5,  4,  7     ; (word) { Gx, xx (m0/m4) or Bx, Rx (m1/m5) }[0-3]/[4-7]
     pmaddwd        m3, m1, coeffV1        ; (dword) { Bx*BV + Rx*RV }[0-3]
     pmaddwd        m2, m0, coeffV2        ; (dword) { Gx*GV }[0-3]
@@ -488,8 +549,8 @@ cglobal %2%3%4%5 %+ ToUV, 7, 7, %1, dstU, dstV, u1, src, u2, w, table
     psrad          m2, 9
     packssdw       m0, m0                 ; (word) { U[0-7] }
     packssdw       m2, m2                 ; (word) { V[0-7] }
-    movd   [dstUq+wq], m0
-    movd   [dstVq+wq], m2
+    movd   [dstUq+wq], xm0
+    movd   [dstVq+wq], xm2
     add            wq, 2
     jl .loop2
 .end:
@@ -524,6 +585,11 @@ INIT_XMM avx
 RGB32_FUNCS 8, 12
 %endif
 
+%if ARCH_X86_64 && HAVE_AVX2_EXTERNAL
+INIT_YMM avx2
+RGB32_FUNCS 8, 12
+%endif
+
 ;-----------------------------------------------------------------------------
 ; YUYV/UYVY/NV12/NV21 packed pixel shuffling.
 ;
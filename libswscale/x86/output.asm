@@ -22,20 +22,30 @@
 
 %include "libavutil/x86/x86util.asm"
 
-SECTION_RODATA
+SECTION_RODATA 32
 
 minshort:      times 8 dw 0x8000
 yuv2yuvX_16_start:  times 4 dd 0x4000 - 0x40000000
 yuv2yuvX_10_start:  times 4 dd 0x10000
 yuv2yuvX_9_start:   times 4 dd 0x20000
+yuv2yuvX_12_start:  times 4 dd 0x4000
+yuv2yuvX_12_upper:  times 8 dw 0xfff
 yuv2yuvX_10_upper:  times 8 dw 0x3ff
 yuv2yuvX_9_upper:   times 8 dw 0x1ff
+yuv2yuvX_16_perm:   dq 0, 2, 4, 6, 1, 3, 5, 7
 pd_4:          times 4 dd 4
 pd_4min0x40000:times 4 dd 4 - (0x40000)
 pw_16:         times 8 dw 16
 pw_32:         times 8 dw 32
 pw_512:        times 8 dw 512
 pw_1024:       times 8 dw 1024
+pd_yuv2rgb_rnd:    times 8 dd 1 << 9
+pd_yuv2rgb_uv_rnd: times 8 dd (1 << 9) - (128 << 19)
+pd_yuv2rgb_y_rnd:  times 8 dd 1 << 21
+pd_yuv2rgb_a_rnd:  times 8 dd 1 << 18
+pd_yuv2rgb_max:    times 8 dd (1 << 30) - 1
+pd_255:            times 8 dd 0xff
+pd_0xff000000:     times 8 dd 0xff000000
 
 SECTION .text
 
@@ -283,6 +293,138 @@ yuv2planeX_fn  9,  7, 5
 yuv2planeX_fn 10,  7, 5
 %endif
 
+%if ARCH_X86_64
+;-----------------------------------------------------------------------------
+; wide vertical line scaling for 9 to 16 bit output
+;
+; Same prototype as yuv2planeX_<output_size> above, dither and offset are
+; unused. Full vectors of mmsize/2 pixels are stored while they fit, the rest
+; of the line in blocks of 8 pixels, so that at most 7 pixels past dstW are
+; written like in the SSE versions.
+;-----------------------------------------------------------------------------
+
+; yuv2planeX_wide output_size
+%macro yuv2planeX_wide 1
+cglobal yuv2planeX_%1, 5, 8, 11, filter, fltsize, src, dst, w
+    vpbroadcastd    m8, [yuv2yuvX_%1_start]
+%if %1 == 16
+    vpbroadcastw    m9, [minshort]
+%if mmsize == 64
+    movu           m10, [yuv2yuvX_16_perm]
+%endif
+%else ; %1 == 9/10/12
+    vpbroadcastw    m9, [yuv2yuvX_%1_upper]
+%endif ; %1 == 9/10/12/16
+    xor             r5,  r5
+
+.pixelloop:
+    mova            m1,  m8
+    mova            m2,  m8
+    movsxd          r7,  fltsized
+.filterloop:
+    ; input pixels
+    mov             r6, [srcq+gprsize*r7-2*gprsize]
+%if %1 == 16
+    movu            m3, [r6+r5*4]
+    movu            m5, [r6+r5*4+mmsize]
+%else ; %1 == 9/10/12
+    movu            m3, [r6+r5*2]
+%endif ; %1 == 9/10/12/16
+    mov             r6, [srcq+gprsize*r7-gprsize]
+%if %1 == 16
+    movu            m4, [r6+r5*4]
+    movu            m6, [r6+r5*4+mmsize]
+%else ; %1 == 9/10/12
+    movu            m4, [r6+r5*2]
+%endif ; %1 == 9/10/12/16
+
+    ; coefficients
+    vpbroadcastd    m0, [filterq+2*r7-4] ; coeff[0], coeff[1]
+%if %1 == 16
+    pslld           m7,  m0,  16
+    psrad           m0,  16              ; coeff[1]
+    psrad           m7,  16              ; coeff[0]
+
+    pmulld          m3,  m7
+    pmulld          m5,  m7
+    pmulld          m4,  m0
+    pmulld          m6,  m0
+
+    paddd           m2,  m3
+    paddd           m1,  m5
+    paddd           m2,  m4
+    paddd           m1,  m6
+%else ; %1 == 9/10/12
+    punpcklwd       m5,  m3,  m4
+    punpckhwd       m3,  m4
+
+    pmaddwd         m5,  m0
+    pmaddwd         m3,  m0
+
+    paddd           m2,  m5
+    paddd           m1,  m3
+%endif ; %1 == 9/10/12/16
+
+    sub             r7,  2
+    jg .filterloop
+
+%if %1 == 16
+    psrad           m2,  31 - %1
+    psrad           m1,  31 - %1
+    packssdw        m2,  m1
+%if mmsize == 64
+    vpermq          m2, m10,  m2
+%else
+    vpermq          m2,  m2,  q3120
+%endif
+    paddw           m2,  m9
+%else ; %1 == 9/10/12
+    psrad           m2,  27 - %1
+    psrad           m1,  27 - %1
+    packusdw        m2,  m1              ; within each lane, already in order
+    pminuw          m2,  m9
+%endif ; %1 == 9/10/12/16
+
+    cmp             wd,  mmsize/2
+    jl .tail
+    movu   [dstq+r5*2],  m2
+    add             r5,  mmsize/2
+    sub             wd,  mmsize/2
+    jg .pixelloop
+    RET
+
+.tail:
+%assign %%i 0
+%rep mmsize/16
+%if %%i
+    vextracti128 [dstq+r5*2+16*%%i], m2, %%i
+%else
+    movu   [dstq+r5*2], xm2
+%endif
+    sub             wd,  8
+    jle .end
+%assign %%i %%i+1
+%endrep
+.end:
+    RET
+%endmacro
+
+%if HAVE_AVX2_EXTERNAL
+INIT_YMM avx2
+yuv2planeX_wide  9
+yuv2planeX_wide 10
+yuv2planeX_wide 12
+yuv2planeX_wide 16
+%endif
+%if HAVE_AVX512_EXTERNAL
+INIT_ZMM avx512
+yuv2planeX_wide  9
+yuv2planeX_wide 10
+yuv2planeX_wide 12
+yuv2planeX_wide 16
+%endif
+%endif ; ARCH_X86_64
+
 ; %1=outout-bpc, %2=alignment (u/a)
 %macro yuv2plane1_mainloop 2
 .loop_%2:
@@ -423,3 +565,183 @@ yuv2plane1_fn  9, 5, 3
 yuv2plane1_fn 10, 5, 3
 yuv2plane1_fn 16, 5, 3
 %endif
+
+%if ARCH_X86_64
+;-----------------------------------------------------------------------------
+; full chroma interpolation to packed 32-bit RGB
+;
+; void yuv2<fmt>_full_X_<opt>(const int16_t *lumFilter, const int16_t **lumSrc,
+;                             int lumFilterSize, const int16_t *chrFilter,
+;                             const int16_t **chrUSrc, const int16_t **chrVSrc,
+;                             int chrFilterSize, const int16_t **alpSrc,
+;                             uint8_t *dest, int dstW, const int32_t *coeffs)
+;
+; Same output as yuv2rgb_full_X_c_template() for the 32-bit formats. $coeffs
+; holds y_offset, y_coeff, v2r, v2g, u2g and u2b, each broadcast to 8 dwords.
+; Filter sizes may be odd; the coefficient following the last one is read but
+; multiplied by zero. mmsize/4 pixels are done per iteration, only dstW pixels
+; are written.
+;-----------------------------------------------------------------------------
+
+; FILTER_TAPS filter, srcs, size, acc
+%macro FILTER_TAPS 4
+    pxor            %4, %4
+    xor             jq, jq
+    cmp            %3q, 2
+    jl %%single
+%%pairs:
+    mov          src1q, [%2q + jq*8]
+    mov          src2q, [%2q + jq*8 + 8]
+    pmovzxwd        m4, [src1q + xq*2]
+    pmovzxwd        m5, [src2q + xq*2]
+    pslld           m5, 16
+    por             m4, m5              ; (word) { src[j][x], src[j+1][x] }
+    VPBROADCASTD    m5, [%1q + jq*2]    ; (word) { filter[j], filter[j+1] }
+    pmaddwd         m4, m5
+    paddd           %4, m4
+    add             jq, 2
+    lea          src1q, [jq + 1]
+    cmp          src1q, %3q
+    jl %%pairs
+    cmp             jq, %3q
+    jge %%done
+%%single:
+    mov          src1q, [%2q + jq*8]
+    pmovzxwd        m4, [src1q + xq*2]  ; (word) { src[j][x], 0 }
+    VPBROADCASTD    m5, [%1q + jq*2]
+    pmaddwd         m4, m5
+    paddd           %4, m4
+%%done:
+%endmacro
+
+; yuv2rgb32_full_X fmt, r_shift, g_shift, b_shift, a_shift, has_alpha
+%macro yuv2rgb32_full_X 6
+cglobal yuv2%1_full_X, 11, 15, 10, lumFilter, lumSrc, lumSize, chrFilter, \
+                                   chrUSrc, chrVSrc, chrSize, alpSrc, dest, \
+                                   w, coeffs, x, j, src1, src2
+    movsxdifnidn lumSizeq, lumSized
+    movsxdifnidn chrSizeq, chrSized
+    movsxdifnidn        wq, wd
+    pxor                m6, m6
+    mova                m7, [pd_yuv2rgb_max]
+    xor                 xq, xq
+.loop:
+    FILTER_TAPS lumFilter, lumSrc,  lumSize, m0
+    FILTER_TAPS chrFilter, chrUSrc, chrSize, m1
+    FILTER_TAPS chrFilter, chrVSrc, chrSize, m2
+%if %6
+    FILTER_TAPS lumFilter, alpSrc,  lumSize, m3
+%endif
+
+    paddd               m0, [pd_yuv2rgb_rnd]
+    paddd               m1, [pd_yuv2rgb_uv_rnd]
+    paddd               m2, [pd_yuv2rgb_uv_rnd]
+    psrad               m0, 10
+    psrad               m1, 10
+    psrad               m2, 10
+    psubd               m0, [coeffsq + 0*32]
+    pmulld              m0, [coeffsq + 1*32]
+    paddd               m0, [pd_yuv2rgb_y_rnd]
+    pmulld              m4, m2, [coeffsq + 2*32]
+    pmulld              m5, m2, [coeffsq + 3*32]
+    pmulld              m2, m1, [coeffsq + 4*32]
+    pmulld              m1, [coeffsq + 5*32]
+    paddd               m4, m0              ; R
+    paddd               m5, m2
+    paddd               m5, m0              ; G
+    paddd               m1, m0              ; B
+
+    ; clipping each component to 30 bits is the same as clipping all three
+    ; when one of them overflows
+    pmaxsd              m4, m6
+    pmaxsd              m5, m6
+    pmaxsd              m1, m6
+    pminsd              m4, m7
+    pminsd              m5, m7
+    pminsd              m1, m7
+    psrld               m4, 22
+    psrld               m5, 22
+    psrld               m1, 22
+%if %2
+    pslld               m4, %2
+%endif
+%if %3
+    pslld               m5, %3
+%endif
+%if %4
+    pslld               m1, %4
+%endif
+    por                 m4, m5
+    por                 m4, m1
+
+%if %6
+    ; A is only clipped when bit 8 is set, otherwise its low byte is stored
+    paddd               m3, [pd_yuv2rgb_a_rnd]
+    psrad               m3, 19
+    pslld               m8, m3, 23
+    psrad               m8, 31
+    pmaxsd              m9, m3, m6
+    pminsd              m9, [pd_255]
+    pand                m9, m8
+    pandn               m8, m3
+    pand                m8, [pd_255]
+    por                 m9, m8
+%if %5
+    pslld               m9, %5
+%endif
+    por                 m4, m9
+%elif %5
+    por                 m4, [pd_0xff000000]
+%else
+    por                 m4, [pd_255]
+%endif
+
+    lea              src1q, [xq + mmsize/4]
+    cmp              src1q, wq
+    jg .tail
+    movu   [destq + xq*4], m4
+    mov                 xq, src1q
+    cmp                 xq, wq
+    jl .loop
+    RET
+
+.tail:
+    sub                 wq, xq
+    lea              destq, [destq + xq*4]
+%if mmsize == 32
+    cmp                 wq, 4
+    jl .tail_px
+    movu           [destq], xm4
+    vextracti128       xm4, m4, 1
+    add              destq, 16
+    sub                 wq, 4
+    jz .end
+%endif
+.tail_px:
+    movd           [destq], xm4
+    psrldq             xm4, 4
+    add              destq, 4
+    dec                 wq
+    jg .tail_px
+.end:
+    RET
+%endmacro
+
+%macro YUV2RGB32_FULL_X_FUNCS 0
+yuv2rgb32_full_X rgba32,  0,  8, 16, 24, 1
+yuv2rgb32_full_X rgbx32,  0,  8, 16, 24, 0
+yuv2rgb32_full_X bgra32, 16,  8,  0, 24, 1
+yuv2rgb32_full_X bgrx32, 16,  8,  0, 24, 0
+yuv2rgb32_full_X argb32,  8, 16, 24,  0, 1
+yuv2rgb32_full_X xrgb32,  8, 16, 24,  0, 0
+yuv2rgb32_full_X abgr32, 24, 16,  8,  0, 1
+yuv2rgb32_full_X xbgr32, 24, 16,  8,  0, 0
+%endmacro
+
+INIT_XMM sse4
+YUV2RGB32_FULL_X_FUNCS
+%if HAVE_AVX2_EXTERNAL
+INIT_YMM avx2
+YUV2RGB32_FULL_X_FUNCS
+%endif
+%endif ; ARCH_X86_64
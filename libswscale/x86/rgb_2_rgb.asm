@@ -298,3 +298,210 @@ UYVY_TO_YUV422
 INIT_XMM avx
 UYVY_TO_YUV422
 %endif
+
+;-----------------------------------------------------------------------------------------------
+; interleave_words(const uint8_t *src1, const uint8_t *src2, uint8_t *dst,
+;                  int width, int height, int src1Stride,
+;                  int src2Stride, int dstStride, int shift)
+;-----------------------------------------------------------------------------------------------
+%macro INTERLEAVE_WORDS 0
+cglobal interleave_words, 9, 11, 5, src1, src2, dst, w, h, src1_stride, src2_stride, dst_stride, shift, x, tmp
+    movsxdifnidn           wq, wd
+    movsxdifnidn src1_strideq, src1_strided
+    movsxdifnidn src2_strideq, src2_strided
+    movsxdifnidn  dst_strideq, dst_strided
+    movd                  xm4, shiftd
+
+.loop_line:
+    xor          xq, xq
+    mov        tmpq, wq
+    and        tmpq, ~(mmsize / 2 - 1)
+    jz .tail
+
+    .loop_simd:
+        movu         m0, [src1q + xq * 2]
+        movu         m1, [src2q + xq * 2]
+        psllw        m0, xm4
+        psllw        m1, xm4
+        punpckhwd    m2, m0, m1
+        punpcklwd    m0, m1
+%if mmsize == 32
+        vperm2i128   m1, m0, m2, 0x31
+        vperm2i128   m0, m0, m2, 0x20
+        movu [dstq + xq * 4         ], m0
+        movu [dstq + xq * 4 + mmsize], m1
+%else
+        movu [dstq + xq * 4         ], m0
+        movu [dstq + xq * 4 + mmsize], m2
+%endif
+        add          xq, mmsize / 2
+        cmp          xq, tmpq
+        jl .loop_simd
+
+    .tail:
+        cmp          xq, wq
+        jge .end_line
+
+    .loop_scalar:
+        movzx      tmpd, word [src1q + xq * 2]
+        movd        xm0, tmpd
+        movzx      tmpd, word [src2q + xq * 2]
+        movd        xm1, tmpd
+        punpcklwd   xm0, xm1
+        psllw       xm0, xm4
+        movd [dstq + xq * 4], xm0
+        add          xq, 1
+        cmp          xq, wq
+        jl .loop_scalar
+
+    .end_line:
+        add       src1q, src1_strideq
+        add       src2q, src2_strideq
+        add        dstq, dst_strideq
+        sub          hd, 1
+        jg .loop_line
+
+    RET
+%endmacro
+
+;-----------------------------------------------------------------------------------------------
+; deinterleave_words(const uint8_t *src, uint8_t *dst1, uint8_t *dst2,
+;                    int width, int height, int srcStride,
+;                    int dst1Stride, int dst2Stride, int shift)
+;-----------------------------------------------------------------------------------------------
+%macro DEINTERLEAVE_WORDS 0
+cglobal deinterleave_words, 9, 11, 5, src, dst1, dst2, w, h, src_stride, dst1_stride, dst2_stride, shift, x, tmp
+    movsxdifnidn           wq, wd
+    movsxdifnidn  src_strideq, src_strided
+    movsxdifnidn dst1_strideq, dst1_strided
+    movsxdifnidn dst2_strideq, dst2_strided
+    movd                  xm4, shiftd
+
+.loop_line:
+    xor          xq, xq
+    mov        tmpq, wq
+    and        tmpq, ~(mmsize / 2 - 1)
+    jz .tail
+
+    .loop_simd:
+        movu         m0, [srcq + xq * 4         ]
+        movu         m1, [srcq + xq * 4 + mmsize]
+        ; sign extend both halves of each pair so that packssdw keeps
+        ; all 16 bits
+        pslld        m2, m0, 16
+        pslld        m3, m1, 16
+        psrad        m2, 16
+        psrad        m3, 16
+        psrad        m0, 16
+        psrad        m1, 16
+        packssdw     m2, m3
+        packssdw     m0, m1
+%if mmsize == 32
+        vpermq       m2, m2, q3120
+        vpermq       m0, m0, q3120
+%endif
+        psrlw        m2, xm4
+        psrlw        m0, xm4
+        movu [dst1q + xq * 2], m2
+        movu [dst2q + xq * 2], m0
+        add          xq, mmsize / 2
+        cmp          xq, tmpq
+        jl .loop_simd
+
+    .tail:
+        cmp          xq, wq
+        jge .end_line
+
+    .loop_scalar:
+        movd        xm0, [srcq + xq * 4]
+        psrlw       xm0, xm4
+        movd       tmpd, xm0
+        mov [dst1q + xq * 2], tmpw
+        shr        tmpd, 16
+        mov [dst2q + xq * 2], tmpw
+        add          xq, 1
+        cmp          xq, wq
+        jl .loop_scalar
+
+    .end_line:
+        add        srcq, src_strideq
+        add       dst1q, dst1_strideq
+        add       dst2q, dst2_strideq
+        sub          hd, 1
+        jg .loop_line
+
+    RET
+%endmacro
+
+;-----------------------------------------------------------------------------------------------
+; shift_words(const uint8_t *src, uint8_t *dst, int width, int height,
+;             int srcStride, int dstStride, int shift)
+;-----------------------------------------------------------------------------------------------
+%macro SHIFT_WORDS 0
+cglobal shift_words, 7, 9, 6, src, dst, w, h, src_stride, dst_stride, shift, x, tmp
+    movsxdifnidn          wq, wd
+    movsxdifnidn src_strideq, src_strided
+    movsxdifnidn dst_strideq, dst_strided
+
+    ; left shift in m4, right shift in m5, one of them is 0
+    mov        tmpd, shiftd
+    neg        tmpd
+    xor          xd, xd
+    test     shiftd, shiftd
+    cmovl    shiftd, xd
+    cmovg      tmpd, xd
+    movd        xm4, shiftd
+    movd        xm5, tmpd
+
+.loop_line:
+    xor          xq, xq
+    mov        tmpq, wq
+    and        tmpq, ~(mmsize / 2 - 1)
+    jz .tail
+
+    .loop_simd:
+        movu         m0, [srcq + xq * 2]
+        psllw        m0, xm4
+        psrlw        m0, xm5
+        movu [dstq + xq * 2], m0
+        add          xq, mmsize / 2
+        cmp          xq, tmpq
+        jl .loop_simd
+
+    .tail:
+        cmp          xq, wq
+        jge .end_line
+
+    .loop_scalar:
+        movzx      tmpd, word [srcq + xq * 2]
+        movd        xm0, tmpd
+        psllw       xm0, xm4
+        psrlw       xm0, xm5
+        movd       tmpd, xm0
+        mov [dstq + xq * 2], tmpw
+        add          xq, 1
+        cmp          xq, wq
+        jl .loop_scalar
+
+    .end_line:
+        add        srcq, src_strideq
+        add        dstq, dst_strideq
+        sub          hd, 1
+        jg .loop_line
+
+    RET
+%endmacro
+
+%if ARCH_X86_64
+INIT_XMM sse2
+INTERLEAVE_WORDS
+DEINTERLEAVE_WORDS
+SHIFT_WORDS
+
+%if HAVE_AVX2_EXTERNAL
+INIT_YMM avx2
+INTERLEAVE_WORDS
+DEINTERLEAVE_WORDS
+SHIFT_WORDS
+%endif
+%endif
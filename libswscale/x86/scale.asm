@@ -28,6 +28,12 @@ max_19bit_flt: times 4 dd 524287.0
 minshort:      times 8 dw 0x8000
 unicoeff:      times 4 dd 0x20000000
 
+; output order of the wide 4-tap and 8-tap horizontal adds
+hscale4_perm_avx2:   dd 0, 1, 4, 5, 2, 3, 6, 7
+hscale8_perm_avx2:   dd 0, 4, 1, 5, 2, 6, 3, 7
+hscale4_perm_avx512: dd 0, 1, 4, 5, 8, 9, 12, 13, 2, 3, 6, 7, 10, 11, 14, 15
+hscale8_perm_avx512: dd 0, 4, 8, 12, 1, 5, 9, 13, 2, 6, 10, 14, 3, 7, 11, 15
+
 SECTION .text
 
 ;-----------------------------------------------------------------------------
@@ -421,3 +427,167 @@ INIT_XMM ssse3
 SCALE_FUNCS2 6, 6, 8
 INIT_XMM sse4
 SCALE_FUNCS2 6, 6, 8
+
+%if ARCH_X86_64
+;-----------------------------------------------------------------------------
+; wide horizontal line scaling for filter sizes 4 and 8
+;
+; Same prototype and semantics as above, but each iteration produces mmsize/4
+; output pixels: the filter rows for all of them are multiplied in 2 (4-tap)
+; or 4 (8-tap) registers, added up horizontally within each 128-bit lane and
+; put back into pixel order with one vpermd. Up to mmsize/4-1 pixels past
+; dstW are written; initFilter() pads filter and filterPos for the reads.
+;-----------------------------------------------------------------------------
+
+; HSCALE_CHUNK xmm, first filterPos index, bytes per position
+; load the source bytes of 16/bytes_per_position consecutive positions
+%macro HSCALE_CHUNK 3
+%if %3 == 4 ; 4-tap from 8-bit
+    movsxd     pos0q, dword [fltposq+((%2)+0)*4]
+    movsxd     pos1q, dword [fltposq+((%2)+1)*4]
+    movd          %1, [srcq+pos0q]
+    pinsrd        %1, [srcq+pos1q], 1
+    movsxd     pos0q, dword [fltposq+((%2)+2)*4]
+    movsxd     pos1q, dword [fltposq+((%2)+3)*4]
+    pinsrd        %1, [srcq+pos0q], 2
+    pinsrd        %1, [srcq+pos1q], 3
+%elif %3 == 8 ; 4-tap from 9-16 bit or 8-tap from 8-bit
+    movsxd     pos0q, dword [fltposq+((%2)+0)*4]
+    movsxd     pos1q, dword [fltposq+((%2)+1)*4]
+    movq          %1, [srcq+pos0q*srcmul]
+    movhps        %1, [srcq+pos1q*srcmul]
+%else ; 8-tap from 9-16 bit
+    movsxd     pos0q, dword [fltposq+(%2)*4]
+    movu          %1, [srcq+pos0q*2]
+%endif
+%endmacro
+
+; HSCALE_ROW reg, first filterPos index, bytes per position
+; load the source pixels multiplied by one register worth of coefficients
+%macro HSCALE_ROW 3
+%assign %%rowbytes mmsize*srcmul/2
+%assign %%chunkpos 16/(%3)
+    HSCALE_CHUNK xm%1, %2, %3
+%if %%rowbytes >= 32
+    HSCALE_CHUNK  xm4, (%2)+%%chunkpos, %3
+    vinserti128  ym%1, ym%1, xm4, 1
+%endif
+%if %%rowbytes == 64
+    HSCALE_CHUNK  xm4, (%2)+%%chunkpos*2, %3
+    HSCALE_CHUNK  xm9, (%2)+%%chunkpos*3, %3
+    vinserti128   ym4, ym4, xm9, 1
+    vinserti64x4  m%1, m%1, ym4, 1
+%endif
+%if srcmul == 1
+%if mmsize == 64
+    pmovzxbw      m%1, ym%1                     ; byte -> word
+%else
+    pmovzxbw      m%1, xm%1                     ; byte -> word
+%endif
+%elif hscale_srcw == 16 ; unsigned -> signed, see above
+    psubw         m%1, m6
+%endif
+    pmaddwd       m%1, [filterq+mmsize*%1]
+%endmacro
+
+; HSCALE_HADDD dst, src, tmp: phaddd within each 128-bit lane
+%macro HSCALE_HADDD 3
+%if mmsize == 64 ; no 512-bit phaddd
+    shufps        m%3, m%1, m%2, q3131
+    shufps        m%1, m%1, m%2, q2020
+    paddd         m%1, m%3
+%else
+    phaddd        m%1, m%2
+%endif
+%endmacro
+
+; HSCALE_WIDE source_width, intermediate_nbits, filtersize
+%macro HSCALE_WIDE 3
+cglobal hscale%1to%2_%3, 6, 7, 10, pos0, dst, w, src, filter, fltpos, pos1
+%assign hscale_srcw %1
+%if %1 == 8
+%define srcmul 1
+%else
+%define srcmul 2
+%endif
+%if mmsize == 64
+    movu          m5, [hscale%3_perm_avx512]
+%else
+    movu          m5, [hscale%3_perm_avx2]
+%endif
+%if %1 == 16
+    vpbroadcastw  m6, [minshort]
+    vpbroadcastd  m7, [unicoeff]
+%endif
+%if %2 == 19
+    vpbroadcastd  m8, [max_19bit_int]
+%endif
+
+.loop:
+%if %3 == 4
+    HSCALE_ROW     0, 0,         4*srcmul
+    HSCALE_ROW     1, mmsize/8,  4*srcmul
+    HSCALE_HADDD   0, 1, 4
+%else ; %3 == 8
+    HSCALE_ROW     0, 0,          8*srcmul
+    HSCALE_ROW     1, mmsize/16,  8*srcmul
+    HSCALE_ROW     2, mmsize/8,   8*srcmul
+    HSCALE_ROW     3, mmsize*3/16, 8*srcmul
+    HSCALE_HADDD   0, 1, 4
+    HSCALE_HADDD   2, 3, 4
+    HSCALE_HADDD   0, 2, 4
+%endif ; %3 == 4/8
+    vpermd        m0, m5, m0                    ; back to pixel order
+%if %1 == 16 ; add 0x8000 * sum(coeffs), i.e. back from signed -> unsigned
+    paddd         m0, m7
+%endif
+
+    ; clip, store
+    psrad         m0, 14 + %1 - %2
+%if %2 == 15
+%if mmsize == 64
+    vpmovsdw  [dstq], m0
+%else
+    vextracti128 xm4, m0, 1
+    packssdw     xm0, xm4
+    movu      [dstq], xm0
+%endif
+    add         dstq, mmsize/2
+%else ; %2 == 19
+    pminsd        m0, m8
+    movu      [dstq], m0
+    add         dstq, mmsize
+%endif ; %2 == 15/19
+    add      fltposq, mmsize
+    add      filterq, mmsize*%3/2
+    sub           wd, mmsize/4
+    jg .loop
+    RET
+%endmacro
+
+; HSCALE_WIDES source_width
+%macro HSCALE_WIDES 1
+HSCALE_WIDE %1, 15, 4
+HSCALE_WIDE %1, 15, 8
+HSCALE_WIDE %1, 19, 4
+HSCALE_WIDE %1, 19, 8
+%endmacro
+
+%macro HSCALE_WIDES2 0
+HSCALE_WIDES  8
+HSCALE_WIDES  9
+HSCALE_WIDES 10
+HSCALE_WIDES 12
+HSCALE_WIDES 14
+HSCALE_WIDES 16
+%endmacro
+
+%if HAVE_AVX2_EXTERNAL
+INIT_YMM avx2
+HSCALE_WIDES2
+%endif
+%if HAVE_AVX512_EXTERNAL
+INIT_ZMM avx512
+HSCALE_WIDES2
+%endif
+%endif ; ARCH_X86_64
@@ -308,12 +308,18 @@ void ff_hscale ## from_bpc ## to ## to_bpc ## _ ## filter_n ## _ ## opt( \
     SCALE_FUNCS(X4, opt); \
     SCALE_FUNCS(X8, opt)
 
+#define SCALE_FUNCS_WIDE(opt) \
+    SCALE_FUNCS(4, opt); \
+    SCALE_FUNCS(8, opt)
+
 #if ARCH_X86_32
 SCALE_FUNCS_MMX(mmx);
 #endif
 SCALE_FUNCS_SSE(sse2);
 SCALE_FUNCS_SSE(ssse3);
 SCALE_FUNCS_SSE(sse4);
+SCALE_FUNCS_WIDE(avx2);
+SCALE_FUNCS_WIDE(avx512);
 
 #define VSCALEX_FUNC(size, opt) \
 void ff_yuv2planeX_ ## size ## _ ## opt(const int16_t *filter, int filterSize, \
@@ -323,6 +329,11 @@ void ff_yuv2planeX_ ## size ## _ ## opt(const int16_t *filter, int filterSize, \
     VSCALEX_FUNC(8,  opt); \
     VSCALEX_FUNC(9,  opt); \
     VSCALEX_FUNC(10, opt)
+#define VSCALEX_FUNCS_WIDE(opt) \
+    VSCALEX_FUNC(9,  opt); \
+    VSCALEX_FUNC(10, opt); \
+    VSCALEX_FUNC(12, opt); \
+    VSCALEX_FUNC(16, opt)
 
 #if ARCH_X86_32
 VSCALEX_FUNCS(mmxext);
@@ -331,6 +342,8 @@ VSCALEX_FUNCS(sse2);
 VSCALEX_FUNCS(sse4);
 VSCALEX_FUNC(16, sse4);
 VSCALEX_FUNCS(avx);
+VSCALEX_FUNCS_WIDE(avx2);
+VSCALEX_FUNCS_WIDE(avx512);
 
 #define VSCALE_FUNC(size, opt) \
 void ff_yuv2plane1_ ## size ## _ ## opt(const int16_t *src, uint8_t *dst, int dstW, \
@@ -379,6 +392,63 @@ INPUT_FUNCS(mmx);
 INPUT_FUNCS(sse2);
 INPUT_FUNCS(ssse3);
 INPUT_FUNCS(avx);
+INPUT_FUNC(rgba,  avx2);
+INPUT_FUNC(bgra,  avx2);
+INPUT_FUNC(argb,  avx2);
+INPUT_FUNC(abgr,  avx2);
+INPUT_FUNC(rgb24, avx2);
+INPUT_FUNC(bgr24, avx2);
+
+#if ARCH_X86_64
+static void fill_yuv2rgb_full_coeffs(const SwsContext *c, int32_t coeffs[6][8])
+{
+    int i;
+
+    for (i = 0; i < 8; i++) {
+        coeffs[0][i] = c->yuv2rgb_y_offset;
+        coeffs[1][i] = c->yuv2rgb_y_coeff;
+        coeffs[2][i] = c->yuv2rgb_v2r_coeff;
+        coeffs[3][i] = c->yuv2rgb_v2g_coeff;
+        coeffs[4][i] = c->yuv2rgb_u2g_coeff;
+        coeffs[5][i] = c->yuv2rgb_u2b_coeff;
+    }
+}
+
+#define YUV2RGB_FULL_X_FUNC(fmt, opt) \
+void ff_yuv2 ## fmt ## _full_X_ ## opt(const int16_t *lumFilter, \
+                                      const int16_t **lumSrc, int lumFilterSize, \
+                                      const int16_t *chrFilter, \
+                                      const int16_t **chrUSrc, \
+                                      const int16_t **chrVSrc, int chrFilterSize, \
+                                      const int16_t **alpSrc, uint8_t *dest, \
+                                      int dstW, const int32_t *coeffs); \
+static void yuv2 ## fmt ## _full_X_ ## opt(SwsContext *c, const int16_t *lumFilter, \
+                                          const int16_t **lumSrc, int lumFilterSize, \
+                                          const int16_t *chrFilter, \
+                                          const int16_t **chrUSrc, \
+                                          const int16_t **chrVSrc, int chrFilterSize, \
+                                          const int16_t **alpSrc, uint8_t *dest, \
+                                          int dstW, int y) \
+{ \
+    DECLARE_ALIGNED(32, int32_t, coeffs)[6][8]; \
+    fill_yuv2rgb_full_coeffs(c, coeffs); \
+    ff_yuv2 ## fmt ## _full_X_ ## opt(lumFilter, lumSrc, lumFilterSize, \
+                                     chrFilter, chrUSrc, chrVSrc, chrFilterSize, \
+                                     alpSrc, dest, dstW, coeffs[0]); \
+}
+#define YUV2RGB_FULL_X_FUNCS(opt) \
+    YUV2RGB_FULL_X_FUNC(rgba32, opt) \
+    YUV2RGB_FULL_X_FUNC(rgbx32, opt) \
+    YUV2RGB_FULL_X_FUNC(bgra32, opt) \
+    YUV2RGB_FULL_X_FUNC(bgrx32, opt) \
+    YUV2RGB_FULL_X_FUNC(argb32, opt) \
+    YUV2RGB_FULL_X_FUNC(xrgb32, opt) \
+    YUV2RGB_FULL_X_FUNC(abgr32, opt) \
+    YUV2RGB_FULL_X_FUNC(xbgr32, opt)
+
+YUV2RGB_FULL_X_FUNCS(sse4)
+YUV2RGB_FULL_X_FUNCS(avx2)
+#endif /* ARCH_X86_64 */
 
 av_cold void ff_sws_init_swscale_x86(SwsContext *c)
 {
@@ -440,12 +510,44 @@ switch(c->dstBpc){ \
     case 8:                                      vscalefn = ff_yuv2plane1_8_  ## opt1;  break; \
     default: av_assert0(c->dstBpc>8); \
     }
+/* the wide kernels only cover the fixed filter sizes and 9-16 bit output,
+ * anything else keeps the SSE versions */
+#define ASSIGN_WIDE_SCALE_FUNC(hscalefn, filtersize, opt) \
+    switch (filtersize) { \
+    case 4:  ASSIGN_SCALE_FUNC2(hscalefn, 4, opt, opt); break; \
+    case 8:  ASSIGN_SCALE_FUNC2(hscalefn, 8, opt, opt); break; \
+    }
+#define ASSIGN_WIDE_VSCALEX_FUNC(vscalefn, opt) \
+    switch(c->dstBpc){ \
+    case 16: if (!isBE(c->dstFormat))            vscalefn = ff_yuv2planeX_16_ ## opt; break; \
+    case 12: if (!isBE(c->dstFormat))            vscalefn = ff_yuv2planeX_12_ ## opt; break; \
+    case 10: if (!isBE(c->dstFormat) && c->dstFormat != AV_PIX_FMT_P010LE) vscalefn = ff_yuv2planeX_10_ ## opt; break; \
+    case 9:  if (!isBE(c->dstFormat))            vscalefn = ff_yuv2planeX_9_  ## opt; break; \
+    }
 #define case_rgb(x, X, opt) \
         case AV_PIX_FMT_ ## X: \
             c->lumToYV12 = ff_ ## x ## ToY_ ## opt; \
             if (!c->chrSrcHSubSample) \
                 c->chrToYV12 = ff_ ## x ## ToUV_ ## opt; \
             break
+#define case_rgb_full_X(fmt, x, a, opt) \
+        case AV_PIX_FMT_ ## fmt: \
+            c->yuv2packedX = CONFIG_SWSCALE_ALPHA && c->needAlpha ? \
+                             yuv2 ## a ## 32_full_X_ ## opt : \
+                             yuv2 ## x ## 32_full_X_ ## opt; \
+            break
+#define ASSIGN_YUV2RGB_FULL_X_FUNC(opt) do { \
+    if (c->flags & SWS_FULL_CHR_H_INT) { \
+        switch (c->dstFormat) { \
+        case_rgb_full_X(RGBA, rgbx, rgba, opt); \
+        case_rgb_full_X(BGRA, bgrx, bgra, opt); \
+        case_rgb_full_X(ARGB, xrgb, argb, opt); \
+        case_rgb_full_X(ABGR, xbgr, abgr, opt); \
+        default: \
+            break; \
+        } \
+    } \
+} while (0)
 #if ARCH_X86_32
     if (EXTERNAL_MMX(cpu_flags)) {
         ASSIGN_MMX_SCALE_FUNC(c->hyScale, c->hLumFilterSize, mmx, mmx);
@@ -550,6 +652,9 @@ switch(c->dstBpc){ \
                             HAVE_ALIGNED_STACK || ARCH_X86_64);
         if (c->dstBpc == 16 && !isBE(c->dstFormat))
             c->yuv2plane1 = ff_yuv2plane1_16_sse4;
+#if ARCH_X86_64
+        ASSIGN_YUV2RGB_FULL_X_FUNC(sse4);
+#endif
     }
 
     if (EXTERNAL_AVX(cpu_flags)) {
@@ -580,4 +685,30 @@ switch(c->dstBpc){ \
             break;
         }
     }
+
+#if ARCH_X86_64
+    if (EXTERNAL_AVX2_FAST(cpu_flags)) {
+        ASSIGN_WIDE_SCALE_FUNC(c->hyScale, c->hLumFilterSize, avx2);
+        ASSIGN_WIDE_SCALE_FUNC(c->hcScale, c->hChrFilterSize, avx2);
+        ASSIGN_WIDE_VSCALEX_FUNC(c->yuv2planeX, avx2);
+        ASSIGN_YUV2RGB_FULL_X_FUNC(avx2);
+
+        switch (c->srcFormat) {
+        case_rgb(rgb24, RGB24, avx2);
+        case_rgb(bgr24, BGR24, avx2);
+        case_rgb(bgra,  BGRA,  avx2);
+        case_rgb(rgba,  RGBA,  avx2);
+        case_rgb(abgr,  ABGR,  avx2);
+        case_rgb(argb,  ARGB,  avx2);
+        default:
+            break;
+        }
+    }
+
+    if (EXTERNAL_AVX512(cpu_flags)) {
+        ASSIGN_WIDE_SCALE_FUNC(c->hyScale, c->hLumFilterSize, avx512);
+        ASSIGN_WIDE_SCALE_FUNC(c->hcScale, c->hChrFilterSize, avx512);
+        ASSIGN_WIDE_VSCALEX_FUNC(c->yuv2planeX, avx512);
+    }
+#endif
 }
@@ -0,0 +1,108 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <string.h>
+
+#include "libavfilter/af_biquads.h"
+#include "libavutil/common.h"
+#include "libavutil/mem.h"
+
+#include "checkasm.h"
+
+#define LEN 256
+#define NB_LANES BIQUADS_NB_LANES
+
+static void fill_input(uint8_t *buf, int is_float)
+{
+    int i;
+
+    for (i = 0; i < LEN; i++) {
+        if (is_float)
+            ((float  *)buf)[i] = (float)rnd() / UINT_MAX * 2.f - 1.f;
+        else
+            ((double *)buf)[i] = (double)rnd() / UINT_MAX * 2.  - 1.;
+    }
+}
+
+static void check_lanes(int is_float)
+{
+    /* a stable lowpass-ish section, with a different mix on every lane */
+    static const double b[3] = { 0.5, -0.9, 0.41 };
+    static const double a[2] = { -1.8, 0.81 };
+    static const int lens[] = { 0, 1, 2, 3, 4, 5, 7, 8, 13, LEN - 4, LEN - 1, LEN };
+    LOCAL_ALIGNED_32(uint8_t, src,  [NB_LANES * LEN * 8]);
+    LOCAL_ALIGNED_32(uint8_t, dst0, [NB_LANES * LEN * 8]);
+    LOCAL_ALIGNED_32(uint8_t, dst1, [NB_LANES * LEN * 8]);
+    uint8_t *srcp[NB_LANES], *dst0p[NB_LANES], *dst1p[NB_LANES];
+    double coeffs[7][NB_LANES];
+    double state[4][NB_LANES], state0[4][NB_LANES], state1[4][NB_LANES];
+    BiquadsDSPContext dsp;
+    int l, i;
+
+    declare_func(void, uint8_t *const *dst, uint8_t *const *src, int len,
+                 double *state, const double *coeffs);
+
+    ff_biquads_dsp_init(&dsp);
+    if (!check_func(is_float ? dsp.filter_lanes_flt : dsp.filter_lanes_dbl,
+                    "biquad_lanes_%s", is_float ? "flt" : "dbl"))
+        return;
+
+    for (l = 0; l < NB_LANES; l++) {
+        double mix = (rnd() & 1) ? 1. : (double)rnd() / UINT_MAX;
+
+        srcp[l]  = src  + l * LEN * 8;
+        dst0p[l] = dst0 + l * LEN * 8;
+        dst1p[l] = dst1 + l * LEN * 8;
+        fill_input(srcp[l], is_float);
+        coeffs[0][l] =  b[0];
+        coeffs[1][l] =  b[1];
+        coeffs[2][l] =  b[2];
+        coeffs[3][l] = -a[0];
+        coeffs[4][l] = -a[1];
+        coeffs[5][l] =  mix;
+        coeffs[6][l] =  1. - mix;
+        for (i = 0; i < 4; i++)
+            state[i][l] = (double)rnd() / UINT_MAX - 0.5;
+    }
+
+    /* short, odd and multiple of 4 lengths, the ones past len must be untouched */
+    for (i = 0; i < FF_ARRAY_ELEMS(lens); i++) {
+        memset(dst0, 0, NB_LANES * LEN * 8);
+        memset(dst1, 0, NB_LANES * LEN * 8);
+        memcpy(state0, state, sizeof(state));
+        memcpy(state1, state, sizeof(state));
+        call_ref(dst0p, srcp, lens[i], &state0[0][0], &coeffs[0][0]);
+        call_new(dst1p, srcp, lens[i], &state1[0][0], &coeffs[0][0]);
+        if (memcmp(dst0, dst1, NB_LANES * LEN * 8) || memcmp(state0, state1, sizeof(state0))) {
+            fprintf(stderr, "biquad_lanes: len %d differs\n", lens[i]);
+            fail();
+            break;
+        }
+    }
+
+    bench_new(dst1p, srcp, LEN, &state1[0][0], &coeffs[0][0]);
+}
+
+void checkasm_check_biquads(void)
+{
+    check_lanes(1);
+    report("biquad_lanes_flt");
+
+    check_lanes(0);
+    report("biquad_lanes_dbl");
+}
@@ -0,0 +1,92 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+
+#include "checkasm.h"
+
+#define TX_FLOAT
+#include "libavutil/cpu.h"
+#include "libavutil/internal.h"
+#include "libavutil/mem.h"
+#include "libavutil/tx_priv.h"
+
+#define MAX_BITS 14
+
+#define randomize_buffer(buf, len)                          \
+    do {                                                    \
+        for (int i = 0; i < len; i++) {                     \
+            buf[i].re = (rnd() & 0xFFFF) / 32768.0f - 1.0f; \
+            buf[i].im = (rnd() & 0xFFFF) / 32768.0f - 1.0f; \
+        }                                                   \
+    } while (0)
+
+static void check_fft(void)
+{
+    LOCAL_ALIGNED_32(AVComplexFloat, in,  [1 << MAX_BITS]);
+    LOCAL_ALIGNED_32(AVComplexFloat, ref, [1 << MAX_BITS]);
+    LOCAL_ALIGNED_32(AVComplexFloat, new, [1 << MAX_BITS]);
+
+    declare_func(void, AVComplexFloat *z, int nbits);
+
+    for (int nbits = 2; nbits <= MAX_BITS; nbits++) {
+        const int len = 1 << nbits;
+        const int cpu_flags = av_get_cpu_flags();
+        AVTXContext *s, *c;
+        av_tx_fn fn, c_fn;
+
+        if (av_tx_init(&s, &fn, AV_TX_FLOAT_FFT, 0, len, NULL, 0) < 0)
+            return;
+
+        /* The reference version checkasm picks may be any previously
+         * tested one, each wanting its input in its own order, so compute
+         * the reference with the whole C transform instead. */
+        av_force_cpu_flags(0);
+        if (av_tx_init(&c, &c_fn, AV_TX_FLOAT_FFT, 0, len, NULL, 0) < 0) {
+            av_force_cpu_flags(cpu_flags);
+            av_tx_uninit(&s);
+            return;
+        }
+        av_force_cpu_flags(cpu_flags);
+
+        if (check_func(s->ptwo_fft, "fft_%d", len)) {
+            randomize_buffer(in, len);
+
+            for (int i = 0; i < len; i++)
+                new[s->revtab[i]] = in[i];
+
+            c_fn(c, ref, in, sizeof(*in));
+            call_new(new, nbits);
+            if (!float_near_abs_eps_array((float *)ref, (float *)new,
+                                          1e-5f * nbits * (1 << (nbits / 2)),
+                                          2 * len))
+                fail();
+            bench_new(new, nbits);
+        }
+
+        av_tx_uninit(&c);
+        av_tx_uninit(&s);
+    }
+
+    report("fft");
+}
+
+void checkasm_check_av_tx(void)
+{
+    check_fft();
+}
@@ -0,0 +1,154 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+
+#include "libavutil/common.h"
+#include "libavutil/mem.h"
+
+#include "libswresample/resample.h"
+
+#include "checkasm.h"
+
+#define PHASE_COUNT    32
+#define MAX_FILTER_LEN 64
+#define FILTER_ALLOC   FFALIGN(MAX_FILTER_LEN, 16)
+#define DST_SAMPLES    128
+/* 44100 -> 48000 Hz, room for the filter and for vector overreads */
+#define SRC_SAMPLES    (DST_SAMPLES * 147 / 160 + MAX_FILTER_LEN + 64)
+
+static void fill_buffers(enum AVSampleFormat fmt, uint8_t *filter,
+                         int filter_length, uint8_t *src)
+{
+    int i, j;
+
+    memset(filter, 0, (PHASE_COUNT + 1) * FILTER_ALLOC * 8);
+    for (i = 0; i <= PHASE_COUNT; i++) {
+        for (j = 0; j < filter_length; j++) {
+            int k = i * FILTER_ALLOC + j;
+            switch (fmt) {
+            case AV_SAMPLE_FMT_S16P:
+                /* keep the 32 bit sums from wrapping */
+                ((int16_t *)filter)[k] = (int16_t)rnd() >> 6;
+                break;
+            case AV_SAMPLE_FMT_S32P:
+                ((int32_t *)filter)[k] = (int32_t)rnd() >> 12;
+                break;
+            case AV_SAMPLE_FMT_FLTP:
+                ((float  *)filter)[k] = (float)rnd() / UINT_MAX - 0.5f;
+                break;
+            case AV_SAMPLE_FMT_DBLP:
+                ((double *)filter)[k] = (double)rnd() / UINT_MAX - 0.5;
+                break;
+            }
+        }
+    }
+
+    for (i = 0; i < SRC_SAMPLES; i++) {
+        switch (fmt) {
+        case AV_SAMPLE_FMT_S16P: ((int16_t *)src)[i] = rnd();                           break;
+        case AV_SAMPLE_FMT_S32P: ((int32_t *)src)[i] = rnd();                           break;
+        case AV_SAMPLE_FMT_FLTP: ((float   *)src)[i] = (float)rnd() / UINT_MAX - 0.5f;  break;
+        case AV_SAMPLE_FMT_DBLP: ((double  *)src)[i] = (double)rnd() / UINT_MAX - 0.5;  break;
+        }
+    }
+}
+
+static int compare_output(enum AVSampleFormat fmt, const uint8_t *dst0,
+                          const uint8_t *dst1, int filter_length)
+{
+    switch (fmt) {
+    case AV_SAMPLE_FMT_FLTP:
+        return float_near_abs_eps_array((const float *)dst0, (const float *)dst1,
+                                        filter_length * 1.0e-6f, DST_SAMPLES);
+    case AV_SAMPLE_FMT_DBLP:
+        return double_near_abs_eps_array((const double *)dst0, (const double *)dst1,
+                                         filter_length * 1.0e-14, DST_SAMPLES);
+    default:
+        return !memcmp(dst0, dst1, DST_SAMPLES * av_get_bytes_per_sample(fmt));
+    }
+}
+
+static void check_resample(enum AVSampleFormat fmt, const char *name)
+{
+    static const int filter_lengths[] = { 2, 8, 18, 32, 46, MAX_FILTER_LEN };
+    LOCAL_ALIGNED_32(uint8_t, filter, [(PHASE_COUNT + 1) * FILTER_ALLOC * 8]);
+    LOCAL_ALIGNED_32(uint8_t, src,  [SRC_SAMPLES * 8]);
+    LOCAL_ALIGNED_32(uint8_t, dst0, [DST_SAMPLES * 8]);
+    LOCAL_ALIGNED_32(uint8_t, dst1, [DST_SAMPLES * 8]);
+    ResampleContext c = { 0 };
+    int linear, i;
+
+    declare_func_emms(AV_CPU_FLAG_MMX, int, ResampleContext *c, void *dst,
+                      const void *src, int n, int update_ctx);
+
+    c.format       = fmt;
+    c.felem_size   = av_get_bytes_per_sample(fmt);
+    c.filter_bank  = filter;
+    c.filter_alloc = FILTER_ALLOC;
+    c.phase_count  = PHASE_COUNT;
+    /* the increments resample_init() sets up for 44100 -> 48000 Hz */
+    c.src_incr     =   5 << 18;
+    c.dst_incr     = 147 << 18;
+    c.dst_incr_div = c.dst_incr / c.src_incr;
+    c.dst_incr_mod = c.dst_incr % c.src_incr;
+    swri_resample_dsp_init(&c);
+
+    for (linear = 0; linear < 2; linear++) {
+        if (!check_func(linear ? c.dsp.resample_linear : c.dsp.resample_common,
+                        "resample_%s_%s", linear ? "linear" : "common", name))
+            continue;
+
+        for (i = 0; i < FF_ARRAY_ELEMS(filter_lengths); i++) {
+            ResampleContext c0, c1;
+            int ret0, ret1;
+
+            c.filter_length = filter_lengths[i];
+            c.index         = rnd() % PHASE_COUNT;
+            c.frac          = rnd() % c.src_incr;
+            fill_buffers(fmt, filter, c.filter_length, src);
+            memset(dst0, 0, DST_SAMPLES * 8);
+            memset(dst1, 0, DST_SAMPLES * 8);
+
+            c0 = c1 = c;
+            ret0 = call_ref(&c0, dst0, src, DST_SAMPLES, 1);
+            ret1 = call_new(&c1, dst1, src, DST_SAMPLES, 1);
+            if (ret0 != ret1 || c0.index != c1.index || c0.frac != c1.frac ||
+                !compare_output(fmt, dst0, dst1, c.filter_length))
+                fail();
+
+            if (c.filter_length == 32)
+                bench_new(&c1, dst1, src, DST_SAMPLES, 0);
+        }
+    }
+}
+
+void checkasm_check_sw_resample(void)
+{
+    check_resample(AV_SAMPLE_FMT_S16P, "int16");
+    report("int16");
+
+    check_resample(AV_SAMPLE_FMT_S32P, "int32");
+    report("int32");
+
+    check_resample(AV_SAMPLE_FMT_FLTP, "float");
+    report("float");
+
+    check_resample(AV_SAMPLE_FMT_DBLP, "double");
+    report("double");
+}
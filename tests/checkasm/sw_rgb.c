@@ -22,8 +22,11 @@
 #include "libavutil/common.h"
 #include "libavutil/intreadwrite.h"
 #include "libavutil/mem.h"
+#include "libavutil/pixdesc.h"
 
 #include "libswscale/rgb2rgb.h"
+#include "libswscale/swscale.h"
+#include "libswscale/swscale_internal.h"
 
 #include "checkasm.h"
 
@@ -179,8 +182,269 @@ static void check_interleave_bytes(void)
     }
 }
 
+static void check_words(void)
+{
+    LOCAL_ALIGNED_16(uint16_t, src0, [2 * MAX_STRIDE * MAX_HEIGHT]);
+    LOCAL_ALIGNED_16(uint16_t, src1, [MAX_STRIDE * MAX_HEIGHT]);
+    LOCAL_ALIGNED_16(uint16_t, dst0_a, [2 * MAX_STRIDE * MAX_HEIGHT]);
+    LOCAL_ALIGNED_16(uint16_t, dst1_a, [2 * MAX_STRIDE * MAX_HEIGHT]);
+    LOCAL_ALIGNED_16(uint16_t, dst0_b, [MAX_STRIDE * MAX_HEIGHT]);
+    LOCAL_ALIGNED_16(uint16_t, dst1_b, [MAX_STRIDE * MAX_HEIGHT]);
+    static const int shifts[] = { 0, 2, 4, 6 };
+    int i;
+
+    randomize_buffers((uint8_t *)src0, 4 * MAX_STRIDE * MAX_HEIGHT);
+    randomize_buffers((uint8_t *)src1, 2 * MAX_STRIDE * MAX_HEIGHT);
+
+    if (check_func(interleaveWords, "interleave_words")) {
+        declare_func(void, const uint8_t *, const uint8_t *, uint8_t *,
+                     int, int, int, int, int, int);
+
+        for (i = 0; i <= 16; i++) {
+            // Try all widths [1,16], and try one random width.
+            int w     = i > 0 ? i : (1 + (rnd() % (MAX_STRIDE - 2)));
+            int h     = 1 + (rnd() % (MAX_HEIGHT - 2));
+            int shift = shifts[i & 3];
+
+            memset(dst0_a, 0, 4 * MAX_STRIDE * MAX_HEIGHT);
+            memset(dst1_a, 0, 4 * MAX_STRIDE * MAX_HEIGHT);
+            call_ref((uint8_t *)src0, (uint8_t *)src1, (uint8_t *)dst0_a, w, h,
+                     2 * MAX_STRIDE, 2 * MAX_STRIDE, 4 * MAX_STRIDE, shift);
+            call_new((uint8_t *)src0, (uint8_t *)src1, (uint8_t *)dst1_a, w, h,
+                     2 * MAX_STRIDE, 2 * MAX_STRIDE, 4 * MAX_STRIDE, shift);
+            // Check one pixel pair past the end, to catch overwrites.
+            checkasm_check(uint16_t, dst0_a, 4 * MAX_STRIDE, dst1_a, 4 * MAX_STRIDE,
+                           2 * w + 2, h + 1, "dst");
+        }
+        bench_new((uint8_t *)src0, (uint8_t *)src1, (uint8_t *)dst1_a, MAX_STRIDE,
+                  MAX_HEIGHT, 2 * MAX_STRIDE, 2 * MAX_STRIDE, 4 * MAX_STRIDE, 6);
+    }
+
+    if (check_func(deinterleaveWords, "deinterleave_words")) {
+        declare_func(void, const uint8_t *, uint8_t *, uint8_t *,
+                     int, int, int, int, int, int);
+
+        for (i = 0; i <= 16; i++) {
+            int w     = i > 0 ? i : (1 + (rnd() % (MAX_STRIDE - 2)));
+            int h     = 1 + (rnd() % (MAX_HEIGHT - 2));
+            int shift = shifts[i & 3];
+
+            memset(dst0_a, 0, 2 * MAX_STRIDE * MAX_HEIGHT);
+            memset(dst1_a, 0, 2 * MAX_STRIDE * MAX_HEIGHT);
+            memset(dst0_b, 0, 2 * MAX_STRIDE * MAX_HEIGHT);
+            memset(dst1_b, 0, 2 * MAX_STRIDE * MAX_HEIGHT);
+            call_ref((uint8_t *)src0, (uint8_t *)dst0_a, (uint8_t *)dst0_b, w, h,
+                     4 * MAX_STRIDE, 2 * MAX_STRIDE, 2 * MAX_STRIDE, shift);
+            call_new((uint8_t *)src0, (uint8_t *)dst1_a, (uint8_t *)dst1_b, w, h,
+                     4 * MAX_STRIDE, 2 * MAX_STRIDE, 2 * MAX_STRIDE, shift);
+            checkasm_check(uint16_t, dst0_a, 2 * MAX_STRIDE, dst1_a, 2 * MAX_STRIDE,
+                           w + 1, h + 1, "dst1");
+            checkasm_check(uint16_t, dst0_b, 2 * MAX_STRIDE, dst1_b, 2 * MAX_STRIDE,
+                           w + 1, h + 1, "dst2");
+        }
+        bench_new((uint8_t *)src0, (uint8_t *)dst1_a, (uint8_t *)dst1_b, MAX_STRIDE,
+                  MAX_HEIGHT, 4 * MAX_STRIDE, 2 * MAX_STRIDE, 2 * MAX_STRIDE, 6);
+    }
+
+    if (check_func(shiftWords, "shift_words")) {
+        declare_func(void, const uint8_t *, uint8_t *, int, int, int, int, int);
+
+        for (i = 0; i <= 16; i++) {
+            int w     = i > 0 ? i : (1 + (rnd() % (MAX_STRIDE - 2)));
+            int h     = 1 + (rnd() % (MAX_HEIGHT - 2));
+            int shift = (i & 4) ? -shifts[i & 3] : shifts[i & 3];
+
+            memset(dst0_b, 0, 2 * MAX_STRIDE * MAX_HEIGHT);
+            memset(dst1_b, 0, 2 * MAX_STRIDE * MAX_HEIGHT);
+            call_ref((uint8_t *)src1, (uint8_t *)dst0_b, w, h,
+                     2 * MAX_STRIDE, 2 * MAX_STRIDE, shift);
+            call_new((uint8_t *)src1, (uint8_t *)dst1_b, w, h,
+                     2 * MAX_STRIDE, 2 * MAX_STRIDE, shift);
+            checkasm_check(uint16_t, dst0_b, 2 * MAX_STRIDE, dst1_b, 2 * MAX_STRIDE,
+                           w + 1, h + 1, "dst");
+        }
+        bench_new((uint8_t *)src1, (uint8_t *)dst1_b, MAX_STRIDE, MAX_HEIGHT,
+                  2 * MAX_STRIDE, 2 * MAX_STRIDE, -6);
+    }
+}
+
+static const enum AVPixelFormat rgb_formats[] = {
+    AV_PIX_FMT_RGB24, AV_PIX_FMT_BGR24,
+    AV_PIX_FMT_RGBA,  AV_PIX_FMT_BGRA,
+    AV_PIX_FMT_ARGB,  AV_PIX_FMT_ABGR,
+};
+
+static void check_rgb_to_y(struct SwsContext *ctx)
+{
+    int i, j;
+    // padded for the vector overreads and overwrites
+    LOCAL_ALIGNED_32(uint8_t, src, [(MAX_STRIDE + 16) * 4]);
+    LOCAL_ALIGNED_32(int16_t, dst0, [MAX_STRIDE + 16]);
+    LOCAL_ALIGNED_32(int16_t, dst1, [MAX_STRIDE + 16]);
+
+    declare_func_emms(AV_CPU_FLAG_MMX, void, uint8_t *dst, const uint8_t *src,
+                      const uint8_t *unused1, const uint8_t *unused2, int width,
+                      uint32_t *rgb2yuv);
+
+    randomize_buffers(src, (MAX_STRIDE + 16) * 4);
+
+    for (i = 0; i < FF_ARRAY_ELEMS(rgb_formats); i++) {
+        const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(rgb_formats[i]);
+
+        ctx->srcFormat = rgb_formats[i];
+        ff_getSwsFunc(ctx);
+
+        if (check_func(ctx->lumToYV12, "%s_to_y", desc->name)) {
+            for (j = 0; j < FF_ARRAY_ELEMS(width); j++) {
+                memset(dst0, 0, (MAX_STRIDE + 16) * sizeof(dst0[0]));
+                memset(dst1, 0, (MAX_STRIDE + 16) * sizeof(dst1[0]));
+                call_ref((uint8_t *)dst0, src, NULL, NULL, width[j],
+                         (uint32_t *)ctx->input_rgb2yuv_table);
+                call_new((uint8_t *)dst1, src, NULL, NULL, width[j],
+                         (uint32_t *)ctx->input_rgb2yuv_table);
+                if (memcmp(dst0, dst1, width[j] * sizeof(dst0[0])))
+                    fail();
+            }
+            bench_new((uint8_t *)dst0, src, NULL, NULL, MAX_STRIDE,
+                      (uint32_t *)ctx->input_rgb2yuv_table);
+        }
+    }
+}
+
+static void check_rgb_to_uv(struct SwsContext *ctx)
+{
+    int i, j;
+    LOCAL_ALIGNED_32(uint8_t, src, [(MAX_STRIDE + 16) * 4]);
+    LOCAL_ALIGNED_32(int16_t, dst0_u, [MAX_STRIDE + 16]);
+    LOCAL_ALIGNED_32(int16_t, dst0_v, [MAX_STRIDE + 16]);
+    LOCAL_ALIGNED_32(int16_t, dst1_u, [MAX_STRIDE + 16]);
+    LOCAL_ALIGNED_32(int16_t, dst1_v, [MAX_STRIDE + 16]);
+
+    declare_func_emms(AV_CPU_FLAG_MMX, void, uint8_t *dstU, uint8_t *dstV,
+                      const uint8_t *unused, const uint8_t *src1,
+                      const uint8_t *src2, int width, uint32_t *rgb2yuv);
+
+    randomize_buffers(src, (MAX_STRIDE + 16) * 4);
+
+    for (i = 0; i < FF_ARRAY_ELEMS(rgb_formats); i++) {
+        const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(rgb_formats[i]);
+
+        ctx->srcFormat        = rgb_formats[i];
+        ctx->chrSrcHSubSample = 0;
+        ff_getSwsFunc(ctx);
+
+        if (check_func(ctx->chrToYV12, "%s_to_uv", desc->name)) {
+            for (j = 0; j < FF_ARRAY_ELEMS(width); j++) {
+                memset(dst0_u, 0, (MAX_STRIDE + 16) * sizeof(dst0_u[0]));
+                memset(dst0_v, 0, (MAX_STRIDE + 16) * sizeof(dst0_v[0]));
+                memset(dst1_u, 0, (MAX_STRIDE + 16) * sizeof(dst1_u[0]));
+                memset(dst1_v, 0, (MAX_STRIDE + 16) * sizeof(dst1_v[0]));
+                call_ref((uint8_t *)dst0_u, (uint8_t *)dst0_v, NULL, src, src,
+                         width[j], (uint32_t *)ctx->input_rgb2yuv_table);
+                call_new((uint8_t *)dst1_u, (uint8_t *)dst1_v, NULL, src, src,
+                         width[j], (uint32_t *)ctx->input_rgb2yuv_table);
+                if (memcmp(dst0_u, dst1_u, width[j] * sizeof(dst0_u[0])) ||
+                    memcmp(dst0_v, dst1_v, width[j] * sizeof(dst0_v[0])))
+                    fail();
+            }
+            bench_new((uint8_t *)dst0_u, (uint8_t *)dst0_v, NULL, src, src,
+                      MAX_STRIDE, (uint32_t *)ctx->input_rgb2yuv_table);
+        }
+    }
+}
+
+static void check_yuv2rgb_full_X(struct SwsContext *ctx)
+{
+#define MAX_VFILTER_SIZE 8
+#define LINE_PIXELS (MAX_STRIDE + 16)
+    static const enum AVPixelFormat formats[] = {
+        AV_PIX_FMT_RGBA, AV_PIX_FMT_BGRA, AV_PIX_FMT_ARGB, AV_PIX_FMT_ABGR,
+    };
+    static const int filter_sizes[] = { 1, 2, 3, 4, 8 };
+    static const int widths[] = { MAX_STRIDE, MAX_STRIDE - 3, 5 };
+
+    int i, j, fi, alpha, fsi, wi;
+    const int16_t *lum[MAX_VFILTER_SIZE], *chr_u[MAX_VFILTER_SIZE];
+    const int16_t *chr_v[MAX_VFILTER_SIZE], *alp[MAX_VFILTER_SIZE];
+
+    // 15 bit input, padded for the vector overreads; the filters have one
+    // extra coefficient which may be read for odd sizes
+    LOCAL_ALIGNED_32(int16_t, src_pixels, [4 * MAX_VFILTER_SIZE * LINE_PIXELS]);
+    LOCAL_ALIGNED_32(int16_t, lum_filter, [MAX_VFILTER_SIZE + 1]);
+    LOCAL_ALIGNED_32(int16_t, chr_filter, [MAX_VFILTER_SIZE + 1]);
+    LOCAL_ALIGNED_32(uint8_t, dst0, [LINE_PIXELS * 4]);
+    LOCAL_ALIGNED_32(uint8_t, dst1, [LINE_PIXELS * 4]);
+
+    declare_func(void, SwsContext *c, const int16_t *lumFilter,
+                 const int16_t **lumSrc, int lumFilterSize,
+                 const int16_t *chrFilter, const int16_t **chrUSrc,
+                 const int16_t **chrVSrc, int chrFilterSize,
+                 const int16_t **alpSrc, uint8_t *dest, int dstW, int y);
+
+    for (i = 0; i < 4 * MAX_VFILTER_SIZE * LINE_PIXELS; i++)
+        src_pixels[i] = rnd() & 0x7FFF;
+    for (i = 0; i < MAX_VFILTER_SIZE; i++) {
+        lum[i]   = src_pixels + (4 * i + 0) * LINE_PIXELS;
+        chr_u[i] = src_pixels + (4 * i + 1) * LINE_PIXELS;
+        chr_v[i] = src_pixels + (4 * i + 2) * LINE_PIXELS;
+        alp[i]   = src_pixels + (4 * i + 3) * LINE_PIXELS;
+    }
+
+    ctx->flags |= SWS_FULL_CHR_H_INT;
+    for (fi = 0; fi < FF_ARRAY_ELEMS(formats); fi++) {
+        for (alpha = 0; alpha <= 1; alpha++) {
+            const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(formats[fi]);
+
+            ctx->dstFormat = formats[fi];
+            ctx->needAlpha = alpha;
+            ff_getSwsFunc(ctx);
+
+            if (!check_func(ctx->yuv2packedX, "yuv2%s_full_X%s", desc->name,
+                            alpha ? "" : "_noalpha"))
+                continue;
+
+            for (fsi = 0; fsi < FF_ARRAY_ELEMS(filter_sizes); fsi++) {
+                const int lum_size = filter_sizes[fsi];
+                const int chr_size = filter_sizes[FF_ARRAY_ELEMS(filter_sizes) - 1 - fsi];
+                int lum_sum = 0, chr_sum = 0;
+
+                // coefficients around the 1.0 point (1 << 12), with some
+                // overshoot to reach the clipping on both ends
+                for (j = 0; j <= MAX_VFILTER_SIZE; j++) {
+                    lum_filter[j] = (1 << 12) / lum_size + (int)(rnd() % 2048) - 1024;
+                    chr_filter[j] = (1 << 12) / chr_size + (int)(rnd() % 2048) - 1024;
+                }
+                for (j = 0; j < lum_size - 1; j++)
+                    lum_sum += lum_filter[j];
+                for (j = 0; j < chr_size - 1; j++)
+                    chr_sum += chr_filter[j];
+                lum_filter[lum_size - 1] = (1 << 12) - lum_sum;
+                chr_filter[chr_size - 1] = (1 << 12) - chr_sum;
+
+                for (wi = 0; wi < FF_ARRAY_ELEMS(widths); wi++) {
+                    const int w = widths[wi];
+
+                    memset(dst0, 0, LINE_PIXELS * 4);
+                    memset(dst1, 0, LINE_PIXELS * 4);
+                    call_ref(ctx, lum_filter, lum, lum_size, chr_filter,
+                             chr_u, chr_v, chr_size, alp, dst0, w, 0);
+                    call_new(ctx, lum_filter, lum, lum_size, chr_filter,
+                             chr_u, chr_v, chr_size, alp, dst1, w, 0);
+                    if (memcmp(dst0, dst1, LINE_PIXELS * 4))
+                        fail();
+                }
+                if (lum_size == 3)
+                    bench_new(ctx, lum_filter, lum, lum_size, chr_filter,
+                              chr_u, chr_v, chr_size, alp, dst0, MAX_STRIDE, 0);
+            }
+        }
+    }
+}
+
 void checkasm_check_sw_rgb(void)
 {
+    struct SwsContext *ctx;
+
     ff_sws_rgb2rgb_init();
 
     check_shuffle_bytes(shuffle_bytes_2103, "shuffle_bytes_2103");
@@ -203,4 +467,25 @@ void checkasm_check_sw_rgb(void)
 
     check_interleave_bytes();
     report("interleave_bytes");
+
+    check_words();
+    report("words");
+
+    ctx = sws_alloc_context();
+    ctx->srcW      = ctx->dstW = MAX_STRIDE;
+    ctx->dstH      = 2 * ctx->srcH;
+    ctx->dstFormat = AV_PIX_FMT_RGBA;
+    if (sws_init_context(ctx, NULL, NULL) < 0)
+        fail();
+
+    check_rgb_to_y(ctx);
+    report("rgb_to_y");
+
+    check_rgb_to_uv(ctx);
+    report("rgb_to_uv");
+
+    check_yuv2rgb_full_X(ctx);
+    report("yuv2rgb_full_X");
+
+    sws_freeContext(ctx);
 }
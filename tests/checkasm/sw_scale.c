@@ -43,17 +43,21 @@ static void check_hscale(void)
 #define FILTER_SIZES 5
     static const int filter_sizes[FILTER_SIZES] = { 4, 8, 16, 32, 40 };
 
-#define HSCALE_PAIRS 2
+#define HSCALE_PAIRS 6
     static const int hscale_pairs[HSCALE_PAIRS][2] = {
-        { 8, 14 },
-        { 8, 18 },
+        {  8, 14 },
+        {  8, 18 },
+        { 10, 14 },
+        { 10, 18 },
+        { 16, 14 },
+        { 16, 18 },
     };
 
     int i, j, fsi, hpi, width;
     struct SwsContext *ctx;
 
-    // padded
-    LOCAL_ALIGNED_32(uint8_t, src, [FFALIGN(SRC_PIXELS + MAX_FILTER_WIDTH - 1, 4)]);
+    // padded, 8 or 16 bit samples
+    LOCAL_ALIGNED_32(uint8_t, src, [FFALIGN(SRC_PIXELS + MAX_FILTER_WIDTH - 1, 4) * 2]);
     LOCAL_ALIGNED_32(uint32_t, dst0, [SRC_PIXELS]);
     LOCAL_ALIGNED_32(uint32_t, dst1, [SRC_PIXELS]);
 
@@ -71,36 +75,61 @@ static void check_hscale(void)
     if (sws_init_context(ctx, NULL, NULL) < 0)
         fail();
 
-    randomize_buffers(src, SRC_PIXELS + MAX_FILTER_WIDTH - 1);
-
     for (hpi = 0; hpi < HSCALE_PAIRS; hpi++) {
+        const int src_bpc = hscale_pairs[hpi][0];
+
+        randomize_buffers(src, (SRC_PIXELS + MAX_FILTER_WIDTH - 1) * 2);
+        // the high bit depth C versions take the sample depth from the format
+        switch (src_bpc) {
+        case 8:  ctx->srcFormat = AV_PIX_FMT_YUV420P;    break;
+        case 10: ctx->srcFormat = AV_PIX_FMT_YUV420P10;  break;
+        case 16: ctx->srcFormat = AV_PIX_FMT_YUV420P16;  break;
+        }
+        if (src_bpc == 10)
+            for (i = 0; i < SRC_PIXELS + MAX_FILTER_WIDTH - 1; i++)
+                ((uint16_t *)src)[i] &= 0x3FF;
+
         for (fsi = 0; fsi < FILTER_SIZES; fsi++) {
             width = filter_sizes[fsi];
 
-            ctx->srcBpc = hscale_pairs[hpi][0];
+            ctx->srcBpc = src_bpc;
             ctx->dstBpc = hscale_pairs[hpi][1];
             ctx->hLumFilterSize = ctx->hChrFilterSize = width;
 
             for (i = 0; i < SRC_PIXELS; i++) {
                 filterPos[i] = i;
 
-                // These filter cofficients are chosen to try break two corner
-                // cases, namely:
-                //
-                // - Negative filter coefficients. The filters output signed
-                //   values, and it should be possible to end up with negative
-                //   output values.
-                //
-                // - Positive clipping. The hscale filter function has clipping
-                //   at (1<<15) - 1
-                //
-                // The coefficients sum to the 1.0 point for the hscale
-                // functions (1 << 14).
-
-                for (j = 0; j < width; j++) {
-                    filter[i * width + j] = -((1 << 14) / (width - 1));
+                if (src_bpc == 8) {
+                    // These filter cofficients are chosen to try break two
+                    // corner cases, namely:
+                    //
+                    // - Negative filter coefficients. The filters output
+                    //   signed values, and it should be possible to end up
+                    //   with negative output values.
+                    //
+                    // - Positive clipping. The hscale filter function has
+                    //   clipping at (1<<15) - 1
+                    //
+                    // The coefficients sum to the 1.0 point for the hscale
+                    // functions (1 << 14).
+
+                    for (j = 0; j < width; j++) {
+                        filter[i * width + j] = -((1 << 14) / (width - 1));
+                    }
+                    filter[i * width + (rnd() % width)] = ((1 << 15) - 1);
+                } else {
+                    // Wider samples would overflow the 32 bit sums with the
+                    // coefficients above. The 16 bit versions also rely on
+                    // the coefficients summing to exactly 1 << 14, like the
+                    // ones initFilter() generates.
+                    int sum = 0;
+
+                    for (j = 0; j < width - 1; j++) {
+                        filter[i * width + j] = (1 << 14) / width + (int)(rnd() % 1024) - 512;
+                        sum += filter[i * width + j];
+                    }
+                    filter[i * width + width - 1] = (1 << 14) - sum;
                 }
-                filter[i * width + (rnd() % width)] = ((1 << 15) - 1);
             }
 
             for (i = 0; i < MAX_FILTER_WIDTH; i++) {
@@ -116,12 +145,97 @@ static void check_hscale(void)
                 memset(dst0, 0, SRC_PIXELS * sizeof(dst0[0]));
                 memset(dst1, 0, SRC_PIXELS * sizeof(dst1[0]));
 
-                call_ref(NULL, dst0, SRC_PIXELS, src, filter, filterPos, width);
-                call_new(NULL, dst1, SRC_PIXELS, src, filter, filterPos, width);
+                call_ref(ctx, dst0, SRC_PIXELS, src, filter, filterPos, width);
+                call_new(ctx, dst1, SRC_PIXELS, src, filter, filterPos, width);
                 if (memcmp(dst0, dst1, SRC_PIXELS * sizeof(dst0[0])))
                     fail();
-                bench_new(NULL, dst0, SRC_PIXELS, src, filter, filterPos, width);
+                bench_new(ctx, dst0, SRC_PIXELS, src, filter, filterPos, width);
+            }
+        }
+    }
+    sws_freeContext(ctx);
+}
+
+static void check_yuv2planeX(void)
+{
+#define MAX_VFILTER_SIZE 16
+#define DST_PIXELS 128
+#define LINE_PIXELS (DST_PIXELS + 32)
+    static const int filter_sizes[] = { 2, 4, 8, 16 };
+    static const int widths[] = { DST_PIXELS, DST_PIXELS - 3 };
+    static const enum AVPixelFormat formats[] = {
+        AV_PIX_FMT_YUV420P9LE, AV_PIX_FMT_YUV420P10LE,
+        AV_PIX_FMT_YUV420P12LE, AV_PIX_FMT_YUV420P16LE,
+    };
+
+    int i, j, fi, fsi, wi;
+    struct SwsContext *ctx;
+    const int16_t *src[MAX_VFILTER_SIZE];
+
+    // 15 bit input in int16_t or 19 bit input in int32_t, padded for the
+    // vector overreads
+    LOCAL_ALIGNED_32(int32_t, src_pixels, [MAX_VFILTER_SIZE * LINE_PIXELS]);
+    LOCAL_ALIGNED_32(int16_t, filter, [MAX_VFILTER_SIZE]);
+    LOCAL_ALIGNED_32(uint16_t, dst0, [LINE_PIXELS]);
+    LOCAL_ALIGNED_32(uint16_t, dst1, [LINE_PIXELS]);
+    LOCAL_ALIGNED_8(uint8_t, dither, [8]);
+
+    declare_func_emms(AV_CPU_FLAG_MMX, void, const int16_t *filter, int filterSize,
+                      const int16_t **src, uint8_t *dest, int dstW,
+                      const uint8_t *dither, int offset);
+
+    ctx = sws_alloc_context();
+    if (sws_init_context(ctx, NULL, NULL) < 0)
+        fail();
+
+    memset(dither, 0, 8);
+    for (i = 0; i < MAX_VFILTER_SIZE; i++)
+        src[i] = (const int16_t *)(src_pixels + i * LINE_PIXELS);
+
+    for (fi = 0; fi < FF_ARRAY_ELEMS(formats); fi++) {
+        const int bits = av_pix_fmt_desc_get(formats[fi])->comp[0].depth;
+
+        ctx->dstFormat = formats[fi];
+        ctx->dstBpc    = bits;
+        ff_getSwsFunc(ctx);
+
+        if (!check_func(ctx->yuv2planeX, "yuv2planeX_%d", bits))
+            continue;
+
+        for (fsi = 0; fsi < FF_ARRAY_ELEMS(filter_sizes); fsi++) {
+            const int filter_size = filter_sizes[fsi];
+            int sum = 0;
+
+            // coefficients around the 1.0 point (1 << 12), with some overshoot
+            // to reach the clipping on both ends
+            for (j = 0; j < filter_size - 1; j++) {
+                filter[j] = (1 << 12) / filter_size + (int)(rnd() % 2048) - 1024;
+                sum += filter[j];
+            }
+            filter[filter_size - 1] = (1 << 12) - sum;
+
+            for (j = 0; j < filter_size; j++) {
+                for (i = 0; i < LINE_PIXELS; i++) {
+                    if (bits == 16)
+                        src_pixels[j * LINE_PIXELS + i] = rnd() & 0x7FFFF;
+                    else
+                        ((int16_t *)src[j])[i] = rnd() & 0x7FFF;
+                }
+            }
+
+            for (wi = 0; wi < FF_ARRAY_ELEMS(widths); wi++) {
+                const int w = widths[wi];
+
+                memset(dst0, 0, LINE_PIXELS * sizeof(dst0[0]));
+                memset(dst1, 0, LINE_PIXELS * sizeof(dst1[0]));
+
+                call_ref(filter, filter_size, src, (uint8_t *)dst0, w, dither, 0);
+                call_new(filter, filter_size, src, (uint8_t *)dst1, w, dither, 0);
+                if (memcmp(dst0, dst1, w * sizeof(dst0[0])))
+                    fail();
             }
+            if (filter_size == 8)
+                bench_new(filter, filter_size, src, (uint8_t *)dst0, DST_PIXELS, dither, 0);
         }
     }
     sws_freeContext(ctx);
@@ -131,4 +245,7 @@ void checkasm_check_sw_scale(void)
 {
     check_hscale();
     report("hscale");
+
+    check_yuv2planeX();
+    report("yuv2planeX");
 }
@@ -0,0 +1,147 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+
+#include "libavfilter/lut3d.h"
+#include "libavutil/common.h"
+#include "libavutil/mem.h"
+
+#include "checkasm.h"
+
+#define WIDTH 256
+#define MAX_LUTSIZE 64
+
+static const char *const interp_names[NB_INTERP_MODE] = {
+    "nearest", "trilinear", "tetrahedral",
+};
+
+static const int lut_sizes[] = { 2, 17, 33, MAX_LUTSIZE };
+
+/* the input layouts of the filter: step 1 is planar */
+static const struct {
+    int depth, step;
+} inputs[] = {
+    {  8, 1 }, { 10, 1 }, { 16, 1 },
+    {  8, 3 }, {  8, 4 }, { 16, 3 }, { 16, 4 },
+};
+
+static void fill_lut(float *lut, int lutsize)
+{
+    int i;
+
+    for (i = 0; i < 3 * lutsize * lutsize * lutsize; i++)
+        lut[i] = (rnd() & 0xFFFF) / 65535.0f;
+}
+
+/**
+ * Draw random pixels in the given layout, with the extremes at the start of
+ * the line, and map them to LUT coordinates the way the filter does.
+ */
+static void fill_coords(float *coords, uint16_t *pixels, int depth, int step,
+                        int lutsize)
+{
+    const int max = (1 << depth) - 1;
+    const float lut_max = lutsize - 1;
+    const float scale_f = 1.0f / max;
+    const ptrdiff_t plane = step == 1 ? WIDTH : 1;
+    int x, c;
+
+    for (x = 0; x < WIDTH * FFMAX(step, 3); x++)
+        pixels[x] = rnd() & max;
+    for (c = 0; c < 3; c++) {
+        pixels[c * plane]               = 0;
+        pixels[c * plane + step]        = max;
+        pixels[c * plane + 2 * step]    = max - 1;
+    }
+
+    for (c = 0; c < 3; c++) {
+        for (x = 0; x < WIDTH; x++) {
+            const int v = pixels[c * plane + x * step];
+            coords[c * WIDTH + x] = av_clipf(v * scale_f * lut_max, 0, lut_max);
+        }
+    }
+}
+
+static void check_interp(void)
+{
+    LOCAL_ALIGNED_32(float, coords,  [3 * WIDTH]);
+    LOCAL_ALIGNED_32(float, dst_ref, [3 * WIDTH]);
+    LOCAL_ALIGNED_32(float, dst_new, [3 * WIDTH]);
+    LOCAL_ALIGNED_32(uint16_t, pixels, [4 * WIDTH]);
+    float *lut = av_malloc_array(3 * MAX_LUTSIZE * MAX_LUTSIZE * MAX_LUTSIZE,
+                                 sizeof(*lut));
+    LUT3DDSPContext dsp;
+    int i, j, k, w;
+
+    declare_func(void, float *dst, const float *src, ptrdiff_t stride,
+                 const float *lut, int lutsize, int w);
+
+    if (!lut)
+        return;
+
+    ff_lut3d_dsp_init(&dsp);
+
+    for (i = 0; i < NB_INTERP_MODE; i++) {
+        if (!check_func(dsp.interp[i], "lut3d_%s", interp_names[i]))
+            continue;
+
+        for (j = 0; j < FF_ARRAY_ELEMS(lut_sizes); j++) {
+            const int lutsize = lut_sizes[j];
+
+            fill_lut(lut, lutsize);
+            for (k = 0; k < FF_ARRAY_ELEMS(inputs); k++) {
+                fill_coords(coords, pixels, inputs[k].depth, inputs[k].step, lutsize);
+
+                /* the tail is padded with valid coordinates, as the filter does */
+                for (w = WIDTH - 5; w <= WIDTH; w += 5) {
+                    int x, c;
+
+                    for (c = 0; c < 3; c++)
+                        for (x = w; x < FFALIGN(w, LUT3D_ROW_ALIGN); x++)
+                            coords[c * WIDTH + x] = 0.0f;
+
+                    memset(dst_ref, 0, 3 * WIDTH * sizeof(*dst_ref));
+                    memset(dst_new, 0, 3 * WIDTH * sizeof(*dst_new));
+                    call_ref(dst_ref, coords, WIDTH, lut, lutsize, w);
+                    call_new(dst_new, coords, WIDTH, lut, lutsize, w);
+                    for (c = 0; c < 3; c++) {
+                        if (!float_near_abs_eps_array(dst_ref + c * WIDTH,
+                                                      dst_new + c * WIDTH,
+                                                      1e-6f, w)) {
+                            fail();
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+
+        fill_lut(lut, 33);
+        fill_coords(coords, pixels, 10, 1, 33);
+        bench_new(dst_new, coords, WIDTH, lut, 33, WIDTH);
+    }
+
+    av_free(lut);
+}
+
+void checkasm_check_vf_lut3d(void)
+{
+    check_interp();
+    report("interp");
+}
@@ -0,0 +1,119 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+
+#include "libavfilter/vf_nnedi.h"
+#include "libavutil/common.h"
+#include "libavutil/mem.h"
+
+#include "checkasm.h"
+
+#define MAX_NEURONS 512
+#define MAX_LEN     288
+
+/* the prescreener sizes, then the predictor sizes */
+static const struct {
+    int n, len;
+} dot_sizes[] = {
+    {   4,  48 }, {   4,  64 },
+    {  32,  32 }, {  32,  64 }, {  64, 128 }, { 128,  48 },
+    { 256,  96 }, { 512, 192 }, { 512, 288 },
+};
+
+static void check_dot_prods(const NNEDIDSPContext *dsp)
+{
+    LOCAL_ALIGNED_32(int16_t, data, [MAX_LEN]);
+    LOCAL_ALIGNED_32(int32_t, sums_ref, [MAX_NEURONS]);
+    LOCAL_ALIGNED_32(int32_t, sums_new, [MAX_NEURONS]);
+    int16_t *weights = av_malloc_array(MAX_NEURONS * MAX_LEN, sizeof(*weights));
+    int i, j;
+
+    declare_func(void, int32_t *sums, const int16_t *data,
+                 const int16_t *weights, int n, int len);
+
+    if (!weights)
+        return;
+
+    if (check_func(dsp->dot_prods, "nnedi_dot_prods")) {
+        for (i = 0; i < FF_ARRAY_ELEMS(dot_sizes); i++) {
+            const int n = dot_sizes[i].n, len = dot_sizes[i].len;
+
+            /* pixels against weights scaled to the int16 range */
+            for (j = 0; j < len; j++)
+                data[j] = rnd() & 0xFF;
+            for (j = 0; j < n * len; j++)
+                weights[j] = (int16_t)rnd();
+            weights[0] = INT16_MIN;
+            weights[1] = INT16_MAX;
+
+            memset(sums_ref, 0, MAX_NEURONS * sizeof(*sums_ref));
+            memset(sums_new, 0, MAX_NEURONS * sizeof(*sums_new));
+            call_ref(sums_ref, data, weights, n, len);
+            call_new(sums_new, data, weights, n, len);
+            if (memcmp(sums_ref, sums_new, MAX_NEURONS * sizeof(*sums_ref)))
+                fail();
+        }
+        bench_new(sums_new, data, weights, 512, 192);
+    }
+
+    av_free(weights);
+}
+
+static void check_exp(const NNEDIDSPContext *dsp)
+{
+    LOCAL_ALIGNED_32(float, src, [MAX_NEURONS / 2]);
+    LOCAL_ALIGNED_32(float, dst_ref, [MAX_NEURONS / 2]);
+    LOCAL_ALIGNED_32(float, dst_new, [MAX_NEURONS / 2]);
+    int n, i;
+
+    declare_func(void, float *s, int n);
+
+    if (check_func(dsp->exp, "nnedi_exp")) {
+        for (n = 16; n <= MAX_NEURONS / 2; n *= 2) {
+            /* the softmax inputs, including values outside of the clip range */
+            for (i = 0; i < n; i++)
+                src[i] = ((int)(rnd() % 200001) - 100000) / 1000.0f;
+            src[0] = -80.0f;
+            src[1] =  80.0f;
+            src[2] =   0.0f;
+
+            memcpy(dst_ref, src, n * sizeof(*src));
+            memcpy(dst_new, src, n * sizeof(*src));
+            call_ref(dst_ref, n);
+            call_new(dst_new, n);
+            if (!float_near_ulp_array(dst_ref, dst_new, 2, n))
+                fail();
+        }
+        memcpy(dst_new, src, MAX_NEURONS / 2 * sizeof(*src));
+        bench_new(dst_new, MAX_NEURONS / 2);
+    }
+}
+
+void checkasm_check_vf_nnedi(void)
+{
+    NNEDIDSPContext dsp;
+
+    ff_nnedi_init(&dsp);
+
+    check_dot_prods(&dsp);
+    report("dot_prods");
+
+    check_exp(&dsp);
+    report("exp");
+}
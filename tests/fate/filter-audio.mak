@@ -397,6 +397,11 @@ FATE_AFILTER-yes += fate-filter-formats
 fate-filter-formats: libavfilter/tests/formats$(EXESUF)
 fate-filter-formats: CMD = run libavfilter/tests/formats$(EXESUF)
 
+FATE_AFILTER-$(CONFIG_ATEMPO_FILTER) += fate-filter-atempo-bench
+fate-filter-atempo-bench: libavfilter/tests/atempo$(EXESUF)
+fate-filter-atempo-bench: CMD = run libavfilter/tests/atempo$(EXESUF) 1
+fate-filter-atempo-bench: CMP = null
+
 FATE_SAMPLES_AVCONV += $(FATE_AFILTER_SAMPLES-yes)
 FATE_FFMPEG += $(FATE_AFILTER-yes)
 fate-afilter: $(FATE_AFILTER-yes) $(FATE_AFILTER_SAMPLES-yes)
@@ -83,6 +83,9 @@ fate-filter-testsrc2-rgb24: CMD = framecrc -lavfi testsrc2=r=7:d=10 -pix_fmt rgb
 FATE_FILTER-$(call ALLYES, LAVFI_INDEV TESTSRC2_FILTER) += fate-filter-testsrc2-rgba
 fate-filter-testsrc2-rgba: CMD = framecrc -lavfi testsrc2=r=7:d=10 -pix_fmt rgba
 
+FATE_FILTER-$(call ALLYES, TESTSRC2_FILTER FORMAT_FILTER SCALE_FILTER) += fate-filter-scale-pq-bt2020-bt709
+fate-filter-scale-pq-bt2020-bt709: CMD = framecrc -lavfi testsrc2=r=7:d=1,format=yuv420p10le,scale=flags=bicubic+accurate_rnd+bitexact:src_transfer=smpte2084:src_primaries=bt2020:dst_transfer=bt709:dst_primaries=bt709,format=yuv420p10le -frames:v 3 -flags +bitexact -sws_flags +accurate_rnd+bitexact
+
 FATE_FILTER-$(call ALLYES, LAVFI_INDEV ALLRGB_FILTER) += fate-filter-allrgb
 fate-filter-allrgb: CMD = framecrc -lavfi allrgb=rate=5:duration=1 -pix_fmt rgb24
 
@@ -775,18 +778,34 @@ FATE_METADATA_FILTER-$(call ALLYES, $(SCENEDETECT_DEPS)) += fate-filter-metadata
 fate-filter-metadata-scenedetect: SRC = $(TARGET_SAMPLES)/svq3/Vertical400kbit.sorenson3.mov
 fate-filter-metadata-scenedetect: CMD = run $(FILTER_METADATA_COMMAND) "sws_flags=+accurate_rnd+bitexact;movie='$(SRC)',select=gt(scene\,.25)"
 
+# the detection filters must give the same results from framestats side data
+FATE_METADATA_FILTER-$(call ALLYES, $(SCENEDETECT_DEPS) FRAMESTATS_FILTER) += fate-filter-metadata-scenedetect-framestats
+fate-filter-metadata-scenedetect-framestats: SRC = $(TARGET_SAMPLES)/svq3/Vertical400kbit.sorenson3.mov
+fate-filter-metadata-scenedetect-framestats: CMD = run $(FILTER_METADATA_COMMAND) "sws_flags=+accurate_rnd+bitexact;movie='$(SRC)',framestats,select=gt(scene\,.25)"
+fate-filter-metadata-scenedetect-framestats: REF = $(SRC_PATH)/tests/ref/fate/filter-metadata-scenedetect
+
 SCDET_DEPS = FFPROBE LAVFI_INDEV MOVIE_FILTER SCDET_FILTER SCALE_FILTER \
                    AVCODEC AVDEVICE MOV_DEMUXER SVQ3_DECODER ZLIB
 FATE_METADATA_FILTER-$(call ALLYES, $(SCDET_DEPS)) += fate-filter-metadata-scdet
 fate-filter-metadata-scdet: SRC = $(TARGET_SAMPLES)/svq3/Vertical400kbit.sorenson3.mov
 fate-filter-metadata-scdet: CMD = run $(FILTER_METADATA_COMMAND) "sws_flags=+accurate_rnd+bitexact;movie='$(SRC)',scdet=s=1"
 
+FATE_METADATA_FILTER-$(call ALLYES, $(SCDET_DEPS) FRAMESTATS_FILTER) += fate-filter-metadata-scdet-framestats
+fate-filter-metadata-scdet-framestats: SRC = $(TARGET_SAMPLES)/svq3/Vertical400kbit.sorenson3.mov
+fate-filter-metadata-scdet-framestats: CMD = run $(FILTER_METADATA_COMMAND) "sws_flags=+accurate_rnd+bitexact;movie='$(SRC)',framestats,scdet=s=1"
+fate-filter-metadata-scdet-framestats: REF = $(SRC_PATH)/tests/ref/fate/filter-metadata-scdet
+
 CROPDETECT_DEPS = FFPROBE LAVFI_INDEV MOVIE_FILTER CROPDETECT_FILTER SCALE_FILTER \
                   AVCODEC AVDEVICE MOV_DEMUXER H264_DECODER
 FATE_METADATA_FILTER-$(call ALLYES, $(CROPDETECT_DEPS)) += fate-filter-metadata-cropdetect
 fate-filter-metadata-cropdetect: SRC = $(TARGET_SAMPLES)/filter/cropdetect.mp4
 fate-filter-metadata-cropdetect: CMD = run $(FILTER_METADATA_COMMAND) "sws_flags=+accurate_rnd+bitexact;movie='$(SRC)',cropdetect=max_outliers=3"
 
+FATE_METADATA_FILTER-$(call ALLYES, $(CROPDETECT_DEPS) FRAMESTATS_FILTER) += fate-filter-metadata-cropdetect-framestats
+fate-filter-metadata-cropdetect-framestats: SRC = $(TARGET_SAMPLES)/filter/cropdetect.mp4
+fate-filter-metadata-cropdetect-framestats: CMD = run $(FILTER_METADATA_COMMAND) "sws_flags=+accurate_rnd+bitexact;movie='$(SRC)',framestats,cropdetect=max_outliers=3"
+fate-filter-metadata-cropdetect-framestats: REF = $(SRC_PATH)/tests/ref/fate/filter-metadata-cropdetect
+
 FREEZEDETECT_DEPS = FFPROBE AVDEVICE LAVFI_INDEV MPTESTSRC_FILTER SCALE_FILTER FREEZEDETECT_FILTER
 FATE_METADATA_FILTER-$(call ALLYES, $(FREEZEDETECT_DEPS)) += fate-filter-metadata-freezedetect
 fate-filter-metadata-freezedetect: CMD = run $(FILTER_METADATA_COMMAND) "sws_flags=+accurate_rnd+bitexact;mptestsrc=r=25:d=10:m=51,freezedetect"
@@ -1095,4 +1095,11 @@ fate-swr-audioconvert: FUZZ = 0
 
 FATE_SWR += $(FATE_SWR_AUDIOCONVERT-yes)
 FATE_FFMPEG += $(FATE_SWR)
-fate-swr: $(FATE_SWR)
+
+FATE_LIBSWRESAMPLE += fate-swr-threads
+fate-swr-threads: libswresample/tests/threads$(EXESUF)
+fate-swr-threads: CMD = run libswresample/tests/threads$(EXESUF)
+fate-swr-threads: CMP = null
+
+FATE-$(CONFIG_SWRESAMPLE) += $(FATE_LIBSWRESAMPLE)
+fate-swr: $(FATE_SWR) $(FATE_LIBSWRESAMPLE)
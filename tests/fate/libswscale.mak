@@ -1,7 +1,27 @@
+FATE_LIBSWSCALE += fate-sws-convert-matrix
+fate-sws-convert-matrix: libswscale/tests/convert_matrix$(EXESUF)
+fate-sws-convert-matrix: CMD = run libswscale/tests/convert_matrix$(EXESUF) 131 67
+fate-sws-convert-matrix: CMP = null
+
+FATE_LIBSWSCALE += fate-sws-filter-cache
+fate-sws-filter-cache: libswscale/tests/filter_cache$(EXESUF)
+fate-sws-filter-cache: CMD = run libswscale/tests/filter_cache$(EXESUF)
+fate-sws-filter-cache: CMP = null
+
 FATE_LIBSWSCALE += fate-sws-pixdesc-query
 fate-sws-pixdesc-query: libswscale/tests/pixdesc_query$(EXESUF)
 fate-sws-pixdesc-query: CMD = run libswscale/tests/pixdesc_query$(EXESUF)
 
+FATE_LIBSWSCALE += fate-sws-slices
+fate-sws-slices: libswscale/tests/slices$(EXESUF)
+fate-sws-slices: CMD = run libswscale/tests/slices$(EXESUF)
+fate-sws-slices: CMP = null
+
+FATE_LIBSWSCALE += fate-sws-transfer
+fate-sws-transfer: libswscale/tests/transfer$(EXESUF)
+fate-sws-transfer: CMD = run libswscale/tests/transfer$(EXESUF)
+fate-sws-transfer: CMP = null
+
 FATE_LIBSWSCALE += $(FATE_LIBSWSCALE-yes)
 FATE-$(CONFIG_SWSCALE) += $(FATE_LIBSWSCALE)
 fate-libswscale: $(FATE_LIBSWSCALE)